@@ -123,6 +123,131 @@ parser.add_argument(
     action="store_true",
     help="build with regHIO support",
 )
+parser.add_argument(
+    "--fast-decomp",
+    action="store_true",
+    help="build with fast-path Yaz0/Yay0 decoders (non-matching)",
+)
+parser.add_argument(
+    "--decomp-workers",
+    action="store_true",
+    help="build JKRDecomp with a prioritized multi-worker queue (non-matching)",
+)
+parser.add_argument(
+    "--stream-decomp",
+    action="store_true",
+    help="build with DVD reads overlapped with SZS decoding (non-matching)",
+)
+parser.add_argument(
+    "--exp-heap-index",
+    action="store_true",
+    help="build JKRExpHeap with a size-class free block index (non-matching)",
+)
+parser.add_argument(
+    "--heap-trace",
+    action="store_true",
+    help="build JKRHeap with allocation trace recording (non-matching)",
+)
+parser.add_argument(
+    "--bgs-broadphase",
+    action="store_true",
+    help="build cBgS with a broadphase grid for line/ground checks (non-matching)",
+)
+parser.add_argument(
+    "--ccs-broadphase",
+    action="store_true",
+    help="build cCcS with a cell index for AT/TG and CO pair checks (non-matching)",
+)
+parser.add_argument(
+    "--bgs-line-multi",
+    action="store_true",
+    help="batch the talk camera's paired BG line checks through dBgS::LineCrossMulti (non-matching)",
+)
+parser.add_argument(
+    "--process-index",
+    action="store_true",
+    help="build the process searchers with ID and name hash indices (non-matching)",
+)
+parser.add_argument(
+    "--cull-batch",
+    action="store_true",
+    help="build actor culling as one batched pass per frame (non-matching)",
+)
+parser.add_argument(
+    "--jpa-field-batch",
+    action="store_true",
+    help="build JParticle with batched particle field updates (non-matching)",
+)
+parser.add_argument(
+    "--jpa-parallel-calc",
+    action="store_true",
+    help="build JParticle with emitter calc split over worker threads (non-matching)",
+)
+parser.add_argument(
+    "--archive-index",
+    action="store_true",
+    help="build JKRArchive with hashed name and resource pointer lookups (non-matching)",
+)
+parser.add_argument(
+    "--res-index",
+    action="store_true",
+    help="build dRes_control_c with hashed archive info lookups (non-matching)",
+)
+parser.add_argument(
+    "--stage-decode-index",
+    action="store_true",
+    help="build stage data decoding with a hashed chunk tag index (non-matching)",
+)
+parser.add_argument(
+    "--dvd-scheduler",
+    action="store_true",
+    help="build the DVD thread with prioritized, cancellable, seek-ordered commands (non-matching)",
+)
+parser.add_argument(
+    "--room-prefetch",
+    action="store_true",
+    help="prefetch room archives behind nearby loading zones, needs --dvd-scheduler (non-matching)",
+)
+parser.add_argument(
+    "--pcm-mix-simd",
+    action="store_true",
+    help="mix and interleave PCM in JASCalc/JASDriver with paired singles (non-matching)",
+)
+parser.add_argument(
+    "--dsp-renderer",
+    action="store_true",
+    help="add a software renderer for JASDsp channels (non-matching)",
+)
+parser.add_argument(
+    "--seq-bench",
+    action="store_true",
+    help="add a headless JASSeqParser benchmark with a pre-decoded interpreter mode (non-matching)",
+)
+parser.add_argument(
+    "--key-cursor",
+    action="store_true",
+    help="cache the last key index per channel in J3D key animations (non-matching)",
+)
+parser.add_argument(
+    "--joint-flatten",
+    action="store_true",
+    help="evaluate J3D joint trees from a flattened joint order instead of recursively (non-matching)",
+)
+parser.add_argument(
+    "--anm-batch",
+    action="store_true",
+    help="let actors defer model calcs to a single-threaded batch, grouped by model data, run before the draw phase (non-matching)",
+)
+parser.add_argument(
+    "--skin-simd",
+    action="store_true",
+    help="use SSE/NEON kernels for J3D envelope blending and skinning on hosted builds (non-matching)",
+)
+parser.add_argument(
+    "--draw-key-sort",
+    action="store_true",
+    help="radix sort J3D draw buffers by a 64-bit packet key and record entries for replay (non-matching)",
+)
 if not is_windows():
     parser.add_argument(
         "--wrapper",
@@ -422,6 +547,81 @@ elif config.version in WII_VERSIONS or config.version in SHIELD_VERSIONS:
 if config.version in ["RZDE01_00", "ShieldD"] or args.debug or args.reghio:
     cflags_framework.extend(["-DENABLE_REGHIO=1"])
 
+if args.fast_decomp:
+    cflags_framework.extend(["-DENABLE_FAST_DECOMP=1"])
+
+if args.decomp_workers:
+    cflags_framework.extend(["-DENABLE_DECOMP_WORKERS=1"])
+
+if args.stream_decomp:
+    cflags_framework.extend(["-DENABLE_STREAM_DECOMP=1"])
+
+if args.exp_heap_index:
+    cflags_framework.extend(["-DENABLE_EXPHEAP_SIZE_INDEX=1"])
+
+if args.heap_trace:
+    cflags_framework.extend(["-DENABLE_HEAP_TRACE=1"])
+
+if args.bgs_broadphase:
+    cflags_framework.extend(["-DENABLE_BGS_BROADPHASE=1"])
+
+if args.ccs_broadphase:
+    cflags_framework.extend(["-DENABLE_CCS_BROADPHASE=1"])
+
+if args.bgs_line_multi:
+    cflags_framework.extend(["-DENABLE_BGS_LINE_MULTI=1"])
+
+if args.process_index:
+    cflags_framework.extend(["-DENABLE_PROCESS_INDEX=1"])
+
+if args.cull_batch:
+    cflags_framework.extend(["-DENABLE_CULL_BATCH=1"])
+
+if args.jpa_field_batch:
+    cflags_framework.extend(["-DENABLE_JPA_FIELD_BATCH=1"])
+
+if args.jpa_parallel_calc:
+    cflags_framework.extend(["-DENABLE_JPA_PARALLEL_CALC=1"])
+
+if args.archive_index:
+    cflags_framework.extend(["-DENABLE_ARCHIVE_INDEX=1"])
+
+if args.res_index:
+    cflags_framework.extend(["-DENABLE_RES_INDEX=1"])
+
+if args.stage_decode_index:
+    cflags_framework.extend(["-DENABLE_STAGE_DECODE_INDEX=1"])
+
+if args.dvd_scheduler:
+    cflags_framework.extend(["-DENABLE_DVD_SCHEDULER=1"])
+
+if args.room_prefetch:
+    cflags_framework.extend(["-DENABLE_ROOM_PREFETCH=1"])
+
+if args.pcm_mix_simd:
+    cflags_framework.extend(["-DENABLE_PCM_MIX_SIMD=1"])
+
+if args.dsp_renderer:
+    cflags_framework.extend(["-DENABLE_DSP_RENDERER=1"])
+
+if args.seq_bench:
+    cflags_framework.extend(["-DENABLE_SEQ_BENCH=1"])
+
+if args.key_cursor:
+    cflags_framework.extend(["-DENABLE_KEY_CURSOR=1"])
+
+if args.joint_flatten:
+    cflags_framework.extend(["-DENABLE_JOINT_FLATTEN=1"])
+
+if args.anm_batch:
+    cflags_framework.extend(["-DENABLE_ANM_BATCH=1"])
+
+if args.skin_simd:
+    cflags_framework.extend(["-DENABLE_SKIN_SIMD=1"])
+
+if args.draw_key_sort:
+    cflags_framework.extend(["-DENABLE_DRAW_KEY_SORT=1"])
+
 if config.version != "ShieldD":
     if config.version in WII_VERSIONS:
         # TODO: whats the correct inlining flag? deferred looks better in some places, others not. something else wrong?
@@ -93,6 +93,10 @@ public:
     virtual ~cCcD_DivideInfo() {}
     void Set(u32, u32, u32);
     bool Chk(cCcD_DivideInfo const&) const;
+
+    u32 GetXDivInfo() const { return mXDivInfo; }
+    u32 GetYDivInfo() const { return mYDivInfo; }
+    u32 GetZDivInfo() const { return mZDivInfo; }
 };  // Size = 0x10
 
 STATIC_ASSERT(0x10 == sizeof(cCcD_DivideInfo));
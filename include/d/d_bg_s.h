@@ -30,6 +30,53 @@ public:
 
 STATIC_ASSERT(sizeof(cBgS_ChkElm) == 0x14);
 
+#if ENABLE_BGS_BROADPHASE
+/**
+ * Header at the start of a cBgS query recording, followed by mCount records.
+ * The buffer is stored in native (big-endian) byte order and is replayed by
+ * tools/host_check/bgs_broadphase.cpp.
+ */
+struct cBgS_BndRecordHeader {
+    /* 0x00 */ u32 mMagic;
+    /* 0x04 */ u32 mVersion;
+    /* 0x08 */ u32 mCount;
+    /* 0x0C */ u32 mDropped;
+};  // Size: 0x10
+
+/**
+ * One recorded body or query.
+ *
+ * TYPE_REFIT:   RefitBnd ran; TYPE_BODY records for every used slot follow
+ * TYPE_BODY:    mSlot, mId = actor ID, mFlag = FLAG_*, mV = bounds min, max
+ * TYPE_REGIST:  as TYPE_BODY, for a body just registered
+ * TYPE_RELEASE: mSlot
+ * TYPE_LINE:    mId = actor ID the line skips, mV = start, end
+ * TYPE_GND:     mId = actor ID the check skips, mV = point
+ */
+struct cBgS_BndRecord {
+    enum EType {
+        TYPE_REFIT,
+        TYPE_BODY,
+        TYPE_REGIST,
+        TYPE_RELEASE,
+        TYPE_LINE,
+        TYPE_GND,
+    };
+
+    enum EFlag {
+        FLAG_NOT_READY = 1,
+        FLAG_MOVE_BG = 2,
+        FLAG_BND_VALID = 4,
+    };
+
+    /* 0x00 */ u8 mType;
+    /* 0x01 */ u8 mFlag;
+    /* 0x02 */ u16 mSlot;
+    /* 0x04 */ u32 mId;
+    /* 0x08 */ f32 mV[6];
+};  // Size: 0x20
+#endif
+
 class cBgS {
 public:
     /* 0x0000 */ cBgS_ChkElm m_chk_element[256];
@@ -40,6 +87,9 @@ public:
     bool Regist(dBgW_Base*, fpc_ProcID, void*);
     bool Release(dBgW_Base*);
     bool LineCross(cBgS_LinChk*);
+#if ENABLE_BGS_LINE_MULTI
+    int LineCrossMulti(cBgS_LinChk**, int);
+#endif
     f32 GroundCross(cBgS_GndChk*);
     static void* ConvDzb(void*);
     fopAc_ac_c* GetActorPointer(int) const;
@@ -58,7 +108,29 @@ public:
     fopAc_ac_c* GetActorPointer(cBgS_PolyInfo const& info) const {
         return GetActorPointer(info.GetBgIndex());
     }
-};  // Size: 0x1404
+
+#if ENABLE_BGS_BROADPHASE
+    enum {
+        BND_GRID_NUM = 16,
+        BND_MASK_NUM = 0x100 / 32,
+    };
+
+    void ClrBnd();
+    void RefitBnd();
+    void GetBndCandidate(f32 min_x, f32 max_x, f32 min_z, f32 max_z, u32* o_cand) const;
+    void RecordBody(u8, int) const;
+
+    static void RecordBnd(u8, u8, int, u32, const Vec*, const Vec*);
+    static bool StartBndRecord(void*, u32);
+    static u32 StopBndRecord();
+
+    u32 m_bnd_indexed[BND_MASK_NUM];
+    u32 m_bnd_always[BND_MASK_NUM];
+    u32 m_bnd_grid[BND_GRID_NUM][BND_GRID_NUM][BND_MASK_NUM];
+    Vec m_bnd_min[0x100];
+    Vec m_bnd_max[0x100];
+#endif
+};  // Size: 0x1404, 0x4C44 with ENABLE_BGS_BROADPHASE
 
 class dBgS_Acch;
 
@@ -174,6 +246,19 @@ public:
         return cBgS::LineCross(i_linChk);
         #endif
     }
+#if ENABLE_BGS_LINE_MULTI
+    int LineCrossMulti(cBgS_LinChk** i_linChk, int i_num) {
+        #if DEBUG
+        if (m_hio.ChkLineOff()) {
+            return 0;
+        }
+        if (m_hio.ChkCheckCounter()) {
+            g_line_counter += i_num;
+        }
+        #endif
+        return cBgS::LineCrossMulti(i_linChk, i_num);
+    }
+#endif
     f32 GroundCross(cBgS_GndChk* i_gndChk) {
         #if DEBUG
         if (m_hio.ChkCheckCounter()) {
@@ -201,7 +286,7 @@ public:
     /* 0x1404 */ u8 field_0x1404[0x1408 - 0x1404];
     /* 0x1408 */ dBgS_HIO m_hio;
 #endif
-};  // Size: 0x1404
+};  // Size: 0x1404, 0x4C44 with ENABLE_BGS_BROADPHASE (offsets above shift by 0x3840)
 
 bool dBgS_CheckBGroundPoly(cBgS_PolyInfo const&);
 bool dBgS_CheckBRoofPoly(cBgS_PolyInfo const&);
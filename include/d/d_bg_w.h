@@ -135,6 +135,10 @@ public:
     bool RwgLineCheck(u16, cBgS_LinChk*);
     bool LineCheckRp(cBgS_LinChk*, int);
     bool LineCheckGrpRp(cBgS_LinChk*, int, int);
+#if ENABLE_BGS_LINE_MULTI
+    u32 LineCheckMultiRp(cBgS_LinChk**, u32, int);
+    u32 LineCheckMultiGrpRp(cBgS_LinChk**, u32, int, int);
+#endif
     bool RwgGroundCheckCommon(f32, u16, cBgS_GndChk*);
     bool RwgGroundCheckGnd(u16, cBgS_GndChk*);
     bool RwgGroundCheckWall(u16, cBgS_GndChk*);
@@ -214,6 +218,12 @@ public:
     virtual bool ChkPolyThrough(int, cBgS_PolyPassChk*);
     virtual bool ChkShdwDrawThrough(int, cBgS_PolyPassChk*);
     virtual bool ChkGrpThrough(int, cBgS_GrpPassChk*, int);
+#if ENABLE_BGS_BROADPHASE
+    virtual bool ChkBndValid() const;
+#endif
+#if ENABLE_BGS_LINE_MULTI
+    virtual u32 LineCheckMulti(cBgS_LinChk**, u32);
+#endif
 
     u32 GetOldInvMtx(Mtx m) { return MTXInverse(m_inv_mtx, m); }
     MtxP GetBaseMtxP() { return pm_base; }
@@ -104,6 +104,13 @@ public:
     virtual void MatrixCrrPos(cBgS_PolyInfo const&, void*, bool, cXyz*, csXyz*, csXyz*) = 0;
     virtual void CallRideCallBack(fopAc_ac_c*, fopAc_ac_c*);
     virtual void CallArrowStickCallBack(fopAc_ac_c*, fopAc_ac_c*, cXyz&);
+#if ENABLE_BGS_BROADPHASE
+    /** Whether GetBnd() encloses every polygon, so cBgS may cull by it. */
+    virtual bool ChkBndValid() const { return false; }
+#endif
+#if ENABLE_BGS_LINE_MULTI
+    virtual u32 LineCheckMulti(cBgS_LinChk**, u32);
+#endif
 
     #if DEBUG
     virtual void DebugDraw() {}
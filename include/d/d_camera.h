@@ -1001,6 +1001,9 @@ public:
     bool lineBGCheck(cXyz*, cXyz*, dBgS_LinChk*, u32);
     bool lineBGCheck(cXyz*, cXyz*, u32);
     bool lineBGCheck(cXyz*, cXyz*, cXyz*, u32);
+#if ENABLE_BGS_LINE_MULTI
+    u32 lineBGCheckMulti(cXyz**, int, cXyz*, u32);
+#endif
     u32 lineCollisionCheckBush(cXyz*, cXyz*);
     cXyz compWallMargin(cXyz*, cXyz*, f32);
     int defaultTriming();
@@ -4316,9 +4316,16 @@ inline int dComIfG_setObjectRes(const char* i_arcName, void* i_archiveRes, u32 i
  * @param i_heap Pointer to heap to load resources into
  * @return TRUE if successful, FALSE otherwise
  */
+#if ENABLE_DVD_SCHEDULER
+inline int dComIfG_setStageRes(const char* i_arcName, JKRHeap* i_heap,
+                               u8 i_priority = mDoDvdThd_PRIORITY_NORMAL) {
+    return g_dComIfG_gameInfo.mResControl.setStageRes(i_arcName, i_heap, i_priority);
+}
+#else
 inline int dComIfG_setStageRes(const char* i_arcName, JKRHeap* i_heap) {
     return g_dComIfG_gameInfo.mResControl.setStageRes(i_arcName, i_heap);
 }
+#endif
 
 inline int dComIfG_syncObjectRes(const char* i_arcName) {
     return g_dComIfG_gameInfo.mResControl.syncObjectRes(i_arcName);
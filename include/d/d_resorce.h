@@ -13,7 +13,12 @@ public:
     dRes_info_c();
     ~dRes_info_c();
 
+#if ENABLE_DVD_SCHEDULER
+    int set(char const* i_arcName, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap,
+            u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     int set(char const* i_arcName, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap);
+#endif
     int loadResource();
     void deleteArchiveRes();
     int setRes(JKRArchive* i_archive, JKRHeap* i_heap);
@@ -75,13 +80,23 @@ public:
     int getStageAllSize();
     int getObjectAllSize();
     int setObjectRes(char const* i_arcName, void* i_archiveRes, u32 i_bufferSize, JKRHeap* i_heap);
+#if ENABLE_DVD_SCHEDULER
+    int setStageRes(char const* i_arcName, JKRHeap* i_heap,
+                    u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     int setStageRes(char const* i_arcName, JKRHeap* i_heap);
+#endif
     void dump();
     void dumpTag();
     void dump(char*);
     int getObjectResName2Index(char const* i_arcName, char const* i_resName);
 
+#if ENABLE_DVD_SCHEDULER
+    static int setRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap,
+                      u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     static int setRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap);
+#endif
     static int syncRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum);
     static int deleteRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum);
     static void* getRes(char const* i_arcName, char const* i_resName, dRes_info_c* i_resInfo, int i_infoNum);
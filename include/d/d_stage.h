@@ -1398,6 +1398,12 @@ dStage_KeepDoorInfo* dStage_GetKeepDoorInfo();
 dStage_KeepDoorInfo* dStage_GetRoomKeepDoorInfo();
 void dStage_dt_c_fieldMapLoader(void* i_data, dStage_dt_c* i_stage);
 
+#if ENABLE_ROOM_PREFETCH
+void dStage_prefetchRoom(const cXyz* i_pos);
+BOOL dStage_resetPrefetchRoom();
+void dStage_getPrefetchRoomStat(u32* o_hitNum, u32* o_missNum);
+#endif
+
 #if DEBUG
 void dStage_DebugDisp();
 #endif
@@ -259,6 +259,9 @@ public:
     /* 0x498 */ u8 demoActorID;
     /* 0x499 */ s8 argument;
     /* 0x49A */ u8 carryType;
+#if ENABLE_CULL_BATCH
+    /* 0x49B */ u8 cullBatch;
+#endif
     /* 0x49C */ u32 actor_status;
     /* 0x4A0 */ u32 actor_condition;
     /* 0x4A4 */ fpc_ProcID parentActorID;
@@ -1,6 +1,9 @@
 #ifndef F_OP_ACTOR_ITER_H_
 #define F_OP_ACTOR_ITER_H_
 
+#if ENABLE_PROCESS_INDEX
+#include "f_pc/f_pc_base.h"
+#endif
 
 typedef int (*fopAcIt_ExecutorFunc)(void* actor, void* data);
 typedef void* (*fopAcIt_JudgeFunc)(void* actor, void* data);
@@ -8,4 +11,9 @@ typedef void* (*fopAcIt_JudgeFunc)(void* actor, void* data);
 int fopAcIt_Executor(fopAcIt_ExecutorFunc executeFunc, void* data);
 void* fopAcIt_Judge(fopAcIt_JudgeFunc judgeFunc, void* data);
 
+#if ENABLE_PROCESS_INDEX
+void* fopAcIt_SearchByID(fpc_ProcID id);
+void* fopAcIt_SearchByName(s16 name);
+#endif
+
 #endif
\ No newline at end of file
@@ -239,7 +239,11 @@ inline fopAc_ac_c* fopAcM_Search(fopAcIt_JudgeFunc i_judgeFunc, void* i_process)
 }
 
 inline fopAc_ac_c* fopAcM_SearchByID(fpc_ProcID id) {
+#if ENABLE_PROCESS_INDEX
+    return (fopAc_ac_c*)fopAcIt_SearchByID(id);
+#else
     return (fopAc_ac_c*)fopAcIt_Judge(fpcSch_JudgeByID, &id);
+#endif
 }
 
 inline fpc_ProcID fopAcM_GetLinkId(const fopAc_ac_c* i_actor) {
@@ -328,6 +332,9 @@ inline void fopAcM_SetMaxFallSpeed(fopAc_ac_c* actor, f32 speed) {
 
 inline void fopAcM_SetMtx(fopAc_ac_c* actor, MtxP m) {
     actor->cullMtx = m;
+#if ENABLE_CULL_BATCH
+    actor->cullBatch = 0;
+#endif
 }
 
 inline void fopAcM_SetSpeed(fopAc_ac_c* actor, f32 x, f32 y, f32 z) {
@@ -388,6 +395,9 @@ inline dJntCol_c* fopAcM_GetJntCol(fopAc_ac_c* i_actor) {
 
 inline void fopAcM_setCullSizeFar(fopAc_ac_c* i_actor, f32 i_far) {
     i_actor->cullSizeFar = i_far;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 inline f32 fopAcM_getCullSizeFar(const fopAc_ac_c* i_actor) {
@@ -404,6 +414,9 @@ inline const Vec* fopAcM_getCullSizeBoxMax(const fopAc_ac_c* i_actor) {
 
 inline void fopAcM_SetCullSize(fopAc_ac_c* i_actor, int i_cullsize) {
     i_actor->cullType = i_cullsize;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 inline int fopAcM_GetCullSize(const fopAc_ac_c* i_actor) {
@@ -481,7 +494,11 @@ inline BOOL fopAcM_isSwitch(const fopAc_ac_c* i_actor, int sw) {
 }
 
 inline fopAc_ac_c* fopAcM_SearchByName(s16 proc_id) {
+#if ENABLE_PROCESS_INDEX
+    return (fopAc_ac_c*)fopAcIt_SearchByName(proc_id);
+#else
     return (fopAc_ac_c*)fopAcIt_Judge(fpcSch_JudgeForPName, &proc_id);
+#endif
 }
 
 inline void dComIfGs_onItem(int bitNo, int roomNo);
@@ -618,6 +635,10 @@ BOOL fopAcM_rollPlayerCrash(fopAc_ac_c const* i_crashActor, f32 i_range, u32 i_f
                             f32 i_min_y, BOOL param_5, f32 param_6);
 bool fopAcM_checkCullingBox(f32[3][4], f32, f32, f32, f32, f32, f32);
 s32 fopAcM_cullingCheck(const fopAc_ac_c* i_actor);
+#if ENABLE_CULL_BATCH
+void fopAcM_cullingCheckAll();
+s32 fopAcM_cullingCheckBatched(const fopAc_ac_c* i_actor);
+#endif
 s32 fopAcM_orderTalkEvent(fopAc_ac_c* i_actorA, fopAc_ac_c* i_actorB, u16 i_priority, u16 i_flag);
 s32 fopAcM_orderTalkItemBtnEvent(u16 i_eventType, fopAc_ac_c* i_actorA, fopAc_ac_c* i_actorB,
                                  u16 i_priority, u16 i_flag);
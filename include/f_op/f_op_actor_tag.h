@@ -9,4 +9,9 @@ int fopAcTg_ToActorQ(create_tag_class* i_createTag);
 
 extern node_list_class g_fopAcTg_Queue;
 
+#if ENABLE_PROCESS_INDEX
+/** Index of every actor currently in g_fopAcTg_Queue. */
+extern struct process_search_index g_fopAcTg_Index;
+#endif
+
 #endif
@@ -10,6 +10,9 @@ typedef struct base_process_class base_process_class;
 
 base_process_class* fpcEx_Search(fpcLyIt_JudgeFunc i_judgeFunc, void* i_data);
 base_process_class* fpcEx_SearchByID(fpc_ProcID i_id);
+#if ENABLE_PROCESS_INDEX
+base_process_class* fpcEx_SearchByName(s16 i_name);
+#endif
 BOOL fpcEx_IsExist(fpc_ProcID i_id);
 int fpcEx_ToLineQ(base_process_class* i_proc);
 int fpcEx_ExecuteQTo(base_process_class* i_proc);
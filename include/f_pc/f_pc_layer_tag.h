@@ -28,4 +28,9 @@ int fpcLyTg_Move(layer_management_tag_class* i_layer_tag, unsigned int i_layerID
                  u16 i_listPriority);
 int fpcLyTg_Init(layer_management_tag_class* i_layer_tag, unsigned int i_id, void* i_data);
 
+#if ENABLE_PROCESS_INDEX
+/** Index of every process currently queued in a layer. */
+extern struct process_search_index g_fpcLyTg_Index;
+#endif
+
 #endif
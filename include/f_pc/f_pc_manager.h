@@ -84,7 +84,11 @@ inline base_process_class* fpcM_Search(fpcLyIt_JudgeFunc i_func, void* i_data) {
 }
 
 inline base_process_class* fpcM_SearchByName(s16 name) {
+#if ENABLE_PROCESS_INDEX
+    return fpcEx_SearchByName(name);
+#else
     return (base_process_class*)fpcLyIt_AllJudge(fpcSch_JudgeForPName, &name);
+#endif
 }
 
 inline base_process_class* fpcM_SearchByID(fpc_ProcID i_id) {
@@ -7,4 +7,51 @@
 void* fpcSch_JudgeForPName(void* pProc, void* pUserData);
 void* fpcSch_JudgeByID(void* pProc, void* pUserData);
 
+#if ENABLE_PROCESS_INDEX
+enum {
+    fpcSch_INDEX_BUCKET_NUM = 0x200,
+    fpcSch_INDEX_NODE_NUM = 0x400,
+    fpcSch_INDEX_NONE = 0,
+};
+
+enum {
+    fpcSch_INDEX_NOT_FOUND,
+    fpcSch_INDEX_FOUND,
+    fpcSch_INDEX_UNKNOWN,
+};
+
+typedef struct process_search_index_node {
+    /* 0x00 */ base_process_class* process;
+    /* 0x04 */ fpc_ProcID id;
+    /* 0x08 */ s16 name;
+    /* 0x0A */ u16 next_id;
+    /* 0x0C */ u16 prev_name;
+    /* 0x0E */ u16 next_name;
+} process_search_index_node;  // Size: 0x10
+
+/**
+ * Index of the processes in one queue by ID and by name. Entries are added
+ * and removed alongside the queue itself, so a lookup returns what a judge
+ * walk over that queue would. Links hold node number + 1 so that a zeroed
+ * index is a valid empty one. Processes that did not fit are counted in
+ * overflow; while it is non-zero every lookup reports fpcSch_INDEX_UNKNOWN
+ * and the caller falls back to the walk.
+ */
+typedef struct process_search_index {
+    /* 0x0000 */ u16 id_head[fpcSch_INDEX_BUCKET_NUM];
+    /* 0x0400 */ u16 name_head[fpcSch_INDEX_BUCKET_NUM];
+    /* 0x0800 */ u16 free_head;
+    /* 0x0802 */ u16 used_num;
+    /* 0x0804 */ u16 overflow;
+    /* 0x0808 */ process_search_index_node nodes[fpcSch_INDEX_NODE_NUM];
+} process_search_index;
+
+void fpcSch_AddIndex(process_search_index* i_index, base_process_class* i_proc);
+void fpcSch_RemoveIndex(process_search_index* i_index, base_process_class* i_proc);
+int fpcSch_SearchIndexByID(process_search_index* i_index, fpc_ProcID i_id,
+                           base_process_class** o_proc);
+int fpcSch_SearchIndexByName(process_search_index* i_index, s16 i_name,
+                             base_process_class** o_proc);
+#endif
+
 #endif
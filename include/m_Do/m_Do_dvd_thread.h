@@ -15,17 +15,62 @@ class JKRMemArchive;
 
 typedef void* (*mDoDvdThd_callback_func)(void*);
 
+#if ENABLE_DVD_SCHEDULER
+enum mDoDvdThd_Priority {
+    mDoDvdThd_PRIORITY_CRITICAL,
+    mDoDvdThd_PRIORITY_NORMAL,
+    mDoDvdThd_PRIORITY_PREFETCH,
+    mDoDvdThd_PRIORITY_MAX,
+};
+
+enum mDoDvdThd_State {
+    mDoDvdThd_STATE_NONE,
+    mDoDvdThd_STATE_QUEUED,
+    mDoDvdThd_STATE_RUNNING,
+    mDoDvdThd_STATE_CANCELLED,
+};
+
+// Disc offset of commands that do not read a file of their own. The
+// scheduler never moves another command across them.
+#define mDoDvdThd_OFFSET_BARRIER 0xFFFFFFFF
+#endif
+
 class mDoDvdThd_command_c : public node_class {
 public:
     /* 0x0C */ bool mIsDone;
     /* 0x10  vtable*/
+#if ENABLE_DVD_SCHEDULER
+    /* 0x14 */ u8 mPriority;
+    /* 0x15 */ u8 mState;
+    /* 0x18 */ u32 mDiscOffset;
+    /* 0x20 */ OSTime mQueueTime;
+    /* 0x28 */ OSTime mStartTime;
+#endif
 public:
     virtual ~mDoDvdThd_command_c();
     mDoDvdThd_command_c();
     inline s32 sync() { return mIsDone; }
     inline void destroy() { delete this; }
     virtual s32 execute() = 0;
-};  // Size = 0x14
+#if ENABLE_DVD_SCHEDULER
+    void setSchedule(s32 i_entryNum, u8 i_priority);
+    bool cancel();
+    void setPriority(u8 i_priority);
+    u8 getPriority() const { return mPriority; }
+    bool isCancelled() const { return mState == mDoDvdThd_STATE_CANCELLED; }
+    OSTime getQueueWaitTime() const { return mStartTime - mQueueTime; }
+#endif
+};  // Size = 0x14, 0x30 with ENABLE_DVD_SCHEDULER (subclass offsets below shift by 0x1C)
+
+#if ENABLE_DVD_SCHEDULER
+struct mDoDvdThd_stat_c {
+    /* 0x00 */ u32 mCount;
+    /* 0x08 */ OSTime mWaitTime;
+    /* 0x10 */ OSTime mMaxWaitTime;
+    /* 0x18 */ OSTime mServiceTime;
+    /* 0x20 */ OSTime mMaxServiceTime;
+};  // Size = 0x28
+#endif
 
 class mDoDvdThd_param_c {
 public:
@@ -36,13 +81,24 @@ public:
     void addition(mDoDvdThd_command_c*);
     void cut(mDoDvdThd_command_c*);
     void mainLoop();
+#if ENABLE_DVD_SCHEDULER
+    mDoDvdThd_command_c* takeCommand();
+    bool cancel(mDoDvdThd_command_c*);
+    void setPriority(mDoDvdThd_command_c*, u8 i_priority);
+    void entryStat(u8 i_priority, OSTime i_waitTime, OSTime i_serviceTime);
+    mDoDvdThd_stat_c getStat(int i_priority);
+#endif
 
 private:
     /* 0x00 */ OSMessageQueue mMessageQueue;
     /* 0x20 */ void* mMessageQueueMessages;
     /* 0x24 */ node_list_class mNodeList;
     /* 0x30 */ OSMutex mMutext;
-};  // Size = 0x48
+#if ENABLE_DVD_SCHEDULER
+    /* 0x48 */ u32 mHeadOffset;
+    /* 0x50 */ mDoDvdThd_stat_c mStat[mDoDvdThd_PRIORITY_MAX];
+#endif
+};  // Size = 0x48, 0xC8 with ENABLE_DVD_SCHEDULER
 
 class mDoDvdThd_callback_c : public mDoDvdThd_command_c {
 public:
@@ -61,7 +117,12 @@ class mDoDvdThd_mountArchive_c : public mDoDvdThd_command_c {
 public:
     virtual ~mDoDvdThd_mountArchive_c();
     mDoDvdThd_mountArchive_c(u8);
+#if ENABLE_DVD_SCHEDULER
+    static mDoDvdThd_mountArchive_c* create(char const*, u8, JKRHeap*,
+                                            u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     static mDoDvdThd_mountArchive_c* create(char const*, u8, JKRHeap*);
+#endif
     virtual s32 execute();
 
     JKRMemArchive* getArchive() const { return mArchive; }
@@ -72,7 +133,7 @@ private:
     /* 0x18 */ s32 mEntryNumber;
     /* 0x1C */ JKRMemArchive* mArchive;
     /* 0x20 */ JKRHeap* mHeap;
-};  // Size = 0x24
+};  // Size = 0x24, 0x40 with ENABLE_DVD_SCHEDULER
 
 class mDoDvdThd_mountAramArchive_c : public mDoDvdThd_command_c {
 public:
@@ -88,8 +149,13 @@ class mDoDvdThd_mountXArchive_c : public mDoDvdThd_command_c {
 public:
     virtual ~mDoDvdThd_mountXArchive_c();
     mDoDvdThd_mountXArchive_c(u8 mountDirection, JKRArchive::EMountMode mountMode);
+#if ENABLE_DVD_SCHEDULER
+    static mDoDvdThd_mountXArchive_c* create(char const*, u8, JKRArchive::EMountMode, JKRHeap*,
+                                             u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     static mDoDvdThd_mountXArchive_c* create(char const*, u8, JKRArchive::EMountMode,
                                                             JKRHeap*);
+#endif
     virtual s32 execute();
 
     JKRArchive* getArchive() const { return mArchive; }
@@ -100,7 +166,7 @@ private:
     /* 0x1C */ JKRArchive* mArchive;
     /* 0x20 */ JKRArchive::EMountMode mMountMode;
     /* 0x24 */ JKRHeap* mHeap;
-};  // Size = 0x28
+};  // Size = 0x28, 0x48 with ENABLE_DVD_SCHEDULER
 
 class mDoDvdThd_getResource_c : public mDoDvdThd_command_c {
     virtual ~mDoDvdThd_getResource_c();
@@ -114,7 +180,12 @@ class mDoDvdThd_getResource_c : public mDoDvdThd_command_c {
 class mDoDvdThd_toMainRam_c : public mDoDvdThd_command_c {
 public:
     mDoDvdThd_toMainRam_c(u8);
+#if ENABLE_DVD_SCHEDULER
+    static mDoDvdThd_toMainRam_c* create(char const*, u8, JKRHeap*,
+                                         u8 i_priority = mDoDvdThd_PRIORITY_NORMAL);
+#else
     static mDoDvdThd_toMainRam_c* create(char const*, u8, JKRHeap*);
+#endif
     virtual ~mDoDvdThd_toMainRam_c();
     virtual s32 execute();
 
@@ -126,7 +197,7 @@ private:
     /* 0x1C */ void* mData;
     /* 0x20 */ s32 mDataSize;
     /* 0x24 */ JKRHeap* mHeap;
-};  // Size = 0x28
+};  // Size = 0x28, 0x48 with ENABLE_DVD_SCHEDULER
 
 struct mDoDvdThdStack {
     u8 stack[4096];
@@ -311,6 +311,9 @@ struct mDoExt_MtxCalcAnmBlendTbl
 
     virtual ~mDoExt_MtxCalcAnmBlendTbl() {}
     virtual void calc();
+#if ENABLE_JOINT_FLATTEN
+    virtual void calc(J3DJointCalcContext* pContext) { J3DMtxCalc::calc(pContext); }
+#endif
 
     /* 0x4 */ int mNum;
     /* 0x8 */ mDoExt_AnmRatioPack* mAnmRatio;
@@ -345,6 +348,10 @@ public:
     void frameUpdate();
 
     virtual ~mDoExt_morf_c();
+#if ENABLE_JOINT_FLATTEN
+    /** The morfs' calc() overrides work on the statics. */
+    virtual void calc(J3DJointCalcContext* pContext) { J3DMtxCalc::calc(pContext); }
+#endif
 
     J3DAnmTransform* getAnm() { return mpAnm; }
     void changeAnm(J3DAnmTransform* anm) { mpAnm = anm; }
@@ -388,6 +395,9 @@ public:
     u32 play(Vec*, u32, s8);
     void entryDL();
     void modelCalc();
+#if ENABLE_ANM_BATCH
+    void modelCalcReq(bool i_regroup);
+#endif
     void getTransform(u16, J3DTransformInfo*);
 
     virtual ~mDoExt_McaMorf();
@@ -403,6 +413,9 @@ private:
     /* 0x50 */ bool field_0x50;
     /* 0x51 */ bool field_0x51;
     /* 0x52 */ bool field_0x52;
+#if ENABLE_KEY_CURSOR
+    /* 0x54 */ u16* mpKeyCursor;
+#endif
 };
 
 class mDoExt_McaMorfSO : public mDoExt_morf_c {
@@ -418,6 +431,9 @@ public:
     void updateDL();
     void entryDL();
     void modelCalc();
+#if ENABLE_ANM_BATCH
+    void modelCalcReq(bool i_regroup);
+#endif
     void getTransform(u16, J3DTransformInfo*);
     void stopZelAnime();
 
@@ -441,6 +457,9 @@ private:
     /* 0x50 */ void* mpBas;
     /* 0x54 */ bool mTranslate;
     /* 0x55 */ bool mMorfNone;
+#if ENABLE_KEY_CURSOR
+    /* 0x58 */ u16* mpKeyCursor;
+#endif
 };
 
 class mDoExt_McaMorf2 : public mDoExt_morf_c {
@@ -457,6 +476,9 @@ public:
     int play(u32, s8);
     void entryDL();
     void modelCalc();
+#if ENABLE_ANM_BATCH
+    void modelCalcReq(bool i_regroup);
+#endif
     void stopZelAnime();
 
     virtual ~mDoExt_McaMorf2();
@@ -475,6 +497,9 @@ private:
     /* 0x44 */ f32 mAnmRate;
     /* 0x48 */ Z2Creature* mpSound;
     /* 0x4C */ void* mpBas;
+#if ENABLE_KEY_CURSOR
+    /* 0x50 */ u16* mpKeyCursor;
+#endif
 };
 
 struct mDoExt_3Dline_field_0x10_c {
@@ -824,6 +849,12 @@ void mDoExt_setAraCacheSize(u32 size);
 
 int mDoExt_resIDToIndex(JKRArchive* p_archive, u16 id);
 void mDoExt_modelEntryDL(J3DModel* i_model);
+#if ENABLE_ANM_BATCH
+void mDoExt_modelCalcBegin();
+void mDoExt_modelCalcReq(J3DModel* i_model, bool i_regroup);
+void mDoExt_modelCalcCancel(J3DModel* i_model);
+void mDoExt_modelCalcFlush();
+#endif
 void mDoExt_brkAnmRemove(J3DModelData* i_modelData);
 void mDoExt_setupStageTexture(J3DModelData* i_modelData);
 OSThread* mDoExt_GetCurrentRunningThread();
@@ -532,6 +532,16 @@ public:
     }
 
     void calcTransform(f32, u16, J3DTransformInfo*) const;
+#if ENABLE_KEY_CURSOR
+    void calcTransform(f32, u16, J3DTransformInfo*, u16*) const;
+
+    /** Key cursors per joint for the pCursor argument. */
+    static const int KEY_CURSOR_NUM = 9;
+
+    void getTransform(u16 jointNo, J3DTransformInfo* pTransform, u16* pCursor) const {
+        calcTransform(getFrame(), jointNo, pTransform, pCursor);
+    }
+#endif
 
     virtual ~J3DAnmTransformKey() {}
     virtual s32 getKind() const { return 8; }
@@ -581,6 +591,13 @@ class J3DAnmTextureSRTKey : public J3DAnmBase {
 public:
     J3DAnmTextureSRTKey();
     void calcTransform(f32, u16, J3DTextureSRTInfo*) const;
+#if ENABLE_KEY_CURSOR
+    void calcTransform(f32, u16, J3DTextureSRTInfo*, u16*) const;
+
+    void getTransform(u16 jointNo, J3DTextureSRTInfo* pSRTInfo, u16* pCursor) const {
+        calcTransform(getFrame(), jointNo, pSRTInfo, pCursor);
+    }
+#endif
     void searchUpdateMaterialID(J3DMaterialTable*);
     void searchUpdateMaterialID(J3DModelData*);
 
@@ -806,6 +823,9 @@ public:
     virtual ~J3DAnmColorKey() {}
     virtual s32 getKind() const { return 11; }
     virtual void getColor(u16, GXColor*) const;
+#if ENABLE_KEY_CURSOR
+    void getColor(u16, GXColor*, u16*) const;
+#endif
 
     /* 0x2C */ s16* mColorR;
     /* 0x30 */ s16* mColorG;
@@ -823,6 +843,10 @@ public:
     J3DAnmTevRegKey();
     void getTevColorReg(u16, _GXColorS10*) const;
     void getTevKonstReg(u16, _GXColor*) const;
+#if ENABLE_KEY_CURSOR
+    void getTevColorReg(u16, _GXColorS10*, u16*) const;
+    void getTevKonstReg(u16, _GXColor*, u16*) const;
+#endif
     void searchUpdateMaterialID(J3DMaterialTable*);
     void searchUpdateMaterialID(J3DModelData*);
 
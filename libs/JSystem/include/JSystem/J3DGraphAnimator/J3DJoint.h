@@ -10,6 +10,24 @@ class J3DJoint;
 class J3DMaterial;
 class J3DMtxBuffer;
 
+#if ENABLE_JOINT_FLATTEN
+/**
+ * What a mtx calc works on, which recursiveCalc() keeps in the J3DSys and J3DMtxCalc statics.
+ * J3DJointTree::calcOrdered() points it at its own stack frame, so that separate models can be
+ * walked at the same time.
+ */
+struct J3DJointCalcContext {
+    void setJ3DSys() const;
+    void getJ3DSys();
+
+    /* 0x00 */ MtxP mCurrentMtx;
+    /* 0x04 */ Vec* mCurrentS;
+    /* 0x08 */ Vec* mParentS;
+    /* 0x0C */ J3DMtxBuffer* mMtxBuffer;
+    /* 0x10 */ J3DJoint* mJoint;
+};  // Size: 0x14
+#endif
+
 /**
  * @ingroup jsystem-j3d
  * 
@@ -42,6 +60,15 @@ public:
     }
     virtual void init(const Vec& param_0, const Mtx&) = 0;
     virtual void calc() = 0;
+#if ENABLE_JOINT_FLATTEN
+    /**
+     * init() and calc() on a context instead of the statics. These defaults pass the context
+     * through the statics, so a subclass of J3DMtxCalcNoAnm that overrides calc() must send
+     * calc(J3DJointCalcContext*) back here.
+     */
+    virtual void init(J3DJointCalcContext* pContext, const Vec& scale, const Mtx& mtx);
+    virtual void calc(J3DJointCalcContext* pContext);
+#endif
 
     static J3DMtxBuffer* getMtxBuffer() {
         J3D_ASSERT_NULLPTR(174, mMtxBuffer != NULL)
@@ -147,6 +174,14 @@ public:
         J3DTransformInfo& transInfo = getJoint()->getTransformInfo();
         A::calcTransform(transInfo);
     }
+#if ENABLE_JOINT_FLATTEN
+    virtual void init(J3DJointCalcContext* pContext, const Vec& param_0, const Mtx& param_1) {
+        B::init(pContext, param_0, param_1);
+    }
+    virtual void calc(J3DJointCalcContext* pContext) {
+        A::calcTransform(pContext, pContext->mJoint->getTransformInfo());
+    }
+#endif
 };
 
 struct J3DMtxCalcAnmBase: public J3DMtxCalc {
@@ -179,6 +214,21 @@ struct J3DMtxCalcAnimationAdaptorDefault : public J3DMtxCalcAnimationAdaptorBase
 
         A0::calcTransform(*transform_p);
     }
+
+#if ENABLE_JOINT_FLATTEN
+    void calc(J3DMtxCalcAnmBase* pMtxCalc, J3DJointCalcContext* pContext) {
+        J3DTransformInfo transform;
+        J3DTransformInfo* transform_p;
+        if (pMtxCalc->getAnmTransform() != NULL) {
+            pMtxCalc->getAnmTransform()->getTransform(pContext->mJoint->getJntNo(), &transform);
+            transform_p = &transform;
+        } else {
+            transform_p = &pContext->mJoint->getTransformInfo();
+        }
+
+        A0::calcTransform(pContext, *transform_p);
+    }
+#endif
 };
 
 template <typename A0, typename B0>
@@ -193,6 +243,12 @@ struct J3DMtxCalcAnimation : public J3DMtxCalcAnmBase {
 
     void init(const Vec& param_0, const Mtx& param_1) { B0::init(param_0, param_1); }
     void calc() { field_0x8.calc(this); }
+#if ENABLE_JOINT_FLATTEN
+    void init(J3DJointCalcContext* pContext, const Vec& param_0, const Mtx& param_1) {
+        B0::init(pContext, param_0, param_1);
+    }
+    void calc(J3DJointCalcContext* pContext) { field_0x8.calc(this, pContext); }
+#endif
 
     A0 field_0x8;
 };
@@ -203,6 +259,9 @@ struct J3DMtxCalcAnimation : public J3DMtxCalcAnmBase {
  */
 struct J3DMtxCalcJ3DSysInitMaya {
     static void init(const Vec&, const Mtx& param_1);
+#if ENABLE_JOINT_FLATTEN
+    static void init(J3DJointCalcContext*, const Vec&, const Mtx&);
+#endif
 };
 
 /**
@@ -211,6 +270,9 @@ struct J3DMtxCalcJ3DSysInitMaya {
  */
 struct J3DMtxCalcJ3DSysInitBasic {
     static void init(const Vec&, const Mtx& param_1);
+#if ENABLE_JOINT_FLATTEN
+    static void init(J3DJointCalcContext*, const Vec&, const Mtx&);
+#endif
 };
 
 /**
@@ -219,6 +281,9 @@ struct J3DMtxCalcJ3DSysInitBasic {
  */
 struct J3DMtxCalcCalcTransformSoftimage {
     static void calcTransform(J3DTransformInfo const&);
+#if ENABLE_JOINT_FLATTEN
+    static void calcTransform(J3DJointCalcContext*, J3DTransformInfo const&);
+#endif
 };
 
 /**
@@ -227,6 +292,9 @@ struct J3DMtxCalcCalcTransformSoftimage {
  */
 struct J3DMtxCalcCalcTransformMaya {
     static void calcTransform(J3DTransformInfo const&);
+#if ENABLE_JOINT_FLATTEN
+    static void calcTransform(J3DJointCalcContext*, J3DTransformInfo const&);
+#endif
 };
 
 /**
@@ -235,6 +303,9 @@ struct J3DMtxCalcCalcTransformMaya {
  */
 struct J3DMtxCalcCalcTransformBasic {
     static void calcTransform(J3DTransformInfo const&);
+#if ENABLE_JOINT_FLATTEN
+    static void calcTransform(J3DJointCalcContext*, J3DTransformInfo const&);
+#endif
 };
 
 inline s32 checkScaleOne(const Vec& param_0) {
@@ -46,6 +46,10 @@ public:
     void makeHierarchy(J3DJoint*, J3DModelHierarchy const**, J3DMaterialTable*,
                                       J3DShapeTable*);
     void findImportantMtxIndex();
+#if ENABLE_JOINT_FLATTEN
+    void makeCalcOrder();
+    void calcOrdered(J3DMtxBuffer*, Vec const&, f32 const (&)[3][4]);
+#endif
 
     virtual void calc(J3DMtxBuffer*, Vec const&, f32 const (&)[3][4]);
     virtual ~J3DJointTree() {}
@@ -97,6 +101,13 @@ private:
     /* 0x34 */ J3DDrawMtxData mDrawMtxData;
     /* 0x40 */ u32 field_0x40;
     /* 0x44 */ JUTNameTab* mJointName;
+#if ENABLE_JOINT_FLATTEN
+    /* 0x48 */ J3DJoint** mCalcJoint;
+    /* 0x4C */ u8* mCalcDepth;
+    /* 0x50 */ u16 mCalcNum;
+};  // Size: 0x54
+#else
 };  // Size: 0x48
+#endif
 
 #endif /* J3DJOINTTREE_H */
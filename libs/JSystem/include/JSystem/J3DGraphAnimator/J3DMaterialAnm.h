@@ -11,19 +11,29 @@ class J3DMatColorAnm {
 public:
     ~J3DMatColorAnm() {}
 
-    J3DMatColorAnm() : field_0x0(0), mAnmFlag(1), mAnmColor(NULL) {}
+    J3DMatColorAnm() : field_0x0(0), mAnmFlag(1), mAnmColor(NULL) {
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
+    }
 
     J3DMatColorAnm(u16 param_1, J3DAnmColor* pAnmColor) {
         field_0x0 = param_1;
         mAnmFlag = 1;
         mAnmColor = pAnmColor;
         J3D_ASSERT_NULLPTR(56, pAnmColor != NULL);
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void operator=(J3DMatColorAnm const& other) {
         mAnmColor = other.mAnmColor;
         field_0x0 = other.field_0x0;
         mAnmFlag = other.mAnmFlag;
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void setAnmFlag(bool flag) { mAnmFlag = flag; }
@@ -31,14 +41,31 @@ public:
 
     void calc(GXColor* pColor) const {
         J3D_ASSERT_NULLPTR(507, pColor != NULL);
+#if ENABLE_KEY_CURSOR
+        if (mAnmColor->getKind() == 11) {
+            ((J3DAnmColorKey*)mAnmColor)->getColor(field_0x0, pColor, mKeyCursor);
+            return;
+        }
+#endif
         mAnmColor->getColor(field_0x0, pColor);
     }
 
+#if ENABLE_KEY_CURSOR
+    void resetKeyCursor() {
+        for (int i = 0; i < 4; i++) {
+            mKeyCursor[i] = 0;
+        }
+    }
+#endif
+
 private:
     /* 0x0 */ u16 field_0x0;
     /* 0x2 */ u16 mAnmFlag;
     /* 0x4 */ J3DAnmColor* mAnmColor;
-};  // Size: 0x8
+#if ENABLE_KEY_CURSOR
+    /* 0x8 */ mutable u16 mKeyCursor[4];
+#endif
+};  // Size: 0x8, 0x10 with ENABLE_KEY_CURSOR
 
 /**
  * @ingroup jsystem-j3d
@@ -47,27 +74,49 @@ private:
 class J3DTexMtxAnm {
 public:
     ~J3DTexMtxAnm() {}
-    J3DTexMtxAnm() : field_0x0(0), mAnmFlag(1), mAnmTransform(NULL) {}
+    J3DTexMtxAnm() : field_0x0(0), mAnmFlag(1), mAnmTransform(NULL) {
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
+    }
 
     J3DTexMtxAnm(u16 param_1, J3DAnmTextureSRTKey* pSRTKey) {
         field_0x0 = param_1;
         mAnmFlag = 1;
         mAnmTransform = pSRTKey;
         J3D_ASSERT_NULLPTR(134, pSRTKey != NULL);
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void operator=(J3DTexMtxAnm const& other) {
         mAnmTransform = other.mAnmTransform;
         field_0x0 = other.field_0x0;
         mAnmFlag = other.mAnmFlag;
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void setAnmFlag(bool flag) { mAnmFlag = flag; }
 
     void calc(J3DTextureSRTInfo* pSRTInfo) const {
         J3D_ASSERT_NULLPTR(519, pSRTInfo != NULL);
+#if ENABLE_KEY_CURSOR
+        mAnmTransform->getTransform(field_0x0, pSRTInfo, mKeyCursor);
+#else
         mAnmTransform->getTransform(field_0x0, pSRTInfo);
+#endif
+    }
+
+#if ENABLE_KEY_CURSOR
+    void resetKeyCursor() {
+        for (int i = 0; i < 5; i++) {
+            mKeyCursor[i] = 0;
+        }
     }
+#endif
 
     bool getAnmFlag() const { return mAnmFlag; }
 
@@ -75,7 +124,10 @@ private:
     /* 0x0 */ u16 field_0x0;
     /* 0x2 */ u16 mAnmFlag;
     /* 0x4 */ J3DAnmTextureSRTKey* mAnmTransform;
-};  // Size: 0x8
+#if ENABLE_KEY_CURSOR
+    /* 0x8 */ mutable u16 mKeyCursor[5];
+#endif
+};  // Size: 0x8, 0x14 with ENABLE_KEY_CURSOR
 
 /**
  * @ingroup jsystem-j3d
@@ -121,19 +173,29 @@ private:
 class J3DTevColorAnm {
 public:
     ~J3DTevColorAnm() {}
-    J3DTevColorAnm() : field_0x0(0), mAnmFlag(1), mAnmTevReg(NULL) {}
+    J3DTevColorAnm() : field_0x0(0), mAnmFlag(1), mAnmTevReg(NULL) {
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
+    }
 
     J3DTevColorAnm(u16 param_1, J3DAnmTevRegKey* pTevRegKey) {
         field_0x0 = param_1;
         mAnmFlag = 1;
         mAnmTevReg = pTevRegKey;
         J3D_ASSERT_NULLPTR(293, pTevRegKey != NULL);
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void operator=(J3DTevColorAnm const& other) {
         mAnmTevReg = other.mAnmTevReg;
         field_0x0 = other.field_0x0;
         mAnmFlag = other.mAnmFlag;
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void setAnmFlag(bool flag) { mAnmFlag = flag; }
@@ -141,14 +203,29 @@ public:
 
     void calc(GXColorS10* pColor) const {
         J3D_ASSERT_NULLPTR(545, pColor != NULL);
+#if ENABLE_KEY_CURSOR
+        mAnmTevReg->getTevColorReg(field_0x0, pColor, mKeyCursor);
+#else
         mAnmTevReg->getTevColorReg(field_0x0, pColor);
+#endif
+    }
+
+#if ENABLE_KEY_CURSOR
+    void resetKeyCursor() {
+        for (int i = 0; i < 4; i++) {
+            mKeyCursor[i] = 0;
+        }
     }
+#endif
 
 private:
     /* 0x0 */ u16 field_0x0;
     /* 0x2 */ u16 mAnmFlag;
     /* 0x4 */ J3DAnmTevRegKey* mAnmTevReg;
-};  // Size: 0x8
+#if ENABLE_KEY_CURSOR
+    /* 0x8 */ mutable u16 mKeyCursor[4];
+#endif
+};  // Size: 0x8, 0x10 with ENABLE_KEY_CURSOR
 
 /**
  * @ingroup jsystem-j3d
@@ -157,19 +234,29 @@ private:
 class J3DTevKColorAnm {
 public:
     ~J3DTevKColorAnm() {}
-    J3DTevKColorAnm() : field_0x0(0), mAnmFlag(1), mAnmTevReg(NULL) {}
+    J3DTevKColorAnm() : field_0x0(0), mAnmFlag(1), mAnmTevReg(NULL) {
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
+    }
 
     J3DTevKColorAnm(u16 param_1, J3DAnmTevRegKey* pTevRegKey) {
         field_0x0 = param_1;
         mAnmFlag = 1;
         mAnmTevReg = pTevRegKey;
         J3D_ASSERT_NULLPTR(371, pTevRegKey != NULL);
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void operator=(J3DTevKColorAnm const& other) {
         mAnmTevReg = other.mAnmTevReg;
         field_0x0 = other.field_0x0;
         mAnmFlag = other.mAnmFlag;
+#if ENABLE_KEY_CURSOR
+        resetKeyCursor();
+#endif
     }
 
     void setAnmFlag(bool flag) { mAnmFlag = flag; }
@@ -177,14 +264,29 @@ public:
 
     void calc(GXColor* pColor) const {
         J3D_ASSERT_NULLPTR(558, pColor != NULL);
+#if ENABLE_KEY_CURSOR
+        mAnmTevReg->getTevKonstReg(field_0x0, pColor, mKeyCursor);
+#else
         mAnmTevReg->getTevKonstReg(field_0x0, pColor);
+#endif
+    }
+
+#if ENABLE_KEY_CURSOR
+    void resetKeyCursor() {
+        for (int i = 0; i < 4; i++) {
+            mKeyCursor[i] = 0;
+        }
     }
+#endif
 
 private:
     /* 0x0 */ u16 field_0x0;
     /* 0x2 */ u16 mAnmFlag;
     /* 0x4 */ J3DAnmTevRegKey* mAnmTevReg;
-};  // Size: 0x8
+#if ENABLE_KEY_CURSOR
+    /* 0x8 */ mutable u16 mKeyCursor[4];
+#endif
+};  // Size: 0x8, 0x10 with ENABLE_KEY_CURSOR
 
 /**
  * @ingroup jsystem-j3d
@@ -47,6 +47,9 @@ public:
     void deformVtxNrm_F32(J3DVertexBuffer*) const;
     void deformVtxNrm_S16(J3DVertexBuffer*) const;
     void deform(J3DModel*);
+#if ENABLE_SKIN_SIMD
+    void checkSimd(J3DModel*, u32);
+#endif
     void setNrmMtx(int i, MtxP mtx) {
         J3DPSMtx33CopyFrom34(mtx, (Mtx3P)mNrmMtx[i]);
     }
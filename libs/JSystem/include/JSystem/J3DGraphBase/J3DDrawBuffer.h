@@ -34,6 +34,7 @@ class J3DPacket;
 class J3DDrawPacket;
 class J3DMatPacket;
 class J3DShapePacket;
+class JKRHeap;
 
 enum J3DDrawBufDrawMode {
     J3DDrawBufDrawMode_Head,
@@ -53,6 +54,60 @@ enum J3DDrawBufSortMode {
     J3DDrawBufSortMode_MAX,
 };
 
+#if ENABLE_DRAW_KEY_SORT
+/**
+ * @ingroup jsystem-j3d
+ * One packet of a key sorted draw buffer. The top 16 bits always hold the entry table slot
+ * the packet would have gone to, so slots draw in table order in either draw mode.
+ *
+ * Mat sort: mKey = slot << 48 | material ID, the slot coming from the texture hash
+ * Z sort:   mKey = bucket << 48 | depth << 16, farther first within a bucket
+ * entryImm: mKey = slot << 48
+ */
+struct J3DDrawKey {
+    /* 0x00 */ u64 mKey;
+    /* 0x08 */ J3DPacket* mpPacket;
+};  // Size: 0x10
+
+/**
+ * @ingroup jsystem-j3d
+ * Header at the start of a draw buffer entry recording, followed by mCount records.
+ * The buffer is stored in native (big-endian) byte order and can be replayed by
+ * tools/draw_key_bench.py.
+ */
+struct J3DDrawRecordHeader {
+    /* 0x00 */ u32 mMagic;
+    /* 0x04 */ u32 mVersion;
+    /* 0x08 */ u32 mCount;
+    /* 0x0C */ u32 mDropped;
+};  // Size: 0x10
+
+/**
+ * @ingroup jsystem-j3d
+ * One recorded draw buffer entry.
+ *
+ * TYPE_FRAME: mSlot = sort mode, mA = entry table size
+ * TYPE_MAT:   mA = texture hash, mB = material ID
+ * TYPE_Z:     mSlot = bucket, mA = depth (f32 bits)
+ * TYPE_IMM:   mSlot = bucket
+ */
+struct J3DDrawRecord {
+    enum EType {
+        TYPE_FRAME,
+        TYPE_MAT,
+        TYPE_Z,
+        TYPE_IMM,
+    };
+
+    /* 0x00 */ u8 mType;
+    /* 0x01 */ u8 mPad;
+    /* 0x02 */ u16 mSlot;
+    /* 0x04 */ u32 mBuffer;
+    /* 0x08 */ u32 mA;
+    /* 0x0C */ u32 mB;
+};  // Size: 0x10
+#endif
+
 /**
  * @ingroup jsystem-j3d
  * 
@@ -77,6 +132,17 @@ public:
     void draw() const;
     void drawHead() const;
     void drawTail() const;
+#if ENABLE_DRAW_KEY_SORT
+    int allocKeyBuffer(u32);
+    int entryKey(J3DPacket*, u64, bool);
+    void spillKey();
+    void sortKey();
+    void drawKey() const;
+    void record(u8, u16, u32, u32) const;
+
+    static bool startRecord(void*, u32);
+    static u32 stopRecord();
+#endif
 
     u32 getEntryTableSize() { return mEntryTableSize; }
     int getSortMode() { return mSortMode; }
@@ -96,6 +162,21 @@ public:
     /* 0x18 */ f32 mZRatio;
     /* 0x1C */ MtxP mpZMtx;
     /* 0x20 */ J3DPacket* mpCallBackPacket;
+#if ENABLE_DRAW_KEY_SORT
+    /* 0x24 */ J3DDrawKey* mpKey;
+    /* 0x28 */ u32 mKeyMax;
+    /* 0x2C */ u32 mKeyNum;
+    /* 0x30 */ u16* mpKeyHash;
+    /* 0x34 */ u32 mKeyHashMask;
+    /* 0x38 */ bool mKeySorted;
+    /* 0x39 */ bool mKeySpilled;
+    /* 0x3C */ JKRHeap* mpKeyHeap;
+
+    static J3DDrawKey* sKeyWork;
+    static u32 sKeyWorkNum;
+    static J3DDrawRecordHeader* sRecordBuffer;
+    static u32 sRecordCapacity;
+#endif
 
     static sortFunc sortFuncTable[6];
     static drawFunc drawFuncTable[2];
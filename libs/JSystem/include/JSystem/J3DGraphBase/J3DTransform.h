@@ -228,4 +228,21 @@ inline void J3DPSMulMtxVec(__REGISTER Mtx3P mtx, __REGISTER S16Vec* vec, __REGIS
 #endif
 }
 
+
+#if ENABLE_SKIN_SIMD
+/**
+ * Skinning kernels with SSE and NEON paths for hosted builds. Everything else runs the scalar
+ * arithmetic of the code they replace. Clearing j3dSkinSimd selects the scalar path at runtime.
+ */
+extern bool j3dSkinSimd;
+
+void J3DSkinMtxConcatWeight(const Mtx a, const Mtx b, f32 weight, Mtx dst);
+void J3DSkinWeightMulMtxVec(const Mtx mtx, const u16* index, const f32* weight, int num,
+                            const Vec* src, Vec* dst);
+void J3DSkinWeightMulMtxVecSR(const Mtx mtx, const u16* index, const f32* weight, int num,
+                              const Vec* src, Vec* dst);
+void J3DSkinMulMtxVec(const Mtx mtx, const Vec* src, Vec* dst, int num);
+void J3DSkinMulMtxVec(const Mtx33 mtx, const Vec* src, Vec* dst, int num);
+#endif
+
 #endif /* J3DTRANSFORM_H */
@@ -3,6 +3,9 @@
 
 #include "JSystem/J3DGraphBase/J3DSys.h"
 #include <mtx.h>
+#if ENABLE_JOINT_FLATTEN
+#include "JSystem/J3DGraphAnimator/J3DJoint.h"
+#endif
 
 class J3DModelData;
 class J3DMaterialTable;
@@ -346,6 +349,12 @@ struct J3DMtxCalcJ3DSysInitSoftimage {
         J3DSys::mCurrentS = param_0;
         MTXCopy(param_1, J3DSys::mCurrentMtx);
     }
+#if ENABLE_JOINT_FLATTEN
+    static void init(J3DJointCalcContext* pContext, const Vec& param_0, const Mtx& param_1) {
+        *pContext->mCurrentS = param_0;
+        MTXCopy(param_1, pContext->mCurrentMtx);
+    }
+#endif
 };
 
 #endif /* J3DMODELLOADER_H */
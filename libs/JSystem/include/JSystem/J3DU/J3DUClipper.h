@@ -15,6 +15,12 @@ public:
     void calcViewFrustum();
     int clip(f32 const (*)[4], Vec, f32) const;
     int clip(f32 const (*)[4], Vec*, Vec*) const;
+#if ENABLE_CULL_BATCH
+    void clipSphereBatch(u32, f32 const*, f32 const*, f32 const*, f32 const*, f32 const*,
+                         u8*) const;
+    void clipBoxBatch(u32, f32 const*, f32 const*, f32 const*, f32 const* const*, f32 const*,
+                      u8*) const;
+#endif
 
     void setFovy(f32 fovy) { mFovY = fovy; }
     void setAspect(f32 aspect) { mAspect = aspect; }
@@ -15,6 +15,14 @@ struct JASCalc {
     static void bzerofast(void* dest, u32 size);
     static void bzero(void* dest, u32 size);
     static f32 pow2(f32);
+#if ENABLE_PCM_MIX_SIMD
+    static void mixMono(s16* dst, const s16* src, u32 n);
+    static void mixMonoWide(s16* dst, const s16* src, u32 n);
+    static void mixStereo(s16* dst, const s16* srcL, const s16* srcR, u32 n);
+    static void mix(s16* dst, const s16* src, u32 n);
+
+    static bool sPairedMix;
+#endif
 
     template <typename A, typename B>
     static A clamp(B x);
@@ -52,6 +52,9 @@ namespace JASDsp {
         void setFIR8FilterParam(s16*);
         void setDistFilter(s16);
         void setBusConnect(u8, u8);
+#if ENABLE_DSP_RENDERER
+        bool render();
+#endif
 
         /* 0x000 */ u16 mIsActive;
         /* 0x002 */ u16 mIsFinished;
@@ -61,8 +64,8 @@ namespace JASDsp {
         /* 0x00A */ u8 field_0x00A[0x00C - 0x00A];
         /* 0x00C */ s16 mPauseFlag;
         /* 0x00E */ short field_0x00E;
-        /* 0x010 */ u16 field_0x010[1][4]; // array size unknown
-        /* 0x018 */ u8 field_0x018[0x050 - 0x018];
+        /* 0x010 */ u16 field_0x010[6][4]; // per mixer output: bus, target, volume, flags
+        /* 0x040 */ u8 field_0x040[0x050 - 0x040];
         /* 0x050 */ u16 field_0x050;
         /* 0x052 */ u16 field_0x052;
         /* 0x054 */ u16 field_0x054;
@@ -113,6 +116,18 @@ namespace JASDsp {
     void initBuffer();
     int setFXLine(u8, s16*, JASDsp::FxlineConfig_*);
     BOOL changeFXLineParam(u8, u8, uintptr_t);
+#if ENABLE_DSP_RENDERER
+    enum {
+        RENDER_BUS_NUM = 12,
+        RENDER_FRAME_SAMPLES = 0x50,
+    };
+
+    void setRenderSource(const u8* data, u32 size);
+    bool isRenderSourceSet();
+    int renderFrame();
+    const s32* getRenderBus(int bus);
+    void renderOutput(s16* left, s16* right);
+#endif
 
     extern u8 const DSPADPCM_FILTER[64];
     extern u32 const DSPRES_FILTER[320];
@@ -92,6 +92,26 @@ public:
 
     static void registerSeqCallback(u16 (*param_0)(JASTrack*, u16)) { sCallBackFunc = param_0; }
 
+#if ENABLE_SEQ_BENCH
+    /** Counters filled in by runBench. Command counts follow sCmdInfo and sExtCmdInfo. */
+    struct TBenchStat {
+        /* 0x000 */ u32 mTicks;
+        /* 0x004 */ u32 mMicroSec;
+        /* 0x008 */ u32 mNoteOn;
+        /* 0x00C */ u32 mNoteOff;
+        /* 0x010 */ u32 mCmd[96];
+        /* 0x190 */ u32 mExtCmd[255];
+        /* 0x58C */ u32 mDecodeHit;
+        /* 0x590 */ u32 mDecodeMiss;
+    };
+
+    bool parseDecoded(JASTrack*, s32*);
+
+    static s32 runBench(void*, u32, u32, bool, TBenchStat*);
+    static void reportBench(const TBenchStat*);
+    static void invalidateDecodeCache(const void*, u32);
+#endif
+
     static CmdInfo sCmdInfo[96];
     static CmdInfo sExtCmdInfo[255];
     static u16 (*sCallBackFunc)(JASTrack*, u16);
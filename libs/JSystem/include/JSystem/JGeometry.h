@@ -48,6 +48,11 @@ struct TUtil<f32> {
         f32 root = __frsqrte(x);
         root = 0.5f * root * (3.0f - x * (root * root));
         return root;
+        #else
+        if (x <= 0.0f) {
+            return x;
+        }
+        return 1.0f / ::sqrtf(x);
         #endif
     }
 
@@ -60,6 +65,11 @@ struct TUtil<f32> {
         f32 root = __frsqrte(x);
         root = 0.5f * root * (3.0f - x * (root * root));
         return x * root;
+        #else
+        if (x <= 0.0f) {
+            return x;
+        }
+        return ::sqrtf(x);
         #endif
     }
 };
@@ -143,6 +153,10 @@ inline void setTVec3f(const __REGISTER f32* vec_a, __REGISTER f32* vec_b) {
         psq_st a_x, 0(vec_b), 0, 0
         stfs b_x, 8(vec_b)
     };
+#else
+    vec_b[0] = vec_a[0];
+    vec_b[1] = vec_a[1];
+    vec_b[2] = vec_a[2];
 #endif
 }
 
@@ -155,6 +169,8 @@ inline float fsqrt_step(float mag) {
     #ifdef __MWERKS__
     f32 root = __frsqrte(mag);
     return 0.5f * root * (3.0f - mag * (root * root));
+    #else
+    return 1.0f / ::sqrtf(mag);
     #endif
 }
 
@@ -174,6 +190,10 @@ inline void mulInternal(__REGISTER const f32* a, __REGISTER const f32* b, __REGI
         psq_st x_y, 0(dst), 0, 0
     };
     dst[2] = a[2] * b[2];
+#else
+    dst[0] = a[0] * b[0];
+    dst[1] = a[1] * b[1];
+    dst[2] = a[2] * b[2];
 #endif
 }
 
@@ -351,6 +371,10 @@ struct TVec3<f32> : public Vec {
             fneg   z,   z
             stfs   z,   8(rdst)
         };
+#else
+        dst->x = -x;
+        dst->y = -y;
+        dst->z = -z;
 #endif
     }
 
@@ -48,6 +48,13 @@ inline u16 read_big_endian_u16(void* ptr) {
     return ((u16)uptr[0] << 8) | ((u16)uptr[1]);
 }
 
+#if ENABLE_ARCHIVE_INDEX
+// Archives with fewer file entries than this keep the linear lookups.
+#ifndef JKRARCHIVE_INDEX_MIN
+#define JKRARCHIVE_INDEX_MIN 16
+#endif
+#endif
+
 extern u32 sCurrentDirID__10JKRArchive;  // JKRArchive::sCurrentDirID
 
 /**
@@ -148,6 +155,15 @@ public:
     SDIFileEntry* findIdxResource(u32) const;
     SDIFileEntry* findPtrResource(const void*) const;
     SDIFileEntry* findIdResource(u16) const;
+#if ENABLE_ARCHIVE_INDEX
+    void createIndex();
+    void destroyIndex();
+    SDIFileEntry* findNameIndex(CArcName&, u32, u32) const;
+    SDIFileEntry* findPtrIndex(const void*) const;
+    void entryPtrIndex(SDIFileEntry*);
+    void removePtrIndex(SDIFileEntry*);
+    u32 getIndexSlot(u32 key) const { return (key * 0x9E3779B1) >> mIndexShift; }
+#endif
 
 public:
     /* vt[04] */ virtual bool becomeCurrent(const char*);                /* override */
@@ -192,6 +208,13 @@ protected:
     /* 0x58 */ u32 field_0x58;
     /* 0x5C */ JKRCompression mCompression;
     /* 0x60 */ EMountDirection mMountDirection;
+#if ENABLE_ARCHIVE_INDEX
+    // Open addressing tables of file index + 1, 0 for an empty slot.
+    /* 0x64 */ u16* mNameIndex;
+    /* 0x68 */ u16* mPtrIndex;
+    /* 0x6C */ u32 mIndexMask;
+    /* 0x70 */ u32 mIndexShift;
+#endif
 
 public:
     static JKRArchive* check_mount_already(s32, JKRHeap*);
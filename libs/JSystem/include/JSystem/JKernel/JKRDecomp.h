@@ -30,11 +30,28 @@ public:
     /* 0x24 */ JKRAMCommand* mAMCommand;
     /* 0x28 */ OSMessageQueue mMessageQueue;
     /* 0x48 */ OSMessage mMessage;
+#if ENABLE_DECOMP_WORKERS
+    /* 0x4C */ JKRDecompCommand* mNext;
+    /* 0x50 */ int mPriority;
+#endif
 };
 
 #define JKRDECOMP_SYNC_BLOCKING 0
 #define JKRDECOMP_SYNC_NON_BLOCKING 1
 
+#if ENABLE_DECOMP_WORKERS
+#define JKRDECOMP_PRIORITY_FOREGROUND 0
+#define JKRDECOMP_PRIORITY_NORMAL 1
+#define JKRDECOMP_PRIORITY_MAX 2
+
+#ifndef JKRDECOMP_WORKER_NUM
+#define JKRDECOMP_WORKER_NUM 2
+#endif
+
+// Number of finished async commands a worker holds before dispatching their completions.
+#define JKRDECOMP_COMPLETION_BATCH 4
+#endif
+
 /**
  * @ingroup jsystem-jkernel
  * 
@@ -57,16 +74,47 @@ public:
     static void decodeSZP(u8*, u8*, u32, u32);
     static void decodeSZS(u8*, u8*, u32, u32);
     static JKRCompression checkCompressed(u8*);
+#if ENABLE_DECOMP_WORKERS
+    static JKRDecompCommand* orderAsync(u8*, u8*, u32, u32, JKRDecompCommand::AsyncCallback, int);
+    static bool orderSync(u8*, u8*, u32, u32, int);
+#endif
+#if ENABLE_FAST_DECOMP
+    static void decodeSZPFull(u8*, u8*, u32);
+    static void decodeSZSFull(u8*, u8*, u32);
+#endif
 
     static JKRDecomp* sDecompObject;
     static OSMessage sMessageBuffer[8];
     static OSMessageQueue sMessageQueue;
+
+#if ENABLE_DECOMP_WORKERS
+private:
+    static JKRDecompCommand* popCommand();
+    static void complete(JKRDecompCommand*);
+    void pushCompletion(JKRDecompCommand*);
+    void flushCompletions();
+
+    JKRDecompCommand* mCompletionHead;
+    JKRDecompCommand* mCompletionTail;
+    int mCompletionNum;
+
+    static JKRDecomp* sWorkers[JKRDECOMP_WORKER_NUM];
+    static JKRDecompCommand* sCommandHead[JKRDECOMP_PRIORITY_MAX];
+    static JKRDecompCommand* sCommandTail[JKRDECOMP_PRIORITY_MAX];
+#endif
 };
 
 inline void JKRDecompress(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength) {
     JKRDecomp::orderSync(srcBuffer, dstBuffer, srcLength, dstLength);
 }
 
+#if ENABLE_DECOMP_WORKERS
+inline void JKRDecompress(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength,
+                          int priority) {
+    JKRDecomp::orderSync(srcBuffer, dstBuffer, srcLength, dstLength, priority);
+}
+#endif
+
 inline JKRDecomp* JKRCreateDecompManager(s32 priority) {
     return JKRDecomp::create(priority);
 }
@@ -61,6 +61,13 @@ protected:
     void removeUsedBlock(CMemBlock* block);
     void recycleFreeBlock(CMemBlock* block);
     void joinTwoBlocks(CMemBlock* block);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    void resetFreeIndex();
+    void indexFreeBlock(CMemBlock* block);
+    void unindexFreeBlock(CMemBlock* block);
+    CMemBlock* findIndexedFreeBlock(u32 size, int align, u32* pOffset);
+    bool checkFreeIndex();
+#endif
 
 public:
     BOOL isEmpty();
@@ -105,6 +112,14 @@ private:
     /* 0x7C */ CMemBlock* mTailFreeList;
     /* 0x80 */ CMemBlock* mHeadUsedList;
     /* 0x84 */ CMemBlock* mTailUsedList;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    // Segregated-fit index: every free block of at least 8 bytes is also linked
+    // into the bin for floor(log2(size)), with a bit per non-empty bin.
+    enum { FREE_BIN_NUM = 29 };
+
+    /* 0x88 */ u32 mFreeBinMask;
+    /* 0x8C */ CMemBlock* mFreeBins[FREE_BIN_NUM];
+#endif
 
 public:
     static JKRExpHeap* createRoot(int maxHeaps, bool errorFlag);
@@ -17,6 +17,57 @@ extern u8 JKRValue_DEBUGFILL_DELETE;
 extern s32 fillcheck_dispcount;
 extern bool data_8074A8D0_debug;
 
+#if ENABLE_HEAP_TRACE
+/** Number of threads that can hold a heap trace tag at once. */
+#define JKR_HEAP_TRACE_TAG_THREAD_MAX 4
+
+/**
+ * @ingroup jsystem-jkernel
+ * Header at the start of a heap trace buffer, followed by mCount records.
+ * The buffer is stored in native (big-endian) byte order and can be read by
+ * tools/heap_trace.py.
+ */
+struct JKRHeapTraceHeader {
+    /* 0x00 */ u32 mMagic;
+    /* 0x04 */ u32 mVersion;
+    /* 0x08 */ u32 mCount;
+    /* 0x0C */ u32 mDropped;
+};  // Size: 0x10
+
+/**
+ * @ingroup jsystem-jkernel
+ * One traced heap operation.
+ *
+ * TYPE_CREATE:  mAddress = heap start, mSize = heap size, mParam = parent heap,
+ *               mTag = upper half of the heap type (e.g. 'EX' for 'EXPH')
+ * Other types:  mTag = calling thread's tag set with JKRHeap::setTraceTag, or 0
+ * TYPE_ALLOC:   mAddress = returned block (0 on failure), mSize = requested size,
+ *               mParam = alignment
+ * TYPE_FREE:    mAddress = freed block
+ * TYPE_RESIZE:  mAddress = block, mSize = requested size, mParam = result
+ */
+struct JKRHeapTraceRecord {
+    enum EType {
+        TYPE_CREATE,
+        TYPE_DESTROY,
+        TYPE_ALLOC,
+        TYPE_FREE,
+        TYPE_RESIZE,
+        TYPE_FREE_ALL,
+        TYPE_FREE_TAIL,
+    };
+
+    /* 0x00 */ u8 mType;
+    /* 0x01 */ u8 mGroupId;
+    /* 0x02 */ u16 mTag;
+    /* 0x04 */ u32 mFrame;
+    /* 0x08 */ u32 mHeap;
+    /* 0x0C */ u32 mAddress;
+    /* 0x10 */ u32 mSize;
+    /* 0x14 */ s32 mParam;
+};  // Size: 0x18
+#endif
+
 /**
  * @ingroup jsystem-jkernel
  * 
@@ -112,6 +163,15 @@ public:
 
     JKRHeap* getParent() { return mChildTree.getParent()->getObject(); }
 
+#if ENABLE_HEAP_TRACE
+    static bool startTrace(void* buffer, u32 size);
+    static u32 stopTrace();
+    static u16 setTraceTag(u16 tag);
+    static u16 getTraceTag();
+    void trace(u8 type, void* address, u32 size, s32 param);
+    void traceCreate();
+#endif
+
     JSUTree<JKRHeap>& getHeapTree() { return mChildTree; }
     void appendDisposer(JKRDisposer* disposer) { mDisposerList.append(&disposer->mLink); }
     void removeDisposer(JKRDisposer* disposer) { mDisposerList.remove(&disposer->mLink); }
@@ -193,8 +253,34 @@ public:
     static JKRHeap* sCurrentHeap;
 
     static JKRErrorHandler mErrorHandler;
+
+#if ENABLE_HEAP_TRACE
+    static JKRHeapTraceHeader* sTraceBuffer;
+    static u32 sTraceCapacity;
+    static u16 sTraceTag[JKR_HEAP_TRACE_TAG_THREAD_MAX];
+    static OSThread* sTraceTagThread[JKR_HEAP_TRACE_TAG_THREAD_MAX];
+#endif
+};
+
+#if ENABLE_HEAP_TRACE
+/**
+ * @ingroup jsystem-jkernel
+ * Sets the heap trace tag for the enclosing scope.
+ */
+class JKRHeapTraceTag {
+public:
+    JKRHeapTraceTag(u16 tag) { mPrevTag = JKRHeap::setTraceTag(tag); }
+    ~JKRHeapTraceTag() { JKRHeap::setTraceTag(mPrevTag); }
+
+private:
+    u16 mPrevTag;
 };
 
+#define JKR_HEAP_TRACE_TAG(tag) JKRHeapTraceTag heapTraceTag_(tag)
+#else
+#define JKR_HEAP_TRACE_TAG(tag)
+#endif
+
 void* operator new(size_t size);
 void* operator new(size_t size, int alignment);
 void* operator new(size_t size, JKRHeap* heap, int alignment);
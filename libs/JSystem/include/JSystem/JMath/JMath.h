@@ -14,18 +14,24 @@ void JMAVECScaleAdd(__REGISTER const Vec* vec1, __REGISTER const Vec* vec2, __RE
 inline int JMAAbs(int value) {
 #ifdef __MWERKS__
     return __abs(value);
+#else
+    return value < 0 ? -value : value;
 #endif
 }
 
 inline f32 JMAAbs(f32 x) {
 #ifdef __MWERKS__
     return __fabsf(x);
+#else
+    return x < 0.0f ? -x : x;
 #endif
 }
 
 inline f32 JMAFastReciprocal(f32 value) {
 #ifdef __MWERKS__
     return __fres(value);
+#else
+    return 1.0f / value;
 #endif
 }
 
@@ -40,6 +46,8 @@ inline float __frsqrtes(__REGISTER double f) {
 
     // clang-format on
     return out;
+#else
+    return 1.0f / ::sqrtf(f);
 #endif
 }
 
@@ -54,6 +62,12 @@ inline f32 JMAFastSqrt(__REGISTER const f32 input) {
     } else {
         return input;
     }
+#else
+    if (input > 0.0f) {
+        return ::sqrtf(input);
+    } else {
+        return input;
+    }
 #endif
 }
 
@@ -87,6 +101,12 @@ inline f32 JMAHermiteInterpolation(__REGISTER f32 p1, __REGISTER f32 p2, __REGIS
     }
     // clang-format on
     return ff25;
+#else
+    f32 t = (p1 - p2) / (p5 - p2);
+    f32 t2_t = t * t - t;
+    f32 a = (2.0f * t * t2_t - t * t) * (p3 - p6) + p3;
+    f32 b = t * p4 - (p7 * t2_t + (p4 * t2_t + p4));
+    return a - (p1 - p2) * b;
 #endif
 }
 
@@ -115,6 +135,10 @@ inline void gekko_ps_copy3(__REGISTER void* dst, __REGISTER const void* src) {
         psq_st src0, 0(dst), 0, 0
         stfs src1, 8(dst)
     };
+#else
+    for (int i = 0; i < 3; i++) {
+        ((f32*)dst)[i] = ((const f32*)src)[i];
+    }
 #endif
 }
 
@@ -131,6 +155,10 @@ inline void gekko_ps_copy6(__REGISTER void* dst, __REGISTER const void* src) {
         psq_st src1, 8(dst), 0, 0
         psq_st src2, 16(dst), 0, 0
     };
+#else
+    for (int i = 0; i < 6; i++) {
+        ((f32*)dst)[i] = ((const f32*)src)[i];
+    }
 #endif
 }
 
@@ -156,6 +184,10 @@ inline void gekko_ps_copy12(__REGISTER void* dst, __REGISTER const void* src) {
         psq_st src4, 32(dst), 0, 0
         psq_st src5, 40(dst), 0, 0
     };
+#else
+    for (int i = 0; i < 12; i++) {
+        ((f32*)dst)[i] = ((const f32*)src)[i];
+    }
 #endif
 }
 
@@ -187,6 +219,10 @@ inline void gekko_ps_copy16(__REGISTER void* dst, __REGISTER const void* src) {
         psq_st src6, 48(dst), 0, 0
         psq_st src7, 56(dst), 0, 0
     };
+#else
+    for (int i = 0; i < 16; i++) {
+        ((f32*)dst)[i] = ((const f32*)src)[i];
+    }
 #endif
 }
 
@@ -211,6 +247,10 @@ namespace JMathInlineVEC {
             ps_add sumz, az, bz
             psq_st sumz, 8(ab), 1, 0
         }
+    #else
+        ab->x = a->x + b->x;
+        ab->y = a->y + b->y;
+        ab->z = a->z + b->z;
     #endif
     }
 
@@ -231,6 +271,10 @@ namespace JMathInlineVEC {
             ps_sub subz, az, bz
             psq_st subz, 8(ab), 1, 0
         }
+    #else
+        ab->x = a->x - b->x;
+        ab->y = a->y - b->y;
+        ab->z = a->z - b->z;
     #endif
     }
 
@@ -248,6 +292,8 @@ namespace JMathInlineVEC {
             ps_sum0 res, res, x_y, x_y
         }
         return res;
+    #else
+        return v->x * v->x + v->y * v->y + v->z * v->z;
     #endif
     }
 
@@ -268,6 +314,8 @@ namespace JMathInlineVEC {
             ps_sum0 res, otheryz, thisyz, thisyz
         };
         return res;
+    #else
+        return a->x * b->x + a->y * b->y + a->z * b->z;
     #endif
     }
 };
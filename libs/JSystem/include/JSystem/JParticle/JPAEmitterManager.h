@@ -7,6 +7,9 @@
 #include "JSystem/JSupport/JSUList.h"
 #include "JSystem/JGeometry.h"
 #include "JSystem/JUtility/JUTAssert.h"
+#if ENABLE_JPA_PARALLEL_CALC
+#include "JSystem/JKernel/JKRThread.h"
+#endif
 
 class JPAEmitterCallBack;
 class JPAParticleCallBack;
@@ -15,6 +18,37 @@ class JPAResourceManager;
 class JPABaseParticle;
 class JKRHeap;
 struct JPAEmitterWorkData;
+class JPAEmitterManager;
+
+#if ENABLE_JPA_PARALLEL_CALC
+// Number of emitter calc slots, counting the thread that calls JPAEmitterManager::calc.
+#ifndef JPA_CALC_WORKER_NUM
+#define JPA_CALC_WORKER_NUM 2
+#endif
+
+// Shortest run of emitters without callbacks that is spread over the calc slots.
+#ifndef JPA_CALC_RUN_MIN
+#define JPA_CALC_RUN_MIN 4
+#endif
+
+// Calc slot of an emitter that is calculated on the calling thread.
+#define JPA_CALC_SLOT_MAIN 0xFF
+
+/**
+ * @ingroup jsystem-jparticle
+ * Runs one slot of a parallel JPAEmitterManager::calc.
+ */
+class JPAEmitterCalcWorker : public JKRThread {
+public:
+    JPAEmitterCalcWorker(JPAEmitterManager*, JKRHeap*, int, u8);
+    virtual ~JPAEmitterCalcWorker() {}
+    virtual void* run();
+
+    /* 0x7C */ JPAEmitterManager* mpMgr;
+    /* 0x80 */ JPAEmitterWorkData* mpWd;
+    /* 0x84 */ u8 mSlot;
+};
+#endif
 
 /**
  * @ingroup jsystem-jparticle
@@ -33,6 +67,16 @@ public:
     void entryResourceManager(JPAResourceManager*, u8);
     void clearResourceManager(u8);
     void calcYBBCam();
+#if ENABLE_JPA_PARALLEL_CALC
+    void startCalcWorker(JKRHeap*, int);
+    void calcParallel(u8);
+    JSULink<JPABaseEmitter>* calcRun(JSULink<JPABaseEmitter>*);
+    void calcSlot(u8, JPAEmitterWorkData*);
+    u8 getCalcSlot(JPABaseEmitter*) const;
+    JPAEmitterWorkData* getWorkData() const;
+    JPANode<JPABaseParticle>* popParticle(JPABaseEmitter*);
+    void pushParticle(JPABaseEmitter*, JPANode<JPABaseParticle>*);
+#endif
     JPAResourceManager* getResourceManager(u16 idx) const { return pResMgrAry[idx]; }
     JPAResourceManager* getResourceManager(u8 res_mgr_id) const { 
         JUT_ASSERT(147, res_mgr_id < ridMax);
@@ -51,6 +95,19 @@ public:
     /* 0x28 */ u32 ptclNum;
     /* 0x2C */ u8 gidMax;
     /* 0x2D */ u8 ridMax;
+#if ENABLE_JPA_PARALLEL_CALC
+    /* 0x30 */ JPABaseEmitter* mpEmtrAry;
+    /* 0x34 */ u8* mpCalcSlot;
+    /* 0x38 */ u8* mpCalcResult;
+    /* 0x3C */ JPAEmitterCalcWorker* mpCalcWorker[JPA_CALC_WORKER_NUM];
+    /*      */ OSMessageQueue mCalcDoneQueue;
+    /*      */ OSMessage mCalcDoneMsg[JPA_CALC_WORKER_NUM];
+    /*      */ JPAList<JPABaseParticle> mPtclSlice[JPA_CALC_WORKER_NUM];
+    /*      */ JPAList<JPABaseParticle>* mpPtclFreed;
+    /*      */ JSULink<JPABaseEmitter>* mpCalcFirst;
+    /*      */ JSULink<JPABaseEmitter>* mpCalcEnd;
+    /*      */ u8 mCalcWorking;
+#endif
 };
 
 #endif /* JPAEMITTERMANAGER_H */
@@ -9,6 +9,25 @@ struct JPAEmitterWorkData;
 class JPABaseParticle;
 class JPAFieldBlock;
 
+#if ENABLE_JPA_FIELD_BATCH
+#define JPA_FIELD_BATCH_MAX 0x80
+
+/**
+ * A run of live particles gathered from an emitter's particle list, so that
+ * JPAFieldBlock::calcBatch can apply one field to all of them without a
+ * virtual call per particle. JPA_FIELD_BATCH_MAX particles fit in the data
+ * cache, so running the fields one after another over the batch does not
+ * refetch them.
+ */
+struct JPAFieldBatch {
+    void clear() { mNum = 0; }
+    void add(JPABaseParticle* ptcl) { mpPtcl[mNum++] = ptcl; }
+
+    /* 0x000 */ u32 mNum;
+    /* 0x004 */ JPABaseParticle* mpPtcl[JPA_FIELD_BATCH_MAX];
+};
+#endif
+
 class JPAFieldBase {
 public:
     void calcAffect(JPAFieldBlock*, JPABaseParticle*);
@@ -148,6 +167,10 @@ public:
     }
     void prepare(JPAEmitterWorkData* work) { pFld->prepare(work, this); }
     void calc(JPAEmitterWorkData* work, JPABaseParticle* ptcl) { pFld->calc(work, this, ptcl); }
+#if ENABLE_JPA_FIELD_BATCH
+    bool isBatchable() const;
+    void calcBatch(JPAFieldBatch*);
+#endif
 
 private:
     /* 0x00 */ const JPAFieldBlockData* mpData;
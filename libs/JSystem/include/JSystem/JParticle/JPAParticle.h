@@ -25,6 +25,10 @@ public:
     bool calc_p(JPAEmitterWorkData*);
     bool calc_c(JPAEmitterWorkData*);
     bool canCreateChild(JPAEmitterWorkData*);
+#if ENABLE_JPA_FIELD_BATCH
+    bool calcBatchBefore(JPAEmitterWorkData*, bool);
+    bool calcBatchAfter(JPAEmitterWorkData*, bool);
+#endif
     f32 getWidth(JPABaseEmitter const*) const;
     f32 getHeight(JPABaseEmitter const*) const;
     int getAge() const { return mAge; }
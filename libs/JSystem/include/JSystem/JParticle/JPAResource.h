@@ -15,6 +15,9 @@ class JPAExTexShape;
 class JPADynamicsBlock;
 class JPAFieldBlock;
 class JPAKeyBlock;
+#if ENABLE_JPA_FIELD_BATCH
+template <class T> struct JPAList;
+#endif
 
 /**
  * @ingroup jsystem-jparticle
@@ -33,6 +36,10 @@ public:
     void calc_p(JPAEmitterWorkData*, JPABaseParticle*);
     void calc_c(JPAEmitterWorkData*, JPABaseParticle*);
     void calcField(JPAEmitterWorkData*, JPABaseParticle*);
+#if ENABLE_JPA_FIELD_BATCH
+    bool isFieldBatchable(JPABaseEmitter*) const;
+    void calcParticleBatch(JPAEmitterWorkData*, JPAList<JPABaseParticle>*, bool);
+#endif
     void calcKey(JPAEmitterWorkData*);
     void calcWorkData_c(JPAEmitterWorkData*);
     void calcWorkData_d(JPAEmitterWorkData*);
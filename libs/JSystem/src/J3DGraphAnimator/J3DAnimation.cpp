@@ -554,6 +554,8 @@ inline f32 J3DHermiteInterpolation(__REGISTER f32 pp1, __REGISTER s16 const* pp2
     }
     // clang-format on
     return fout;
+#else
+    return JMAHermiteInterpolation(pp1, *pp2, *pp3, *pp4, *pp5, *pp6, *pp7);
 #endif
 }
 
@@ -606,7 +608,81 @@ f32 J3DGetKeyFrameInterpolation(f32 frame, J3DAnmKeyTableBase* pKeyTable, T* pDa
     }
 }
 
+#if ENABLE_KEY_CURSOR
+template<typename T>
+static u32 J3DSearchKeyFrame(f32 frame, T* pData, u32 keyNum, u32 stride) {
+    T* pKey = pData;
+    while (keyNum > 1) {
+        u32 half = keyNum >> 1;
+        u32 offset = half * stride;
+        if (frame >= pKey[offset]) {
+            pKey += offset;
+            keyNum = keyNum - half;
+        } else {
+            keyNum = half;
+        }
+    }
+    return (pKey - pData) / stride;
+}
+
+/**
+ * Same result as the version above. The key found last time for this channel is tried first,
+ * then the one after it, and only seeks and loops fall back to the binary search.
+ */
+template<typename T>
+f32 J3DGetKeyFrameInterpolation(f32 frame, J3DAnmKeyTableBase* pKeyTable, T* pData, u16* pCursor) {
+    if (pCursor == NULL) {
+        return J3DGetKeyFrameInterpolation(frame, pKeyTable, pData);
+    }
+    J3D_ASSERT_NULLPTR(__LINE__, pData != NULL);
+
+    if (frame < pData[0]) {
+        return pData[1];
+    }
+
+    u32 stride = pKeyTable->mType == 0 ? 3 : 4;
+    u32 last = pKeyTable->mMaxFrame - 1;
+    if (pData[last * stride] <= frame) {
+        return pData[last * stride + 1];
+    }
+
+    u32 key = *pCursor;
+    if (key >= last || frame < pData[key * stride]) {
+        key = J3DSearchKeyFrame(frame, pData, pKeyTable->mMaxFrame, stride);
+    } else if (frame >= pData[(key + 1) * stride]) {
+        key++;
+        if (frame >= pData[(key + 1) * stride]) {
+            key = J3DSearchKeyFrame(frame, pData, pKeyTable->mMaxFrame, stride);
+        }
+    }
+    *pCursor = key;
+
+    pData += key * stride;
+    if (stride == 3) {
+        return J3DHermiteInterpolation(frame, &pData[0], &pData[1], &pData[2], &pData[3], &pData[4], &pData[5]);
+    } else {
+        return J3DHermiteInterpolation(frame, &pData[0], &pData[1], &pData[3], &pData[4], &pData[5], &pData[6]);
+    }
+}
+
+static inline u16* J3DKeyCursor(u16* pCursor, u32 no) {
+    return pCursor != NULL ? &pCursor[no] : NULL;
+}
+#endif
+
+#if ENABLE_KEY_CURSOR
 void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo* pTransform) const {
+    calcTransform(frame, jointNo, pTransform, NULL);
+}
+
+/**
+ * pCursor is NULL or the joint's 9 key cursors, kept by the animation's user.
+ */
+void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo* pTransform,
+                                       u16* pCursor) const {
+#else
+void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo* pTransform) const {
+#endif
     J3D_ASSERT_RANGE(829, jointNo >= 0 && jointNo < field_0x1e);
     J3D_ASSERT_NULLPTR(830, pTransform != NULL);
 
@@ -623,8 +699,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mScale.x = mScaleData[entryX->mScaleInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mScale.x = J3DGetKeyFrameInterpolation(frame, &entryX->mScaleInfo,
+                                                &mScaleData[entryX->mScaleInfo.mOffset],
+                                                J3DKeyCursor(pCursor, 0));
+#else
         pTransform->mScale.x = J3DGetKeyFrameInterpolation(frame, &entryX->mScaleInfo,
                                                 &mScaleData[entryX->mScaleInfo.mOffset]);
+#endif
     }
 
     switch (entryY->mScaleInfo.mMaxFrame) {
@@ -635,8 +717,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mScale.y = mScaleData[entryY->mScaleInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mScale.y = J3DGetKeyFrameInterpolation(frame, &entryY->mScaleInfo,
+                                                &mScaleData[entryY->mScaleInfo.mOffset],
+                                                J3DKeyCursor(pCursor, 3));
+#else
         pTransform->mScale.y = J3DGetKeyFrameInterpolation(frame, &entryY->mScaleInfo,
                                                 &mScaleData[entryY->mScaleInfo.mOffset]);
+#endif
     }
 
     switch (entryZ->mScaleInfo.mMaxFrame) {
@@ -647,8 +735,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mScale.z = mScaleData[entryZ->mScaleInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mScale.z = J3DGetKeyFrameInterpolation(frame, &entryZ->mScaleInfo,
+                                                &mScaleData[entryZ->mScaleInfo.mOffset],
+                                                J3DKeyCursor(pCursor, 6));
+#else
         pTransform->mScale.z = J3DGetKeyFrameInterpolation(frame, &entryZ->mScaleInfo,
                                                 &mScaleData[entryZ->mScaleInfo.mOffset]);
+#endif
     }
 
     switch (entryX->mRotationInfo.mMaxFrame) {
@@ -659,8 +753,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mRotation.x = mRotData[entryX->mRotationInfo.mOffset] << mDecShift;
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mRotation.x = (int)J3DGetKeyFrameInterpolation(frame, &entryX->mRotationInfo,
+                                            &mRotData[entryX->mRotationInfo.mOffset],
+                                            J3DKeyCursor(pCursor, 1)) << mDecShift;
+#else
         pTransform->mRotation.x = (int)J3DGetKeyFrameInterpolation(frame, &entryX->mRotationInfo,
                                             &mRotData[entryX->mRotationInfo.mOffset]) << mDecShift;
+#endif
     }
 
     switch (entryY->mRotationInfo.mMaxFrame) {
@@ -671,8 +771,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mRotation.y = mRotData[entryY->mRotationInfo.mOffset] << mDecShift;
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mRotation.y = (int)J3DGetKeyFrameInterpolation(frame, &entryY->mRotationInfo,
+                                            &mRotData[entryY->mRotationInfo.mOffset],
+                                            J3DKeyCursor(pCursor, 4)) << mDecShift;
+#else
         pTransform->mRotation.y = (int)J3DGetKeyFrameInterpolation(frame, &entryY->mRotationInfo,
                                             &mRotData[entryY->mRotationInfo.mOffset]) << mDecShift;
+#endif
     }
 
     switch (entryZ->mRotationInfo.mMaxFrame) {
@@ -683,8 +789,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mRotation.z = mRotData[entryZ->mRotationInfo.mOffset] << mDecShift;
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mRotation.z = (int)J3DGetKeyFrameInterpolation(frame, &entryZ->mRotationInfo,
+                                            &mRotData[entryZ->mRotationInfo.mOffset],
+                                            J3DKeyCursor(pCursor, 7)) << mDecShift;
+#else
         pTransform->mRotation.z = (int)J3DGetKeyFrameInterpolation(frame, &entryZ->mRotationInfo,
                                             &mRotData[entryZ->mRotationInfo.mOffset]) << mDecShift;
+#endif
     }
 
     switch (entryX->mTranslateInfo.mMaxFrame) {
@@ -695,8 +807,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mTranslate.x = mTransData[entryX->mTranslateInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mTranslate.x = J3DGetKeyFrameInterpolation(frame, &entryX->mTranslateInfo,
+                                                    &mTransData[entryX->mTranslateInfo.mOffset],
+                                                    J3DKeyCursor(pCursor, 2));
+#else
         pTransform->mTranslate.x = J3DGetKeyFrameInterpolation(frame, &entryX->mTranslateInfo,
                                                     &mTransData[entryX->mTranslateInfo.mOffset]);
+#endif
     }
 
     switch (entryY->mTranslateInfo.mMaxFrame) {
@@ -707,8 +825,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mTranslate.y = mTransData[entryY->mTranslateInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mTranslate.y = J3DGetKeyFrameInterpolation(frame, &entryY->mTranslateInfo,
+                                                    &mTransData[entryY->mTranslateInfo.mOffset],
+                                                    J3DKeyCursor(pCursor, 5));
+#else
         pTransform->mTranslate.y = J3DGetKeyFrameInterpolation(frame, &entryY->mTranslateInfo,
                                                     &mTransData[entryY->mTranslateInfo.mOffset]);
+#endif
     }
 
     switch (entryZ->mTranslateInfo.mMaxFrame) {
@@ -719,8 +843,14 @@ void J3DAnmTransformKey::calcTransform(f32 frame, u16 jointNo, J3DTransformInfo*
         pTransform->mTranslate.z = mTransData[entryZ->mTranslateInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTransform->mTranslate.z = J3DGetKeyFrameInterpolation(frame, &entryZ->mTranslateInfo,
+                                                    &mTransData[entryZ->mTranslateInfo.mOffset],
+                                                    J3DKeyCursor(pCursor, 8));
+#else
         pTransform->mTranslate.z = J3DGetKeyFrameInterpolation(frame, &entryZ->mTranslateInfo,
                                                     &mTransData[entryZ->mTranslateInfo.mOffset]);
+#endif
     }
 }
 
@@ -737,7 +867,19 @@ J3DAnmTextureSRTKey::J3DAnmTextureSRTKey() {
     mTexMtxCalcType = 0;
 }
 
+#if ENABLE_KEY_CURSOR
 void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInfo* pTexSRTInfo) const {
+    calcTransform(frame, jointNo, pTexSRTInfo, NULL);
+}
+
+/**
+ * pCursor is NULL or the texture matrix's 5 key cursors, kept by its J3DTexMtxAnm.
+ */
+void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInfo* pTexSRTInfo,
+                                        u16* pCursor) const {
+#else
+void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInfo* pTexSRTInfo) const {
+#endif
     J3D_ASSERT_RANGE(992, jointNo >= 0 && jointNo < mTrackNum);
     J3D_ASSERT_NULLPTR(993, pTexSRTInfo != NULL);
 
@@ -754,8 +896,14 @@ void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInf
         pTexSRTInfo->mScaleX = mScaleData[entryX->mScaleInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTexSRTInfo->mScaleX = J3DGetKeyFrameInterpolation(frame, &entryX->mScaleInfo,
+                                                &mScaleData[entryX->mScaleInfo.mOffset],
+                                                J3DKeyCursor(pCursor, 0));
+#else
         pTexSRTInfo->mScaleX = J3DGetKeyFrameInterpolation(frame, &entryX->mScaleInfo,
                                                 &mScaleData[entryX->mScaleInfo.mOffset]);
+#endif
     }
 
     switch (entryY->mScaleInfo.mMaxFrame) {
@@ -766,8 +914,14 @@ void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInf
         pTexSRTInfo->mScaleY = mScaleData[entryY->mScaleInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTexSRTInfo->mScaleY = J3DGetKeyFrameInterpolation(frame, &entryY->mScaleInfo,
+                                                &mScaleData[entryY->mScaleInfo.mOffset],
+                                                J3DKeyCursor(pCursor, 1));
+#else
         pTexSRTInfo->mScaleY = J3DGetKeyFrameInterpolation(frame, &entryY->mScaleInfo,
                                                 &mScaleData[entryY->mScaleInfo.mOffset]);
+#endif
     }
 
     switch (entryRot->mRotationInfo.mMaxFrame) {
@@ -778,8 +932,14 @@ void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInf
         pTexSRTInfo->mRotation = mRotData[entryRot->mRotationInfo.mOffset] << mDecShift;
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTexSRTInfo->mRotation = (int)J3DGetKeyFrameInterpolation(frame, &entryRot->mRotationInfo,
+                                        &mRotData[entryRot->mRotationInfo.mOffset],
+                                        J3DKeyCursor(pCursor, 2)) << mDecShift;
+#else
         pTexSRTInfo->mRotation = (int)J3DGetKeyFrameInterpolation(frame, &entryRot->mRotationInfo,
                                         &mRotData[entryRot->mRotationInfo.mOffset]) << mDecShift;
+#endif
     }
 
     switch (entryX->mTranslateInfo.mMaxFrame) {
@@ -790,8 +950,14 @@ void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInf
         pTexSRTInfo->mTranslationX = mTransData[entryX->mTranslateInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTexSRTInfo->mTranslationX = J3DGetKeyFrameInterpolation(frame, &entryX->mTranslateInfo,
+                                                    &mTransData[entryX->mTranslateInfo.mOffset],
+                                                    J3DKeyCursor(pCursor, 3));
+#else
         pTexSRTInfo->mTranslationX = J3DGetKeyFrameInterpolation(frame, &entryX->mTranslateInfo,
                                                     &mTransData[entryX->mTranslateInfo.mOffset]);
+#endif
     }
 
     switch (entryY->mTranslateInfo.mMaxFrame) {
@@ -802,8 +968,14 @@ void J3DAnmTextureSRTKey::calcTransform(f32 frame, u16 jointNo, J3DTextureSRTInf
         pTexSRTInfo->mTranslationY = mTransData[entryY->mTranslateInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        pTexSRTInfo->mTranslationY = J3DGetKeyFrameInterpolation(frame, &entryY->mTranslateInfo,
+                                                    &mTransData[entryY->mTranslateInfo.mOffset],
+                                                    J3DKeyCursor(pCursor, 4));
+#else
         pTexSRTInfo->mTranslationY = J3DGetKeyFrameInterpolation(frame, &entryY->mTranslateInfo,
                                                     &mTransData[entryY->mTranslateInfo.mOffset]);
+#endif
     }
 }
 
@@ -1054,7 +1226,18 @@ J3DAnmColorKey::J3DAnmColorKey() {
     mAnmTable = NULL;
 }
 
+#if ENABLE_KEY_CURSOR
 void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
+    getColor(index, pColor, NULL);
+}
+
+/**
+ * pCursor is NULL or the material's 4 key cursors, kept by its J3DMatColorAnm.
+ */
+void J3DAnmColorKey::getColor(u16 index, GXColor* pColor, u16* pCursor) const {
+#else
+void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
+#endif
     J3D_ASSERT_RANGE(1614, index >= 0 && index < mUpdateMaterialNum);
     J3D_ASSERT_NULLPTR(1615, pColor != NULL);
     J3DAnmColorKeyTable* entry = &mAnmTable[index];
@@ -1068,8 +1251,14 @@ void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
         pColor->r = mColorR[entry->mRInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRInfo,
+                                          &mColorR[entry->mRInfo.mOffset],
+                                          J3DKeyCursor(pCursor, 0));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRInfo,
                                           &mColorR[entry->mRInfo.mOffset]);
+#endif
         if (col < 0.0f) {
             pColor->r = 0;
         } else if (col > 255.0f) {
@@ -1087,8 +1276,14 @@ void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
         pColor->g = mColorG[entry->mGInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGInfo,
+                                          &mColorG[entry->mGInfo.mOffset],
+                                          J3DKeyCursor(pCursor, 1));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGInfo,
                                           &mColorG[entry->mGInfo.mOffset]);
+#endif
         if (col < 0.0f) {
             pColor->g = 0;
         } else if (col > 255.0f) {
@@ -1106,8 +1301,14 @@ void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
         pColor->b = mColorB[entry->mBInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBInfo,
+                                          &mColorB[entry->mBInfo.mOffset],
+                                          J3DKeyCursor(pCursor, 2));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBInfo,
                                           &mColorB[entry->mBInfo.mOffset]);
+#endif
         if (col < 0.0f) {
             pColor->b = 0;
         } else if (col > 255.0f) {
@@ -1125,8 +1326,14 @@ void J3DAnmColorKey::getColor(u16 index, GXColor* pColor) const {
         pColor->a = mColorA[entry->mAInfo.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mAInfo,
+                                          &mColorA[entry->mAInfo.mOffset],
+                                          J3DKeyCursor(pCursor, 3));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mAInfo,
                                           &mColorA[entry->mAInfo.mOffset]);
+#endif
         if (col < 0.0f) {
             pColor->a = 0;
         } else if (col > 255.0f) {
@@ -1226,7 +1433,18 @@ void J3DAnmTextureSRTKey::searchUpdateMaterialID(J3DModelData* pModelData) {
     searchUpdateMaterialID(&pModelData->getMaterialTable());
 }
 
+#if ENABLE_KEY_CURSOR
 void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
+    getTevColorReg(index, pColor, NULL);
+}
+
+/**
+ * pCursor is NULL or the register's 4 key cursors, kept by its J3DTevColorAnm.
+ */
+void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor, u16* pCursor) const {
+#else
+void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
+#endif
     J3D_ASSERT_RANGE(1887, index >= 0 && index < mCRegUpdateMaterialNum);
     J3D_ASSERT_NULLPTR(1888, pColor != NULL);
     J3DAnmCRegKeyTable* entry = &mAnmCRegKeyTable[index];
@@ -1240,8 +1458,14 @@ void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
         pColor->r = mAnmCRegDataR[entry->mRTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRTable,
+                                          &mAnmCRegDataR[entry->mRTable.mOffset],
+                                          J3DKeyCursor(pCursor, 0));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRTable,
                                           &mAnmCRegDataR[entry->mRTable.mOffset]);
+#endif
         if (col < -0x400) {
             pColor->r = -0x400;
         } else if (col > 0x3FF) {
@@ -1259,8 +1483,14 @@ void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
         pColor->g = mAnmCRegDataG[entry->mGTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGTable,
+                                          &mAnmCRegDataG[entry->mGTable.mOffset],
+                                          J3DKeyCursor(pCursor, 1));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGTable,
                                           &mAnmCRegDataG[entry->mGTable.mOffset]);
+#endif
         if (col < -0x400) {
             pColor->g = -0x400;
         } else if (col > 0x3FF) {
@@ -1278,8 +1508,14 @@ void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
         pColor->b = mAnmCRegDataB[entry->mBTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBTable,
+                                          &mAnmCRegDataB[entry->mBTable.mOffset],
+                                          J3DKeyCursor(pCursor, 2));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBTable,
                                           &mAnmCRegDataB[entry->mBTable.mOffset]);
+#endif
         if (col < -0x400) {
             pColor->b = -0x400;
         } else if (col > 0x3FF) {
@@ -1297,8 +1533,14 @@ void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
         pColor->a = mAnmCRegDataA[entry->mATable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mATable,
+                                          &mAnmCRegDataA[entry->mATable.mOffset],
+                                          J3DKeyCursor(pCursor, 3));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mATable,
                                           &mAnmCRegDataA[entry->mATable.mOffset]);
+#endif
         if (col < -0x400) {
             pColor->a = -0x400;
         } else if (col > 0x3FF) {
@@ -1309,7 +1551,18 @@ void J3DAnmTevRegKey::getTevColorReg(u16 index, GXColorS10* pColor) const {
     }
 }
 
+#if ENABLE_KEY_CURSOR
 void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
+    getTevKonstReg(index, pColor, NULL);
+}
+
+/**
+ * pCursor is NULL or the register's 4 key cursors, kept by its J3DTevKColorAnm.
+ */
+void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor, u16* pCursor) const {
+#else
+void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
+#endif
     J3D_ASSERT_RANGE(1989, index >= 0 && index < mKRegUpdateMaterialNum);
     J3D_ASSERT_NULLPTR(1990, pColor != NULL);
     J3DAnmKRegKeyTable* entry = &mAnmKRegKeyTable[index];
@@ -1323,8 +1576,14 @@ void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
         pColor->r = mAnmKRegDataR[entry->mRTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRTable,
+                                          &mAnmKRegDataR[entry->mRTable.mOffset],
+                                          J3DKeyCursor(pCursor, 0));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mRTable,
                                           &mAnmKRegDataR[entry->mRTable.mOffset]);
+#endif
         if (col < 0) {
             pColor->r = 0;
         } else if (col > 0xFF) {
@@ -1342,8 +1601,14 @@ void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
         pColor->g = mAnmKRegDataG[entry->mGTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGTable,
+                                          &mAnmKRegDataG[entry->mGTable.mOffset],
+                                          J3DKeyCursor(pCursor, 1));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mGTable,
                                           &mAnmKRegDataG[entry->mGTable.mOffset]);
+#endif
         if (col < 0) {
             pColor->g = 0;
         } else if (col > 0xFF) {
@@ -1361,8 +1626,14 @@ void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
         pColor->b = mAnmKRegDataB[entry->mBTable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBTable,
+                                          &mAnmKRegDataB[entry->mBTable.mOffset],
+                                          J3DKeyCursor(pCursor, 2));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mBTable,
                                           &mAnmKRegDataB[entry->mBTable.mOffset]);
+#endif
         if (col < 0) {
             pColor->b = 0;
         } else if (col > 0xFF) {
@@ -1380,8 +1651,14 @@ void J3DAnmTevRegKey::getTevKonstReg(u16 index, GXColor* pColor) const {
         pColor->a = mAnmKRegDataA[entry->mATable.mOffset];
         break;
     default:
+#if ENABLE_KEY_CURSOR
+        col = J3DGetKeyFrameInterpolation(mFrame, &entry->mATable,
+                                          &mAnmKRegDataA[entry->mATable.mOffset],
+                                          J3DKeyCursor(pCursor, 3));
+#else
         col = J3DGetKeyFrameInterpolation(mFrame, &entry->mATable,
                                           &mAnmKRegDataA[entry->mATable.mOffset]);
+#endif
         if (col < 0) {
             pColor->a = 0;
         } else if (col > 0xFF) {
@@ -8,6 +8,209 @@
 #include "JSystem/JMath/JMath.h"
 #include "m_Do/m_Do_mtx.h"
 
+#if ENABLE_JOINT_FLATTEN
+J3DMtxBuffer* J3DMtxCalc::mMtxBuffer;
+
+J3DJoint* J3DMtxCalc::mJoint;
+
+/** Copies the walk's matrix and scales into J3DSys, for code that still works on them there. */
+void J3DJointCalcContext::setJ3DSys() const {
+    if (mCurrentMtx != J3DSys::mCurrentMtx) {
+        MTXCopy(mCurrentMtx, J3DSys::mCurrentMtx);
+        J3DSys::mCurrentS = *mCurrentS;
+        J3DSys::mParentS = *mParentS;
+    }
+}
+
+/** Takes the matrix and scales back from J3DSys once that code has run. */
+void J3DJointCalcContext::getJ3DSys() {
+    if (mCurrentMtx != J3DSys::mCurrentMtx) {
+        MTXCopy(J3DSys::mCurrentMtx, mCurrentMtx);
+        *mCurrentS = J3DSys::mCurrentS;
+        *mParentS = J3DSys::mParentS;
+    }
+}
+
+/** Points pContext at the statics, for the mtx calcs recursiveCalc() and the morfs run. */
+static void J3DSysCalcContext(J3DJointCalcContext* pContext) {
+    pContext->mCurrentMtx = J3DSys::mCurrentMtx;
+    pContext->mCurrentS = &J3DSys::mCurrentS;
+    pContext->mParentS = &J3DSys::mParentS;
+    pContext->mMtxBuffer = J3DMtxCalc::mMtxBuffer;
+    pContext->mJoint = J3DMtxCalc::mJoint;
+}
+
+void J3DMtxCalc::init(J3DJointCalcContext* pContext, Vec const& scale, Mtx const& mtx) {
+    init(scale, mtx);
+    pContext->getJ3DSys();
+}
+
+void J3DMtxCalc::calc(J3DJointCalcContext* pContext) {
+    pContext->setJ3DSys();
+    setJoint(pContext->mJoint);
+    setMtxBuffer(pContext->mMtxBuffer);
+    calc();
+    pContext->getJ3DSys();
+}
+
+void J3DMtxCalcJ3DSysInitBasic::init(Vec const& scale, Mtx const& mtx) {
+    J3DJointCalcContext context;
+    J3DSysCalcContext(&context);
+    init(&context, scale, mtx);
+}
+
+void J3DMtxCalcJ3DSysInitBasic::init(J3DJointCalcContext* pContext, Vec const& scale,
+                                     Mtx const& mtx) {
+    MtxP currentMtx = pContext->mCurrentMtx;
+    Vec& currentS = *pContext->mCurrentS;
+    Vec& parentS = *pContext->mParentS;
+    currentS = scale;
+    Vec init = {1.0f, 1.0f, 1.0f};
+    parentS = init;
+    JMAMTXApplyScale(mtx, currentMtx, scale.x, scale.y, scale.z);
+}
+
+void J3DMtxCalcJ3DSysInitMaya::init(Vec const& scale, Mtx const& mtx) {
+    J3DJointCalcContext context;
+    J3DSysCalcContext(&context);
+    init(&context, scale, mtx);
+}
+
+void J3DMtxCalcJ3DSysInitMaya::init(J3DJointCalcContext* pContext, Vec const& scale,
+                                    Mtx const& mtx) {
+    MtxP currentMtx = pContext->mCurrentMtx;
+    Vec& currentS = *pContext->mCurrentS;
+    Vec& parentS = *pContext->mParentS;
+    Vec init = {1.0f, 1.0f, 1.0f};
+    parentS = init;
+    currentS = scale;
+    JMAMTXApplyScale(mtx, currentMtx, scale.x, scale.y, scale.z);
+}
+
+void J3DMtxCalcCalcTransformBasic::calcTransform(J3DTransformInfo const& transInfo) {
+    J3DJointCalcContext context;
+    J3DSysCalcContext(&context);
+    calcTransform(&context, transInfo);
+}
+
+void J3DMtxCalcCalcTransformBasic::calcTransform(J3DJointCalcContext* pContext,
+                                                 J3DTransformInfo const& transInfo) {
+    MtxP currentMtx = pContext->mCurrentMtx;
+    Vec& currentS = *pContext->mCurrentS;
+    J3DJoint* joint = pContext->mJoint;
+    J3DMtxBuffer* mtxBuf = pContext->mMtxBuffer;
+    u16 jntNo = joint->getJntNo();
+
+    MtxP anmMtx = mtxBuf->getAnmMtx(jntNo);
+
+    currentS.x *= transInfo.mScale.x;
+    currentS.y *= transInfo.mScale.y;
+    currentS.z *= transInfo.mScale.z;
+    J3DGetTranslateRotateMtx(transInfo, anmMtx);
+
+    if (!checkScaleOne(currentS)) {
+        mtxBuf->setScaleFlag(jntNo, 0);
+        JMAMTXApplyScale(anmMtx, anmMtx, transInfo.mScale.x, transInfo.mScale.y,
+                         transInfo.mScale.z);
+    } else {
+        mtxBuf->setScaleFlag(jntNo, 1);
+    }
+
+    MTXConcat(currentMtx, anmMtx, currentMtx);
+    MTXCopy(currentMtx, anmMtx);
+}
+
+void J3DMtxCalcCalcTransformSoftimage::calcTransform(J3DTransformInfo const& transInfo) {
+    J3DJointCalcContext context;
+    J3DSysCalcContext(&context);
+    calcTransform(&context, transInfo);
+}
+
+void J3DMtxCalcCalcTransformSoftimage::calcTransform(J3DJointCalcContext* pContext,
+                                                     J3DTransformInfo const& transInfo) {
+    MtxP currentMtx = pContext->mCurrentMtx;
+    Vec& currentS = *pContext->mCurrentS;
+    J3DJoint* joint = pContext->mJoint;
+    J3DMtxBuffer* mtxBuf = pContext->mMtxBuffer;
+    u16 jntNo = joint->getJntNo();
+
+    MtxP anmMtx = mtxBuf->getAnmMtx(jntNo);
+
+    J3DGetTranslateRotateMtx(transInfo.mRotation.x, transInfo.mRotation.y, transInfo.mRotation.z,
+                             transInfo.mTranslate.x * currentS.x,
+                             transInfo.mTranslate.y * currentS.y,
+                             transInfo.mTranslate.z * currentS.z, anmMtx);
+    MTXConcat(currentMtx, anmMtx, currentMtx);
+
+    currentS.x *= transInfo.mScale.x;
+    currentS.y *= transInfo.mScale.y;
+    currentS.z *= transInfo.mScale.z;
+
+    if (!checkScaleOne(currentS)) {
+        mtxBuf->setScaleFlag(jntNo, 0);
+        JMAMTXApplyScale(currentMtx, anmMtx, currentS.x, currentS.y, currentS.z);
+        anmMtx[0][3] = currentMtx[0][3];
+        anmMtx[1][3] = currentMtx[1][3];
+        anmMtx[2][3] = currentMtx[2][3];
+    } else {
+        mtxBuf->setScaleFlag(jntNo, 1);
+        MTXCopy(currentMtx, anmMtx);
+    }
+}
+
+void J3DMtxCalcCalcTransformMaya::calcTransform(J3DTransformInfo const& transInfo) {
+    J3DJointCalcContext context;
+    J3DSysCalcContext(&context);
+    calcTransform(&context, transInfo);
+}
+
+void J3DMtxCalcCalcTransformMaya::calcTransform(J3DJointCalcContext* pContext,
+                                                J3DTransformInfo const& transInfo) {
+    MtxP currentMtx = pContext->mCurrentMtx;
+    Vec& parentS = *pContext->mParentS;
+    J3DJoint* joint = pContext->mJoint;
+    J3DMtxBuffer* mtxBuf = pContext->mMtxBuffer;
+
+    u16 jntNo = joint->getJntNo();
+
+    MtxP anmMtx = mtxBuf->getAnmMtx(jntNo);
+
+    J3DGetTranslateRotateMtx(transInfo, anmMtx);
+
+    if (transInfo.mScale.x == 1.0f && transInfo.mScale.y == 1.0f && transInfo.mScale.z == 1.0f) {
+        mtxBuf->setScaleFlag(jntNo, 1);
+    } else {
+        mtxBuf->setScaleFlag(jntNo, 0);
+        JMAMTXApplyScale(anmMtx, anmMtx, transInfo.mScale.x, transInfo.mScale.y,
+                         transInfo.mScale.z);
+    }
+
+    u8 scaleCompensate = joint->getScaleCompensate();
+    if (scaleCompensate == 1) {
+        Vec inv;
+        inv.x = JMath::fastReciprocal(parentS.x);
+        inv.y = JMath::fastReciprocal(parentS.y);
+        inv.z = JMath::fastReciprocal(parentS.z);
+
+        anmMtx[0][0] *= inv.x;
+        anmMtx[0][1] *= inv.x;
+        anmMtx[0][2] *= inv.x;
+        anmMtx[1][0] *= inv.y;
+        anmMtx[1][1] *= inv.y;
+        anmMtx[1][2] *= inv.y;
+        anmMtx[2][0] *= inv.z;
+        anmMtx[2][1] *= inv.z;
+        anmMtx[2][2] *= inv.z;
+    }
+
+    MTXConcat(currentMtx, anmMtx, currentMtx);
+    MTXCopy(currentMtx, anmMtx);
+
+    parentS.x = transInfo.mScale.x;
+    parentS.y = transInfo.mScale.y;
+    parentS.z = transInfo.mScale.z;
+}
+#else
 void J3DMtxCalcJ3DSysInitBasic::init(Vec const& scale, Mtx const& mtx) {
     J3DSys::mCurrentS = scale;
     Vec init = {1.0f, 1.0f, 1.0f};
@@ -123,6 +326,7 @@ void J3DMtxCalcCalcTransformMaya::calcTransform(J3DTransformInfo const& transInf
     J3DSys::mParentS.y = transInfo.mScale.y;
     J3DSys::mParentS.z = transInfo.mScale.z;
 }
+#endif
 
 void J3DJoint::appendChild(J3DJoint* pChild) {
     if (mChild == NULL) {
@@ -19,7 +19,13 @@ J3DJointTree::J3DJointTree()
     : mHierarchy(NULL), mFlags(0), mModelDataType(0), mRootNode(NULL), mBasicMtxCalc(NULL),
       mJointNodePointer(NULL), mJointNum(0), mWEvlpMtxNum(0), mWEvlpMixMtxNum(0),
       mWEvlpMixMtxIndex(0), mWEvlpMixWeight(0), mInvJointMtx(NULL), mWEvlpImportantMtxIdx(0),
-      field_0x40(0), mJointName(NULL) {}
+      field_0x40(0), mJointName(NULL) {
+#if ENABLE_JOINT_FLATTEN
+    mCalcJoint = NULL;
+    mCalcDepth = NULL;
+    mCalcNum = 0;
+#endif
+}
 
 void J3DJointTree::makeHierarchy(J3DJoint* pJoint, const J3DModelHierarchy** pHierarchy,
                                  J3DMaterialTable* pMaterialTable, J3DShapeTable* pShapeTable) {
@@ -100,6 +106,12 @@ void J3DJointTree::findImportantMtxIndex() {
 
 void J3DJointTree::calc(J3DMtxBuffer* pMtxBuffer, Vec const& scale, f32 const (&mtx)[3][4]) {
     J3D_ASSERT_NULLPTR(217, pMtxBuffer != NULL);
+#if ENABLE_JOINT_FLATTEN
+    if (mCalcJoint != NULL) {
+        calcOrdered(pMtxBuffer, scale, mtx);
+        return;
+    }
+#endif
     getBasicMtxCalc()->init(scale, mtx);
     getBasicMtxCalc()->setMtxBuffer(pMtxBuffer);
 
@@ -111,6 +123,138 @@ void J3DJointTree::calc(J3DMtxBuffer* pMtxBuffer, Vec const& scale, f32 const (&
     root->recursiveCalc();
 }
 
+#if ENABLE_JOINT_FLATTEN
+/** Deepest hierarchy calcOrdered() handles; deeper trees keep using recursiveCalc(). */
+static const int l_calcLevelMax = 32;
+
+/** State recursiveCalc() keeps in its stack frame, one entry per hierarchy level. */
+struct J3DJointCalcLevel {
+    /* 0x00 */ Mtx mCurrentMtx;
+    /* 0x30 */ Vec mCurrentS;
+    /* 0x3C */ Vec mParentS;
+    /* 0x48 */ J3DMtxCalc* mPrevMtxCalc;
+    /* 0x4C */ J3DJointCallBack mCallBack;
+    /* 0x50 */ J3DJoint* mJoint;
+};  // Size: 0x54
+
+/**
+ * Flattens the child/younger links into a pre-order joint list with the depth of each joint,
+ * the order recursiveCalc() visits them in. Called once after makeHierarchy().
+ */
+void J3DJointTree::makeCalcOrder() {
+    mCalcJoint = NULL;
+    mCalcDepth = NULL;
+    mCalcNum = 0;
+    if (mRootNode == NULL)
+        return;
+
+    J3DJoint** order = new J3DJoint*[mJointNum];
+    u8* depth = new u8[mJointNum];
+    J3DJoint* path[l_calcLevelMax];
+    int num = 0;
+    int level = 0;
+    J3DJoint* joint = mRootNode;
+    while (joint != NULL) {
+        if (num >= mJointNum || level >= l_calcLevelMax) {
+            JUT_WARN(__LINE__, "joint tree too deep to flatten, using recursiveCalc");
+            delete[] order;
+            delete[] depth;
+            return;
+        }
+        order[num] = joint;
+        depth[num] = level;
+        num++;
+
+        if (joint->mChild != NULL) {
+            path[level++] = joint;
+            joint = joint->mChild;
+            continue;
+        }
+        while (joint->mYounger == NULL && level > 0)
+            joint = path[--level];
+        joint = joint->mYounger;
+    }
+
+    mCalcJoint = order;
+    mCalcDepth = depth;
+    mCalcNum = num;
+}
+
+/**
+ * Joint callbacks still work on J3DSys and the current mtx calc, so calcOrdered() hands them
+ * its state through the statics and takes back what they changed.
+ */
+static void J3DJointCalcCallBack(J3DJointCalcContext* pContext, J3DMtxCalc* pMtxCalc,
+                                 J3DJointCallBack callBack, J3DJoint* pJoint, int timing) {
+    pContext->setJ3DSys();
+    J3DJoint::mCurrentMtxCalc = pMtxCalc;
+    (*callBack)(pJoint, timing);
+    pContext->getJ3DSys();
+}
+
+/**
+ * Same as calc() through root->recursiveCalc(), but walks the list built by makeCalcOrder() in
+ * a loop. The current matrix and scales, the mtx calc in effect and the state recursiveCalc()
+ * saves per call all live on this stack frame and reach the mtx calcs through a
+ * J3DJointCalcContext, so trees whose mtx calcs are the library's own can be walked on
+ * several threads at once. Mtx calcs without a context version and joint callbacks still go
+ * through the J3DSys and J3DMtxCalc statics.
+ */
+void J3DJointTree::calcOrdered(J3DMtxBuffer* pMtxBuffer, Vec const& scale,
+                               f32 const (&mtx)[3][4]) {
+    J3DJointCalcLevel level[l_calcLevelMax];
+    Mtx currentMtx;
+    Vec currentS;
+    Vec parentS;
+    J3DJointCalcContext context;
+    context.mCurrentMtx = currentMtx;
+    context.mCurrentS = &currentS;
+    context.mParentS = &parentS;
+    context.mMtxBuffer = pMtxBuffer;
+    context.mJoint = NULL;
+
+    J3DMtxCalc* mtxCalc = getBasicMtxCalc();
+    mtxCalc->init(&context, scale, mtx);
+
+    for (int i = 0; i < mCalcNum; i++) {
+        J3DJoint* joint = mCalcJoint[i];
+        J3DJointCalcLevel* cur = &level[mCalcDepth[i]];
+        MTXCopy(currentMtx, cur->mCurrentMtx);
+        cur->mCurrentS = currentS;
+        cur->mParentS = parentS;
+        cur->mPrevMtxCalc = NULL;
+        cur->mJoint = joint;
+
+        context.mJoint = joint;
+        if (joint->getMtxCalc() != NULL) {
+            cur->mPrevMtxCalc = mtxCalc;
+            mtxCalc = joint->getMtxCalc();
+            mtxCalc->calc(&context);
+        } else if (mtxCalc != NULL) {
+            mtxCalc->calc(&context);
+        }
+
+        cur->mCallBack = joint->getCallBack();
+        if (cur->mCallBack != NULL)
+            J3DJointCalcCallBack(&context, mtxCalc, cur->mCallBack, joint, 0);
+
+        // Unwind every level that has no more joints below it: this one, unless the next joint
+        // is its child, and each parent up to the next joint's younger brother.
+        int next = i + 1 < mCalcNum ? mCalcDepth[i + 1] : 0;
+        for (int d = mCalcDepth[i]; d >= next; d--) {
+            J3DJointCalcLevel* done = &level[d];
+            MTXCopy(done->mCurrentMtx, currentMtx);
+            currentS = done->mCurrentS;
+            parentS = done->mParentS;
+            if (done->mPrevMtxCalc != NULL)
+                mtxCalc = done->mPrevMtxCalc;
+            if (done->mCallBack != NULL)
+                J3DJointCalcCallBack(&context, mtxCalc, done->mCallBack, done->mJoint, 1);
+        }
+    }
+}
+#endif
+
 void J3DMtxCalc::setMtxBuffer(J3DMtxBuffer* mtxBuffer) {
     J3DMtxCalc::mMtxBuffer = mtxBuffer;
 }
@@ -313,7 +313,9 @@ void J3DMtxBuffer::calcWeightEnvelopeMtx() {
             worldMtx = &mpAnmMtx[idx];
             invMtx = &mJointTree->getInvJointMtx((u16)idx);
 
-            #if DEBUG || !__MWERKS__
+            #if ENABLE_SKIN_SIMD && (DEBUG || !__MWERKS__)
+            // J3DSkinMtxConcatWeight concatenates and blends in one step below.
+            #elif DEBUG || !__MWERKS__
             MTXConcat(*worldMtx, *invMtx, mtx);
             #else
             // Fakematch? Doesn't match if worldMtx and invMtx are used directly.
@@ -341,7 +343,9 @@ void J3DMtxBuffer::calcWeightEnvelopeMtx() {
 
             weight = *++weights;
 
-            #if DEBUG || !__MWERKS__
+            #if ENABLE_SKIN_SIMD && (DEBUG || !__MWERKS__)
+            J3DSkinMtxConcatWeight(*worldMtx, *invMtx, weight, weightAnmMtx);
+            #elif DEBUG || !__MWERKS__
             weightAnmMtx[0][0] += mtx[0][0] * weight;
             weightAnmMtx[0][1] += mtx[0][1] * weight;
             weightAnmMtx[0][2] += mtx[0][2] * weight;
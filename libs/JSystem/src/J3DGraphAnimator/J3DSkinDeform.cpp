@@ -47,6 +47,9 @@ static void J3DPSWeightMTXMultVecSR(f32 (*param_0)[4], f32 param_1, Vec* param_2
 }
 
 void J3DSkinNList::calcSkin_VtxPosF32(f32 (*param_0)[4], void* param_1, void* param_2) {
+#if ENABLE_SKIN_SIMD
+    J3DSkinWeightMulMtxVec(param_0, field_0x0, field_0x8, field_0x10, (Vec*)param_1, (Vec*)param_2);
+#else
     int r29 = field_0x10;
     for (int i = 0; i < r29; i++) {
         Vec* pVec1 = (Vec*)param_1 + field_0x0[i];
@@ -54,9 +57,14 @@ void J3DSkinNList::calcSkin_VtxPosF32(f32 (*param_0)[4], void* param_1, void* pa
         f32 weight = field_0x8[i];
         J3DPSWeightMTXMultVec(param_0, weight, pVec1, pVec2);
     }
+#endif
 }
 
 void J3DSkinNList::calcSkin_VtxNrmF32(f32 (*param_0)[4], void* param_1, void* param_2) {
+#if ENABLE_SKIN_SIMD
+    J3DSkinWeightMulMtxVecSR(param_0, field_0x4, field_0xc, field_0x12, (Vec*)param_1,
+                             (Vec*)param_2);
+#else
     int r29 = field_0x12;
     for (int i = 0; i < r29; i++) {
         Vec* pVec1 = (Vec*)param_1 + field_0x4[i];
@@ -64,6 +72,7 @@ void J3DSkinNList::calcSkin_VtxNrmF32(f32 (*param_0)[4], void* param_1, void* pa
         f32 weight = field_0xc[i];
         J3DPSWeightMTXMultVecSR(param_0, weight, pVec1, pVec2);
     }
+#endif
 }
 
 J3DSkinDeform::J3DSkinDeform() {
@@ -555,10 +564,25 @@ void J3DSkinDeform::deformVtxPos_F32(J3DVertexBuffer* pVtxBuffer, J3DMtxBuffer*
     void* currentVtxPos = (void*)pVtxBuffer->getCurrentVtxPos();
     void* transformedVtxPos = (void*)pVtxBuffer->getTransformedVtxPos(0);
 
+#if ENABLE_SKIN_SIMD
+    // Neighbouring vertices mostly share a draw matrix, so hand the kernel whole runs.
+    for (int i = 0; i < vtxNum;) {
+        u16 posIndex = mPosData[i];
+        int end = i + 1;
+        while (end < vtxNum && mPosData[end] == posIndex) {
+            end++;
+        }
+        anmMtx = anmMtxs[jointTree->getDrawMtxFlag(posIndex)];
+        J3DSkinMulMtxVec(anmMtx[jointTree->getDrawMtxIndex(posIndex)], (Vec*)currentVtxPos + i,
+                         (Vec*)transformedVtxPos + i, end - i);
+        i = end;
+    }
+#else
     for (int i = 0; i < vtxNum; i++) {
         anmMtx = anmMtxs[jointTree->getDrawMtxFlag(mPosData[i])];
         J3DPSMulMtxVec(anmMtx[jointTree->getDrawMtxIndex(mPosData[i])], (Vec*)(((f32*)currentVtxPos) + (i * 3)), (Vec*)(((f32*)transformedVtxPos) + (i * 3)));
     }
+#endif
 
     DCStoreRange(pVtxBuffer->getTransformedVtxPos(0), pVtxBuffer->getVertexData()->getVtxNum() * sizeof(Vec));
     pVtxBuffer->setCurrentVtxPos(transformedVtxPos);
@@ -594,9 +618,22 @@ void J3DSkinDeform::deformVtxNrm_F32(J3DVertexBuffer* pVtxBuffer) const {
     void* currentVtxNrm = (void*)pVtxBuffer->getCurrentVtxNrm();
     void* transformedVtxNrm = (void*)pVtxBuffer->getTransformedVtxNrm(0);
 
+#if ENABLE_SKIN_SIMD
+    for (int i = 0; i < nrmNum;) {
+        u16 nrmIndex = mNrmData[i];
+        int end = i + 1;
+        while (end < nrmNum && mNrmData[end] == nrmIndex) {
+            end++;
+        }
+        J3DSkinMulMtxVec(mNrmMtx[nrmIndex], (Vec*)currentVtxNrm + i, (Vec*)transformedVtxNrm + i,
+                         end - i);
+        i = end;
+    }
+#else
     for (int i = 0; i < nrmNum; i++) {
         J3DPSMulMtxVec(mNrmMtx[mNrmData[i]], (Vec*)((u8*)currentVtxNrm + i * 3 * 4), (Vec*)((u8*)transformedVtxNrm + i * 3 * 4));
     }
+#endif
 
     DCStoreRange(pVtxBuffer->getTransformedVtxNrm(0), pVtxBuffer->getVertexData()->getNrmNum() * sizeof(Vec));
     pVtxBuffer->setCurrentVtxNrm(transformedVtxNrm);
@@ -671,6 +708,112 @@ void J3DSkinDeform::deform(J3DVertexBuffer* pVtxBuffer, J3DMtxBuffer* pMtxBuffer
     }
 }
 
+#if ENABLE_SKIN_SIMD
+static f32 J3DSkinMaxError(const f32* a, const f32* b, u32 num, f32 err) {
+    for (u32 i = 0; i < num; i++) {
+        f32 diff = a[i] - b[i];
+        if (diff < 0.0f) {
+            diff = -diff;
+        }
+        if (!(diff <= err)) {
+            err = diff;
+        }
+    }
+    return err;
+}
+
+static u32 J3DSkinVtxPerMs(u32 vtxNum, u32 loopNum, OSTime time) {
+    u32 us = OSTicksToMicroseconds(time);
+    return us != 0 ? (u32)((u64)vtxNum * loopNum * 1000 / us) : 0;
+}
+
+/**
+ * Validates the skinning kernels on a real model. Runs the envelope blend and deform of pModel
+ * loopNum times on the scalar path and then on the kernels, reports the largest difference in
+ * the envelope matrices, positions and normals, and the vertices per millisecond of each path.
+ * Only F32 positions and normals are compared, since the S16 paths have no kernel.
+ */
+void J3DSkinDeform::checkSimd(J3DModel* pModel, u32 loopNum) {
+    J3D_ASSERT_NULLPTR(__LINE__, pModel != NULL);
+
+    J3DVertexBuffer* vtxBuffer = pModel->getVertexBuffer();
+    J3DMtxBuffer* mtxBuffer = pModel->getMtxBuffer();
+    J3DVertexData* vtxData = vtxBuffer->getVertexData();
+    J3DJointTree* jointTree = mtxBuffer->getJointTree();
+    u32 vtxNum = vtxData->getVtxNum();
+    u32 nrmNum = vtxData->getNrmNum();
+    u32 evlpNum = jointTree->getWEvlpMtxNum();
+    bool fast = jointTree->checkFlag(0x100);
+    bool posF32 = fast || vtxData->getVtxPosType() == GX_F32;
+    bool nrmF32 = fast || vtxData->getVtxNrmType() == GX_F32;
+    if (loopNum == 0) {
+        loopNum = 1;
+    }
+
+    void* srcPos = vtxBuffer->getCurrentVtxPos();
+    void* srcNrm = vtxBuffer->getCurrentVtxNrm();
+    // S16 streams hold 6 bytes a vertex; they are not compared, so only F32 ones are copied.
+    Vec* refPos = posF32 ? new Vec[vtxNum] : NULL;
+    Vec* refNrm = nrmF32 ? new Vec[nrmNum] : NULL;
+    Mtx* refEvlp = new Mtx[evlpNum];
+    f32 posErr = 0.0f;
+    f32 nrmErr = 0.0f;
+    f32 evlpErr = 0.0f;
+    OSTime time[2];
+
+    bool simd = j3dSkinSimd;
+    for (int pass = 0; pass < 2; pass++) {
+        j3dSkinSimd = pass != 0;
+        OSTime start = OSGetTime();
+        for (u32 i = 0; i < loopNum; i++) {
+            vtxBuffer->setCurrentVtxPos(srcPos);
+            vtxBuffer->setCurrentVtxNrm(srcNrm);
+            pModel->calcWeightEnvelopeMtx();
+            deform(pModel);
+        }
+        time[pass] = OSGetTime() - start;
+
+        if (pass == 0) {
+            if (posF32) {
+                memcpy(refPos, vtxBuffer->getCurrentVtxPos(), vtxNum * sizeof(Vec));
+            }
+            if (nrmF32) {
+                memcpy(refNrm, vtxBuffer->getCurrentVtxNrm(), nrmNum * sizeof(Vec));
+            }
+            for (u32 i = 0; i < evlpNum; i++) {
+                MTXCopy(mtxBuffer->getWeightAnmMtx(i), refEvlp[i]);
+            }
+        } else {
+            if (posF32) {
+                posErr = J3DSkinMaxError(&refPos[0].x, (f32*)vtxBuffer->getCurrentVtxPos(),
+                                         vtxNum * 3, posErr);
+            }
+            if (nrmF32) {
+                nrmErr = J3DSkinMaxError(&refNrm[0].x, (f32*)vtxBuffer->getCurrentVtxNrm(),
+                                         nrmNum * 3, nrmErr);
+            }
+            for (u32 i = 0; i < evlpNum; i++) {
+                evlpErr = J3DSkinMaxError(refEvlp[i][0], mtxBuffer->getWeightAnmMtx(i)[0], 12,
+                                          evlpErr);
+            }
+        }
+    }
+    j3dSkinSimd = simd;
+
+    OSReport("J3DSkinDeform::checkSimd vtx %d nrm %d evlp %d loop %d%s\n", vtxNum, nrmNum, evlpNum,
+             loopNum, fast ? " (fast)" : "");
+    OSReport("  max error evlp %f pos %f%s nrm %f%s\n", evlpErr, posErr, posF32 ? "" : " (S16)",
+             nrmErr, nrmF32 ? "" : " (S16)");
+    OSReport("  scalar %d us %d vtx/ms, simd %d us %d vtx/ms\n",
+             (u32)OSTicksToMicroseconds(time[0]), J3DSkinVtxPerMs(vtxNum, loopNum, time[0]),
+             (u32)OSTicksToMicroseconds(time[1]), J3DSkinVtxPerMs(vtxNum, loopNum, time[1]));
+
+    delete[] refPos;
+    delete[] refNrm;
+    delete[] refEvlp;
+}
+#endif
+
 void J3DVtxColorCalc::calc(J3DModel* pModel) {
     J3D_ASSERT_NULLPTR(1351, pModel != NULL);
     calc(pModel->getVertexBuffer());
@@ -8,6 +8,10 @@
 #include "JSystem/J3DGraphBase/J3DDrawBuffer.h"
 #include "JSystem/J3DGraphBase/J3DMaterial.h"
 #include "JSystem/JKernel/JKRHeap.h"
+#if ENABLE_DRAW_KEY_SORT
+#include "JSystem/JUtility/JUTAssert.h"
+#include <cstring>
+#endif
 
 void J3DDrawBuffer::calcZRatio() {
     mZRatio = (mZFar - mZNear) / (f32)mEntryTableSize;
@@ -21,6 +25,16 @@ void J3DDrawBuffer::initialize() {
     mpZMtx = NULL;
     mpCallBackPacket = NULL;
     mEntryTableSize = 0x20;
+#if ENABLE_DRAW_KEY_SORT
+    mpKey = NULL;
+    mKeyMax = 0;
+    mKeyNum = 0;
+    mpKeyHash = NULL;
+    mKeyHashMask = 0;
+    mKeySorted = false;
+    mKeySpilled = false;
+    mpKeyHeap = NULL;
+#endif
     calcZRatio();
 }
 
@@ -41,6 +55,12 @@ J3DDrawBuffer::~J3DDrawBuffer() {
 
     delete[] mpBuffer;
     mpBuffer = NULL;
+#if ENABLE_DRAW_KEY_SORT
+    delete[] mpKey;
+    mpKey = NULL;
+    delete[] mpKeyHash;
+    mpKeyHash = NULL;
+#endif
 }
 
 void J3DDrawBuffer::frameInit() {
@@ -49,6 +69,22 @@ void J3DDrawBuffer::frameInit() {
         mpBuffer[i] = NULL;
 
     mpCallBackPacket = NULL;
+
+#if ENABLE_DRAW_KEY_SORT
+    if (mKeySpilled) {
+        mKeySpilled = false;
+        if (mKeyMax * 2 < 0x8000) {
+            allocKeyBuffer(mKeyMax * 2);
+        }
+    }
+
+    record(J3DDrawRecord::TYPE_FRAME, mSortMode, mEntryTableSize, 0);
+    mKeyNum = 0;
+    mKeySorted = false;
+    if (mpKeyHash != NULL) {
+        memset(mpKeyHash, 0xFF, (mKeyHashMask + 1) * sizeof(u16));
+    }
+#endif
 }
 
 int J3DDrawBuffer::entryMatSort(J3DMatPacket* pMatPacket) {
@@ -58,6 +94,12 @@ int J3DDrawBuffer::entryMatSort(J3DMatPacket* pMatPacket) {
     pMatPacket->getShapePacket()->drawClear();
 
     if (pMatPacket->isChanged()) {
+#if ENABLE_DRAW_KEY_SORT
+        record(J3DDrawRecord::TYPE_MAT, 0, 0, pMatPacket->mDiffFlag);
+        if (mpKey != NULL && entryKey(pMatPacket, 0, false) >= 0) {
+            return 1;
+        }
+#endif
         pMatPacket->setNextPacket(mpBuffer[0]);
         mpBuffer[0] = pMatPacket;
         return 1;
@@ -73,6 +115,16 @@ int J3DDrawBuffer::entryMatSort(J3DMatPacket* pMatPacket) {
     } else {
         hash = ((uintptr_t)pTexture->getResTIMG(texNo) + pTexture->getResTIMG(texNo)->imageOffset) >> 5;
     }
+#if ENABLE_DRAW_KEY_SORT
+    record(J3DDrawRecord::TYPE_MAT, 0, hash, pMatPacket->mDiffFlag);
+    if (mpKey != NULL) {
+        u64 key = (u64)(hash & (mEntryTableSize - 1)) << 48 | pMatPacket->mDiffFlag;
+        int ret = entryKey(pMatPacket, key, true);
+        if (ret >= 0) {
+            return ret;
+        }
+    }
+#endif
     u32 slot = hash & (mEntryTableSize - 1);
 
     if (mpBuffer[slot] == NULL) {
@@ -151,6 +203,21 @@ int J3DDrawBuffer::entryZSort(J3DMatPacket* pMatPacket) {
     }
 
     index = (mEntryTableSize - 1) - index;
+#if ENABLE_DRAW_KEY_SORT
+    union {
+        f32 f;
+        u32 u;
+    } depth;
+    depth.f = value;
+    record(J3DDrawRecord::TYPE_Z, index, depth.u, 0);
+    if (mpKey != NULL) {
+        // Flip to an unsigned order, then invert so that farther packets sort first.
+        u32 order = (depth.u & 0x80000000) ? ~depth.u : depth.u | 0x80000000;
+        if (entryKey(pMatPacket, (u64)index << 48 | (u64)~order << 16, false) >= 0) {
+            return 1;
+        }
+    }
+#endif
     pMatPacket->setNextPacket(mpBuffer[index]);
     mpBuffer[index] = pMatPacket;
     return 1;
@@ -199,6 +266,15 @@ int J3DDrawBuffer::entryImm(J3DPacket* pPacket, u16 index) {
     J3D_ASSERT_NULLPTR(394, pPacket != NULL);
     J3D_ASSERT_RANGE(395, index < mEntryTableSize);
 
+#if ENABLE_DRAW_KEY_SORT
+    record(J3DDrawRecord::TYPE_IMM, index, 0, 0);
+    if (mpKey != NULL) {
+        if (entryKey(pPacket, (u64)index << 48, false) >= 0) {
+            return 1;
+        }
+    }
+#endif
+
     pPacket->setNextPacket(mpBuffer[index]);
     mpBuffer[index] = pPacket;
     return 1;
@@ -219,6 +295,12 @@ int J3DDrawBuffer::entryNum;
 void J3DDrawBuffer::draw() const {
     J3D_ASSERT_RANGE(411, mDrawMode < J3DDrawBufDrawMode_MAX);
 
+#if ENABLE_DRAW_KEY_SORT
+    if (mpKey != NULL) {
+        drawKey();
+    }
+#endif
+
     drawFunc func = drawFuncTable[mDrawMode];
     (this->*func)();
 }
@@ -241,3 +323,283 @@ void J3DDrawBuffer::drawTail() const {
         }
     }
 }
+
+#if ENABLE_DRAW_KEY_SORT
+J3DDrawKey* J3DDrawBuffer::sKeyWork;
+
+u32 J3DDrawBuffer::sKeyWorkNum;
+
+J3DDrawRecordHeader* J3DDrawBuffer::sRecordBuffer;
+
+u32 J3DDrawBuffer::sRecordCapacity;
+
+static u32 l_keyCount[8][256];
+
+/**
+ * Switches entryMatSort, entryZSort and entryImm to a flat array of up to num keyed packets,
+ * which is radix sorted once before drawing. The array comes from the current heap, and is
+ * regrown from the same heap by frameInit after a frame that overflowed it. On failure the
+ * previous array, if any, is kept.
+ */
+int J3DDrawBuffer::allocKeyBuffer(u32 num) {
+    J3D_ASSERT_RANGE(__LINE__, num != 0 && num < 0x8000);
+
+    if (mpKeyHeap == NULL) {
+        mpKeyHeap = JKRGetCurrentHeap();
+    }
+
+    u32 hashSize = 1;
+    while (hashSize < num * 2) {
+        hashSize <<= 1;
+    }
+
+    if (sKeyWorkNum < num) {
+        J3DDrawKey* keyWork = new (mpKeyHeap, 0x20) J3DDrawKey[num];
+        if (keyWork == NULL) {
+            return kJ3DError_Alloc;
+        }
+        delete[] sKeyWork;
+        sKeyWork = keyWork;
+        sKeyWorkNum = num;
+    }
+
+    J3DDrawKey* key = new (mpKeyHeap, 0x20) J3DDrawKey[num];
+    u16* keyHash = new (mpKeyHeap, 0x20) u16[hashSize];
+    if (key == NULL || keyHash == NULL) {
+        delete[] key;
+        delete[] keyHash;
+        return kJ3DError_Alloc;
+    }
+
+    delete[] mpKey;
+    delete[] mpKeyHash;
+    mpKey = key;
+    mpKeyHash = keyHash;
+    mKeyMax = num;
+    mKeyHashMask = hashSize - 1;
+    mKeyNum = 0;
+    mKeySorted = false;
+    memset(mpKeyHash, 0xFF, hashSize * sizeof(u16));
+    return kJ3DError_Success;
+}
+
+/**
+ * Appends pPacket with the given key. With merge set, a packet already entered with the same
+ * key and an identical material takes pPacket's shape instead and 0 is returned, matching
+ * entryMatSort. Returns -1 once the key array has spilled this frame; the caller then enters
+ * pPacket in the entry table.
+ */
+int J3DDrawBuffer::entryKey(J3DPacket* pPacket, u64 key, bool merge) {
+    if (mKeySpilled) {
+        return -1;
+    }
+
+    u32 hashIdx = 0;
+    if (merge) {
+        u32 hash = (u32)(key >> 32) * 0x9E3779B1 + (u32)key * 0x85EBCA77;
+        hash ^= hash >> 15;
+        for (hashIdx = hash & mKeyHashMask; mpKeyHash[hashIdx] != 0xFFFF;
+             hashIdx = (hashIdx + 1) & mKeyHashMask)
+        {
+            J3DDrawKey* entry = &mpKey[mpKeyHash[hashIdx]];
+            if (entry->mKey == key) {
+                J3DMatPacket* packet = (J3DMatPacket*)entry->mpPacket;
+                if (packet->isSame((J3DMatPacket*)pPacket)) {
+                    packet->addShapePacket(((J3DMatPacket*)pPacket)->getShapePacket());
+                    return 0;
+                }
+            }
+        }
+    }
+
+    if (mKeyNum >= mKeyMax) {
+        spillKey();
+        return -1;
+    }
+
+    if (merge) {
+        mpKeyHash[hashIdx] = mKeyNum;
+    }
+    mpKey[mKeyNum].mKey = key;
+    mpKey[mKeyNum].mpPacket = pPacket;
+    mKeyNum++;
+    mKeySorted = false;
+    return 1;
+}
+
+/**
+ * Moves the keyed packets to the entry table, which takes every entry for the rest of the
+ * frame. They are entered in request order, so the table holds what it would have held
+ * without the key array, and Z sorted buffers keep their back-to-front order.
+ */
+void J3DDrawBuffer::spillKey() {
+    JUT_WARN(__LINE__, "draw key buffer full (%d), using entry table\n", mKeyMax);
+
+    for (u32 i = 0; i < mKeyNum; i++) {
+        u32 slot = (u32)(mpKey[i].mKey >> 48);
+        J3DPacket* packet = mpKey[i].mpPacket;
+        packet->setNextPacket(mpBuffer[slot]);
+        mpBuffer[slot] = packet;
+    }
+
+    mKeyNum = 0;
+    mKeySpilled = true;
+}
+
+/**
+ * Stable LSD radix sort of the key array, one pass per byte. Only bytes that differ between
+ * keys are counted and sorted, so Mat sort usually takes 2-3 passes and Z sort 4-5.
+ */
+void J3DDrawBuffer::sortKey() {
+    mKeySorted = true;
+
+    u32 num = mKeyNum;
+    if (num < 2) {
+        return;
+    }
+
+    u64 keyAnd = mpKey[0].mKey;
+    u64 keyOr = keyAnd;
+    for (u32 i = 1; i < num; i++) {
+        keyAnd &= mpKey[i].mKey;
+        keyOr |= mpKey[i].mKey;
+    }
+
+    u64 diff = keyAnd ^ keyOr;
+    int digit[8];
+    int digitNum = 0;
+    for (int j = 0; j < 8; j++) {
+        if ((u8)(diff >> (j * 8)) != 0) {
+            digit[digitNum++] = j;
+            memset(l_keyCount[j], 0, sizeof(l_keyCount[j]));
+        }
+    }
+
+    for (u32 i = 0; i < num; i++) {
+        u64 key = mpKey[i].mKey;
+        for (int d = 0; d < digitNum; d++) {
+            l_keyCount[digit[d]][(u8)(key >> (digit[d] * 8))]++;
+        }
+    }
+
+    J3DDrawKey* src = mpKey;
+    J3DDrawKey* dst = sKeyWork;
+    for (int d = 0; d < digitNum; d++) {
+        u32* count = l_keyCount[digit[d]];
+        int shift = digit[d] * 8;
+
+        u32 offset = 0;
+        for (int k = 0; k < 256; k++) {
+            u32 n = count[k];
+            count[k] = offset;
+            offset += n;
+        }
+
+        for (u32 i = 0; i < num; i++) {
+            dst[count[(u8)(src[i].mKey >> shift)]++] = src[i];
+        }
+
+        J3DDrawKey* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != mpKey) {
+        memcpy(mpKey, src, num * sizeof(J3DDrawKey));
+    }
+}
+
+/**
+ * Draws the keyed packets. Head mode draws in key order; tail mode keeps key order within a
+ * slot but draws slots from last to first, as drawTail does for the entry table.
+ */
+void J3DDrawBuffer::drawKey() const {
+    if (!mKeySorted) {
+        const_cast<J3DDrawBuffer*>(this)->sortKey();
+    }
+
+    J3DDrawKey* key = mpKey;
+    if (mDrawMode == J3DDrawBufDrawMode_Head) {
+        for (u32 i = 0; i < mKeyNum; i++) {
+            key[i].mpPacket->draw();
+        }
+        return;
+    }
+
+    int end = mKeyNum;
+    while (end > 0) {
+        u32 slot = (u32)(key[end - 1].mKey >> 48);
+        int start = end - 1;
+        while (start > 0 && (u32)(key[start - 1].mKey >> 48) == slot) {
+            start--;
+        }
+        for (int i = start; i < end; i++) {
+            key[i].mpPacket->draw();
+        }
+        end = start;
+    }
+}
+
+/**
+ * Starts recording draw buffer entries into a caller-owned buffer, for replay with
+ * tools/draw_key_bench.py. Recording stops silently (counting dropped records) once the
+ * buffer is full.
+ */
+bool J3DDrawBuffer::startRecord(void* buffer, u32 size) {
+    if (buffer == NULL || size < sizeof(J3DDrawRecordHeader)) {
+        return false;
+    }
+
+    J3DDrawRecordHeader* header = (J3DDrawRecordHeader*)buffer;
+    header->mMagic = 'DKRC';
+    header->mVersion = 1;
+    header->mCount = 0;
+    header->mDropped = 0;
+
+    BOOL interrupts = OSDisableInterrupts();
+    sRecordCapacity = (size - sizeof(J3DDrawRecordHeader)) / sizeof(J3DDrawRecord);
+    sRecordBuffer = header;
+    OSRestoreInterrupts(interrupts);
+    return true;
+}
+
+/**
+ * Stops recording and returns the number of records written.
+ */
+u32 J3DDrawBuffer::stopRecord() {
+    BOOL interrupts = OSDisableInterrupts();
+    J3DDrawRecordHeader* header = sRecordBuffer;
+    sRecordBuffer = NULL;
+    OSRestoreInterrupts(interrupts);
+
+    return header != NULL ? header->mCount : 0;
+}
+
+void J3DDrawBuffer::record(u8 type, u16 slot, u32 a, u32 b) const {
+    if (sRecordBuffer == NULL) {
+        return;
+    }
+
+    BOOL interrupts = OSDisableInterrupts();
+    J3DDrawRecordHeader* header = sRecordBuffer;
+    if (header == NULL) {
+        OSRestoreInterrupts(interrupts);
+        return;
+    }
+    if (header->mCount >= sRecordCapacity) {
+        header->mDropped++;
+        OSRestoreInterrupts(interrupts);
+        return;
+    }
+
+    J3DDrawRecord* record = (J3DDrawRecord*)(header + 1) + header->mCount;
+    header->mCount++;
+    record->mType = type;
+    record->mPad = 0;
+    record->mSlot = slot;
+    record->mBuffer = (uintptr_t)this;
+    record->mA = a;
+    record->mB = b;
+    OSRestoreInterrupts(interrupts);
+}
+#endif
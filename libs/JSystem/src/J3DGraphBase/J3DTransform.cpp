@@ -549,3 +549,222 @@ f32 const PSMulUnit01[] = {
     0.0f,
     -1.0f,
 };
+
+#if ENABLE_SKIN_SIMD
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define J3D_SKIN_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define J3D_SKIN_NEON 1
+#endif
+
+bool j3dSkinSimd = true;
+
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+// The vector paths use plain multiplies and adds in the order of the scalar code, so without
+// contraction into fused multiply-adds their results match it bit for bit.
+#if J3D_SKIN_SSE
+typedef __m128 J3DSkinVec4;
+
+static inline J3DSkinVec4 J3DSkinSplat(f32 f) { return _mm_set1_ps(f); }
+static inline J3DSkinVec4 J3DSkinLane3(f32 f) { return _mm_set_ps(f, 0.0f, 0.0f, 0.0f); }
+static inline J3DSkinVec4 J3DSkinSet3(f32 x, f32 y, f32 z) { return _mm_set_ps(0.0f, z, y, x); }
+static inline J3DSkinVec4 J3DSkinAdd(J3DSkinVec4 a, J3DSkinVec4 b) { return _mm_add_ps(a, b); }
+static inline J3DSkinVec4 J3DSkinMul(J3DSkinVec4 a, J3DSkinVec4 b) { return _mm_mul_ps(a, b); }
+static inline J3DSkinVec4 J3DSkinLoad4(const f32* p) { return _mm_loadu_ps(p); }
+static inline void J3DSkinStore4(f32* p, J3DSkinVec4 v) { _mm_storeu_ps(p, v); }
+
+static inline J3DSkinVec4 J3DSkinLoad3(const f32* p) {
+    return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)p), _mm_load_ss(p + 2));
+}
+
+static inline void J3DSkinStore3(f32* p, J3DSkinVec4 v) {
+    _mm_storel_pi((__m64*)p, v);
+    _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+#else
+typedef float32x4_t J3DSkinVec4;
+
+static inline J3DSkinVec4 J3DSkinSplat(f32 f) { return vdupq_n_f32(f); }
+static inline J3DSkinVec4 J3DSkinLane3(f32 f) { return vsetq_lane_f32(f, vdupq_n_f32(0.0f), 3); }
+static inline J3DSkinVec4 J3DSkinSet3(f32 x, f32 y, f32 z) {
+    return vcombine_f32(vset_lane_f32(y, vdup_n_f32(x), 1), vset_lane_f32(z, vdup_n_f32(0.0f), 0));
+}
+static inline J3DSkinVec4 J3DSkinAdd(J3DSkinVec4 a, J3DSkinVec4 b) { return vaddq_f32(a, b); }
+static inline J3DSkinVec4 J3DSkinMul(J3DSkinVec4 a, J3DSkinVec4 b) { return vmulq_f32(a, b); }
+static inline J3DSkinVec4 J3DSkinLoad4(const f32* p) { return vld1q_f32(p); }
+static inline void J3DSkinStore4(f32* p, J3DSkinVec4 v) { vst1q_f32(p, v); }
+
+static inline J3DSkinVec4 J3DSkinLoad3(const f32* p) {
+    return vcombine_f32(vld1_f32(p), vset_lane_f32(p[2], vdup_n_f32(0.0f), 0));
+}
+
+static inline void J3DSkinStore3(f32* p, J3DSkinVec4 v) {
+    vst1_f32(p, vget_low_f32(v));
+    vst1q_lane_f32(p + 2, v, 2);
+}
+#endif
+
+/** Columns of a 3x4 matrix, so that m * v is c[0] * x + c[1] * y + c[2] * z + c[3]. */
+static inline void J3DSkinLoadColumn(const f32* m, int stride, J3DSkinVec4* c, int num) {
+    // Built in registers: a 16 byte load of four floats just stored stalls store forwarding.
+    for (int i = 0; i < num; i++) {
+        c[i] = J3DSkinSet3(m[i], m[stride + i], m[stride * 2 + i]);
+    }
+}
+
+static inline J3DSkinVec4 J3DSkinMulColumn(const J3DSkinVec4* c, const f32* v) {
+    J3DSkinVec4 t = J3DSkinMul(c[0], J3DSkinSplat(v[0]));
+    t = J3DSkinAdd(t, J3DSkinMul(c[1], J3DSkinSplat(v[1])));
+    return J3DSkinAdd(t, J3DSkinMul(c[2], J3DSkinSplat(v[2])));
+}
+#endif
+
+/** dst += (a * b) * weight, the blend step of J3DMtxBuffer::calcWeightEnvelopeMtx. */
+void J3DSkinMtxConcatWeight(const Mtx a, const Mtx b, f32 weight, Mtx dst) {
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+    if (j3dSkinSimd) {
+        J3DSkinVec4 b0 = J3DSkinLoad4(b[0]);
+        J3DSkinVec4 b1 = J3DSkinLoad4(b[1]);
+        J3DSkinVec4 b2 = J3DSkinLoad4(b[2]);
+        J3DSkinVec4 w = J3DSkinSplat(weight);
+        for (int i = 0; i < 3; i++) {
+            // Same association as C_MTXConcat: a2 * b2 + (a0 * b0 + a1 * b1) + a3.
+            J3DSkinVec4 t = J3DSkinAdd(J3DSkinMul(J3DSkinSplat(a[i][0]), b0),
+                                       J3DSkinMul(J3DSkinSplat(a[i][1]), b1));
+            t = J3DSkinAdd(J3DSkinMul(J3DSkinSplat(a[i][2]), b2), t);
+            t = J3DSkinAdd(J3DSkinLane3(a[i][3]), t);
+            J3DSkinStore4(dst[i], J3DSkinAdd(J3DSkinLoad4(dst[i]), J3DSkinMul(t, w)));
+        }
+        return;
+    }
+#endif
+    Mtx mtx;
+    MTXConcat(a, b, mtx);
+    for (int i = 0; i < 3; i++) {
+        dst[i][0] += mtx[i][0] * weight;
+        dst[i][1] += mtx[i][1] * weight;
+        dst[i][2] += mtx[i][2] * weight;
+        dst[i][3] += mtx[i][3] * weight;
+    }
+}
+
+/** dst[index[i]] += (mtx * src[index[i]]) * weight[i], one joint of a fast skin list. */
+void J3DSkinWeightMulMtxVec(const Mtx mtx, const u16* index, const f32* weight, int num,
+                            const Vec* src, Vec* dst) {
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+    if (j3dSkinSimd) {
+        J3DSkinVec4 c[4];
+        J3DSkinLoadColumn(mtx[0], 4, c, 4);
+        for (int i = 0; i < num; i++) {
+            const f32* v = &src[index[i]].x;
+            f32* d = &dst[index[i]].x;
+            // Same order as J3DPSWeightMTXMultVec: m3 + m0 * x + m1 * y + m2 * z.
+            J3DSkinVec4 t = J3DSkinAdd(c[3], J3DSkinMul(c[0], J3DSkinSplat(v[0])));
+            t = J3DSkinAdd(t, J3DSkinMul(c[1], J3DSkinSplat(v[1])));
+            t = J3DSkinAdd(t, J3DSkinMul(c[2], J3DSkinSplat(v[2])));
+            J3DSkinStore3(d, J3DSkinAdd(J3DSkinLoad3(d), J3DSkinMul(t, J3DSkinSplat(weight[i]))));
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < num; i++) {
+        const Vec* v = &src[index[i]];
+        Vec* d = &dst[index[i]];
+        f32 x = mtx[0][3] + mtx[0][0] * v->x;
+        f32 y = mtx[1][3] + mtx[1][0] * v->x;
+        f32 z = mtx[2][3] + mtx[2][0] * v->x;
+        x += mtx[0][1] * v->y;
+        y += mtx[1][1] * v->y;
+        z += mtx[2][1] * v->y;
+        x += mtx[0][2] * v->z;
+        y += mtx[1][2] * v->z;
+        z += mtx[2][2] * v->z;
+        d->x += x * weight[i];
+        d->y += y * weight[i];
+        d->z += z * weight[i];
+    }
+}
+
+/** As J3DSkinWeightMulMtxVec without the translation, for normals. */
+void J3DSkinWeightMulMtxVecSR(const Mtx mtx, const u16* index, const f32* weight, int num,
+                              const Vec* src, Vec* dst) {
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+    if (j3dSkinSimd) {
+        J3DSkinVec4 c[3];
+        J3DSkinLoadColumn(mtx[0], 4, c, 3);
+        for (int i = 0; i < num; i++) {
+            f32* d = &dst[index[i]].x;
+            J3DSkinVec4 t = J3DSkinMulColumn(c, &src[index[i]].x);
+            J3DSkinStore3(d, J3DSkinAdd(J3DSkinLoad3(d), J3DSkinMul(t, J3DSkinSplat(weight[i]))));
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < num; i++) {
+        const Vec* v = &src[index[i]];
+        Vec* d = &dst[index[i]];
+        f32 x = mtx[0][0] * v->x;
+        f32 y = mtx[1][0] * v->x;
+        f32 z = mtx[2][0] * v->x;
+        x += mtx[0][1] * v->y;
+        y += mtx[1][1] * v->y;
+        z += mtx[2][1] * v->y;
+        x += mtx[0][2] * v->z;
+        y += mtx[1][2] * v->z;
+        z += mtx[2][2] * v->z;
+        d->x += x * weight[i];
+        d->y += y * weight[i];
+        d->z += z * weight[i];
+    }
+}
+
+/** dst[i] = mtx * src[i] for a run of vertices bound to the same matrix. */
+void J3DSkinMulMtxVec(const Mtx mtx, const Vec* src, Vec* dst, int num) {
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+    if (j3dSkinSimd) {
+        J3DSkinVec4 c[4];
+        J3DSkinLoadColumn(mtx[0], 4, c, 4);
+        for (int i = 0; i < num; i++) {
+            J3DSkinStore3(&dst[i].x, J3DSkinAdd(J3DSkinMulColumn(c, &src[i].x), c[3]));
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < num; i++) {
+#ifdef __MWERKS__
+        J3DPSMulMtxVec((MtxP)mtx, (Vec*)&src[i], &dst[i]);
+#else
+        Vec v = src[i];
+        dst[i].x = mtx[0][0] * v.x + mtx[0][1] * v.y + mtx[0][2] * v.z + mtx[0][3];
+        dst[i].y = mtx[1][0] * v.x + mtx[1][1] * v.y + mtx[1][2] * v.z + mtx[1][3];
+        dst[i].z = mtx[2][0] * v.x + mtx[2][1] * v.y + mtx[2][2] * v.z + mtx[2][3];
+#endif
+    }
+}
+
+/** dst[i] = mtx * src[i] for a run of normals bound to the same normal matrix. */
+void J3DSkinMulMtxVec(const Mtx33 mtx, const Vec* src, Vec* dst, int num) {
+#if J3D_SKIN_SSE || J3D_SKIN_NEON
+    if (j3dSkinSimd) {
+        J3DSkinVec4 c[3];
+        J3DSkinLoadColumn(mtx[0], 3, c, 3);
+        for (int i = 0; i < num; i++) {
+            J3DSkinStore3(&dst[i].x, J3DSkinMulColumn(c, &src[i].x));
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < num; i++) {
+#ifdef __MWERKS__
+        J3DPSMulMtxVec((Mtx3P)mtx, (Vec*)&src[i], &dst[i]);
+#else
+        Vec v = src[i];
+        dst[i].x = mtx[0][0] * v.x + mtx[0][1] * v.y + mtx[0][2] * v.z;
+        dst[i].y = mtx[1][0] * v.x + mtx[1][1] * v.y + mtx[1][2] * v.z;
+        dst[i].z = mtx[2][0] * v.x + mtx[2][1] * v.y + mtx[2][2] * v.z;
+#endif
+    }
+}
+#endif
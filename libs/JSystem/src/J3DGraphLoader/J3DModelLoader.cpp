@@ -109,6 +109,9 @@ J3DModelData* J3DModelLoader::load(void const* i_data, u32 i_flags) {
     }
     J3DModelHierarchy const* hierarchy = mpModelData->getHierarchy();
     mpModelData->makeHierarchy(NULL, &hierarchy);
+#if ENABLE_JOINT_FLATTEN
+    mpModelData->getJointTree().makeCalcOrder();
+#endif
     mpModelData->getShapeTable()->sortVcdVatCmd();
     mpModelData->getJointTree().findImportantMtxIndex();
     setupBBoardInfo();
@@ -214,6 +217,9 @@ J3DModelData* J3DModelLoader::loadBinaryDisplayList(void const* i_data, u32 i_fl
     }
     J3DModelHierarchy const* hierarchy = mpModelData->getHierarchy();
     mpModelData->makeHierarchy(NULL, &hierarchy);
+#if ENABLE_JOINT_FLATTEN
+    mpModelData->getJointTree().makeCalcOrder();
+#endif
     mpModelData->getShapeTable()->sortVcdVatCmd();
     mpModelData->getJointTree().findImportantMtxIndex();
     setupBBoardInfo();
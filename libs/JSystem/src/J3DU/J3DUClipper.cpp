@@ -149,6 +149,89 @@ int J3DUClipper::clip(f32 const (*param_1)[4], Vec* param_2, Vec* param_3) const
     return 0;
 }
 
+#if ENABLE_CULL_BATCH
+/**
+ * Sphere version of clip() over structure-of-arrays input. Centers are
+ * already in view space and each sphere carries its own far distance, so
+ * the whole batch runs without touching the clipper state. o_result[i] is
+ * set to 1 when sphere i is outside the frustum.
+ */
+void J3DUClipper::clipSphereBatch(u32 num, f32 const* x, f32 const* y, f32 const* z,
+                                  f32 const* radius, f32 const* far, u8* o_result) const {
+    f32 n0x = _04.x, n0y = _04.y, n0z = _04.z;
+    f32 n1x = _10.x, n1y = _10.y, n1z = _10.z;
+    f32 n2x = _1C.x, n2y = _1C.y, n2z = _1C.z;
+    f32 n3x = _28.x, n3y = _28.y, n3z = _28.z;
+    f32 near = mNear;
+
+    for (u32 i = 0; i < num; i++) {
+        f32 vx = x[i];
+        f32 vy = y[i];
+        f32 vz = z[i];
+        f32 r = radius[i];
+
+        int out = (-vz < near - r);
+        out |= (-vz > far[i] + r);
+        out |= (vx * n0x + vy * n0y + vz * n0z > r);
+        out |= (vx * n1x + vy * n1y + vz * n1z > r);
+        out |= (vx * n2x + vy * n2y + vz * n2z > r);
+        out |= (vx * n3x + vy * n3y + vz * n3z > r);
+        o_result[i] = out;
+    }
+}
+
+/**
+ * Box version of clip() over structure-of-arrays input. Each box is given
+ * by its view space center and three half extent axes (axis[k * 3 + c] is
+ * component c of axis k). A box is outside when it lies entirely beyond one
+ * plane, which is the same rule clip() applies to the eight corners.
+ */
+void J3DUClipper::clipBoxBatch(u32 num, f32 const* x, f32 const* y, f32 const* z,
+                               f32 const* const* axis, f32 const* far, u8* o_result) const {
+    f32 n0x = _04.x, n0y = _04.y, n0z = _04.z;
+    f32 n1x = _10.x, n1y = _10.y, n1z = _10.z;
+    f32 n2x = _1C.x, n2y = _1C.y, n2z = _1C.z;
+    f32 n3x = _28.x, n3y = _28.y, n3z = _28.z;
+    f32 near = mNear;
+    f32 const* a0x = axis[0];
+    f32 const* a0y = axis[1];
+    f32 const* a0z = axis[2];
+    f32 const* a1x = axis[3];
+    f32 const* a1y = axis[4];
+    f32 const* a1z = axis[5];
+    f32 const* a2x = axis[6];
+    f32 const* a2y = axis[7];
+    f32 const* a2z = axis[8];
+
+    for (u32 i = 0; i < num; i++) {
+        f32 vx = x[i];
+        f32 vy = y[i];
+        f32 vz = z[i];
+        f32 ez = fabsf(a0z[i]) + fabsf(a1z[i]) + fabsf(a2z[i]);
+
+        int out = (-vz + ez < near);
+        out |= (-vz - ez > far[i]);
+        out |= (vx * n0x + vy * n0y + vz * n0z -
+                    (fabsf(a0x[i] * n0x + a0y[i] * n0y + a0z[i] * n0z) +
+                     fabsf(a1x[i] * n0x + a1y[i] * n0y + a1z[i] * n0z) +
+                     fabsf(a2x[i] * n0x + a2y[i] * n0y + a2z[i] * n0z)) > 0.0f);
+        out |= (vx * n1x + vy * n1y + vz * n1z -
+                    (fabsf(a0x[i] * n1x + a0y[i] * n1y + a0z[i] * n1z) +
+                     fabsf(a1x[i] * n1x + a1y[i] * n1y + a1z[i] * n1z) +
+                     fabsf(a2x[i] * n1x + a2y[i] * n1y + a2z[i] * n1z)) > 0.0f);
+        out |= (vx * n2x + vy * n2y + vz * n2z -
+                    (fabsf(a0x[i] * n2x + a0y[i] * n2y + a0z[i] * n2z) +
+                     fabsf(a1x[i] * n2x + a1y[i] * n2y + a1z[i] * n2z) +
+                     fabsf(a2x[i] * n2x + a2y[i] * n2y + a2z[i] * n2z)) > 0.0f);
+        out |= (vx * n3x + vy * n3y + vz * n3z -
+                    (fabsf(a0x[i] * n3x + a0y[i] * n3y + a0z[i] * n3z) +
+                     fabsf(a1x[i] * n3x + a1y[i] * n3y + a1z[i] * n3z) +
+                     fabsf(a2x[i] * n3x + a2y[i] * n3y + a2z[i] * n3z)) > 0.0f);
+        o_result[i] = out;
+    }
+}
+#endif
+
 static char const* const stringBase_8039A984 = " J3DUClipper::mFovy = %f";
 
 static char const* const stringBase_8039A99D = " J3DUClipper::mAspect = %f";
@@ -212,6 +212,24 @@ void JASDriver::readDspBuffer(s16* param_0, u32 param_1) {
 
 u32 sDspUpCount;
 
+#if ENABLE_DSP_RENDERER
+/**
+ * Stands in for the DSP once JASDsp::setRenderSource has given the renderer
+ * wave memory. Renders each subframe into the DAC buffer in software and
+ * updates the channels between subframes, as the DSP interrupts would. The
+ * second half of the buffer is the left channel, as readDspBuffer interleaves
+ * it first.
+ */
+static void renderDspFrame(s16* buffer, u32 frameSamples) {
+    for (u32 i = 0; i < JASDriver::getSubFrames(); i++) {
+        u32 offset = i * JASDsp::RENDER_FRAME_SAMPLES;
+        JASDsp::renderFrame();
+        JASDsp::renderOutput(buffer + frameSamples + offset, buffer + offset);
+        JASDriver::updateDSP();
+    }
+}
+#endif
+
 void JASDriver::finishDSPFrame() {
     static u32 waitcount;
     int r30 = sDspDacWriteBuffer + 1;
@@ -245,6 +263,18 @@ void JASDriver::finishDSPFrame() {
     JASAudioThread::setDSPSyncCount(getSubFrames());
     JASProbe::start(7, "DSP-MAIN");
     u32 r27 = getFrameSamples();
+#if ENABLE_DSP_RENDERER
+    if (JASDsp::isRenderSourceSet()) {
+        renderDspFrame(sDspDacBuffer[sDspDacWriteBuffer], r27);
+        JASProbe::stop(7);
+        // No DSP interrupt follows, so updateDac starts the next frame.
+        sDspStatus = 0;
+        if (sDspDacCallback) {
+            sDspDacCallback(sDspDacBuffer[sDspDacWriteBuffer], r27);
+        }
+        return;
+    }
+#endif
     JASDsp::syncFrame(getSubFrames(), u32(sDspDacBuffer[sDspDacWriteBuffer]), u32(sDspDacBuffer[sDspDacWriteBuffer] + r27));
     sDspStatus = 1;
     updateDSP();
@@ -285,6 +315,9 @@ void JASDriver::mixMonoTrack(s16* buffer, u32 param_1, MixCallback param_2) {
         return;
     }
     JASProbe::stop(5);
+#if ENABLE_PCM_MIX_SIMD
+    JASCalc::mixMono(buffer, r26, param_1);
+#else
     s16* pTrack = buffer;
     s16* r28 = r26;
     for (u32 i = param_1; i != 0; i--) {
@@ -298,6 +331,7 @@ void JASDriver::mixMonoTrack(s16* buffer, u32 param_1, MixCallback param_2) {
         pTrack++;
         r28++;
     }
+#endif
 }
 
 void JASDriver::mixMonoTrackWide(s16* buffer, u32 param_1, MixCallback param_2) {
@@ -307,6 +341,9 @@ void JASDriver::mixMonoTrackWide(s16* buffer, u32 param_1, MixCallback param_2)
         return;
     }
     JASProbe::stop(5);
+#if ENABLE_PCM_MIX_SIMD
+    JASCalc::mixMonoWide(buffer, r26, param_1);
+#else
     s16* pTrack = buffer;
     s16* r28 = r26;
     for (u32 i = param_1; i != 0; i--) {
@@ -320,6 +357,7 @@ void JASDriver::mixMonoTrackWide(s16* buffer, u32 param_1, MixCallback param_2)
         pTrack++;
         r28++;
     }
+#endif
 }
 
 void JASDriver::mixExtraTrack(s16* buffer, u32 param_1, MixCallback param_2) {
@@ -330,6 +368,9 @@ void JASDriver::mixExtraTrack(s16* buffer, u32 param_1, MixCallback param_2) {
     }
     JASProbe::stop(5);
     JASProbe::start(6, "MIXING");
+#if ENABLE_PCM_MIX_SIMD
+    JASCalc::mixStereo(buffer, r27 + getFrameSamples(), r27, param_1);
+#else
     s16* pTrack = buffer;
     s16* r29 = r27;
     s16* r28 = r27 + getFrameSamples();
@@ -343,6 +384,7 @@ void JASDriver::mixExtraTrack(s16* buffer, u32 param_1, MixCallback param_2) {
         r28++;
         r29++;
     }
+#endif
     JASProbe::stop(6);
 }
 
@@ -351,6 +393,9 @@ void JASDriver::mixInterleaveTrack(s16* buffer, u32 param_1, MixCallback param_2
     if (!r31) {
         return;
     }
+#if ENABLE_PCM_MIX_SIMD
+    JASCalc::mix(buffer, r31, param_1 * 2);
+#else
     s16* pTrack = buffer;
     s16* r30 = r31;
     for (u32 i = param_1 * 2; i != 0; i--) {
@@ -359,6 +404,7 @@ void JASDriver::mixInterleaveTrack(s16* buffer, u32 param_1, MixCallback param_2
         pTrack++;
         r30++;
     }
+#endif
 }
 
 u32 JASDriver::getSubFrameCounter() {
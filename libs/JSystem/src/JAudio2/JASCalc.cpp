@@ -4,7 +4,100 @@
 #include <cmath>
 #include <limits>
 
+#if ENABLE_PCM_MIX_SIMD
+#include <os.h>
+
+/**
+ * Mixes with Gekko paired singles. GQR5 (set up by OSInitFastCast) loads s16
+ * samples into pairs exactly and saturates them to s16 on store, so every
+ * kernel matches the clamping scalar loops bit for bit. GQRs are part of the
+ * thread context, so setting them here does not leak into other threads.
+ * Clearing sPairedMix switches back to the scalar loops at runtime.
+ */
+bool JASCalc::sPairedMix = true;
+
+#ifdef __MWERKS__
+static const f32 l_monoGain[2] = {1.0f, 1.0f};
+static const f32 l_wideGain[2] = {1.0f, -1.0f};
+
+/** dst[2i] += srcL[i] * gain[0], dst[2i + 1] += srcR[i] * gain[1], n > 0. */
+static void mixStereoPS(register s16* dst, register const s16* srcL, register const s16* srcR,
+                        register u32 n, register const f32* gain) {
+    register f32 l, r, d, g;
+
+    OSInitFastCast();
+    // clang-format off
+    asm {
+        psq_l       g, 0(gain), 0, 0
+        subi        dst, dst, 4
+        subi        srcL, srcL, 2
+        subi        srcR, srcR, 2
+        mtctr       n
+    _loop:
+        psq_lu      l, 2(srcL), 1, 5
+        psq_lu      r, 2(srcR), 1, 5
+        psq_lu      d, 4(dst), 0, 5
+        ps_merge00  l, l, r
+        ps_madd     d, l, g, d
+        psq_st      d, 0(dst), 0, 5
+        bdnz        _loop
+    }
+    // clang-format on
+}
+
+/** dst[i] += src[i] for n sample pairs, n > 0. */
+static void mixPS(register s16* dst, register const s16* src, register u32 n) {
+    register f32 s, d;
+
+    OSInitFastCast();
+    // clang-format off
+    asm {
+        subi        dst, dst, 4
+        subi        src, src, 4
+        mtctr       n
+    _loop:
+        psq_lu      s, 4(src), 0, 5
+        psq_lu      d, 4(dst), 0, 5
+        ps_add      d, d, s
+        psq_st      d, 0(dst), 0, 5
+        bdnz        _loop
+    }
+    // clang-format on
+}
+
+/** dst[2i] = s1[i], dst[2i + 1] = s2[i], n > 0. */
+static void imixcopyPS(register const s16* s1, register const s16* s2, register s16* dst,
+                       register u32 n) {
+    register f32 a, b;
+
+    OSInitFastCast();
+    // clang-format off
+    asm {
+        subi        s1, s1, 2
+        subi        s2, s2, 2
+        subi        dst, dst, 4
+        mtctr       n
+    _loop:
+        psq_lu      a, 2(s1), 1, 5
+        psq_lu      b, 2(s2), 1, 5
+        ps_merge00  a, a, b
+        psq_stu     a, 4(dst), 0, 5
+        bdnz        _loop
+    }
+    // clang-format on
+}
+#endif
+#endif
+
 void JASCalc::imixcopy(const s16* s1, const s16* s2, s16* dst, u32 n) {
+#if ENABLE_PCM_MIX_SIMD && defined(__MWERKS__)
+    if (sPairedMix) {
+        if (n != 0) {
+            imixcopyPS(s1, s2, dst, n);
+        }
+        return;
+    }
+#endif
     for (n; n != 0; n--) {
         *dst++ = *(s1)++;
         *dst++ = *(s2)++;
@@ -16,6 +109,23 @@ void JASCalc::bcopyfast(const void* src, void* dest, u32 size) {
     JUT_ASSERT(227, (reinterpret_cast<u32>(dest) & 0x03) == 0);
     JUT_ASSERT(228, (size & 0x0f) == 0);
 
+#if ENABLE_PCM_MIX_SIMD && defined(__MWERKS__)
+    // lfd/stfd move eight bytes at a time without touching the bit pattern.
+    if (((reinterpret_cast<u32>(src) | reinterpret_cast<u32>(dest)) & 0x07) == 0) {
+        const f64* dsrc = (const f64*)src;
+        f64* ddest = (f64*)dest;
+        for (size = size / (2 * sizeof(f64)); size != 0; size--) {
+            f64 copy1 = dsrc[0];
+            f64 copy2 = dsrc[1];
+            ddest[0] = copy1;
+            ddest[1] = copy2;
+            dsrc += 2;
+            ddest += 2;
+        }
+        return;
+    }
+#endif
+
     u32 copy1, copy2, copy3, copy4;
     u32* usrc = (u32*)src;
     u32* udest = (u32*)dest;
@@ -80,6 +190,18 @@ void JASCalc::bzerofast(void* dest, u32 size) {
     JUT_ASSERT(336, (reinterpret_cast<u32>(dest) & 0x03) == 0);
     JUT_ASSERT(337, (size & 0x0f) == 0);
 
+#if ENABLE_PCM_MIX_SIMD && defined(__MWERKS__)
+    if ((reinterpret_cast<u32>(dest) & 0x07) == 0) {
+        f64* ddest = (f64*)dest;
+        for (size = size / (2 * sizeof(f64)); size != 0; size--) {
+            ddest[0] = 0.0;
+            ddest[1] = 0.0;
+            ddest += 2;
+        }
+        return;
+    }
+#endif
+
     u32* udest = (u32*)dest;
 
     for (size = size / (4 * sizeof(u32)); size != 0; size--) {
@@ -132,6 +254,76 @@ void JASCalc::bzero(void* dest, u32 size) {
     }
 }
 
+#if ENABLE_PCM_MIX_SIMD
+void JASCalc::mixMono(s16* dst, const s16* src, u32 n) {
+#ifdef __MWERKS__
+    if (sPairedMix) {
+        if (n != 0) {
+            mixStereoPS(dst, src, src, n, l_monoGain);
+        }
+        return;
+    }
+#endif
+    for (; n != 0; n--) {
+        s32 sample = *src++;
+        dst[0] = clamp<s16, s32>(dst[0] + sample);
+        dst[1] = clamp<s16, s32>(dst[1] + sample);
+        dst += 2;
+    }
+}
+
+void JASCalc::mixMonoWide(s16* dst, const s16* src, u32 n) {
+#ifdef __MWERKS__
+    if (sPairedMix) {
+        if (n != 0) {
+            mixStereoPS(dst, src, src, n, l_wideGain);
+        }
+        return;
+    }
+#endif
+    for (; n != 0; n--) {
+        s32 sample = *src++;
+        dst[0] = clamp<s16, s32>(dst[0] + sample);
+        dst[1] = clamp<s16, s32>(dst[1] - sample);
+        dst += 2;
+    }
+}
+
+void JASCalc::mixStereo(s16* dst, const s16* srcL, const s16* srcR, u32 n) {
+#ifdef __MWERKS__
+    if (sPairedMix) {
+        if (n != 0) {
+            mixStereoPS(dst, srcL, srcR, n, l_monoGain);
+        }
+        return;
+    }
+#endif
+    for (; n != 0; n--) {
+        dst[0] = clamp<s16, s32>(dst[0] + *srcL++);
+        dst[1] = clamp<s16, s32>(dst[1] + *srcR++);
+        dst += 2;
+    }
+}
+
+void JASCalc::mix(s16* dst, const s16* src, u32 n) {
+#ifdef __MWERKS__
+    if (sPairedMix) {
+        if (n >= 2) {
+            mixPS(dst, src, n / 2);
+        }
+        if (n & 1) {
+            dst[n - 1] = clamp<s16, s32>(dst[n - 1] + src[n - 1]);
+        }
+        return;
+    }
+#endif
+    for (; n != 0; n--) {
+        *dst = clamp<s16, s32>(*dst + *src++);
+        dst++;
+    }
+}
+#endif
+
 s16 const JASCalc::CUTOFF_TO_IIR_TABLE[128][4] = {
     0x0F5C, 0x0A3D, 0x4665, 0x1E73,
     0x0F5E, 0x0A3D, 0x4664, 0x1E73,
@@ -722,3 +722,227 @@ u16 DSP_CreateMap2(u32 param_0) {
     }
     return r30;
 }
+
+#if ENABLE_DSP_RENDERER
+/**
+ * Software model of the channel microcode, so the audio engine can run and
+ * be load tested without a DSP. Each TChannel keeps its playback state in the
+ * same words the microcode uses: the reset request at 0x008, the resampler
+ * phase at 0x060 and window at 0x078, the ADPCM history at 0x0A8 and the
+ * decoded block at 0x0B0. Wave addresses (0x118) are offsets into the buffer
+ * given to setRenderSource, which stands in for ARAM.
+ *
+ * Only the wave formats setWaveInfo produces are decoded: 4 and 2 bit ADPCM,
+ * PCM8 and PCM16. Oscillator channels, the auto mixer and the per channel
+ * filters render as if bypassed.
+ */
+static const u8* l_renderSource;
+static u32 l_renderSourceSize;
+static s32 l_renderBus[JASDsp::RENDER_BUS_NUM][JASDsp::RENDER_FRAME_SAMPLES];
+
+// Bus addresses in the same order as connect_table in setBusConnect.
+static const u16 l_renderBusAddr[JASDsp::RENDER_BUS_NUM] = {
+    0x0000, 0x0D00, 0x0D60, 0x0DC0, 0x0E20, 0x0E80,
+    0x0EE0, 0x0CA0, 0x0F40, 0x0FA0, 0x0B00, 0x09A0,
+};
+
+static int getRenderBusNo(u16 addr) {
+    for (int i = 1; i < JASDsp::RENDER_BUS_NUM; i++) {
+        if (l_renderBusAddr[i] == addr) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static const u8* getRenderSource(u32 addr, u32 size) {
+    if (l_renderSource == NULL || addr + size > l_renderSourceSize || addr + size < addr) {
+        return NULL;
+    }
+    return l_renderSource + addr;
+}
+
+/** Decodes one 16 sample ADPCM block, continuing from the channel's history. */
+static void decodeRenderBlock(JASDsp::TChannel* ch, u32 block) {
+    s16* dst = (s16*)ch->field_0x0b0;
+    const u8* src = getRenderSource(ch->field_0x118 + block * ch->field_0x100, ch->field_0x100);
+    if (src == NULL) {
+        for (int i = 0; i < 16; i++) {
+            dst[i] = 0;
+        }
+        return;
+    }
+
+    s32 scale = 1 << (src[0] >> 4);
+    const u8* coef = JASDsp::DSPADPCM_FILTER + (src[0] & 0xF) * 4;
+    s32 coef1 = (s16)((coef[0] << 8) | coef[1]);
+    s32 coef2 = (s16)((coef[2] << 8) | coef[3]);
+    s32 hist1 = ch->field_0x0a8[0];
+    s32 hist2 = ch->field_0x0a8[1];
+    for (int i = 0; i < 16; i++) {
+        s32 sample;
+        if (ch->field_0x100 == 9) {
+            s32 nibble = (i & 1) ? (src[1 + (i >> 1)] & 0xF) : (src[1 + (i >> 1)] >> 4);
+            sample = (scale * ((nibble ^ 8) - 8)) << 11;
+        } else {
+            s32 nibble = (src[1 + (i >> 2)] >> (6 - (i & 3) * 2)) & 3;
+            sample = (scale * ((nibble ^ 2) - 2)) << 13;
+        }
+        sample = JASCalc::clamp<s16, s32>((sample + coef1 * hist1 + coef2 * hist2) >> 11);
+        dst[i] = sample;
+        hist2 = hist1;
+        hist1 = sample;
+    }
+    ch->field_0x0a8[0] = hist1;
+    ch->field_0x0a8[1] = hist2;
+}
+
+/** Returns the next source sample and advances the play position. */
+static s32 fetchRenderSample(JASDsp::TChannel* ch) {
+    u32 pos = ch->field_0x070;
+    if (pos >= ch->field_0x114) {
+        if (!ch->field_0x102) {
+            ch->mIsFinished = 1;
+            return 0;
+        }
+        pos = ch->field_0x110;
+        ch->field_0x0a8[0] = ch->field_0x104;
+        ch->field_0x0a8[1] = ch->field_0x106;
+        ch->field_0x074 = -1;
+    }
+    ch->field_0x070 = pos + 1;
+
+    const u8* src;
+    switch (ch->field_0x100) {
+    case 5:
+    case 9:
+        if (ch->field_0x074 != pos >> 4) {
+            ch->field_0x074 = pos >> 4;
+            decodeRenderBlock(ch, pos >> 4);
+        }
+        return (s16)ch->field_0x0b0[pos & 0xF];
+    case 8:
+        src = getRenderSource(ch->field_0x118 + pos, 1);
+        return src != NULL ? (s8)src[0] << 8 : 0;
+    case 0x10:
+        src = getRenderSource(ch->field_0x118 + pos * 2, 2);
+        return src != NULL ? (s16)((src[0] << 8) | src[1]) : 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Renders one frame of this channel into the buses. Returns false if the
+ * channel is idle, paused or finished.
+ */
+bool JASDsp::TChannel::render() {
+    if (!mIsActive || mIsFinished || mPauseFlag) {
+        return false;
+    }
+
+    if (field_0x008) {
+        field_0x008 = 0;
+        field_0x070 = (field_0x100 == 5 || field_0x100 == 9) ? 0 : field_0x068;
+        field_0x074 = -1;
+        field_0x0a8[0] = 0;
+        field_0x0a8[1] = 0;
+        field_0x060 = 0;
+        field_0x078[0] = 0;
+        for (int i = 1; i < 4; i++) {
+            field_0x078[i] = fetchRenderSample(this);
+        }
+    }
+
+    // 4 tap polyphase resampling with the 64 phase table at the start of
+    // DSPRES_FILTER, between window samples 1 and 2. The taps are read out of
+    // the u32 words so the result does not depend on host byte order.
+    s32 wave[RENDER_FRAME_SAMPLES];
+    s32 step = mPitch << 4;
+    s32 phase = (u16)field_0x060;
+    s32 w0 = field_0x078[0];
+    s32 w1 = field_0x078[1];
+    s32 w2 = field_0x078[2];
+    s32 w3 = field_0x078[3];
+    for (int i = 0; i < RENDER_FRAME_SAMPLES; i++) {
+        const u32* tap = DSPRES_FILTER + (phase >> 10) * 2;
+        wave[i] = (w0 * (s16)(tap[0] >> 16) + w1 * (s16)tap[0] + w2 * (s16)(tap[1] >> 16) +
+                   w3 * (s16)tap[1]) >> 15;
+        for (phase += step; phase >= 0x10000; phase -= 0x10000) {
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = fetchRenderSample(this);
+        }
+    }
+    field_0x060 = phase;
+    field_0x078[0] = w0;
+    field_0x078[1] = w1;
+    field_0x078[2] = w2;
+    field_0x078[3] = w3;
+
+    // Each of the six mixer outputs ramps linearly to its target volume
+    // over the frame. A forced stop ramps to silence and finishes.
+    for (int i = 0; i < 6; i++) {
+        u16* mixer = field_0x010[i];
+        int bus = getRenderBusNo(mixer[0]);
+        s32 target = mForcedStop ? 0 : (s16)mixer[1];
+        s32 volume = (s16)mixer[2] << 16;
+        s32 delta = ((target << 16) - volume) / RENDER_FRAME_SAMPLES;
+        mixer[2] = target;
+        if (bus == 0) {
+            continue;
+        }
+
+        s32* dst = l_renderBus[bus];
+        for (int j = 0; j < RENDER_FRAME_SAMPLES; j++) {
+            volume += delta;
+            dst[j] += (wave[j] * (volume >> 16)) >> 15;
+        }
+    }
+
+    if (mForcedStop) {
+        mIsFinished = 1;
+    }
+    return true;
+}
+
+/**
+ * Sets the memory wave addresses point into. Once set, JASDriver renders
+ * frames with renderFrame instead of handing them to the DSP; NULL hands them
+ * back.
+ */
+void JASDsp::setRenderSource(const u8* data, u32 size) {
+    l_renderSource = data;
+    l_renderSourceSize = size;
+}
+
+bool JASDsp::isRenderSourceSet() {
+    return l_renderSource != NULL;
+}
+
+/** Renders every channel into freshly cleared buses. Returns the number of channels rendered. */
+int JASDsp::renderFrame() {
+    JASCalc::bzero(l_renderBus, sizeof(l_renderBus));
+    int num = 0;
+    for (int i = 0; i < 64; i++) {
+        if (CH_BUF[i].render()) {
+            num++;
+        }
+    }
+    return num;
+}
+
+const s32* JASDsp::getRenderBus(int bus) {
+    JUT_ASSERT(__LINE__, 0 <= bus && bus < RENDER_BUS_NUM);
+    return l_renderBus[bus];
+}
+
+/** Writes the main left and right buses to the two halves of a DSP DAC buffer. */
+void JASDsp::renderOutput(s16* left, s16* right) {
+    for (int i = 0; i < RENDER_FRAME_SAMPLES; i++) {
+        left[i] = JASCalc::clamp<s16, s32>(l_renderBus[1][i]);
+        right[i] = JASCalc::clamp<s16, s32>(l_renderBus[2][i]);
+    }
+}
+#endif
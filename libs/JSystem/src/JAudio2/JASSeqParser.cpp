@@ -8,6 +8,43 @@
 #include "JSystem/JSupport/JSupport.h"
 #include "JSystem/JUtility/JUTAssert.h"
 
+#if ENABLE_SEQ_BENCH
+static JASTrack* l_benchTrack;
+
+static JASSeqParser::TBenchStat* l_benchStat;
+
+static bool l_benchDecode;
+
+/** Tracks opened under the runBench root play without allocating channels. */
+static bool isBenchTrack(JASTrack* track) {
+    return l_benchTrack != NULL && track->getRootTrack() == l_benchTrack;
+}
+
+static void countBenchOp(JASSeqCtrl* seqCtrl) {
+    const u8* pc = (const u8*)seqCtrl->getCur();
+    u8 cmd = pc[0];
+    if ((cmd & 0x80) == 0) {
+        l_benchStat->mNoteOn++;
+        return;
+    }
+    switch (cmd & 0xf0) {
+    case 0x80:
+        l_benchStat->mNoteOff++;
+        return;
+    case 0x90:
+        pc += 2;
+        cmd = pc[0];
+        break;
+    }
+    if (cmd == 0xb0) {
+        if (pc[1] < 255) {
+            l_benchStat->mExtCmd[pc[1]]++;
+        }
+    } else if (cmd >= 0xa0) {
+        l_benchStat->mCmd[cmd - 0xa0]++;
+    }
+}
+#endif
 
 JASSeqParser::CmdInfo JASSeqParser::sCmdInfo[96] = {
     NULL, 0x0000, 0x0000,
@@ -903,7 +940,11 @@ s32 JASSeqParser::execNoteOnGate(JASTrack* param_0, u32 param_1, u32 param_2, u3
     if (param_3 == 0) {
         r31 |= 4;
     }
+#if ENABLE_SEQ_BENCH
+    int result = isBenchTrack(param_0) ? 0 : param_0->gateOn(param_1, param_2, param_3, r31);
+#else
     int result = param_0->gateOn(param_1, param_2, param_3, r31);
+#endif
     if (param_3) {
         seqCtrl->wait(param_3);
     } else {
@@ -913,10 +954,20 @@ s32 JASSeqParser::execNoteOnGate(JASTrack* param_0, u32 param_1, u32 param_2, u3
 }
 
 s32 JASSeqParser::execNoteOnMidi(JASTrack* param_0, u32 param_1, u32 param_2, u32 param_3) {
+#if ENABLE_SEQ_BENCH
+    if (isBenchTrack(param_0)) {
+        return 0;
+    }
+#endif
      return param_0->noteOn(param_1, param_2, param_3);
 }
 
 s32 JASSeqParser::execNoteOff(JASTrack* param_0, u32 param_1) {
+#if ENABLE_SEQ_BENCH
+    if (isBenchTrack(param_0)) {
+        return 0;
+    }
+#endif
     return param_0->noteOff(param_1, 0);
 }
 
@@ -1004,6 +1055,15 @@ s32 JASSeqParser::parseRegCommand(JASTrack* param_0, int param_1) {
 }
 
 s32 JASSeqParser::parse(JASTrack* param_0) {
+#if ENABLE_SEQ_BENCH
+    if (isBenchTrack(param_0)) {
+        countBenchOp(param_0->getSeqCtrl());
+        s32 result;
+        if (l_benchDecode && parseDecoded(param_0, &result)) {
+            return result;
+        }
+    }
+#endif
     u32 r31 = param_0->getSeqCtrl()->readByte();
     s32 r30 = 0;
     if ((r31 & 0x80) == 0) {
@@ -1023,3 +1083,251 @@ s32 JASSeqParser::parse(JASTrack* param_0) {
     }
     return r30;
 }
+
+#if ENABLE_SEQ_BENCH
+enum {
+    DECODE_CACHE_NUM = 0x100,
+};
+
+enum DecodeKind {
+    DECODE_NOTE_ON,
+    DECODE_NOTE_GATE,
+    DECODE_NOTE_OFF,
+    DECODE_COMMAND,
+};
+
+/**
+ * One instruction with its arguments already read. Entries are only keyed by address, so the
+ * sequence data managers drop them through invalidateDecodeCache before data is reloaded.
+ */
+struct TDecodedOp {
+    const u8* mPc;
+    s32 (JASSeqParser::*mCommand)(JASTrack*, u32*);
+    u32 mArgs[8];
+    u8 mKind;
+    u8 mArgNum;
+    u8 mRegMask;
+    u8 mLength;
+};
+
+static TDecodedOp l_decodeCache[DECODE_CACHE_NUM];
+
+static bool decodeOp(JASSeqCtrl* seqCtrl, TDecodedOp* op) {
+    const u8* pc = (const u8*)seqCtrl->getCur();
+    u32 cmd = seqCtrl->readByte();
+    op->mArgNum = 0;
+    op->mRegMask = 0;
+    if ((cmd & 0x80) == 0) {
+        u32 flags = seqCtrl->readByte();
+        u32 velocity = seqCtrl->readByte();
+        if ((flags & 7) == 0) {
+            op->mKind = DECODE_NOTE_GATE;
+            op->mArgs[0] = cmd;
+            op->mArgs[1] = (u8)velocity;
+            op->mArgs[2] = seqCtrl->readMidiValue();
+            op->mArgs[3] = (u8)flags;
+        } else {
+            op->mKind = DECODE_NOTE_ON;
+            op->mArgs[0] = flags & 7;
+            op->mArgs[1] = cmd;
+            op->mArgs[2] = (u8)velocity;
+        }
+    } else if ((cmd & 0xf0) == 0x80) {
+        op->mKind = DECODE_NOTE_OFF;
+        op->mArgs[0] = cmd & 7;
+    } else {
+        u16 types = 0;
+        if ((cmd & 0xf0) == 0x90) {
+            int num = (cmd & 7) + 1;
+            u8 mask = seqCtrl->readByte();
+            u16 bits = 3;
+            for (int i = 0; i < num; i++) {
+                if (mask & 0x80) {
+                    types |= bits;
+                }
+                mask <<= 1;
+                bits <<= 2;
+            }
+            cmd = seqCtrl->readByte();
+        }
+        if (cmd < 0xa0) {
+            return false;
+        }
+
+        JASSeqParser::CmdInfo* cmdInfo;
+        if (cmd != 0xb0) {
+            cmdInfo = &JASSeqParser::sCmdInfo[cmd - 0xa0];
+        } else {
+            u32 ext = seqCtrl->readByte();
+            if (ext >= 255) {
+                return false;
+            }
+            cmdInfo = &JASSeqParser::sExtCmdInfo[ext];
+        }
+        types |= cmdInfo->field_0xe;
+        for (int i = 0; i < cmdInfo->field_0xc; i++, types >>= 2) {
+            u32 arg = 0;
+            switch (types & 3) {
+            case 0:
+                arg = (u8)seqCtrl->readByte();
+                break;
+            case 1:
+                arg = (u16)seqCtrl->read16();
+                break;
+            case 2:
+                arg = seqCtrl->read24();
+                break;
+            case 3:
+                arg = (u8)seqCtrl->readByte();
+                op->mRegMask |= 1 << i;
+                break;
+            }
+            op->mArgs[i] = arg;
+        }
+        op->mKind = DECODE_COMMAND;
+        op->mArgNum = cmdInfo->field_0xc;
+        op->mCommand = cmdInfo->field_0x0;
+        if (op->mCommand == &JASSeqParser::cmdWait) {
+            // Fold the variable length wait into its fixed argument form.
+            op->mArgs[0] = seqCtrl->readMidiValue();
+            op->mArgNum = 1;
+            op->mCommand = &JASSeqParser::cmdWaitByte;
+        }
+    }
+
+    op->mPc = pc;
+    op->mLength = (const u8*)seqCtrl->getCur() - pc;
+    return true;
+}
+
+/**
+ * Runs the instruction at the cursor from the decode cache. Returns false, with the cursor
+ * untouched, for instructions the cache cannot hold so that parse handles them.
+ */
+bool JASSeqParser::parseDecoded(JASTrack* param_0, s32* result) {
+    JASSeqCtrl* seqCtrl = param_0->getSeqCtrl();
+    const u8* pc = (const u8*)seqCtrl->getCur();
+    // JASSeqCtrl::jump takes an offset from the start of the sequence data.
+    u32 offset = pc - (const u8*)seqCtrl->getBase();
+    uintptr_t addr = (uintptr_t)pc;
+    TDecodedOp* op = &l_decodeCache[(addr ^ (addr >> 8)) & (DECODE_CACHE_NUM - 1)];
+    if (op->mPc == pc) {
+        l_benchStat->mDecodeHit++;
+        seqCtrl->jump(offset + op->mLength);
+    } else {
+        l_benchStat->mDecodeMiss++;
+        if (!decodeOp(seqCtrl, op)) {
+            op->mPc = NULL;
+            seqCtrl->jump(offset);
+            return false;
+        }
+    }
+
+    *result = 0;
+    switch (op->mKind) {
+    case DECODE_NOTE_ON:
+        execNoteOnMidi(param_0, op->mArgs[0], op->mArgs[1], op->mArgs[2]);
+        break;
+    case DECODE_NOTE_GATE:
+        execNoteOnGate(param_0, op->mArgs[0], op->mArgs[1], op->mArgs[2], op->mArgs[3]);
+        break;
+    case DECODE_NOTE_OFF:
+        if (op->mArgs[0]) {
+            execNoteOff(param_0, op->mArgs[0]);
+        } else {
+            JUT_WARN(__LINE__, "%s", "noteoff for note_id == 0");
+        }
+        break;
+    case DECODE_COMMAND:
+        if (op->mCommand) {
+            u32 args[8];
+            for (int i = 0; i < op->mArgNum; i++) {
+                args[i] = (op->mRegMask & (1 << i)) ? readReg(param_0, op->mArgs[i]) : op->mArgs[i];
+            }
+            *result = execCommand(param_0, op->mCommand, op->mArgNum, args);
+        }
+        break;
+    }
+    return true;
+}
+
+/** Drops the decoded instructions that start in the given sequence data. */
+void JASSeqParser::invalidateDecodeCache(const void* addr, u32 size) {
+    for (int i = 0; i < DECODE_CACHE_NUM; i++) {
+        const u8* pc = l_decodeCache[i].mPc;
+        if (pc >= (const u8*)addr && pc < (const u8*)addr + size) {
+            l_decodeCache[i].mPc = NULL;
+        }
+    }
+}
+
+/**
+ * Plays a sequence on a private root track for up to the given number of ticks, without
+ * allocating channels and without the DSP sub-frame callback. Child tracks are ticked through
+ * the root as usual. With decode set, instructions run from the decode cache instead of
+ * being read again on every visit, so two runs of the same sequence compare both interpreters.
+ * The cache outlives the run; sequence data rewritten in place must be invalidated first.
+ */
+s32 JASSeqParser::runBench(void* seq, u32 offset, u32 ticks, bool decode, TBenchStat* stat) {
+    JUT_ASSERT(__LINE__, l_benchTrack == NULL);
+    JASTrack* track = new JASTrack();
+    if (track == NULL) {
+        JUT_WARN(__LINE__, "%s", "Not enough JASTrack\n");
+        return -1;
+    }
+
+    JASCalc::bzero(stat, sizeof(TBenchStat));
+    track->setSeqData(seq, offset);
+    track->mStatus = JASTrack::STATUS_RUN;
+    l_benchTrack = track;
+    l_benchStat = stat;
+    l_benchDecode = decode;
+
+    OSTime start = OSGetTime();
+    while (stat->mTicks < ticks) {
+        stat->mTicks++;
+        if (track->tickProc() < 0) {
+            break;
+        }
+    }
+    stat->mMicroSec = OSTicksToMicroseconds(OSGetTime() - start);
+
+    track->close();
+    l_benchTrack = NULL;
+    l_benchStat = NULL;
+    l_benchDecode = false;
+    delete track;
+    return 0;
+}
+
+void JASSeqParser::reportBench(const TBenchStat* stat) {
+    u32 ops = stat->mNoteOn + stat->mNoteOff;
+    for (int i = 0; i < 96; i++) {
+        ops += stat->mCmd[i];
+    }
+    for (int i = 0; i < 255; i++) {
+        ops += stat->mExtCmd[i];
+    }
+
+    JASReport("--------------- JASSeqParser bench ----------------");
+    JASReport(" ticks: %d ops: %d time: %d us", stat->mTicks, ops, stat->mMicroSec);
+    if (stat->mMicroSec != 0) {
+        JASReport(" ops/s: %d", (u32)((u64)ops * 1000000 / stat->mMicroSec));
+    }
+    if (stat->mDecodeHit + stat->mDecodeMiss != 0) {
+        JASReport(" decode hit: %d miss: %d", stat->mDecodeHit, stat->mDecodeMiss);
+    }
+    JASReport(" note on: %d note off: %d", stat->mNoteOn, stat->mNoteOff);
+    for (int i = 0; i < 96; i++) {
+        if (stat->mCmd[i] != 0) {
+            JASReport(" cmd 0x%02x: %d", i + 0xa0, stat->mCmd[i]);
+        }
+    }
+    for (int i = 0; i < 255; i++) {
+        if (stat->mExtCmd[i] != 0) {
+            JASReport(" ext 0x%02x: %d", i, stat->mExtCmd[i]);
+        }
+    }
+    JASReport("");
+}
+#endif
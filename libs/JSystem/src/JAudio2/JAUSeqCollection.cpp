@@ -1,6 +1,9 @@
 #include "JSystem/JSystem.h" // IWYU pragma: keep
 
 #include "JSystem/JAudio2/JAUSeqCollection.h"
+#if ENABLE_SEQ_BENCH
+#include "JSystem/JAudio2/JASSeqParser.h"
+#endif
 #include "JSystem/JUtility/JUTAssert.h"
 
 JAUSeqCollection::JAUSeqCollection() {
@@ -56,6 +59,9 @@ int JAUSeqDataMgr_SeqCollection::releaseSeqData() {
     if (user_) {
         JAISeqDataRegion region;
         getSeqDataRegion(&region);
+#if ENABLE_SEQ_BENCH
+        JASSeqParser::invalidateDecodeCache(region.addr, region.size);
+#endif
         int result = user_->releaseSeqData(region);
         return result;
     }
@@ -7,6 +7,9 @@
 #include "JSystem/JAudio2/JAUSeqDataBlockMgr.h"
 #include "JSystem/JAudio2/JAUSoundInfo.h"
 #include "JSystem/JAudio2/JASResArcLoader.h"
+#if ENABLE_SEQ_BENCH
+#include "JSystem/JAudio2/JASSeqParser.h"
+#endif
 #include <types.h>
 
 JAUSeqDataBlock::JAUSeqDataBlock() : field_0x0(this) {}
@@ -150,6 +153,10 @@ bool JAUDynamicSeqDataBlocks::loadDynamicSeq(JAISoundID param_0, bool param_1,
         link->getObject()->field_0x10 = param_0;
         link->getObject()->field_0x1c = 1;
         field_0xc.append(link);
+#if ENABLE_SEQ_BENCH
+        JASSeqParser::invalidateDecodeCache(link->getObject()->region.addr,
+                                            link->getObject()->region.size);
+#endif
         JASResArcLoader::loadResourceAsync(
             seqDataArchive_, resourceId,
             link->getObject()->region.addr, link->getObject()->region.size,
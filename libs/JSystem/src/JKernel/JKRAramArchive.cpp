@@ -22,6 +22,9 @@ JKRAramArchive::JKRAramArchive(s32 entryNumber, JKRArchive::EMountDirection moun
 
     mVolumeType = 'RARC';
     mVolumeName = mStringTable + mNodes->name_offset;
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
     JKRFileLoader::sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
 }
@@ -86,6 +89,9 @@ BOOL JKRAramArchive::mountFixed(s32 entryNumber, JKRArchive::EMountDirection mou
     }
     mVolumeType = 'RARC';
     mVolumeName = mStringTable + mNodes->name_offset;
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
     sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
     return TRUE;
@@ -210,6 +216,9 @@ void* JKRAramArchive::fetchResource(SDIFileEntry* pEntry, u32* pOutSize) {
         }
 
         pEntry->data = outBuf;
+#if ENABLE_ARCHIVE_INDEX
+        entryPtrIndex(pEntry);
+#endif
         if (compression == COMPRESSION_YAZ0) {
             this->setExpandSize(pEntry, *pOutSize);
         }
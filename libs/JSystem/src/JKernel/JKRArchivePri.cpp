@@ -4,12 +4,17 @@
 #include "JSystem/JKernel/JKRHeap.h"
 #include <cctype>
 #include <cstring>
+#include <stdint.h>
 
 u32 JKRArchive::sCurrentDirID;
 
 JKRArchive::JKRArchive() {
     mIsMounted = false;
     mMountDirection = MOUNT_DIRECTION_HEAD;
+#if ENABLE_ARCHIVE_INDEX
+    mNameIndex = NULL;
+    mPtrIndex = NULL;
+#endif
 }
 
 JKRArchive::JKRArchive(s32 entryNumber, JKRArchive::EMountMode mountMode) {
@@ -28,9 +33,19 @@ JKRArchive::JKRArchive(s32 entryNumber, JKRArchive::EMountMode mountMode) {
         sCurrentVolume = this;
         sCurrentDirID = 0;
     }
+#if ENABLE_ARCHIVE_INDEX
+    mNameIndex = NULL;
+    mPtrIndex = NULL;
+#endif
 }
 
+#if ENABLE_ARCHIVE_INDEX
+JKRArchive::~JKRArchive() {
+    destroyIndex();
+}
+#else
 JKRArchive::~JKRArchive() {}
+#endif
 
 bool JKRArchive::isSameName(JKRArchive::CArcName& name, u32 nameOffset, u16 nameHash) const {
     u16 hash = name.getHash();
@@ -61,6 +76,16 @@ JKRArchive::SDIDirEntry* JKRArchive::findDirectory(const char* name, u32 directo
     SDIDirEntry* dirEntry = mNodes + directoryId;
     SDIFileEntry* fileEntry = mFiles + dirEntry->first_file_index;
 
+#if ENABLE_ARCHIVE_INDEX
+    if (mNameIndex != NULL) {
+        fileEntry = findNameIndex(arcName, dirEntry->first_file_index, dirEntry->num_entries);
+        if (fileEntry != NULL && ((fileEntry->type_flags_and_name_offset >> 24) & 2)) {
+            return findDirectory(name, fileEntry->data_offset);
+        }
+        return NULL;
+    }
+#endif
+
     for (int i = 0; i < dirEntry->num_entries; i++) {
         if (isSameName(arcName, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
             if ((fileEntry->type_flags_and_name_offset >> 24) & 2) {
@@ -80,6 +105,11 @@ JKRArchive::SDIFileEntry* JKRArchive::findTypeResource(u32 type, const char* nam
         SDIDirEntry* dirEntry = findResType(type);
 
         if (dirEntry) {
+#if ENABLE_ARCHIVE_INDEX
+            if (mNameIndex != NULL) {
+                return findNameIndex(arcName, dirEntry->first_file_index, dirEntry->num_entries);
+            }
+#endif
             SDIFileEntry* fileEntry = mFiles + dirEntry->first_file_index;
             for (int i = 0; i < dirEntry->num_entries; i++) {
                 if (isSameName(arcName, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
@@ -99,6 +129,22 @@ JKRArchive::SDIFileEntry* JKRArchive::findFsResource(const char* name, u32 direc
         SDIDirEntry* dirEntry = mNodes + directoryId;
         SDIFileEntry* fileEntry = mFiles + dirEntry->first_file_index;
 
+#if ENABLE_ARCHIVE_INDEX
+        if (mNameIndex != NULL) {
+            fileEntry = findNameIndex(arcName, dirEntry->first_file_index, dirEntry->num_entries);
+            if (fileEntry == NULL) {
+                return NULL;
+            }
+            if ((fileEntry->type_flags_and_name_offset >> 24) & 2) {
+                return findFsResource(name, fileEntry->data_offset);
+            }
+            if (name == NULL) {
+                return fileEntry;
+            }
+            return NULL;
+        }
+#endif
+
         for (int i = 0; i < dirEntry->num_entries; i++) {
             if (isSameName(arcName, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
                 if ((fileEntry->type_flags_and_name_offset >> 24) & 2) {
@@ -130,6 +176,11 @@ JKRArchive::SDIFileEntry* JKRArchive::findNameResource(const char* name) const {
     SDIFileEntry* fileEntry = mFiles;
 
     CArcName arcName(name);
+#if ENABLE_ARCHIVE_INDEX
+    if (mNameIndex != NULL) {
+        return findNameIndex(arcName, 0, mArcInfoBlock->num_file_entries);
+    }
+#endif
     for (int i = 0; i < mArcInfoBlock->num_file_entries; i++) {
         if (isSameName(arcName, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
             return fileEntry;
@@ -141,6 +192,11 @@ JKRArchive::SDIFileEntry* JKRArchive::findNameResource(const char* name) const {
 }
 
 JKRArchive::SDIFileEntry* JKRArchive::findPtrResource(const void* resource) const {
+#if ENABLE_ARCHIVE_INDEX
+    if (mPtrIndex != NULL) {
+        return findPtrIndex(resource);
+    }
+#endif
     SDIFileEntry* fileEntry = mFiles;
     for (int i = 0; i < mArcInfoBlock->num_file_entries; i++) {
         if (fileEntry->data == resource) {
@@ -225,3 +281,163 @@ u32 JKRArchive::getExpandSize(SDIFileEntry* fileEntry) const {
 
     return mExpandedSize[index];
 }
+
+#if ENABLE_ARCHIVE_INDEX
+/**
+ * Every directory holds a "." and a ".." entry, and each of the two names
+ * has one hash, so they would pile up into two long probe chains.
+ */
+static bool JKRArchive_isDotName(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+/**
+ * Builds the name and resource pointer indices once the file entries are
+ * loaded. Small archives, and archives whose heap has no room left, keep
+ * the linear lookups. "." and ".." stay out of the name index.
+ */
+void JKRArchive::createIndex() {
+    u32 num = mArcInfoBlock->num_file_entries;
+    if (num < JKRARCHIVE_INDEX_MIN || num >= 0xFFFF) {
+        return;
+    }
+
+    u32 bits = 1;
+    while ((1 << bits) < num + (num >> 1)) {
+        bits++;
+    }
+
+    u32 size = (1 << bits) * sizeof(u16) * 2;
+    JKRHeap* heap = mHeap != NULL ? mHeap : JKRHeap::getCurrentHeap();
+    if (heap == NULL || (u32)heap->getFreeSize() < size + 0x20) {
+        return;
+    }
+
+    mNameIndex = (u16*)JKRAllocFromHeap(heap, size, mMountDirection == MOUNT_DIRECTION_TAIL ? -4 : 4);
+    if (mNameIndex == NULL) {
+        return;
+    }
+    memset(mNameIndex, 0, size);
+    mPtrIndex = mNameIndex + (1 << bits);
+    mIndexMask = (1 << bits) - 1;
+    mIndexShift = 32 - bits;
+
+    SDIFileEntry* fileEntry = mFiles;
+    for (u32 i = 0; i < num; i++) {
+        if (!JKRArchive_isDotName(mStringTable + fileEntry->getNameOffset())) {
+            u32 slot = getIndexSlot(fileEntry->name_hash);
+            while (mNameIndex[slot] != 0) {
+                slot = (slot + 1) & mIndexMask;
+            }
+            mNameIndex[slot] = i + 1;
+        }
+
+        entryPtrIndex(fileEntry);
+        fileEntry++;
+    }
+}
+
+void JKRArchive::destroyIndex() {
+    if (mNameIndex != NULL) {
+        JKRFree(mNameIndex);
+        mNameIndex = NULL;
+        mPtrIndex = NULL;
+    }
+}
+
+/**
+ * Finds the entry named @p name among the @p num entries starting at
+ * @p first. Entries go in in file order and never leave the name index, so
+ * the first match along the probe chain is the one the linear scan finds.
+ * "." and ".." are not in the index and are scanned for.
+ */
+JKRArchive::SDIFileEntry* JKRArchive::findNameIndex(CArcName& name, u32 first, u32 num) const {
+    if (JKRArchive_isDotName(name.getString())) {
+        SDIFileEntry* fileEntry = mFiles + first;
+        for (u32 i = 0; i < num; i++) {
+            if (isSameName(name, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
+                return fileEntry;
+            }
+            fileEntry++;
+        }
+        return NULL;
+    }
+
+    for (u32 slot = getIndexSlot(name.getHash()); mNameIndex[slot] != 0;
+         slot = (slot + 1) & mIndexMask)
+    {
+        u32 index = mNameIndex[slot] - 1;
+        if (index - first < num) {
+            SDIFileEntry* fileEntry = mFiles + index;
+            if (isSameName(name, fileEntry->type_flags_and_name_offset & 0xFFFFFF, fileEntry->name_hash)) {
+                return fileEntry;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+JKRArchive::SDIFileEntry* JKRArchive::findPtrIndex(const void* resource) const {
+    if (resource == NULL) {
+        return NULL;
+    }
+
+    // Removal reorders the chain, so keep looking for a lower entry that
+    // shares the pointer, as the linear scan would return it.
+    SDIFileEntry* result = NULL;
+    for (u32 slot = getIndexSlot((uintptr_t)resource); mPtrIndex[slot] != 0;
+         slot = (slot + 1) & mIndexMask)
+    {
+        SDIFileEntry* fileEntry = mFiles + (mPtrIndex[slot] - 1);
+        if (fileEntry->data == resource && (result == NULL || fileEntry < result)) {
+            result = fileEntry;
+        }
+    }
+
+    return result;
+}
+
+/** Adds @p fileEntry under its current data pointer. */
+void JKRArchive::entryPtrIndex(SDIFileEntry* fileEntry) {
+    if (mPtrIndex == NULL || fileEntry->data == NULL) {
+        return;
+    }
+
+    u16 value = (fileEntry - mFiles) + 1;
+    u32 slot = getIndexSlot((uintptr_t)fileEntry->data);
+    while (mPtrIndex[slot] != 0) {
+        if (mPtrIndex[slot] == value) {
+            return;
+        }
+        slot = (slot + 1) & mIndexMask;
+    }
+    mPtrIndex[slot] = value;
+}
+
+/** Removes @p fileEntry, which must still hold the data pointer it was added with. */
+void JKRArchive::removePtrIndex(SDIFileEntry* fileEntry) {
+    if (mPtrIndex == NULL || fileEntry->data == NULL) {
+        return;
+    }
+
+    u16 value = (fileEntry - mFiles) + 1;
+    u32 hole = getIndexSlot((uintptr_t)fileEntry->data);
+    while (mPtrIndex[hole] != value) {
+        if (mPtrIndex[hole] == 0) {
+            return;
+        }
+        hole = (hole + 1) & mIndexMask;
+    }
+
+    // Shift later entries of the chain back so lookups never stop early.
+    for (u32 slot = (hole + 1) & mIndexMask; mPtrIndex[slot] != 0; slot = (slot + 1) & mIndexMask) {
+        u32 home = getIndexSlot((uintptr_t)mFiles[mPtrIndex[slot] - 1].data);
+        if (((slot - home) & mIndexMask) >= ((slot - hole) & mIndexMask)) {
+            mPtrIndex[hole] = mPtrIndex[slot];
+            hole = slot;
+        }
+    }
+    mPtrIndex[hole] = 0;
+}
+#endif
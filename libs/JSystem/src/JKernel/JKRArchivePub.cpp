@@ -250,6 +250,9 @@ void JKRArchive::removeResourceAll() {
         for (int i = 0; i < mArcInfoBlock->num_file_entries; i++) {
             if (fileEntry->data) {
                 JKRFreeToHeap(mHeap, fileEntry->data);
+#if ENABLE_ARCHIVE_INDEX
+                removePtrIndex(fileEntry);
+#endif
                 fileEntry->data = NULL;
             }
             fileEntry++;
@@ -263,6 +266,9 @@ bool JKRArchive::removeResource(void* resource) {
     if (fileEntry == NULL)
         return false;
 
+#if ENABLE_ARCHIVE_INDEX
+    removePtrIndex(fileEntry);
+#endif
     fileEntry->data = NULL;
     JKRFreeToHeap(mHeap, resource);
     return true;
@@ -274,6 +280,9 @@ bool JKRArchive::detachResource(void* resource) {
     if (fileEntry == NULL)
         return false;
 
+#if ENABLE_ARCHIVE_INDEX
+    removePtrIndex(fileEntry);
+#endif
     fileEntry->data = NULL;
     return true;
 }
@@ -3,7 +3,11 @@
 #include "JSystem/JKernel/JKRAssertHeap.h"
 
 JKRAssertHeap::JKRAssertHeap(void* data, u32 size, JKRHeap* parent, bool errorFlag)
-    : JKRHeap(data, size, parent, errorFlag) {}
+    : JKRHeap(data, size, parent, errorFlag) {
+#if ENABLE_HEAP_TRACE
+    traceCreate();
+#endif
+}
 
 JKRAssertHeap::~JKRAssertHeap() {
     this->dispose();
@@ -24,6 +24,9 @@ JKRCompArchive::JKRCompArchive(s32 entryNum, JKRArchive::EMountDirection eMountD
 
     mVolumeType = 'RARC';
     mVolumeName = &mStringTable[mNodes->name_offset];
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
     sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
 }
@@ -233,6 +236,9 @@ void* JKRCompArchive::fetchResource(SDIFileEntry *fileEntry, u32 *pSize) {
         u32 flag = fileEntry->type_flags_and_name_offset >> 0x18;
         if(flag & 0x10) {
             fileEntry->data = (void *)(field_0x64 + fileEntry->data_offset);
+#if ENABLE_ARCHIVE_INDEX
+            entryPtrIndex(fileEntry);
+#endif
             *pSize = size;
         }
         else if (flag & 0x20) {
@@ -240,6 +246,9 @@ void* JKRCompArchive::fetchResource(SDIFileEntry *fileEntry, u32 *pSize) {
             size = JKRAramArchive::fetchResource_subroutine(fileEntry->data_offset + mAramPart->getAddress() - mSizeOfMemPart, size, mHeap, compression, &data);
             *pSize = size;
             fileEntry->data = data;
+#if ENABLE_ARCHIVE_INDEX
+            entryPtrIndex(fileEntry);
+#endif
             if(compression == COMPRESSION_YAZ0) {
                 setExpandSize(fileEntry, *pSize);
             }
@@ -251,6 +260,9 @@ void* JKRCompArchive::fetchResource(SDIFileEntry *fileEntry, u32 *pSize) {
                 *pSize = resSize;
             }
             fileEntry->data = data;
+#if ENABLE_ARCHIVE_INDEX
+            entryPtrIndex(fileEntry);
+#endif
             if (compression == COMPRESSION_YAZ0) {
                 setExpandSize(fileEntry, *pSize);
             }
@@ -323,6 +335,9 @@ void JKRCompArchive::removeResourceAll() {
                     JKRFreeToHeap(mHeap, fileEntry->data);
                 }
 
+#if ENABLE_ARCHIVE_INDEX
+                removePtrIndex(fileEntry);
+#endif
                 fileEntry->data = NULL;
             }
         }
@@ -340,6 +355,9 @@ bool JKRCompArchive::removeResource(void* resource) {
         JKRFreeToHeap(mHeap, resource);
     }
 
+#if ENABLE_ARCHIVE_INDEX
+    removePtrIndex(fileEntry);
+#endif
     fileEntry->data = NULL;
     return true;
 }
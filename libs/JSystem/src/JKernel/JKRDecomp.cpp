@@ -3,6 +3,9 @@
 #include "JSystem/JKernel/JKRDecomp.h"
 #include "JSystem/JKernel/JKRAramPiece.h"
 #include "global.h"
+#if ENABLE_FAST_DECOMP
+#include <cstring>
+#endif
 
 #if PLATFORM_GCN
 const u32 stack_size = 0x800;
@@ -14,7 +17,16 @@ JKRDecomp* JKRDecomp::sDecompObject;
 
 JKRDecomp* JKRDecomp::create(s32 priority) {
     if (!sDecompObject) {
+#if ENABLE_DECOMP_WORKERS
+        // The queue is shared by every worker, so it must exist before the first one runs.
+        OSInitMessageQueue(&sMessageQueue, sMessageBuffer, ARRAY_SIZE(sMessageBuffer));
+        for (int i = 0; i < JKRDECOMP_WORKER_NUM; i++) {
+            sWorkers[i] = new (JKRGetSystemHeap(), 0) JKRDecomp(priority);
+        }
+        sDecompObject = sWorkers[0];
+#else
         sDecompObject = new (JKRGetSystemHeap(), 0) JKRDecomp(priority);
+#endif
     }
 
     return sDecompObject;
@@ -24,12 +36,120 @@ OSMessage JKRDecomp::sMessageBuffer[8] = {0};
 
 OSMessageQueue JKRDecomp::sMessageQueue = {0};
 
+#if ENABLE_DECOMP_WORKERS
+JKRDecomp* JKRDecomp::sWorkers[JKRDECOMP_WORKER_NUM];
+
+JKRDecompCommand* JKRDecomp::sCommandHead[JKRDECOMP_PRIORITY_MAX];
+
+JKRDecompCommand* JKRDecomp::sCommandTail[JKRDECOMP_PRIORITY_MAX];
+#endif
+
 JKRDecomp::JKRDecomp(s32 priority) : JKRThread(stack_size, 0x10, priority) {
+#if ENABLE_DECOMP_WORKERS
+    mCompletionHead = NULL;
+    mCompletionTail = NULL;
+    mCompletionNum = 0;
+#endif
     resume();
 }
 
 JKRDecomp::~JKRDecomp() {}
 
+#if ENABLE_DECOMP_WORKERS
+/**
+ * Worker loop. sMessageQueue only acts as a doorbell: commands live in the
+ * per-priority lists, so a full doorbell never drops work, since a failed send
+ * means enough wakeups are already pending for the workers to drain the lists.
+ */
+void* JKRDecomp::run() {
+    for (;;) {
+        JKRDecompCommand* command = popCommand();
+        if (command == NULL) {
+            flushCompletions();
+
+            OSMessage message;
+            OSReceiveMessage(&sMessageQueue, &message, OS_MESSAGE_BLOCK);
+            continue;
+        }
+
+        decode(command->mSrcBuffer, command->mDstBuffer, command->mSrcLength, command->mDstLength);
+
+        if (command->field_0x20 != 0 || command->mCallback) {
+            pushCompletion(command);
+            if (mCompletionNum >= JKRDECOMP_COMPLETION_BATCH) {
+                flushCompletions();
+            }
+        } else {
+            complete(command);
+        }
+    }
+}
+
+JKRDecompCommand* JKRDecomp::popCommand() {
+    JKRDecompCommand* command = NULL;
+
+    BOOL interrupts = OSDisableInterrupts();
+    for (int i = 0; i < JKRDECOMP_PRIORITY_MAX; i++) {
+        command = sCommandHead[i];
+        if (command != NULL) {
+            sCommandHead[i] = command->mNext;
+            if (sCommandHead[i] == NULL) {
+                sCommandTail[i] = NULL;
+            }
+            command->mNext = NULL;
+            break;
+        }
+    }
+    OSRestoreInterrupts(interrupts);
+
+    return command;
+}
+
+void JKRDecomp::complete(JKRDecompCommand* command) {
+    if (command->field_0x20 != 0) {
+        if (command->field_0x20 == 1) {
+            JKRAramPcs_SendCommand(command->mAMCommand);
+        }
+        return;
+    }
+
+    if (command->mCallback) {
+        (*command->mCallback)((u32)command);
+        return;
+    }
+
+    if (command->field_0x1c) {
+        OSSendMessage(command->field_0x1c, (OSMessage)1, OS_MESSAGE_NOBLOCK);
+    } else {
+        OSSendMessage(&command->mMessageQueue, (OSMessage)1, OS_MESSAGE_NOBLOCK);
+    }
+}
+
+void JKRDecomp::pushCompletion(JKRDecompCommand* command) {
+    command->mNext = NULL;
+    if (mCompletionTail != NULL) {
+        mCompletionTail->mNext = command;
+    } else {
+        mCompletionHead = command;
+    }
+    mCompletionTail = command;
+    mCompletionNum++;
+}
+
+void JKRDecomp::flushCompletions() {
+    JKRDecompCommand* command = mCompletionHead;
+    mCompletionHead = NULL;
+    mCompletionTail = NULL;
+    mCompletionNum = 0;
+
+    while (command != NULL) {
+        // The callback may free the command, so step past it first.
+        JKRDecompCommand* next = command->mNext;
+        complete(command);
+        command = next;
+    }
+}
+#else
 void* JKRDecomp::run() {
     OSInitMessageQueue(&sMessageQueue, sMessageBuffer, 8);
     for (;;) {
@@ -58,6 +178,7 @@ void* JKRDecomp::run() {
         }
     }
 }
+#endif
 
 JKRDecompCommand* JKRDecomp::prepareCommand(u8* srcBuffer, u8* dstBuffer, u32 srcLength,
                                             u32 dstLength,
@@ -72,8 +193,26 @@ JKRDecompCommand* JKRDecomp::prepareCommand(u8* srcBuffer, u8* dstBuffer, u32 sr
 }
 
 void JKRDecomp::sendCommand(JKRDecompCommand* command) {
+#if ENABLE_DECOMP_WORKERS
+    // Also reached from the ARAM DMA completion interrupt, so the lists are guarded
+    // by disabling interrupts rather than by a mutex.
+    int priority = command->mPriority;
+    command->mNext = NULL;
+
+    BOOL interrupts = OSDisableInterrupts();
+    if (sCommandTail[priority] != NULL) {
+        sCommandTail[priority]->mNext = command;
+    } else {
+        sCommandHead[priority] = command;
+    }
+    sCommandTail[priority] = command;
+    OSRestoreInterrupts(interrupts);
+
+    OSSendMessage(&sMessageQueue, (OSMessage)1, OS_MESSAGE_NOBLOCK);
+#else
     int result = OSSendMessage(&sMessageQueue, command, OS_MESSAGE_NOBLOCK);
     JUT_ASSERT_MSG(142, result, "Decomp MesgBuf FULL!");
+#endif
 }
 
 JKRDecompCommand* JKRDecomp::orderAsync(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength,
@@ -84,6 +223,18 @@ JKRDecompCommand* JKRDecomp::orderAsync(u8* srcBuffer, u8* dstBuffer, u32 srcLen
     return command;
 }
 
+#if ENABLE_DECOMP_WORKERS
+JKRDecompCommand* JKRDecomp::orderAsync(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength,
+                                        JKRDecompCommand::AsyncCallback callback, int priority) {
+    JUT_ASSERT(__LINE__, 0 <= priority && priority < JKRDECOMP_PRIORITY_MAX);
+    JKRDecompCommand* command =
+        prepareCommand(srcBuffer, dstBuffer, srcLength, dstLength, callback);
+    command->mPriority = priority;
+    sendCommand(command);
+    return command;
+}
+#endif
+
 bool JKRDecomp::sync(JKRDecompCommand* command, int isNonBlocking) {
     OSMessage message;
     if (isNonBlocking == JKRDECOMP_SYNC_BLOCKING) {
@@ -100,11 +251,27 @@ bool JKRDecomp::sync(JKRDecompCommand* command, int isNonBlocking) {
 }
 
 bool JKRDecomp::orderSync(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength) {
+#if ENABLE_DECOMP_WORKERS
+    // A caller blocked on the result is a foreground load by definition.
+    return orderSync(srcBuffer, dstBuffer, srcLength, dstLength, JKRDECOMP_PRIORITY_FOREGROUND);
+#else
     JKRDecompCommand* command = orderAsync(srcBuffer, dstBuffer, srcLength, dstLength, NULL);
     bool result = sync(command, JKRDECOMP_SYNC_BLOCKING);
     delete command;
     return result;
+#endif
+}
+
+#if ENABLE_DECOMP_WORKERS
+bool JKRDecomp::orderSync(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength,
+                          int priority) {
+    JKRDecompCommand* command =
+        orderAsync(srcBuffer, dstBuffer, srcLength, dstLength, NULL, priority);
+    bool result = sync(command, JKRDECOMP_SYNC_BLOCKING);
+    delete command;
+    return result;
 }
+#endif
 
 void JKRDecomp::decode(u8* srcBuffer, u8* dstBuffer, u32 srcLength, u32 dstLength) {
     JKRCompression compression = checkCompressed(srcBuffer);
@@ -138,6 +305,13 @@ void JKRDecomp::decodeSZP(u8* src, u8* dst, u32 srcLength, u32 dstLength) {
     if (dstLength > decodedSize)
         return;
 
+#if ENABLE_FAST_DECOMP
+    if (dstLength == 0 && (u32)decodedSize <= srcLength) {
+        decodeSZPFull(src, dst, decodedSize);
+        return;
+    }
+#endif
+
     do
     {
         if (counter == 0)
@@ -215,6 +389,14 @@ void JKRDecomp::decodeSZS(u8* src_buffer, u8* dst_buffer, u32 srcSize, u32 dstSi
         return;
     }
 
+#if ENABLE_FAST_DECOMP
+    u32 decodedSize = READU32_BE(src_buffer, 4);
+    if (dstSize == 0 && decodedSize <= srcSize) {
+        decodeSZSFull(src_buffer, dst_buffer, decodedSize);
+        return;
+    }
+#endif
+
     u8* curSrcPos = src_buffer + 0x10;
     do {
         if (chunkBitsLeft == 0) {
@@ -263,6 +445,107 @@ void JKRDecomp::decodeSZS(u8* src_buffer, u8* dst_buffer, u32 srcSize, u32 dstSi
     } while (dst_buffer != decompEnd);
 }
 
+#if ENABLE_FAST_DECOMP
+/**
+ * Copies a back-reference of `count` bytes starting `distance` bytes behind `dst`.
+ * Non-overlapping references are copied in one block; overlapping ones are copied
+ * in runs of `distance` bytes, which doubles each pass since the run is repeated.
+ */
+static inline void copyBackReference(u8* dst, u32 distance, u32 count) {
+    if (distance >= count) {
+        memcpy(dst, dst - distance, count);
+    } else if (distance == 1) {
+        memset(dst, dst[-1], count);
+    } else {
+        u8* copyStart = dst - distance;
+        while (count > distance) {
+            memcpy(dst, copyStart, distance);
+            dst += distance;
+            count -= distance;
+            distance <<= 1;
+        }
+        memcpy(dst, copyStart, count);
+    }
+}
+
+/**
+ * Yay0 fast path. Only used when the whole expanded image fits in `dst` and no
+ * leading bytes are skipped, so the per-byte length bookkeeping can be dropped.
+ */
+void JKRDecomp::decodeSZPFull(u8* src, u8* dst, u32 decodedSize) {
+    u32 linkTableOffset = READU32_BE(src, 8);
+    u32 srcDataOffset = READU32_BE(src, 12);
+    u8* chunkPtr = src + 16;
+    u8* linkPtr = src + linkTableOffset;
+    u8* dataPtr = src + srcDataOffset;
+    u8* dstPtr = dst;
+    u8* dstEnd = dst + decodedSize;
+
+    while (dstPtr < dstEnd) {
+        u32 chunkBits = READU32_BE(chunkPtr, 0);
+        chunkPtr += sizeof(u32);
+
+        for (int i = 32; i != 0 && dstPtr < dstEnd; i--, chunkBits <<= 1) {
+            if (chunkBits & 0x80000000) {
+                *dstPtr++ = *dataPtr++;
+                continue;
+            }
+
+            u32 linkInfo = linkPtr[0] << 8 | linkPtr[1];
+            linkPtr += sizeof(u16);
+
+            u32 count = linkInfo >> 12;
+            if (count == 0) {
+                count = *dataPtr++ + 0x12;
+            } else {
+                count += 2;
+            }
+            if (count > (u32)(dstEnd - dstPtr)) {
+                count = dstEnd - dstPtr;
+            }
+
+            copyBackReference(dstPtr, (linkInfo & 0xFFF) + 1, count);
+            dstPtr += count;
+        }
+    }
+}
+
+/**
+ * Yaz0 fast path. Same preconditions as decodeSZPFull.
+ */
+void JKRDecomp::decodeSZSFull(u8* src, u8* dst, u32 decodedSize) {
+    u8* curSrcPos = src + 0x10;
+    u8* dstPtr = dst;
+    u8* dstEnd = dst + decodedSize;
+
+    while (dstPtr < dstEnd) {
+        u32 chunkBits = *curSrcPos++;
+
+        for (int i = 8; i != 0 && dstPtr < dstEnd; i--, chunkBits <<= 1) {
+            if (chunkBits & 0x80) {
+                *dstPtr++ = *curSrcPos++;
+                continue;
+            }
+
+            u32 distance = ((curSrcPos[0] & 0xF) << 8 | curSrcPos[1]) + 1;
+            u32 count = curSrcPos[0] >> 4;
+            curSrcPos += 2;
+            if (count == 0) {
+                count = *curSrcPos++ + 0x12;
+            } else {
+                count += 2;
+            }
+            if (count > (u32)(dstEnd - dstPtr)) {
+                count = dstEnd - dstPtr;
+            }
+
+            copyBackReference(dstPtr, distance, count);
+            dstPtr += count;
+        }
+    }
+}
+#endif
+
 JKRCompression JKRDecomp::checkCompressed(u8* src) {
     if ((src[0] == 'Y') && (src[1] == 'a') && (src[3] == '0')) {
         if (src[2] == 'y') {
@@ -287,6 +570,10 @@ JKRDecompCommand::JKRDecompCommand() {
     field_0x1c = NULL;
     mThis = this;
     field_0x20 = 0;
+#if ENABLE_DECOMP_WORKERS
+    mNext = NULL;
+    mPriority = JKRDECOMP_PRIORITY_NORMAL;
+#endif
 }
 
 JKRDecompCommand::~JKRDecompCommand() {}
@@ -19,6 +19,9 @@ JKRDvdArchive::JKRDvdArchive(s32 entryNum, JKRArchive::EMountDirection mountDire
 
     mVolumeType = 'RARC';
     mVolumeName = mStringTable + mNodes->name_offset;
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
     sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
 }
@@ -159,6 +162,9 @@ void* JKRDvdArchive::fetchResource(SDIFileEntry* fileEntry, u32* returnSize) {
         }
 
         fileEntry->data = resourcePtr;
+#if ENABLE_ARCHIVE_INDEX
+        entryPtrIndex(fileEntry);
+#endif
         if (fileCompression == COMPRESSION_YAZ0) {
             setExpandSize(fileEntry, *returnSize);
         }
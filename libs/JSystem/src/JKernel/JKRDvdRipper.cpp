@@ -17,6 +17,10 @@ static int JKRDecompressFromDVD(JKRDvdFile*, void*, u32, u32, u32, u32, u32*);
 static int decompSZS_subroutine(u8*, u8*);
 static u8* firstSrcData();
 static u8* nextSrcData(u8*);
+#if ENABLE_STREAM_DECOMP
+static void requestSrcData(int);
+static bool waitSrcData();
+#endif
 
 void* JKRDvdRipper::loadToMainRAM(char const* name, u8* dst, JKRExpandSwitch expandSwitch,
                                   u32 dstLength, JKRHeap* heap,
@@ -270,6 +274,26 @@ static u32* tsPtr;
 
 static u32 tsArea;
 
+#if ENABLE_STREAM_DECOMP
+// Padding in front of each read window, large enough for the unconsumed tail of
+// the previous window (at most one code byte plus eight 3-byte tokens).
+#define SZS_WINDOW_PAD 0x20
+
+static u8* srcWindow[2];
+
+static u8* srcWindowEnd[2];
+
+static int srcWindowIndex;
+
+static u8* srcPendingBuf;
+
+static u32 srcPendingOffset;
+
+static u32 srcPendingSize;
+
+static bool srcPendingAsync;
+#endif
+
 static int JKRDecompressFromDVD(JKRDvdFile* dvdFile, void* dst, u32 fileSize, u32 inMaxDest,
                                 u32 inFileOffset, u32 inSrcOffset, u32* inTsPtr) {
     BOOL interrupts = OSDisableInterrupts();
@@ -282,10 +306,25 @@ static int JKRDecompressFromDVD(JKRDvdFile* dvdFile, void* dst, u32 fileSize, u3
     OSLockMutex(&decompMutex);
     u32 result = 0;
     u32 szsBufferSize = JKRDvdRipper::getSZSBufferSize();
+#if ENABLE_STREAM_DECOMP
+    // Two read windows in the buffer serial decoding uses: one is decoded while the DVD
+    // fills the other.
+    u32 windowSize = (szsBufferSize / 2 - SZS_WINDOW_PAD) & ~(0x20 - 1);
+    szpBuf = (u8 *)JKRAllocFromSysHeap(szsBufferSize, -0x20);
+    JUT_ASSERT(909, szpBuf != NULL);
+
+    szpEnd = szpBuf + szsBufferSize;
+    srcWindow[0] = szpBuf + SZS_WINDOW_PAD;
+    srcWindowEnd[0] = srcWindow[0] + windowSize;
+    srcWindow[1] = srcWindowEnd[0] + SZS_WINDOW_PAD;
+    srcWindowEnd[1] = srcWindow[1] + windowSize;
+    srcPendingSize = 0;
+#else
     szpBuf = (u8 *)JKRAllocFromSysHeap(szsBufferSize, -0x20);
     JUT_ASSERT(909, szpBuf != NULL);
 
     szpEnd = szpBuf + szsBufferSize;
+#endif
     if (inFileOffset != 0) {
         refBuf = (u8 *)JKRAllocFromSysHeap(0x1120, -4);
         JUT_ASSERT(918, refBuf != NULL);
@@ -308,6 +347,13 @@ static int JKRDecompressFromDVD(JKRDvdFile* dvdFile, void* dst, u32 fileSize, u3
     } else {
         result = -1;
     }
+#if ENABLE_STREAM_DECOMP
+    // The decoder can stop before the stream ends; the window must not be freed
+    // while the DVD is still writing into it.
+    if (srcPendingSize != 0 && srcPendingAsync) {
+        srcFile->sync();
+    }
+#endif
     JKRFree(szpBuf);
     if (refBuf)
     {
@@ -341,7 +387,11 @@ int decompSZS_subroutine(u8* src, u8* dest) {
     u8* copySource;
     do {
         if (validBitCount == 0) {
+#if ENABLE_STREAM_DECOMP
+            if ((src > srcLimit) && (transLeft || srcPendingSize)) {
+#else
             if ((src > srcLimit) && transLeft) {
+#endif
                 src = nextSrcData(src);
                 if (!src) {
                     return -1;
@@ -433,6 +483,81 @@ int decompSZS_subroutine(u8* src, u8* dest) {
     return 0;
 }
 
+#if ENABLE_STREAM_DECOMP
+/**
+ * Starts an asynchronous read of the next part of the stream into the given window.
+ */
+static void requestSrcData(int index) {
+    u32 bufSize = srcWindowEnd[index] - srcWindow[index];
+    u32 length = transLeft < bufSize ? transLeft : bufSize;
+
+    srcPendingBuf = srcWindow[index];
+    srcPendingOffset = srcOffset;
+    srcPendingSize = length;
+    srcPendingAsync = DVDReadAsyncPrio(srcFile->getFileInfo(), srcPendingBuf, length,
+                                       srcPendingOffset, JKRDvdFile::doneProcess, 2);
+    srcOffset += length;
+    transLeft -= length;
+}
+
+/**
+ * Waits for the outstanding read. Failed reads are retried synchronously.
+ */
+static bool waitSrcData() {
+    s32 result = srcPendingAsync ? srcFile->sync() : -1;
+    srcPendingAsync = false;
+
+    while (result < 0) {
+        if (result == -3 || !JKRDvdRipper::isErrorRetry()) {
+            srcPendingSize = 0;
+            return false;
+        }
+        VIWaitForRetrace();
+        result = DVDReadPrio(srcFile->getFileInfo(), srcPendingBuf, srcPendingSize,
+                             srcPendingOffset, 2);
+    }
+
+    DCInvalidateRange(srcPendingBuf, srcPendingSize);
+    srcPendingSize = 0;
+    return true;
+}
+
+static u8* firstSrcData() {
+    srcWindowIndex = 0;
+    srcLimit = srcWindowEnd[0] - 0x19;
+
+    requestSrcData(0);
+    if (!waitSrcData()) {
+        return NULL;
+    }
+    if (transLeft != 0) {
+        requestSrcData(1);
+    }
+    return srcWindow[0];
+}
+
+/**
+ * Moves the unconsumed tail of the current window in front of the other window,
+ * waits for that window's read, and reuses the current window for the next read.
+ */
+static u8* nextSrcData(u8* src) {
+    u32 limit = srcWindowEnd[srcWindowIndex] - src;
+    int next = srcWindowIndex ^ 1;
+    u8* dest = srcWindow[next] - limit;
+
+    memcpy(dest, src, limit);
+    if (!waitSrcData()) {
+        return NULL;
+    }
+
+    srcWindowIndex = next;
+    srcLimit = srcWindowEnd[next] - 0x19;
+    if (transLeft != 0) {
+        requestSrcData(next ^ 1);
+    }
+    return dest;
+}
+#else
 static u8* firstSrcData() {
     srcLimit = szpEnd - 0x19;
     u8* buffer = szpBuf;
@@ -492,3 +617,4 @@ static u8* nextSrcData(u8* src) {
 
     return dest;
 }
+#endif
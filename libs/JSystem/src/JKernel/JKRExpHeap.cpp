@@ -11,6 +11,28 @@
 #include "JSystem/JUtility/JUTException.h"
 #include <cstdlib>
 
+#if ENABLE_EXPHEAP_SIZE_INDEX
+/**
+ * Bin links, kept in the first bytes of an indexed free block's content.
+ */
+struct JKRExpHeapFreeLink {
+    JKRExpHeap::CMemBlock* mPrev;
+    JKRExpHeap::CMemBlock* mNext;
+};
+
+static inline JKRExpHeapFreeLink* getFreeLink(JKRExpHeap::CMemBlock* block) {
+    return (JKRExpHeapFreeLink*)block->getContent();
+}
+
+static inline bool isIndexedSize(u32 size) {
+    return size >= sizeof(JKRExpHeapFreeLink);
+}
+
+static inline int getFreeBin(u32 size) {
+    return (31 - __cntlzw(size)) - 3;
+}
+#endif
+
 JKRExpHeap* JKRExpHeap::createRoot(int maxHeaps, bool errorFlag) {
     JKRExpHeap* heap = NULL;
     if (!sRootHeap) {
@@ -91,6 +113,9 @@ JKRExpHeap* JKRExpHeap::create(u32 size, JKRHeap* parent, bool errorFlag) {
         u32 local_34 = newHeap->mHeadFreeList->size;
         if (isDefaultDebugFill()) {
             JKRFillMemory(local_30, local_34, JKRValue_DEBUGFILL_NOTUSE);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            newHeap->resetFreeIndex();
+#endif
         }
     }
 #endif
@@ -125,6 +150,9 @@ JKRExpHeap* JKRExpHeap::create(void* ptr, u32 size, JKRHeap* parent, bool errorF
         u32 local_34 = newHeap->mHeadFreeList->size;
         if (isDefaultDebugFill()) {
             JKRFillMemory(local_30, local_34, JKRValue_DEBUGFILL_NOTUSE);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            newHeap->resetFreeIndex();
+#endif
         }
     }
 #endif
@@ -162,6 +190,12 @@ JKRExpHeap::JKRExpHeap(void* data, u32 size, JKRHeap* parent, bool errorFlag)
     mHeadFreeList->initiate(NULL, NULL, size - sizeof(CMemBlock), 0, 0);
     mHeadUsedList = NULL;
     mTailUsedList = NULL;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    resetFreeIndex();
+#endif
+#if ENABLE_HEAP_TRACE
+    traceCreate();
+#endif
 }
 
 JKRExpHeap::~JKRExpHeap() {
@@ -244,6 +278,12 @@ void* JKRExpHeap::allocFromHead(u32 size, int align) {
     CMemBlock* newFreeBlock = NULL;
     CMemBlock* newUsedBlock = NULL;
 
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    if (mAllocMode == 0 && isIndexedSize(size)) {
+        foundBlock = findIndexedFreeBlock(size, align, &foundOffset);
+        foundSize = foundBlock ? foundBlock->size : -1;
+    } else
+#endif
     for (CMemBlock* block = mHeadFreeList; block; block = block->mNext) {
         u32 offset =
             ALIGN_PREV(align - 1 + (uintptr_t)block->getContent(), align) - (uintptr_t)block->getContent();
@@ -272,6 +312,9 @@ void* JKRExpHeap::allocFromHead(u32 size, int align) {
     DBfoundBlock = foundBlock;
 
     if (foundBlock) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(foundBlock);
+#endif
         if (foundOffset >= sizeof(CMemBlock)) {
             CMemBlock* prev = foundBlock->mPrev;
             CMemBlock* next = foundBlock->mNext;
@@ -293,6 +336,12 @@ void* JKRExpHeap::allocFromHead(u32 size, int align) {
                 setFreeBlock(newFreeBlock, foundBlock, next);
             }
 
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            indexFreeBlock(foundBlock);
+            if (newFreeBlock) {
+                indexFreeBlock(newFreeBlock);
+            }
+#endif
             appendUsedList(newUsedBlock);
             DBnewFreeBlock = newFreeBlock;
             DBnewUsedBlock = newUsedBlock;
@@ -308,6 +357,9 @@ void* JKRExpHeap::allocFromHead(u32 size, int align) {
                     newUsedBlock->allocFore(size, mCurrentGroupId, (u8)foundOffset, 0, 0);
                 if (newFreeBlock) {
                     setFreeBlock(newFreeBlock, prev, next);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+                    indexFreeBlock(newFreeBlock);
+#endif
                 }
                 appendUsedList(newUsedBlock);
                 return newUsedBlock->getContent();
@@ -319,6 +371,9 @@ void* JKRExpHeap::allocFromHead(u32 size, int align) {
                 removeFreeBlock(foundBlock);
                 if (newFreeBlock) {
                     setFreeBlock(newFreeBlock, prev, next);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+                    indexFreeBlock(newFreeBlock);
+#endif
                 }
                 appendUsedList(foundBlock);
                 return foundBlock->getContent();
@@ -334,6 +389,12 @@ void* JKRExpHeap::allocFromHead(u32 size) {
     s32 foundSize = -1;
     CMemBlock* foundBlock = NULL;
     CMemBlock* newblock = NULL;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    if (mAllocMode == 0 && isIndexedSize(size)) {
+        u32 foundOffset;
+        foundBlock = findIndexedFreeBlock(size, 0, &foundOffset);
+    } else
+#endif
     for (CMemBlock* block = mHeadFreeList; block; block = block->mNext) {
         if (block->size < size) {
             continue;
@@ -355,9 +416,15 @@ void* JKRExpHeap::allocFromHead(u32 size) {
     }
 
     if (foundBlock) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(foundBlock);
+#endif
         newblock = foundBlock->allocFore(size, mCurrentGroupId, 0, 0, 0);
         if (newblock) {
             setFreeBlock(newblock, foundBlock->mPrev, foundBlock->mNext);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            indexFreeBlock(newblock);
+#endif
         } else {
             removeFreeBlock(foundBlock);
         }
@@ -388,9 +455,15 @@ void* JKRExpHeap::allocFromTail(u32 size, int align) {
     }
 
     if (foundBlock != NULL) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(foundBlock);
+#endif
         if (offset >= sizeof(CMemBlock)) {
             newBlock->initiate(NULL, NULL, usedSize, mCurrentGroupId, -0x80);
             foundBlock->size = foundBlock->size - usedSize - sizeof(CMemBlock);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            indexFreeBlock(foundBlock);
+#endif
             appendUsedList(newBlock);
             return newBlock->getContent();
         } else {
@@ -424,6 +497,9 @@ void* JKRExpHeap::allocFromTail(u32 size) {
     }
 
     if (foundBlock != NULL) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(foundBlock);
+#endif
         usedBlock = foundBlock->allocBack(size, 0, 0, mCurrentGroupId, 0);
         if (usedBlock) {
             freeBlock = foundBlock;
@@ -435,6 +511,9 @@ void* JKRExpHeap::allocFromTail(u32 size) {
 
         if (freeBlock) {
             setFreeBlock(freeBlock, foundBlock->mPrev, foundBlock->mNext);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            indexFreeBlock(freeBlock);
+#endif
         }
         appendUsedList(usedBlock);
         return usedBlock->getContent();
@@ -471,6 +550,9 @@ void JKRExpHeap::do_freeAll() {
     if (mDebugFill) {
         JKRFillMemory((u8*)(mHeadFreeList + 1), mHeadFreeList->size, JKRValue_DEBUGFILL_DELETE);
     }
+#endif
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    resetFreeIndex();
 #endif
     unlock();
 }
@@ -494,6 +576,13 @@ void JKRExpHeap::do_fillFreeArea() {
 #if DEBUG
     lock();
     for (CMemBlock* block = mHeadFreeList; block; block = block->mNext) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        if (isIndexedSize(block->size)) {
+            JKRFillMemory((u8*)block->getContent() + sizeof(JKRExpHeapFreeLink),
+                          block->size - sizeof(JKRExpHeapFreeLink), JKRValue_DEBUGFILL_DELETE);
+            continue;
+        }
+#endif
         JKRFillMemory((u8*)block->getContent(), block->size, JKRValue_DEBUGFILL_DELETE);
     }
     unlock();
@@ -542,6 +631,9 @@ s32 JKRExpHeap::do_resize(void* ptr, u32 size) {
         }
 
         u32 local_24 = block->size;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(foundBlock);
+#endif
         removeFreeBlock(foundBlock);
         block->size += foundBlock->size + sizeof(CMemBlock);
         if (block->size - size > sizeof(CMemBlock)) {
@@ -750,12 +842,18 @@ void JKRExpHeap::recycleFreeBlock(JKRExpHeap::CMemBlock* block) {
         mHeadFreeList = newBlock;
         mTailFreeList = newBlock;
         setFreeBlock(newBlock, NULL, NULL);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        indexFreeBlock(newBlock);
+#endif
         return;
     }
 
     if (mHeadFreeList >= blockEnd) {
         newBlock->initiate(NULL, NULL, size, 0, 0);
         setFreeBlock(newBlock, NULL, mHeadFreeList);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        indexFreeBlock(newBlock);
+#endif
         joinTwoBlocks(newBlock);
         return;
     }
@@ -763,6 +861,9 @@ void JKRExpHeap::recycleFreeBlock(JKRExpHeap::CMemBlock* block) {
     if (mTailFreeList <= newBlock) {
         newBlock->initiate(NULL, NULL, size, 0, 0);
         setFreeBlock(newBlock, mTailFreeList, NULL);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        indexFreeBlock(newBlock);
+#endif
         joinTwoBlocks(newBlock->mPrev);
         return;
     }
@@ -776,6 +877,9 @@ void JKRExpHeap::recycleFreeBlock(JKRExpHeap::CMemBlock* block) {
         freeBlock->mNext = newBlock;
         newBlock->mNext->mPrev = newBlock;
         newBlock->mGroupId = 0;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        indexFreeBlock(newBlock);
+#endif
         joinTwoBlocks(newBlock);
         joinTwoBlocks(freeBlock);
         return;
@@ -798,6 +902,10 @@ void JKRExpHeap::joinTwoBlocks(CMemBlock* block) {
     }
 
     if (endAddr == nextAddr) {
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        unindexFreeBlock(block);
+        unindexFreeBlock(next);
+#endif
         block->size = next->size + sizeof(CMemBlock) + (next->mFlags & 0x7f) + block->size;
         CMemBlock* local_30 = next->mNext;
 #if DEBUG
@@ -808,8 +916,152 @@ void JKRExpHeap::joinTwoBlocks(CMemBlock* block) {
         }
 #endif
         setFreeBlock(block, block->mPrev, local_30);
+#if ENABLE_EXPHEAP_SIZE_INDEX
+        indexFreeBlock(block);
+#endif
+    }
+}
+
+#if ENABLE_EXPHEAP_SIZE_INDEX
+void JKRExpHeap::resetFreeIndex() {
+    mFreeBinMask = 0;
+    for (int i = 0; i < FREE_BIN_NUM; i++) {
+        mFreeBins[i] = NULL;
+    }
+
+    for (CMemBlock* block = mHeadFreeList; block; block = block->mNext) {
+        indexFreeBlock(block);
+    }
+}
+
+void JKRExpHeap::indexFreeBlock(CMemBlock* block) {
+    if (!isIndexedSize(block->size)) {
+        return;
+    }
+
+    int bin = getFreeBin(block->size);
+    JKRExpHeapFreeLink* link = getFreeLink(block);
+    link->mPrev = NULL;
+    link->mNext = mFreeBins[bin];
+    if (mFreeBins[bin] != NULL) {
+        getFreeLink(mFreeBins[bin])->mPrev = block;
+    }
+    mFreeBins[bin] = block;
+    mFreeBinMask |= 1 << bin;
+}
+
+/**
+ * Must be called before the block's size or content changes, since the bin is
+ * derived from the current size.
+ */
+void JKRExpHeap::unindexFreeBlock(CMemBlock* block) {
+    if (!isIndexedSize(block->size)) {
+        return;
     }
+
+    int bin = getFreeBin(block->size);
+    JKRExpHeapFreeLink* link = getFreeLink(block);
+    if (link->mPrev != NULL) {
+        getFreeLink(link->mPrev)->mNext = link->mNext;
+    } else {
+        mFreeBins[bin] = link->mNext;
+        if (mFreeBins[bin] == NULL) {
+            mFreeBinMask &= ~(1 << bin);
+        }
+    }
+    if (link->mNext != NULL) {
+        getFreeLink(link->mNext)->mPrev = link->mPrev;
+    }
+#if DEBUG
+    if (mDebugFill) {
+        JKRFillMemory((u8*)link, sizeof(JKRExpHeapFreeLink), JKRValue_DEBUGFILL_DELETE);
+    }
+#endif
+}
+
+/**
+ * Best fit through the size index. Any block that fits in the lowest candidate bin
+ * is smaller than every block in the bins above it, so the search stops at the
+ * first bin with a fit. Ties go to the lower address, which is the block the
+ * address-ordered walk in allocFromHead would pick.
+ */
+JKRExpHeap::CMemBlock* JKRExpHeap::findIndexedFreeBlock(u32 size, int align, u32* pOffset) {
+    CMemBlock* foundBlock = NULL;
+    u32 foundOffset = 0;
+    u32 mask = mFreeBinMask & (0xFFFFFFFF << getFreeBin(size));
+
+    while (mask != 0) {
+        int bin = 31 - __cntlzw(mask & -mask);
+        for (CMemBlock* block = mFreeBins[bin]; block; block = getFreeLink(block)->mNext) {
+            u32 offset = 0;
+            if (align > 4) {
+                offset = ALIGN_PREV(align - 1 + (uintptr_t)block->getContent(), align) -
+                         (uintptr_t)block->getContent();
+            }
+            if (block->size < size + offset) {
+                continue;
+            }
+
+            if (foundBlock == NULL || block->size < foundBlock->size ||
+                (block->size == foundBlock->size && block < foundBlock))
+            {
+                foundBlock = block;
+                foundOffset = offset;
+            }
+        }
+
+        if (foundBlock != NULL) {
+            break;
+        }
+        mask &= mask - 1;
+    }
+
+    *pOffset = foundOffset;
+    return foundBlock;
+}
+
+bool JKRExpHeap::checkFreeIndex() {
+    bool ok = true;
+    int freeCount = 0;
+    for (CMemBlock* block = mHeadFreeList; block; block = block->mNext) {
+        if (isIndexedSize(block->size)) {
+            freeCount++;
+        }
+    }
+
+    int indexCount = 0;
+    for (int i = 0; i < FREE_BIN_NUM; i++) {
+        if ((mFreeBins[i] != NULL) != ((mFreeBinMask >> i) & 1)) {
+            ok = false;
+            JUTWarningConsole_f(":::bin %d: bad bin mask (%08x)\n", i, mFreeBinMask);
+        }
+
+        CMemBlock* prev = NULL;
+        for (CMemBlock* block = mFreeBins[i]; block; block = getFreeLink(block)->mNext) {
+            if (!isIndexedSize(block->size) || getFreeBin(block->size) != i) {
+                ok = false;
+                JUTWarningConsole_f(":::addr %08x: bad bin (%d, %08x)\n", block, i, block->size);
+                break;
+            }
+            if (getFreeLink(block)->mPrev != prev) {
+                ok = false;
+                JUTWarningConsole_f(":::addr %08x: bad bin previous pointer (%08x)\n", block,
+                                    getFreeLink(block)->mPrev);
+                break;
+            }
+            prev = block;
+            indexCount++;
+        }
+    }
+
+    if (indexCount != freeCount) {
+        ok = false;
+        JUTWarningConsole_f(":::bad free index count (%d, %d)\n", freeCount, indexCount);
+    }
+
+    return ok;
 }
+#endif
 
 bool JKRExpHeap::check() {
     lock();
@@ -868,11 +1120,23 @@ bool JKRExpHeap::check() {
         if (mCheckMemoryFilled) {
             u8* local_34 = (u8*)block->getContent();
             u32 local_38 = block->size;
+#if ENABLE_EXPHEAP_SIZE_INDEX
+            if (isIndexedSize(local_38)) {
+                local_34 += sizeof(JKRExpHeapFreeLink);
+                local_38 -= sizeof(JKRExpHeapFreeLink);
+            }
+#endif
             ok = JKRHeap::checkMemoryFilled(local_34, local_38, JKRValue_DEBUGFILL_DELETE);
         }
 #endif
     }
 
+#if ENABLE_EXPHEAP_SIZE_INDEX
+    if (!checkFreeIndex()) {
+        ok = false;
+    }
+#endif
+
     if (totalBytes != mSize) {
         ok = false;
         JUTWarningConsole_f(":::bad total memory block size (%08X, %08X)\n", mSize, totalBytes);
@@ -10,6 +10,9 @@
 #include "JSystem/JUtility/JUTException.h"
 #include <stdint.h>
 #include <cstring>
+#if ENABLE_HEAP_TRACE
+#include <vi.h>
+#endif
 
 #if DEBUG
 u8 JKRValue_DEBUGFILL_NOTUSE = 0xFD;
@@ -66,6 +69,9 @@ JKRHeap::JKRHeap(void* data, u32 size, JKRHeap* parent, bool errorFlag)
 }
 
 JKRHeap::~JKRHeap() {
+#if ENABLE_HEAP_TRACE
+    trace(JKRHeapTraceRecord::TYPE_DESTROY, NULL, 0, 0);
+#endif
     mChildTree.getParent()->removeChild(&mChildTree);
     JSUTree<JKRHeap>* nextRootHeap = sRootHeap->mChildTree.getFirstChild();
 
@@ -141,6 +147,143 @@ bool JKRHeap::initArena2(char** memory, u32* size, int maxHeaps) {
 }
 #endif
 
+#if ENABLE_HEAP_TRACE
+JKRHeapTraceHeader* JKRHeap::sTraceBuffer;
+
+u32 JKRHeap::sTraceCapacity;
+
+u16 JKRHeap::sTraceTag[JKR_HEAP_TRACE_TAG_THREAD_MAX];
+
+OSThread* JKRHeap::sTraceTagThread[JKR_HEAP_TRACE_TAG_THREAD_MAX];
+
+/**
+ * Starts recording heap operations into a caller-owned buffer. The buffer must
+ * not come from a traced heap operation that is still in flight; recording
+ * stops silently (counting dropped records) once the buffer is full.
+ */
+bool JKRHeap::startTrace(void* buffer, u32 size) {
+    if (buffer == NULL || size < sizeof(JKRHeapTraceHeader)) {
+        return false;
+    }
+
+    JKRHeapTraceHeader* header = (JKRHeapTraceHeader*)buffer;
+    header->mMagic = 'HTRC';
+    header->mVersion = 1;
+    header->mCount = 0;
+    header->mDropped = 0;
+
+    BOOL interrupts = OSDisableInterrupts();
+    sTraceCapacity = (size - sizeof(JKRHeapTraceHeader)) / sizeof(JKRHeapTraceRecord);
+    sTraceBuffer = header;
+    OSRestoreInterrupts(interrupts);
+    return true;
+}
+
+/**
+ * Stops recording and returns the number of records written.
+ */
+u32 JKRHeap::stopTrace() {
+    BOOL interrupts = OSDisableInterrupts();
+    JKRHeapTraceHeader* header = sTraceBuffer;
+    sTraceBuffer = NULL;
+    OSRestoreInterrupts(interrupts);
+
+    return header != NULL ? header->mCount : 0;
+}
+
+/**
+ * Sets the caller tag stored with subsequent records (e.g. a process name).
+ * Each thread has its own tag, so a tagged scope on the DVD thread neither
+ * clears nor takes over the main thread's tag. Returns the calling thread's
+ * previous tag so callers can restore it.
+ */
+u16 JKRHeap::setTraceTag(u16 tag) {
+    OSThread* thread = OSGetCurrentThread();
+
+    BOOL interrupts = OSDisableInterrupts();
+    int slot = -1;
+    u16 prev = 0;
+    for (int i = 0; i < JKR_HEAP_TRACE_TAG_THREAD_MAX; i++) {
+        if (sTraceTagThread[i] == thread) {
+            slot = i;
+            prev = sTraceTag[i];
+            break;
+        }
+        if (sTraceTagThread[i] == NULL && slot < 0) {
+            slot = i;
+        }
+    }
+
+    if (slot >= 0) {
+        // A thread whose tag goes back to 0 gives up its slot.
+        sTraceTag[slot] = tag;
+        sTraceTagThread[slot] = tag != 0 ? thread : NULL;
+    }
+    OSRestoreInterrupts(interrupts);
+
+    if (slot < 0) {
+        JUT_WARN(__LINE__, "%s", "heap trace tag threads full\n");
+    }
+    return prev;
+}
+
+/**
+ * Returns the calling thread's trace tag, or 0 if it has none.
+ */
+u16 JKRHeap::getTraceTag() {
+    OSThread* thread = OSGetCurrentThread();
+    for (int i = 0; i < JKR_HEAP_TRACE_TAG_THREAD_MAX; i++) {
+        if (sTraceTagThread[i] == thread) {
+            return sTraceTag[i];
+        }
+    }
+    return 0;
+}
+
+void JKRHeap::trace(u8 type, void* address, u32 size, s32 param) {
+    if (sTraceBuffer == NULL) {
+        return;
+    }
+
+    BOOL interrupts = OSDisableInterrupts();
+    JKRHeapTraceHeader* header = sTraceBuffer;
+    if (header == NULL) {
+        OSRestoreInterrupts(interrupts);
+        return;
+    }
+    if (header->mCount >= sTraceCapacity) {
+        header->mDropped++;
+        OSRestoreInterrupts(interrupts);
+        return;
+    }
+
+    JKRHeapTraceRecord* record = (JKRHeapTraceRecord*)(header + 1) + header->mCount;
+    header->mCount++;
+    record->mType = type;
+    record->mGroupId = type == JKRHeapTraceRecord::TYPE_DESTROY ? 0 : getCurrentGroupId();
+    if (type == JKRHeapTraceRecord::TYPE_CREATE) {
+        record->mTag = getHeapType() >> 16;
+    } else {
+        record->mTag = getTraceTag();
+    }
+    record->mFrame = VIGetRetraceCount();
+    record->mHeap = (uintptr_t)this;
+    record->mAddress = (uintptr_t)address;
+    record->mSize = size;
+    record->mParam = param;
+    OSRestoreInterrupts(interrupts);
+}
+
+/**
+ * Records the heap's creation. Called from the end of each concrete heap's
+ * constructor, where getHeapType() already resolves to the final class.
+ */
+void JKRHeap::traceCreate() {
+    JKRHeap* parent = mChildTree.getParent() != NULL ? getParent() : NULL;
+    trace(JKRHeapTraceRecord::TYPE_CREATE, mStart, mSize, (uintptr_t)parent);
+}
+#endif
+
 JKRHeap* JKRHeap::becomeSystemHeap() {
     JKRHeap* prev = sSystemHeap;
     sSystemHeap = this;
@@ -182,6 +325,9 @@ void* JKRHeap::alloc(u32 size, int alignment) {
     if (sAllocCallback) {
         sAllocCallback(size, alignment, this, mem);
     }
+#endif
+#if ENABLE_HEAP_TRACE
+    trace(JKRHeapTraceRecord::TYPE_ALLOC, mem, size, alignment);
 #endif
     return mem;
 }
@@ -204,6 +350,9 @@ void JKRHeap::free(void* ptr) {
     if (sFreeCallback) {
         sFreeCallback(ptr, this);
     }
+#endif
+#if ENABLE_HEAP_TRACE
+    trace(JKRHeapTraceRecord::TYPE_FREE, ptr, 0, 0);
 #endif
     do_free(ptr);
 }
@@ -221,6 +370,9 @@ void JKRHeap::freeAll() {
         JUT_WARN(493, "freeAll in heap %x", this);
     }
     do_freeAll();
+#if ENABLE_HEAP_TRACE
+    trace(JKRHeapTraceRecord::TYPE_FREE_ALL, NULL, 0, 0);
+#endif
 }
 
 void JKRHeap::freeTail() {
@@ -228,6 +380,9 @@ void JKRHeap::freeTail() {
         JUT_WARN(507, "freeTail in heap %x", this);
     }
     do_freeTail();
+#if ENABLE_HEAP_TRACE
+    trace(JKRHeapTraceRecord::TYPE_FREE_TAIL, NULL, 0, 0);
+#endif
 }
 
 static void dummy2() {
@@ -248,7 +403,13 @@ s32 JKRHeap::resize(void* ptr, u32 size) {
     if (mInitFlag) {
         JUT_WARN(567, "resize block %x into %x in heap %x", ptr, size, this);
     }
+#if ENABLE_HEAP_TRACE
+    s32 result = do_resize(ptr, size);
+    trace(JKRHeapTraceRecord::TYPE_RESIZE, ptr, size, result);
+    return result;
+#else
     return do_resize(ptr, size);
+#endif
 }
 
 s32 JKRHeap::getSize(void* ptr, JKRHeap* heap) {
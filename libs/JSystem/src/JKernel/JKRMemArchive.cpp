@@ -19,6 +19,9 @@ JKRMemArchive::JKRMemArchive(s32 entryNum, JKRArchive::EMountDirection mountDire
 
     mVolumeType = 'RARC';
     mVolumeName = mStringTable + mNodes->name_offset;
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
 
     sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
@@ -33,6 +36,9 @@ JKRMemArchive::JKRMemArchive(void* buffer, u32 bufferSize, JKRMemBreakFlag param
 
     mVolumeType = 'RARC';
     mVolumeName = mStringTable + mNodes->name_offset;
+#if ENABLE_ARCHIVE_INDEX
+    createIndex();
+#endif
 
     sVolumeList.prepend(&mFileLoaderLink);
     mIsMounted = true;
@@ -127,6 +133,9 @@ void* JKRMemArchive::fetchResource(SDIFileEntry* fileEntry, u32* resourceSize) {
     JUT_ASSERT(555, isMounted());
     if (!fileEntry->data) {
         fileEntry->data = mArchiveData + fileEntry->data_offset;
+#if ENABLE_ARCHIVE_INDEX
+        entryPtrIndex(fileEntry);
+#endif
     }
 
     if (resourceSize) {
@@ -173,6 +182,9 @@ void JKRMemArchive::removeResourceAll(void) {
     SDIFileEntry* fileEntry = mFiles;
     for (int i = 0; i < mArcInfoBlock->num_file_entries; i++) {
         if (fileEntry->data) {
+#if ENABLE_ARCHIVE_INDEX
+            removePtrIndex(fileEntry);
+#endif
             fileEntry->data = NULL;
         }
     }
@@ -186,6 +198,9 @@ bool JKRMemArchive::removeResource(void* resource) {
     if (!fileEntry)
         return false;
 
+#if ENABLE_ARCHIVE_INDEX
+    removePtrIndex(fileEntry);
+#endif
     fileEntry->data = NULL;
     return true;
 }
@@ -49,6 +49,9 @@ JKRSolidHeap::JKRSolidHeap(void* start, u32 size, JKRHeap* parent, bool useError
         JKRFillMemory(mStart, mSize, JKRValue_DEBUGFILL_NOTUSE);
     }
 #endif
+#if ENABLE_HEAP_TRACE
+    traceCreate();
+#endif
 }
 
 JKRSolidHeap::~JKRSolidHeap(void) {
@@ -51,12 +51,22 @@ void JPABaseEmitter::init(JPAEmitterManager* param_0, JPAResource* param_1) {
 }
 
 JPABaseParticle* JPABaseEmitter::createParticle() {
+#if ENABLE_JPA_PARALLEL_CALC
+    JPANode<JPABaseParticle>* node = mpEmtrMgr->popParticle(this);
+    if (node != NULL) {
+        JPAEmitterWorkData* work = mpEmtrMgr->getWorkData();
+        mAlivePtclBase.push_front(node);
+        pRes->getDyn()->calc(work);
+        node->getObject()->init_p(work);
+        return node->getObject();
+#else
     if (mpPtclPool->getNum() != 0) {
         JPANode<JPABaseParticle>* node = mpPtclPool->pop_front();
         mAlivePtclBase.push_front(node);
         pRes->getDyn()->calc(mpEmtrMgr->pWd);
         node->getObject()->init_p(mpEmtrMgr->pWd);
         return node->getObject();
+#endif
     } else {
         JUT_WARN(128, "%s", "JPA : Can NOT create particle more\n");
     }
@@ -65,11 +75,19 @@ JPABaseParticle* JPABaseEmitter::createParticle() {
 }
 
 JPABaseParticle* JPABaseEmitter::createChild(JPABaseParticle* parent) {
+#if ENABLE_JPA_PARALLEL_CALC
+    JPANode<JPABaseParticle>* node = mpEmtrMgr->popParticle(this);
+    if (node != NULL) {
+        mAlivePtclChld.push_front(node);
+        node->getObject()->init_c(mpEmtrMgr->getWorkData(), parent);
+        return node->getObject();
+#else
     if (mpPtclPool->getNum() != 0) {
         JPANode<JPABaseParticle>* node = mpPtclPool->pop_front();
         mAlivePtclChld.push_front(node);
         node->getObject()->init_c(mpEmtrMgr->pWd, parent);
         return node->getObject();
+#endif
     } else {
         JUT_WARN(151, "%s", "JPA : Can NOT create child particle more\n")
     }
@@ -78,10 +96,17 @@ JPABaseParticle* JPABaseEmitter::createChild(JPABaseParticle* parent) {
 }
 
 void JPABaseEmitter::deleteAllParticle() {
+#if ENABLE_JPA_PARALLEL_CALC
+    while (mAlivePtclBase.getNum())
+        mpEmtrMgr->pushParticle(this, mAlivePtclBase.pop_back());
+    while (mAlivePtclChld.getNum())
+        mpEmtrMgr->pushParticle(this, mAlivePtclChld.pop_back());
+#else
     while (mAlivePtclBase.getNum())
         mpPtclPool->push_front(mAlivePtclBase.pop_back());
     while (mAlivePtclChld.getNum())
         mpPtclPool->push_front(mAlivePtclChld.pop_back());
+#endif
 }
 
 bool JPABaseEmitter::processTillStartFrame() {
@@ -19,6 +19,16 @@ JPAEmitterManager::JPAEmitterManager(u32 i_ptclNum, u32 i_emtrNum, JKRHeap* pHea
 
     JPABaseEmitter* p_emtr_link = new (pHeap, 0) JPABaseEmitter[emtrNum];
     JUT_ASSERT(44, p_emtr_link);
+#if ENABLE_JPA_PARALLEL_CALC
+    mpEmtrAry = p_emtr_link;
+    mpCalcSlot = NULL;
+    mpCalcResult = NULL;
+    mpPtclFreed = NULL;
+    mCalcWorking = false;
+    for (int i = 0; i < JPA_CALC_WORKER_NUM; i++) {
+        mpCalcWorker[i] = NULL;
+    }
+#endif
     for (u32 i = 0; i < emtrNum; i++)
         mFreeEmtrList.prepend(&p_emtr_link[i].mLink);
 
@@ -72,6 +82,12 @@ JPABaseEmitter* JPAEmitterManager::createSimpleEmitterID(JGeometry::TVec3<f32> c
 
 void JPAEmitterManager::calc(u8 group_id) {
     JUT_ASSERT(154, group_id < gidMax);
+#if ENABLE_JPA_PARALLEL_CALC
+    if (mpCalcSlot != NULL) {
+        calcParallel(group_id);
+        return;
+    }
+#endif
     JSULink<JPABaseEmitter>* pNext = NULL;
     for (JSULink<JPABaseEmitter>* pLink = pEmtrUseList[group_id].getFirst();
          pLink != pEmtrUseList[group_id].getEnd(); pLink = pNext) {
@@ -84,6 +100,225 @@ void JPAEmitterManager::calc(u8 group_id) {
     }
 }
 
+#if ENABLE_JPA_PARALLEL_CALC
+JPAEmitterCalcWorker::JPAEmitterCalcWorker(JPAEmitterManager* mgr, JKRHeap* heap, int priority,
+                                           u8 slot)
+    : JKRThread(heap, 0x4000, 1, priority) {
+    mpMgr = mgr;
+    mSlot = slot;
+    mpWd = new (heap, 0) JPAEmitterWorkData();
+    JUT_ASSERT(__LINE__, mpWd);
+    resume();
+}
+
+void* JPAEmitterCalcWorker::run() {
+    for (;;) {
+        waitMessageBlock();
+        mpMgr->calcSlot(mSlot, mpWd);
+        OSSendMessage(&mpMgr->mCalcDoneQueue, NULL, OS_MESSAGE_BLOCK);
+    }
+}
+
+/**
+ * Switches calc to the parallel mode, with JPA_CALC_WORKER_NUM - 1 worker
+ * threads next to the calling one.
+ */
+void JPAEmitterManager::startCalcWorker(JKRHeap* heap, int priority) {
+    if (mpCalcSlot != NULL) {
+        return;
+    }
+
+    mpCalcResult = new (heap, 0) u8[emtrNum];
+    JUT_ASSERT(__LINE__, mpCalcResult);
+    mpPtclFreed = new (heap, 0) JPAList<JPABaseParticle>[emtrNum];
+    JUT_ASSERT(__LINE__, mpPtclFreed);
+    OSInitMessageQueue(&mCalcDoneQueue, mCalcDoneMsg, JPA_CALC_WORKER_NUM);
+    for (u8 i = 1; i < JPA_CALC_WORKER_NUM; i++) {
+        mpCalcWorker[i] = new (heap, 0) JPAEmitterCalcWorker(this, heap, priority, i);
+        JUT_ASSERT(__LINE__, mpCalcWorker[i]);
+    }
+
+    mpCalcSlot = new (heap, 0) u8[emtrNum];
+    JUT_ASSERT(__LINE__, mpCalcSlot);
+}
+
+/**
+ * Emitters with a callback run on the calling thread, since callbacks reach
+ * into game code. The rest are split by resource, because field blocks keep
+ * per resource scratch, so every emitter of one resource runs on one slot.
+ */
+u8 JPAEmitterManager::getCalcSlot(JPABaseEmitter* emtr) const {
+    if (emtr->getEmitterCallBackPtr() != NULL || emtr->getParticleCallBackPtr() != NULL) {
+        return JPA_CALC_SLOT_MAIN;
+    }
+    return ((uintptr_t)emtr->pRes >> 4) % JPA_CALC_WORKER_NUM;
+}
+
+/**
+ * Same as the serial calc loop, except that runs of emitters without callbacks
+ * are handed to calcRun. Emitters with a callback run on the calling thread in
+ * between, so callbacks see the emitters before and after them just as in
+ * serial calc.
+ */
+void JPAEmitterManager::calcParallel(u8 group_id) {
+    JSULink<JPABaseEmitter>* pNext = NULL;
+    for (JSULink<JPABaseEmitter>* pLink = pEmtrUseList[group_id].getFirst();
+         pLink != pEmtrUseList[group_id].getEnd(); pLink = pNext)
+    {
+        JPABaseEmitter* emtr = pLink->getObject();
+        if (getCalcSlot(emtr) != JPA_CALC_SLOT_MAIN) {
+            pNext = calcRun(pLink);
+            continue;
+        }
+
+        pNext = pLink->getNext();
+        if (emtr->pRes->calc(pWd, emtr) && !emtr->checkStatus(0x200))
+            forceDeleteEmitter(emtr);
+    }
+}
+
+/**
+ * Calculates the emitters from pFirst up to the next one with a callback and
+ * returns the link after them. Runs shorter than JPA_CALC_RUN_MIN are done
+ * serially. Longer ones are spread over the calc slots: each slot takes
+ * particles from a fixed slice of the pool, sized by its share of the run,
+ * and particles freed meanwhile stay with their emitter until every slot is
+ * done. The pool is then put back together in emitter order and finished
+ * emitters are deleted in list order, so the result does not depend on how
+ * the threads were scheduled. A slot can run out of particles while serial
+ * calc would still have found some in the pool.
+ */
+JSULink<JPABaseEmitter>* JPAEmitterManager::calcRun(JSULink<JPABaseEmitter>* pFirst) {
+    u32 slotNum[JPA_CALC_WORKER_NUM];
+    for (int i = 0; i < JPA_CALC_WORKER_NUM; i++) {
+        slotNum[i] = 0;
+    }
+
+    u32 runNum = 0;
+    JSULink<JPABaseEmitter>* pEnd;
+    for (pEnd = pFirst; pEnd != NULL; pEnd = pEnd->getNext()) {
+        JPABaseEmitter* emtr = pEnd->getObject();
+        u8 slot = getCalcSlot(emtr);
+        if (slot == JPA_CALC_SLOT_MAIN) {
+            break;
+        }
+        mpCalcSlot[emtr - mpEmtrAry] = slot;
+        slotNum[slot]++;
+        runNum++;
+    }
+
+    JSULink<JPABaseEmitter>* pNext = NULL;
+    JSULink<JPABaseEmitter>* pLink;
+    if (runNum < JPA_CALC_RUN_MIN) {
+        for (pLink = pFirst; pLink != pEnd; pLink = pNext) {
+            pNext = pLink->getNext();
+
+            JPABaseEmitter* emtr = pLink->getObject();
+            if (emtr->pRes->calc(pWd, emtr) && !emtr->checkStatus(0x200))
+                forceDeleteEmitter(emtr);
+        }
+        return pEnd;
+    }
+
+    u32 freeNum = mPtclPool.getNum();
+    u32 sliceNum[JPA_CALC_WORKER_NUM];
+    sliceNum[0] = freeNum;
+    for (int i = 1; i < JPA_CALC_WORKER_NUM; i++) {
+        sliceNum[i] = freeNum * slotNum[i] / runNum;
+        sliceNum[0] -= sliceNum[i];
+    }
+    for (int i = 0; i < JPA_CALC_WORKER_NUM; i++) {
+        for (u32 j = 0; j < sliceNum[i]; j++) {
+            mPtclSlice[i].push_back(mPtclPool.pop_front());
+        }
+    }
+
+    mpCalcFirst = pFirst;
+    mpCalcEnd = pEnd;
+    mCalcWorking = true;
+    for (int i = 1; i < JPA_CALC_WORKER_NUM; i++) {
+        *mpCalcWorker[i]->mpWd = *pWd;
+        mpCalcWorker[i]->sendMessageBlock(NULL);
+    }
+    calcSlot(0, pWd);
+    for (int i = 1; i < JPA_CALC_WORKER_NUM; i++) {
+        OSMessage msg;
+        OSReceiveMessage(&mCalcDoneQueue, &msg, OS_MESSAGE_BLOCK);
+    }
+    mCalcWorking = false;
+
+    for (int i = JPA_CALC_WORKER_NUM - 1; i >= 0; i--) {
+        while (mPtclSlice[i].getNum()) {
+            mPtclPool.push_front(mPtclSlice[i].pop_back());
+        }
+    }
+    for (pLink = pFirst; pLink != pEnd; pLink = pNext) {
+        pNext = pLink->getNext();
+
+        JPABaseEmitter* emtr = pLink->getObject();
+        u32 idx = emtr - mpEmtrAry;
+        while (mpPtclFreed[idx].getNum()) {
+            mPtclPool.push_front(mpPtclFreed[idx].pop_front());
+        }
+        if (mpCalcResult[idx] && !emtr->checkStatus(0x200)) {
+            forceDeleteEmitter(emtr);
+        }
+    }
+    return pEnd;
+}
+
+void JPAEmitterManager::calcSlot(u8 slot, JPAEmitterWorkData* work) {
+    for (JSULink<JPABaseEmitter>* pLink = mpCalcFirst; pLink != mpCalcEnd;
+         pLink = pLink->getNext())
+    {
+        JPABaseEmitter* emtr = pLink->getObject();
+        u32 idx = emtr - mpEmtrAry;
+        if (mpCalcSlot[idx] == slot) {
+            mpCalcResult[idx] = emtr->pRes->calc(work, emtr);
+        }
+    }
+}
+
+/** Work data of the calc slot running on the current thread. */
+JPAEmitterWorkData* JPAEmitterManager::getWorkData() const {
+    OSThread* thread = OSGetCurrentThread();
+    for (int i = 1; i < JPA_CALC_WORKER_NUM; i++) {
+        if (mpCalcWorker[i] != NULL && mpCalcWorker[i]->getThreadRecord() == thread) {
+            return mpCalcWorker[i]->mpWd;
+        }
+    }
+    return pWd;
+}
+
+/**
+ * Takes a particle for emtr, or returns NULL when there is none left. While
+ * the slots run, an emitter first reuses the particles it freed itself, last
+ * freed first like the pool, then takes from the slice of its slot.
+ */
+JPANode<JPABaseParticle>* JPAEmitterManager::popParticle(JPABaseEmitter* emtr) {
+    JPAList<JPABaseParticle>* pool = &mPtclPool;
+    if (mCalcWorking) {
+        u32 idx = emtr - mpEmtrAry;
+        if (mpPtclFreed[idx].getNum() != 0) {
+            return mpPtclFreed[idx].pop_back();
+        }
+        pool = &mPtclSlice[mpCalcSlot[idx]];
+    }
+    if (pool->getNum() == 0) {
+        return NULL;
+    }
+    return pool->pop_front();
+}
+
+void JPAEmitterManager::pushParticle(JPABaseEmitter* emtr, JPANode<JPABaseParticle>* node) {
+    if (mCalcWorking) {
+        mpPtclFreed[emtr - mpEmtrAry].push_back(node);
+    } else {
+        mPtclPool.push_front(node);
+    }
+}
+#endif
+
 void JPAEmitterManager::draw(JPADrawInfo const* drawInfo, u8 group_id) {
     JUT_ASSERT(192, group_id < gidMax);
     drawInfo->getCamMtx(pWd->mPosCamMtx);
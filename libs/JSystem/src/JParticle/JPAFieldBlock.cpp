@@ -198,6 +198,97 @@ void JPAFieldSpin::calc(JPAEmitterWorkData* work, JPAFieldBlock* block, JPABaseP
     calcAffect(block, ptcl);
 }
 
+#if ENABLE_JPA_FIELD_BATCH
+static JGeometry::TVec3<f32> JPABaseParticle::* const l_fieldAddVel[3] = {
+    &JPABaseParticle::mVelType0,
+    &JPABaseParticle::mVelType1,
+    &JPABaseParticle::mVelType2,
+};
+
+/**
+ * Batched calcAffect for a field whose acceleration is the same for every
+ * particle.
+ */
+static void JPAFieldBatch_affect(JPAFieldBase* fld, JPAFieldBlock* block, JPAFieldBatch* batch) {
+    u32 add_type = block->getAddType();
+    if (add_type > 2) {
+        return;
+    }
+
+    JGeometry::TVec3<f32> JPABaseParticle::* vel = l_fieldAddVel[add_type];
+    if (!block->checkStatus(0x78)) {
+        for (u32 i = 0; i < batch->mNum; i++) {
+            (batch->mpPtcl[i]->*vel).add(fld->mAccel);
+        }
+        return;
+    }
+
+    for (u32 i = 0; i < batch->mNum; i++) {
+        JPABaseParticle* ptcl = batch->mpPtcl[i];
+        JGeometry::TVec3<f32> vec = fld->mAccel;
+        if (!ptcl->checkStatus(4)) {
+            vec.scale(fld->calcFadeAffect(block, ptcl->mTime));
+        }
+        (ptcl->*vel).add(vec);
+    }
+}
+
+bool JPAFieldBlock::isBatchable() const {
+    switch (getType()) {
+    case FIELD_GRAVITY:
+    case FIELD_AIR:
+    case FIELD_VORTEX:
+    case FIELD_DRAG:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Applies this field to every particle in the batch. Same results as
+ * calling calc for each particle in turn; only the types accepted by
+ * isBatchable are handled.
+ */
+void JPAFieldBlock::calcBatch(JPAFieldBatch* batch) {
+    switch (getType()) {
+    case FIELD_GRAVITY:
+        JPAFieldBatch_affect(pFld, this, batch);
+        break;
+    case FIELD_AIR:
+        JPAFieldBatch_affect(pFld, this, batch);
+        if (checkStatus(4)) {
+            for (u32 i = 0; i < batch->mNum; i++) {
+                JPABaseParticle* ptcl = batch->mpPtcl[i];
+                f32 len = ptcl->mVelType1.length();
+                if (len > getMagRndm()) {
+                    ptcl->mVelType1.scale(getMagRndm() / len);
+                }
+            }
+        }
+        break;
+    case FIELD_VORTEX: {
+        JPAFieldVortex* vortex = (JPAFieldVortex*)pFld;
+        for (u32 i = 0; i < batch->mNum; i++) {
+            vortex->JPAFieldVortex::calc(NULL, this, batch->mpPtcl[i]);
+        }
+        break;
+    }
+    case FIELD_DRAG:
+        for (u32 i = 0; i < batch->mNum; i++) {
+            JPABaseParticle* ptcl = batch->mpPtcl[i];
+            if (!ptcl->checkStatus(4)) {
+                f32 fade = pFld->calcFadeAffect(this, ptcl->mTime);
+                ptcl->mDrag *= 1.0f - fade * (1.0f - getMag());
+            } else {
+                ptcl->mDrag *= getMag();
+            }
+        }
+        break;
+    }
+}
+#endif
+
 JPAFieldBlock::JPAFieldBlock(u8 const* data, JKRHeap* heap)
     : mpData((const JPAFieldBlockData*)data) {
     init(heap);
@@ -292,6 +292,70 @@ bool JPABaseParticle::calc_c(JPAEmitterWorkData* work) {
     return false;
 }
 
+#if ENABLE_JPA_FIELD_BATCH
+/**
+ * calc_p/calc_c split around the field pass for JPAResource::calcParticleBatch.
+ * Only used for emitters without a particle callback, so the callback call
+ * between the two halves is dropped. Returns true when the particle expired.
+ */
+bool JPABaseParticle::calcBatchBefore(JPAEmitterWorkData* work, bool child) {
+    if (++mAge >= mLifeTime) {
+        return true;
+    }
+    mTime = (f32)mAge / (f32)mLifeTime;
+
+    if (child && mAge == 0) {
+        return false;
+    }
+
+    if (checkStatus(0x20)) {
+        mOffsetPosition.set(work->mGlobalPos);
+    }
+
+    if (child) {
+        mVelType1.y -= work->mpRes->getCsp()->getGravity();
+    }
+    mVelType2.zero();
+    return false;
+}
+
+bool JPABaseParticle::calcBatchAfter(JPAEmitterWorkData* work, bool child) {
+    if (!child || mAge != 0) {
+        mVelType2.add(mVelType0);
+        mVelType1.scale(work->mpEmtr->mAirResist);
+        f32 ratio = mMoment * mDrag;
+        mVelocity.set(ratio * (mVelType1.x + mVelType2.x),
+                      ratio * (mVelType1.y + mVelType2.y),
+                      ratio * (mVelType1.z + mVelType2.z));
+    }
+
+    if (checkStatus(2)) {
+        return true;
+    }
+
+    if (!child) {
+        work->mpRes->calc_p(work, this);
+        mRotateAngle += mRotateSpeed;
+
+        if (work->mpRes->getCsp() != NULL && canCreateChild(work)) {
+            for (int i = work->mpRes->getCsp()->getRate(); i > 0; i--) {
+                work->mpEmtr->createChild(this);
+            }
+        }
+    } else {
+        work->mpRes->calc_c(work, this);
+        mRotateAngle += mRotateSpeed;
+    }
+
+    mLocalPosition.add(mVelocity);
+    mPosition.set(mOffsetPosition.x + mLocalPosition.x * work->mPublicScale.x,
+                  mOffsetPosition.y + mLocalPosition.y * work->mPublicScale.y,
+                  mOffsetPosition.z + mLocalPosition.z * work->mPublicScale.z);
+
+    return false;
+}
+#endif
+
 bool JPABaseParticle::canCreateChild(JPAEmitterWorkData* work) {
     JPAChildShape* csp = work->mpRes->getCsp();
     bool ret = false;
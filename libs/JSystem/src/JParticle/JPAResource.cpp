@@ -13,6 +13,9 @@
 #include "JSystem/JParticle/JPAResourceManager.h"
 #include <gx.h>
 #include "global.h"
+#if ENABLE_JPA_PARALLEL_CALC
+#include "JSystem/JParticle/JPAEmitterManager.h"
+#endif
 
 JPAResource::JPAResource() {
     mpCalcEmitterFuncList = mpDrawEmitterFuncList = mpDrawEmitterChildFuncList = NULL;
@@ -754,18 +757,35 @@ bool JPAResource::calc(JPAEmitterWorkData* work, JPABaseEmitter* emtr) {
             }
         }
 
+#if ENABLE_JPA_FIELD_BATCH
+        if (isFieldBatchable(emtr)) {
+            calcParticleBatch(work, &emtr->mAlivePtclBase, false);
+            calcParticleBatch(work, &emtr->mAlivePtclChld, true);
+            emtr->mTick++;
+            return false;
+        }
+#endif
+
         JPANode<JPABaseParticle>* next = NULL;
         for (JPANode<JPABaseParticle>* node = emtr->mAlivePtclBase.getFirst(); node != emtr->mAlivePtclBase.getEnd(); node = next) {
             next = node->getNext();
             if (node->getObject()->calc_p(work)) {
+#if ENABLE_JPA_PARALLEL_CALC
+                emtr->mpEmtrMgr->pushParticle(emtr, emtr->mAlivePtclBase.erase(node));
+#else
                 emtr->mpPtclPool->push_front(emtr->mAlivePtclBase.erase(node));
+#endif
             }
         }
 
         for (JPANode<JPABaseParticle>* node = emtr->mAlivePtclChld.getFirst(); node != emtr->mAlivePtclChld.getEnd(); node = next) {
             next = node->getNext();
             if (node->getObject()->calc_c(work)) {
+#if ENABLE_JPA_PARALLEL_CALC
+                emtr->mpEmtrMgr->pushParticle(emtr, emtr->mAlivePtclChld.erase(node));
+#else
                 emtr->mpPtclPool->push_front(emtr->mAlivePtclChld.erase(node));
+#endif
             }
         }
 
@@ -1008,6 +1028,70 @@ void JPAResource::calcField(JPAEmitterWorkData* work, JPABaseParticle* ptcl) {
     }
 }
 
+#if ENABLE_JPA_FIELD_BATCH
+/**
+ * The batched path needs every field to have a batch kernel, and no
+ * particle callback, since the callback runs between the fields and the
+ * rest of calc_p and may look at other particles.
+ */
+bool JPAResource::isFieldBatchable(JPABaseEmitter* emtr) const {
+    if (emtr->mpPtclCallBack != NULL) {
+        return false;
+    }
+
+    for (int i = fldNum - 1; i >= 0; i--) {
+        if (!ppFld[i]->isBatchable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Same as the calc_p/calc_c loops in calc, but runs the fields one at a
+ * time over batches of JPA_FIELD_BATCH_MAX particles. Everything after the
+ * fields (calc funcs, child creation, freeing) still runs per particle in
+ * list order, so random numbers and pool use happen in the same order.
+ */
+void JPAResource::calcParticleBatch(JPAEmitterWorkData* work, JPAList<JPABaseParticle>* list,
+                                    bool child) {
+    JPAFieldBatch batch;
+    JPANode<JPABaseParticle>* nodes[JPA_FIELD_BATCH_MAX];
+    u8 expired[JPA_FIELD_BATCH_MAX];
+
+    JPANode<JPABaseParticle>* node = list->getFirst();
+    while (node != list->getEnd()) {
+        int num = 0;
+        batch.clear();
+        for (; node != list->getEnd() && num < JPA_FIELD_BATCH_MAX; node = node->getNext()) {
+            JPABaseParticle* ptcl = node->getObject();
+            nodes[num] = node;
+            expired[num] = ptcl->calcBatchBefore(work, child);
+            if (!expired[num] && (!child || ptcl->mAge != 0) && !ptcl->checkStatus(0x40)) {
+                batch.add(ptcl);
+            }
+            num++;
+        }
+
+        if (batch.mNum != 0) {
+            for (int i = fldNum - 1; i >= 0; i--) {
+                ppFld[i]->calcBatch(&batch);
+            }
+        }
+
+        for (int i = 0; i < num; i++) {
+            if (expired[i] || nodes[i]->getObject()->calcBatchAfter(work, child)) {
+#if ENABLE_JPA_PARALLEL_CALC
+                work->mpEmtr->mpEmtrMgr->pushParticle(work->mpEmtr, list->erase(nodes[i]));
+#else
+                work->mpEmtr->mpPtclPool->push_front(list->erase(nodes[i]));
+#endif
+            }
+        }
+    }
+}
+#endif
+
 void JPAResource::calcKey(JPAEmitterWorkData* work) {
     for (int i = keyNum - 1; i >= 0; i--) {
         f32 val = ppKey[i]->calc(work->mpEmtr->mTick);
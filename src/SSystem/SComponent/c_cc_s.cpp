@@ -5,10 +5,110 @@
 
 #include "SSystem/SComponent/c_cc_s.h"
 #include "JSystem/JUtility/JUTAssert.h"
+#if ENABLE_CCS_BROADPHASE
+#include <cstring>
+#endif
 
 #define CHECK_FLOAT_CLASS(line, x) JUT_ASSERT(line, !isnan(x));
 #define CHECK_FLOAT_RANGE(line, x) JUT_ASSERT(line, -1.0e32f < x && x < 1.0e32f);
 
+#if ENABLE_CCS_BROADPHASE
+/**
+ * Broadphase over the 32 cells per axis that cCcD_DivideArea assigns to each
+ * object. Row [axis][cell] holds a bit per list index of the objects covering
+ * that cell; row [axis][32] is the union of all cells. ORing the rows of the
+ * cells an object covers and ANDing the three axes yields exactly the objects
+ * that pass cCcD_DivideInfo::Chk against it, which are then visited in list
+ * order so hit order is unchanged.
+ */
+enum {
+    CCS_CELL_NUM = 32,
+    CCS_CELL_ROW_NUM = CCS_CELL_NUM + 1,
+    CCS_TG_WORD_NUM = 0x300 / 32,
+    CCS_CO_WORD_NUM = 0x100 / 32,
+};
+
+static u32 l_tgCell[3 * CCS_CELL_ROW_NUM * CCS_TG_WORD_NUM];
+static u32 l_coCell[3 * CCS_CELL_ROW_NUM * CCS_CO_WORD_NUM];
+
+static inline u32 cCcS_GetDivInfo(const cCcD_DivideInfo& info, int axis) {
+    if (axis == 0) {
+        return info.GetXDivInfo();
+    } else if (axis == 1) {
+        return info.GetYDivInfo();
+    } else {
+        return info.GetZDivInfo();
+    }
+}
+
+static void cCcS_SetCell(u32* cells, int words, cCcD_Obj** objs, int num) {
+    memset(cells, 0, 3 * CCS_CELL_ROW_NUM * words * sizeof(u32));
+
+    for (int i = 0; i < num; i++) {
+        if (objs[i] == NULL) {
+            continue;
+        }
+
+        u32 bit = 1 << (i & 31);
+        const cCcD_DivideInfo& info = objs[i]->GetDivideInfo();
+        for (int axis = 0; axis < 3; axis++) {
+            u32* row = cells + axis * CCS_CELL_ROW_NUM * words;
+            u32 div = cCcS_GetDivInfo(info, axis);
+            if (div != 0) {
+                row[CCS_CELL_NUM * words + (i >> 5)] |= bit;
+            }
+            while (div != 0) {
+                int cell = 31 - __cntlzw(div);
+                div &= ~(1 << cell);
+                row[cell * words + (i >> 5)] |= bit;
+            }
+        }
+    }
+}
+
+static void cCcS_GetCellCandidate(const u32* cells, int words, const cCcD_DivideInfo& info,
+                                  u32* o_cand) {
+    for (int axis = 0; axis < 3; axis++) {
+        const u32* row = cells + axis * CCS_CELL_ROW_NUM * words;
+        u32 div = cCcS_GetDivInfo(info, axis);
+        u32 tmp[CCS_TG_WORD_NUM];
+
+        if (div == 0xFFFFFFFF) {
+            for (int w = 0; w < words; w++) {
+                tmp[w] = row[CCS_CELL_NUM * words + w];
+            }
+        } else {
+            for (int w = 0; w < words; w++) {
+                tmp[w] = 0;
+            }
+            while (div != 0) {
+                int cell = 31 - __cntlzw(div);
+                div &= ~(1 << cell);
+                for (int w = 0; w < words; w++) {
+                    tmp[w] |= row[cell * words + w];
+                }
+            }
+        }
+
+        for (int w = 0; w < words; w++) {
+            o_cand[w] = axis == 0 ? tmp[w] : (o_cand[w] & tmp[w]);
+        }
+    }
+}
+
+/** Pops the lowest candidate index at or after word *p_word, or returns -1. */
+static inline int cCcS_PopCandidate(u32* cand, int* p_word, int words) {
+    for (; *p_word < words; (*p_word)++) {
+        u32 bits = cand[*p_word];
+        if (bits != 0) {
+            cand[*p_word] = bits & (bits - 1);
+            return (*p_word << 5) + (31 - __cntlzw(bits & -bits));
+        }
+    }
+    return -1;
+}
+#endif
+
 cCcS::cCcS() {}
 
 void cCcS::Ct() {
@@ -148,6 +248,10 @@ void cCcS::ChkAtTg() {
     cCcD_Obj** objTgEnd = mpObjTg + mObjTgCount;
     ClrAtHitInf();
     ClrTgHitInf();
+#if ENABLE_CCS_BROADPHASE
+    int tg_words = (mObjTgCount + 31) >> 5;
+    cCcS_SetCell(l_tgCell, tg_words, mpObjTg, mObjTgCount);
+#endif
     for (cCcD_Obj** pat_obj = mpObjAt; pat_obj < mpObjAt + mObjAtCount; ++pat_obj) {
         if (*pat_obj == NULL || !(*pat_obj)->ChkAtSet())
             continue;
@@ -155,11 +259,24 @@ void cCcS::ChkAtTg() {
         cCcD_ShapeAttr* pat_sa = (*pat_obj)->GetShapeAttr();
         JUT_ASSERT(0, pat_sa != NULL);
 
+#if ENABLE_CCS_BROADPHASE
+        u32 cand[CCS_TG_WORD_NUM];
+        cCcS_GetCellCandidate(l_tgCell, tg_words, (*pat_obj)->GetDivideInfo(), cand);
+
+        int word = 0;
+        for (int tg = cCcS_PopCandidate(cand, &word, tg_words); tg >= 0;
+             tg = cCcS_PopCandidate(cand, &word, tg_words))
+        {
+            cCcD_Obj** ptg_obj = mpObjTg + tg;
+            if (*ptg_obj == NULL || !(*ptg_obj)->ChkTgSet())
+                continue;
+#else
         for (cCcD_Obj** ptg_obj = mpObjTg; ptg_obj < objTgEnd; ++ptg_obj) {
             if (*ptg_obj == NULL || !(*ptg_obj)->ChkTgSet())
                 continue;
             if (!(*pat_obj)->GetDivideInfo().Chk((*ptg_obj)->GetDivideInfo()))
                 continue;
+#endif
             if (ChkNoHitAtTg(*pat_obj, *ptg_obj))
                 continue;
 
@@ -206,6 +323,10 @@ void cCcS::ChkCo() {
         return;
 
     cCcD_Obj** objCoEnd = mpObjCo + mObjCoCount;
+#if ENABLE_CCS_BROADPHASE
+    int co_words = (mObjCoCount + 31) >> 5;
+    cCcS_SetCell(l_coCell, co_words, mpObjCo, mObjCoCount);
+#endif
     for (cCcD_Obj** pco1_obj = mpObjCo; pco1_obj < objCoEnd - 1; ++pco1_obj) {
         if (*pco1_obj == NULL || !(*pco1_obj)->ChkCoSet())
             continue;
@@ -213,11 +334,28 @@ void cCcS::ChkCo() {
         cCcD_ShapeAttr* pco1_sa = (*pco1_obj)->GetShapeAttr();
         JUT_ASSERT(0, pco1_sa != NULL);
 
+#if ENABLE_CCS_BROADPHASE
+        u32 cand[CCS_CO_WORD_NUM];
+        cCcS_GetCellCandidate(l_coCell, co_words, (*pco1_obj)->GetDivideInfo(), cand);
+
+        // Only pairs after pco1_obj, as in the full scan.
+        int next = pco1_obj - mpObjCo + 1;
+        int word = next >> 5;
+        cand[word] &= ~((1 << (next & 31)) - 1);
+
+        for (int co = cCcS_PopCandidate(cand, &word, co_words); co >= 0;
+             co = cCcS_PopCandidate(cand, &word, co_words))
+        {
+            cCcD_Obj** pco2_obj = mpObjCo + co;
+            if (*pco2_obj == NULL || !(*pco2_obj)->ChkCoSet())
+                continue;
+#else
         for (cCcD_Obj** pco2_obj = pco1_obj + 1; pco2_obj < objCoEnd; ++pco2_obj) {
             if (*pco2_obj == NULL || !(*pco2_obj)->ChkCoSet())
                 continue;
             if (!(*pco1_obj)->GetDivideInfo().Chk((*pco2_obj)->GetDivideInfo()))
                 continue;
+#endif
             if (ChkNoHitCo(*pco1_obj, *pco2_obj))
                 continue;
 
@@ -17,7 +17,11 @@ static int daE_DB_LEAF_Execute(e_db_leaf_class* i_this) {
     mDoMtx_stack_c::YrotM(i_this->shape_angle.y);
     mDoMtx_stack_c::XrotM(i_this->shape_angle.x);
     i_this->mpMorf->getModel()->setBaseTRMtx(mDoMtx_stack_c::now);
+#if ENABLE_ANM_BATCH
+    i_this->mpMorf->modelCalcReq(true);
+#else
     i_this->mpMorf->modelCalc();
+#endif
     return 1;
 }
 
@@ -21,7 +21,11 @@ static int daE_HB_LEAF_Execute(e_hb_leaf_class* i_this) {
     mDoMtx_stack_c::YrotM(i_this->shape_angle.y);
     mDoMtx_stack_c::XrotM(i_this->shape_angle.x);
     i_this->mpMorf->getModel()->setBaseTRMtx(mDoMtx_stack_c::get());
+#if ENABLE_ANM_BATCH
+    i_this->mpMorf->modelCalcReq(true);
+#else
     i_this->mpMorf->modelCalc();
+#endif
 
     fopAc_ac_c* actor = fopAcM_SearchByID(i_this->field_0x5bc);
     if (i_this->field_0x5ba == 0) {
@@ -39,7 +39,11 @@ static int daE_YD_LEAF_Execute(e_yd_leaf_class* i_this) {
     mDoMtx_stack_c::XrotM(i_this->shape_angle.x);
     mDoMtx_stack_c::scaleM(i_this->scale.y, i_this->scale.y, i_this->scale.y);
     i_this->mpMorf->getModel()->setBaseTRMtx(mDoMtx_stack_c::get());
+#if ENABLE_ANM_BATCH
+    i_this->mpMorf->modelCalcReq(true);
+#else
     i_this->mpMorf->modelCalc();
+#endif
     return 1;
 }
 
@@ -10,6 +10,9 @@
 #include "d/d_bg_w.h"
 #include "d/d_com_inf_game.h"
 #include "f_op/f_op_actor_mng.h"
+#if ENABLE_BGS_BROADPHASE
+#include <cstring>
+#endif
 
 void cBgS_ChkElm::Init() {
     m_bgw_base_ptr = NULL;
@@ -34,6 +37,226 @@ void cBgS_ChkElm::Release() {
 
 static int l_SetCounter;
 
+#if ENABLE_BGS_BROADPHASE
+/**
+ * Broadphase over the registered BG bodies. Static bodies with trustworthy
+ * bounds are hashed by their XZ extent into a BND_GRID_NUM^2 grid of slot
+ * masks, rebuilt once per frame in dBgS::Move. Move BG (whose bounds change
+ * during actor execution), KCol and bodies registered since the last refit
+ * are tested on every query. Candidates are visited in slot order, so
+ * results match the full scan.
+ */
+static const f32 l_bndCellSize = 2048.0f;
+static const f32 l_bndLimit = 1000000.0f;
+
+static cBgS_BndRecordHeader* l_bndRecord;
+static u32 l_bndRecordCapacity;
+
+static inline bool cBgS_ChkBndSafe(f32 v) {
+    return v >= -l_bndLimit && v <= l_bndLimit;
+}
+
+static inline int cBgS_GetBndCell(f32 v) {
+    return (int)(v * (1.0f / l_bndCellSize));
+}
+
+static inline void cBgS_GetBndCellRange(f32 min, f32 max, int* o_start, int* o_num) {
+    int start = cBgS_GetBndCell(min);
+    int num = cBgS_GetBndCell(max) - start + 1;
+    if (num >= cBgS::BND_GRID_NUM) {
+        start = 0;
+        num = cBgS::BND_GRID_NUM;
+    }
+    *o_start = start;
+    *o_num = num;
+}
+
+/** Mirrors the early-out of cM3d_Cross_MinMaxBoxLine, so it never rejects a hit. */
+static inline bool cBgS_ChkLinBnd(const Vec& min, const Vec& max, const cM3dGLin* p_lin) {
+    const cXyz& start = p_lin->GetStartP();
+    const cXyz& end = p_lin->GetEndP();
+    if ((start.x > max.x && end.x > max.x) || (start.x < min.x && end.x < min.x) ||
+        (start.z > max.z && end.z > max.z) || (start.z < min.z && end.z < min.z) ||
+        (start.y > max.y && end.y > max.y) || (start.y < min.y && end.y < min.y))
+    {
+        return false;
+    }
+    return true;
+}
+
+/** The actor ID a check skips, as ChkSameActorPid tests it. */
+static inline u32 cBgS_GetRecordPid(const cBgS_Chk* p_chk) {
+    fpc_ProcID pid = p_chk->GetActorPid();
+    return p_chk->ChkSameActorPid(pid) ? pid : fpcM_ERROR_PROCESS_ID_e;
+}
+
+/** Mirrors the root group test of cBgW::GroundCrossGrpRp. */
+static inline bool cBgS_ChkGndBnd(const Vec& min, const Vec& max, const cXyz& pos) {
+    if (min.x > pos.x || max.x < pos.x || min.z > pos.z || max.z < pos.z || !(min.y < pos.y)) {
+        return false;
+    }
+    return true;
+}
+
+void cBgS::ClrBnd() {
+    memset(m_bnd_indexed, 0, sizeof(m_bnd_indexed));
+    memset(m_bnd_always, 0, sizeof(m_bnd_always));
+    memset(m_bnd_grid, 0, sizeof(m_bnd_grid));
+}
+
+void cBgS::RefitBnd() {
+    ClrBnd();
+    if (l_bndRecord != NULL) {
+        RecordBnd(cBgS_BndRecord::TYPE_REFIT, 0, 0, 0, NULL, NULL);
+    }
+
+    cBgS_ChkElm* elm = m_chk_element;
+    for (int i = 0; i < 0x100; i++, elm++) {
+        if (!elm->ChkUsed()) {
+            continue;
+        }
+        if (l_bndRecord != NULL) {
+            RecordBody(cBgS_BndRecord::TYPE_BODY, i);
+        }
+
+        u32 bit = 1 << (i & 31);
+        dBgW_Base* bgw = elm->m_bgw_base_ptr;
+        if (bgw->ChkNotReady() || bgw->ChkMoveBg() || !bgw->ChkBndValid()) {
+            m_bnd_always[i >> 5] |= bit;
+            continue;
+        }
+
+        const cM3dGAab* bnd = bgw->GetBnd();
+        const cXyz* min = bnd->GetMinP();
+        const cXyz* max = bnd->GetMaxP();
+        if (!cBgS_ChkBndSafe(min->x) || !cBgS_ChkBndSafe(min->y) || !cBgS_ChkBndSafe(min->z) ||
+            !cBgS_ChkBndSafe(max->x) || !cBgS_ChkBndSafe(max->y) || !cBgS_ChkBndSafe(max->z) ||
+            min->x > max->x || min->y > max->y || min->z > max->z)
+        {
+            m_bnd_always[i >> 5] |= bit;
+            continue;
+        }
+
+        m_bnd_min[i] = *min;
+        m_bnd_max[i] = *max;
+        m_bnd_indexed[i >> 5] |= bit;
+
+        int start_x, num_x, start_z, num_z;
+        cBgS_GetBndCellRange(min->x, max->x, &start_x, &num_x);
+        cBgS_GetBndCellRange(min->z, max->z, &start_z, &num_z);
+        for (int z = 0; z < num_z; z++) {
+            u32(*row)[BND_MASK_NUM] = m_bnd_grid[(start_z + z) & (BND_GRID_NUM - 1)];
+            for (int x = 0; x < num_x; x++) {
+                row[(start_x + x) & (BND_GRID_NUM - 1)][i >> 5] |= bit;
+            }
+        }
+    }
+}
+
+void cBgS::GetBndCandidate(f32 min_x, f32 max_x, f32 min_z, f32 max_z, u32* o_cand) const {
+    if (!cBgS_ChkBndSafe(min_x) || !cBgS_ChkBndSafe(max_x) || !cBgS_ChkBndSafe(min_z) ||
+        !cBgS_ChkBndSafe(max_z))
+    {
+        for (int w = 0; w < BND_MASK_NUM; w++) {
+            o_cand[w] = m_bnd_indexed[w] | m_bnd_always[w];
+        }
+        return;
+    }
+
+    int start_x, num_x, start_z, num_z;
+    cBgS_GetBndCellRange(min_x, max_x, &start_x, &num_x);
+    cBgS_GetBndCellRange(min_z, max_z, &start_z, &num_z);
+
+    for (int w = 0; w < BND_MASK_NUM; w++) {
+        o_cand[w] = 0;
+    }
+    for (int z = 0; z < num_z; z++) {
+        const u32(*row)[BND_MASK_NUM] = m_bnd_grid[(start_z + z) & (BND_GRID_NUM - 1)];
+        for (int x = 0; x < num_x; x++) {
+            const u32* cell = row[(start_x + x) & (BND_GRID_NUM - 1)];
+            for (int w = 0; w < BND_MASK_NUM; w++) {
+                o_cand[w] |= cell[w];
+            }
+        }
+    }
+
+    for (int w = 0; w < BND_MASK_NUM; w++) {
+        o_cand[w] = (o_cand[w] & m_bnd_indexed[w]) | m_bnd_always[w];
+    }
+}
+
+/**
+ * Starts recording body refits and queries into a caller-owned buffer, for
+ * replay with tools/host_check/bgs_broadphase.cpp. Recording stops silently
+ * (counting dropped records) once the buffer is full.
+ */
+bool cBgS::StartBndRecord(void* buffer, u32 size) {
+    if (buffer == NULL || size < sizeof(cBgS_BndRecordHeader)) {
+        return false;
+    }
+
+    cBgS_BndRecordHeader* header = (cBgS_BndRecordHeader*)buffer;
+    header->mMagic = 'BGRC';
+    header->mVersion = 1;
+    header->mCount = 0;
+    header->mDropped = 0;
+    l_bndRecordCapacity = (size - sizeof(cBgS_BndRecordHeader)) / sizeof(cBgS_BndRecord);
+    l_bndRecord = header;
+    return true;
+}
+
+/**
+ * Stops recording and returns the number of records written.
+ */
+u32 cBgS::StopBndRecord() {
+    cBgS_BndRecordHeader* header = l_bndRecord;
+    l_bndRecord = NULL;
+    return header != NULL ? header->mCount : 0;
+}
+
+void cBgS::RecordBnd(u8 type, u8 flag, int slot, u32 id, const Vec* a, const Vec* b) {
+    cBgS_BndRecordHeader* header = l_bndRecord;
+    if (header->mCount >= l_bndRecordCapacity) {
+        header->mDropped++;
+        return;
+    }
+
+    cBgS_BndRecord* record = (cBgS_BndRecord*)(header + 1) + header->mCount;
+    header->mCount++;
+    record->mType = type;
+    record->mFlag = flag;
+    record->mSlot = slot;
+    record->mId = id;
+    record->mV[0] = a != NULL ? a->x : 0.0f;
+    record->mV[1] = a != NULL ? a->y : 0.0f;
+    record->mV[2] = a != NULL ? a->z : 0.0f;
+    record->mV[3] = b != NULL ? b->x : 0.0f;
+    record->mV[4] = b != NULL ? b->y : 0.0f;
+    record->mV[5] = b != NULL ? b->z : 0.0f;
+}
+
+/** Records the state RefitBnd reads from the body in slot i. */
+void cBgS::RecordBody(u8 type, int i) const {
+    const cBgS_ChkElm* elm = &m_chk_element[i];
+    dBgW_Base* bgw = elm->m_bgw_base_ptr;
+    u8 flag = 0;
+    const Vec* min = NULL;
+    const Vec* max = NULL;
+    if (bgw->ChkNotReady()) {
+        flag |= cBgS_BndRecord::FLAG_NOT_READY;
+    }
+    if (bgw->ChkMoveBg()) {
+        flag |= cBgS_BndRecord::FLAG_MOVE_BG;
+    }
+    if (!bgw->ChkNotReady() && bgw->ChkBndValid()) {
+        flag |= cBgS_BndRecord::FLAG_BND_VALID;
+        min = bgw->GetBnd()->GetMinP();
+        max = bgw->GetBnd()->GetMaxP();
+    }
+    RecordBnd(type, flag, i, elm->m_actor_id, min, max);
+}
+#endif
+
 bool cBgS::Regist(dBgW_Base* p_data, fpc_ProcID actor_id, void* p_actor) {
     if (p_data == NULL) {
         return true;
@@ -47,6 +270,13 @@ bool cBgS::Regist(dBgW_Base* p_data, fpc_ProcID actor_id, void* p_actor) {
             if (!m_chk_element[i].m_used) {
                 m_chk_element[i].Regist2(p_data, actor_id, p_actor);
                 p_data->Regist(i);
+#if ENABLE_BGS_BROADPHASE
+                m_bnd_indexed[i >> 5] &= ~(1 << (i & 31));
+                m_bnd_always[i >> 5] |= 1 << (i & 31);
+                if (l_bndRecord != NULL) {
+                    RecordBody(cBgS_BndRecord::TYPE_REGIST, i);
+                }
+#endif
 
                 l_SetCounter = i + 1;
                 if (l_SetCounter >= 0x100) {
@@ -74,6 +304,13 @@ bool cBgS::Release(dBgW_Base* p_data) {
     if (p_data->ChkUsed() && id >= 0 && id < 0x100 && m_chk_element[id].ChkUsed()) {
         m_chk_element[id].Release();
         p_data->Release();
+#if ENABLE_BGS_BROADPHASE
+        m_bnd_indexed[id >> 5] &= ~(1 << (id & 31));
+        m_bnd_always[id >> 5] &= ~(1 << (id & 31));
+        if (l_bndRecord != NULL) {
+            RecordBnd(cBgS_BndRecord::TYPE_RELEASE, 0, id, 0, NULL, NULL);
+        }
+#endif
     } else {
         return 1;
     }
@@ -86,6 +323,9 @@ void cBgS::Ct() {
     for (int i = 0; i < 0x100; i++) {
         m_chk_element[i].Init();
     }
+#if ENABLE_BGS_BROADPHASE
+    ClrBnd();
+#endif
 }
 
 void cBgS::Dt() {
@@ -98,6 +338,9 @@ void cBgS::Dt() {
     for (int i = 0; i < 0x100; i++) {
         m_chk_element[i].Init();
     }
+#if ENABLE_BGS_BROADPHASE
+    ClrBnd();
+#endif
 }
 
 bool cBgS::LineCross(cBgS_LinChk* p_line) {
@@ -105,6 +348,39 @@ bool cBgS::LineCross(cBgS_LinChk* p_line) {
     p_line->ClrHit();
     p_line->PreCalc();
 
+#if ENABLE_BGS_BROADPHASE
+    const cXyz& start = p_line->GetLinP()->GetStartP();
+    const cXyz& end = p_line->GetLinP()->GetEndP();
+    if (l_bndRecord != NULL) {
+        RecordBnd(cBgS_BndRecord::TYPE_LINE, 0, 0, cBgS_GetRecordPid(p_line), &start, &end);
+    }
+    u32 cand[BND_MASK_NUM];
+    GetBndCandidate(start.x < end.x ? start.x : end.x, start.x < end.x ? end.x : start.x,
+                    start.z < end.z ? start.z : end.z, start.z < end.z ? end.z : start.z, cand);
+
+    for (int w = 0; w < BND_MASK_NUM; w++) {
+        u32 bits = cand[w];
+        while (bits != 0) {
+            u32 bit = bits & -bits;
+            bits ^= bit;
+            int i = (w << 5) + (31 - __cntlzw(bit));
+            cBgS_ChkElm* elm = &m_chk_element[i];
+            if ((m_bnd_indexed[w] & bit) &&
+                !cBgS_ChkLinBnd(m_bnd_min[i], m_bnd_max[i], p_line->GetLinP()))
+            {
+                continue;
+            }
+
+            if (elm->ChkUsed() && !elm->m_bgw_base_ptr->ChkNotReady() &&
+                !p_line->ChkSameActorPid(elm->m_actor_id) &&
+                elm->m_bgw_base_ptr->LineCheck(p_line))
+            {
+                p_line->SetActorInfo(i, elm->m_bgw_base_ptr, elm->m_actor_id);
+                p_line->SetHit();
+            }
+        }
+    }
+#else
     cBgS_ChkElm* elm = m_chk_element;
     for (int i = 0; i < 0x100; i++) {
         if (elm->ChkUsed() && !elm->m_bgw_base_ptr->ChkNotReady() &&
@@ -115,15 +391,139 @@ bool cBgS::LineCross(cBgS_LinChk* p_line) {
         }
         elm++;
     }
+#endif
 
     return p_line->ChkHit();
 }
 
+#if ENABLE_BGS_LINE_MULTI
+/**
+ * Runs LineCross for each of p_lines in batches of 32. Each BG body is
+ * walked once per batch with the rays that can reach it, and every ray sees
+ * the bodies in slot order, so per-ray results match LineCross.
+ * Returns the number of rays that hit.
+ */
+int cBgS::LineCrossMulti(cBgS_LinChk** p_lines, int num) {
+    int hit_num = 0;
+
+    for (; num > 0; p_lines += 32, num -= 32) {
+        int batch_num = num < 32 ? num : 32;
+
+        for (int j = 0; j < batch_num; j++) {
+            p_lines[j]->ClearPi();
+            p_lines[j]->ClrHit();
+            p_lines[j]->PreCalc();
+        }
+
+#if ENABLE_BGS_BROADPHASE
+        f32 min_x = G_CM3D_F_INF, max_x = -G_CM3D_F_INF;
+        f32 min_z = G_CM3D_F_INF, max_z = -G_CM3D_F_INF;
+        for (int j = 0; j < batch_num; j++) {
+            const cM3dGLin* lin = p_lines[j]->GetLinP();
+            const cXyz& start = lin->GetStartP();
+            const cXyz& end = lin->GetEndP();
+            if (l_bndRecord != NULL) {
+                RecordBnd(cBgS_BndRecord::TYPE_LINE, 0, 0, cBgS_GetRecordPid(p_lines[j]), &start,
+                          &end);
+            }
+            min_x = start.x < min_x ? start.x : min_x;
+            min_x = end.x < min_x ? end.x : min_x;
+            max_x = start.x > max_x ? start.x : max_x;
+            max_x = end.x > max_x ? end.x : max_x;
+            min_z = start.z < min_z ? start.z : min_z;
+            min_z = end.z < min_z ? end.z : min_z;
+            max_z = start.z > max_z ? start.z : max_z;
+            max_z = end.z > max_z ? end.z : max_z;
+        }
+
+        u32 cand[BND_MASK_NUM];
+        GetBndCandidate(min_x, max_x, min_z, max_z, cand);
+#endif
+
+        for (int i = 0; i < 0x100; i++) {
+#if ENABLE_BGS_BROADPHASE
+            u32 slot_bit = 1 << (i & 31);
+            if (!(cand[i >> 5] & slot_bit)) {
+                continue;
+            }
+#endif
+            cBgS_ChkElm* elm = &m_chk_element[i];
+            if (!elm->ChkUsed() || elm->m_bgw_base_ptr->ChkNotReady()) {
+                continue;
+            }
+
+            u32 mask = 0;
+            for (int j = 0; j < batch_num; j++) {
+                if (p_lines[j]->ChkSameActorPid(elm->m_actor_id)) {
+                    continue;
+                }
+#if ENABLE_BGS_BROADPHASE
+                if ((m_bnd_indexed[i >> 5] & slot_bit) &&
+                    !cBgS_ChkLinBnd(m_bnd_min[i], m_bnd_max[i], p_lines[j]->GetLinP()))
+                {
+                    continue;
+                }
+#endif
+                mask |= 1 << j;
+            }
+
+            if (mask == 0) {
+                continue;
+            }
+
+            u32 hit = elm->m_bgw_base_ptr->LineCheckMulti(p_lines, mask);
+            for (int j = 0; j < batch_num; j++) {
+                if (hit & (1 << j)) {
+                    p_lines[j]->SetActorInfo(i, elm->m_bgw_base_ptr, elm->m_actor_id);
+                    p_lines[j]->SetHit();
+                }
+            }
+        }
+
+        for (int j = 0; j < batch_num; j++) {
+            if (p_lines[j]->ChkHit()) {
+                hit_num++;
+            }
+        }
+    }
+
+    return hit_num;
+}
+#endif
+
 f32 cBgS::GroundCross(cBgS_GndChk* p_gnd) {
     p_gnd->SetNowY(-G_CM3D_F_INF);
     p_gnd->ClearPi();
     p_gnd->PreCheck();
 
+#if ENABLE_BGS_BROADPHASE
+    const cXyz& pos = p_gnd->GetPointP();
+    if (l_bndRecord != NULL) {
+        RecordBnd(cBgS_BndRecord::TYPE_GND, 0, 0, cBgS_GetRecordPid(p_gnd), &pos, NULL);
+    }
+    u32 cand[BND_MASK_NUM];
+    GetBndCandidate(pos.x, pos.x, pos.z, pos.z, cand);
+
+    for (int w = 0; w < BND_MASK_NUM; w++) {
+        u32 bits = cand[w];
+        while (bits != 0) {
+            u32 bit = bits & -bits;
+            bits ^= bit;
+            int i = (w << 5) + (31 - __cntlzw(bit));
+            cBgS_ChkElm* elm = &m_chk_element[i];
+            if ((m_bnd_indexed[w] & bit) && !cBgS_ChkGndBnd(m_bnd_min[i], m_bnd_max[i], pos)) {
+                continue;
+            }
+
+            if (elm->ChkUsed() && !elm->m_bgw_base_ptr->ChkNotReady() &&
+                !p_gnd->ChkSameActorPid(elm->m_actor_id) &&
+                elm->m_bgw_base_ptr->GroundCross(p_gnd))
+            {
+                p_gnd->SetActorInfo(i, elm->m_bgw_base_ptr, elm->m_actor_id);
+            }
+        }
+    }
+#else
     cBgS_ChkElm* elm = m_chk_element;
     for (int i = 0; i < 0x100; i++) {
         if (elm->ChkUsed() && !elm->m_bgw_base_ptr->ChkNotReady() &&
@@ -133,6 +533,7 @@ f32 cBgS::GroundCross(cBgS_GndChk* p_gnd) {
         }
         elm++;
     }
+#endif
 
     return p_gnd->GetNowY();
 }
@@ -301,6 +702,10 @@ void dBgS::Move() {
         }
         elm++;
     }
+
+#if ENABLE_BGS_BROADPHASE
+    RefitBnd();
+#endif
 }
 
 bool dBgS::Regist(dBgW_Base* pbgw, fopAc_ac_c* p_actor) {
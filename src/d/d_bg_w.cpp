@@ -506,6 +506,110 @@ bool cBgW::LineCheck(cBgS_LinChk* i_linchk) {
     return LineCheckGrpRp(i_linchk, m_rootGrpIdx, 1);
 }
 
+#if ENABLE_BGS_LINE_MULTI
+/**
+ * Batched versions of LineCheckRp/LineCheckGrpRp. Each node is visited once
+ * for all rays in i_mask that still overlap it; per ray, boxes and polygons
+ * are tested in the same order as the single-ray walk, so results match.
+ */
+u32 cBgW::LineCheckMultiRp(cBgS_LinChk** i_linchk, u32 i_mask, int i_idx) {
+    cBgW_NodeTree* node = &pm_node_tree[i_idx];
+
+    u32 mask = 0;
+    for (int i = 0; i < 32; i++) {
+        u32 bit = 1 << i;
+        if ((i_mask & bit) &&
+            cM3d_Cross_MinMaxBoxLine(node->GetMinP(), node->GetMaxP(),
+                                     &i_linchk[i]->GetLinP()->GetStartP(),
+                                     &i_linchk[i]->GetLinP()->GetEndP()))
+        {
+            mask |= bit;
+        }
+    }
+
+    if (mask == 0) {
+        return 0;
+    }
+
+    cBgD_Tree_t* tree = &pm_bgd->m_tree_tbl[i_idx];
+    u32 hit = 0;
+
+    if (tree->m_flag & 1) {
+        cBgW_BlkElm* blk = &pm_blk[tree->m_id[0]];
+        for (int i = 0; i < 32; i++) {
+            u32 bit = 1 << i;
+            if (!(mask & bit)) {
+                continue;
+            }
+
+            cBgS_LinChk* linchk = i_linchk[i];
+            if (linchk->GetPreWallChk() && blk->m_wall_idx != 0xFFFF &&
+                RwgLineCheck(blk->m_wall_idx, linchk))
+            {
+                hit |= bit;
+            }
+            if (linchk->GetPreGroundChk() && blk->m_gnd_idx != 0xFFFF &&
+                RwgLineCheck(blk->m_gnd_idx, linchk))
+            {
+                hit |= bit;
+            }
+            if (linchk->GetPreRoofChk() && blk->m_roof_idx != 0xFFFF &&
+                RwgLineCheck(blk->m_roof_idx, linchk))
+            {
+                hit |= bit;
+            }
+        }
+
+        return hit;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        if (tree->m_id[i] != 0xFFFF) {
+            hit |= LineCheckMultiRp(i_linchk, mask, tree->m_id[i]);
+        }
+    }
+
+    return hit;
+}
+
+u32 cBgW::LineCheckMultiGrpRp(cBgS_LinChk** i_linchk, u32 i_mask, int i_grp_idx, int depth) {
+    u32 mask = 0;
+    for (int i = 0; i < 32; i++) {
+        u32 bit = 1 << i;
+        if ((i_mask & bit) && pm_grp[i_grp_idx].m_aab.Cross(i_linchk[i]->GetLinP()) &&
+            !ChkGrpThrough(i_grp_idx, i_linchk[i]->GetGrpPassChk(), depth))
+        {
+            mask |= bit;
+        }
+    }
+
+    if (mask == 0) {
+        return 0;
+    }
+
+    u32 hit = 0;
+
+    if (pm_bgd->m_g_tbl[i_grp_idx].m_tree_idx != 0xFFFF) {
+        hit |= LineCheckMultiRp(i_linchk, mask, pm_bgd->m_g_tbl[i_grp_idx].m_tree_idx);
+    }
+
+    int child_idx = pm_bgd->m_g_tbl[i_grp_idx].m_first_child;
+    while (true) {
+        if (child_idx == 0xFFFF)
+            break;
+
+        hit |= LineCheckMultiGrpRp(i_linchk, mask, child_idx, depth + 1);
+        child_idx = pm_bgd->m_g_tbl[child_idx].m_next_sibling;
+    }
+
+    return hit;
+}
+
+u32 cBgW::LineCheckMulti(cBgS_LinChk** i_linchk, u32 i_mask) {
+    return LineCheckMultiGrpRp(i_linchk, i_mask, m_rootGrpIdx, 1);
+}
+#endif
+
 bool cBgW::RwgGroundCheckCommon(f32 i_yPos, u16 i_poly_idx, cBgS_GndChk* i_gndchk) {
     if (i_yPos < i_gndchk->GetPointP().y && i_yPos > i_gndchk->GetNowY()) {
         cBgD_Tri_t* tri = &pm_bgd->m_t_tbl[i_poly_idx];
@@ -774,6 +878,12 @@ cM3dGAab* cBgW::GetBnd() const {
     return &pm_grp[m_rootGrpIdx].m_aab;
 }
 
+#if ENABLE_BGS_BROADPHASE
+bool cBgW::ChkBndValid() const {
+    return pm_vtx_tbl != NULL && pm_grp != NULL;
+}
+#endif
+
 void cBgW::GetTrans(cXyz* o_trans) const {
     MtxP base = pm_base;
     o_trans->x = base[0][3] - m_inv_mtx[0][3];
@@ -32,6 +32,23 @@ void dBgW_Base::CallRideCallBack(fopAc_ac_c* param_0, fopAc_ac_c* param_1) {}
 
 void dBgW_Base::CallArrowStickCallBack(fopAc_ac_c* param_0, fopAc_ac_c* param_1, cXyz& param_2) {}
 
+#if ENABLE_BGS_LINE_MULTI
+/**
+ * Runs LineCheck on each ray in i_mask (bit n selects i_linchk[n]) and
+ * returns the mask of rays that hit this body.
+ */
+u32 dBgW_Base::LineCheckMulti(cBgS_LinChk** i_linchk, u32 i_mask) {
+    u32 hit = 0;
+    for (int i = 0; i < 32; i++) {
+        u32 bit = 1 << i;
+        if ((i_mask & bit) && LineCheck(i_linchk[i])) {
+            hit |= bit;
+        }
+    }
+    return hit;
+}
+#endif
+
 void dBgW_Base::CalcDiffShapeAngleY(s16 param_0) {
     m_diff_ShapeAngleY = param_0 - m_old_ShapeAngleY;
     m_old_ShapeAngleY = param_0;
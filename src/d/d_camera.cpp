@@ -2525,7 +2525,52 @@ f32 dCamera_c::groundHeight(cXyz* param_0) {
     return height == -G_CM3D_F_INF ? param_0->y : height;
 }
 
+#if ENABLE_BGS_LINE_MULTI
+/**
+ * Sets up @p i_linChk from the camera's line check flags, for lineBGCheck
+ * and lineBGCheckMulti.
+ */
+static void setLineBGCheck(cXyz* i_start, cXyz* i_end, dBgS_LinChk* i_linChk, u32 i_flags) {
+    if (i_flags & 0x8000) {
+        i_linChk->ClrCam();
+        i_linChk->SetObj();
+    } else {
+        i_linChk->ClrObj();
+        i_linChk->SetCam();
+    }
+
+    i_linChk->Set(i_start, i_end, NULL);
+
+    if (i_flags & 4) {
+        i_linChk->ClrSttsRoofOff();
+    } else {
+        i_linChk->SetSttsRoofOff();
+    }
+
+    if (i_flags & 2) {
+        i_linChk->ClrSttsWallOff();
+    } else {
+        i_linChk->SetSttsWallOff();
+    }
+
+    if (i_flags & 1) {
+        i_linChk->ClrSttsGroundOff();
+    } else {
+        i_linChk->SetSttsGroundOff();
+    }
+
+    if (i_flags & 8) {
+        i_linChk->OnWaterGrp();
+    } else {
+        i_linChk->OffWaterGrp();
+    }
+}
+#endif
+
 bool dCamera_c::lineBGCheck(cXyz* i_start, cXyz* i_end, dBgS_LinChk* i_linChk, u32 i_flags) {
+#if ENABLE_BGS_LINE_MULTI
+    setLineBGCheck(i_start, i_end, i_linChk, i_flags);
+#else
     if (i_flags & 0x8000) {
         i_linChk->ClrCam();
         i_linChk->SetObj();
@@ -2559,6 +2604,7 @@ bool dCamera_c::lineBGCheck(cXyz* i_start, cXyz* i_end, dBgS_LinChk* i_linChk, u
     } else {
         i_linChk->OffWaterGrp();
     }
+#endif
 
     if (dComIfG_Bgsp().LineCross(i_linChk)) {
         return true;
@@ -2586,6 +2632,33 @@ bool dCamera_c::lineBGCheck(cXyz* i_start, cXyz* i_end, u32 i_flags) {
     return lineBGCheck(i_start, i_end, &lin_chk, i_flags);
 }
 
+#if ENABLE_BGS_LINE_MULTI
+/**
+ * lineBGCheck for up to 4 rays sharing an end point, walked together with
+ * dBgS::LineCrossMulti. Returns a mask with bit n set when ray n hits.
+ */
+u32 dCamera_c::lineBGCheckMulti(cXyz** i_starts, int i_num, cXyz* i_end, u32 i_flags) {
+    JUT_ASSERT(__LINE__, i_num <= 4);
+    dBgS_CamLinChk lin_chk[4];
+    cBgS_LinChk* lines[4];
+
+    for (int i = 0; i < i_num; i++) {
+        setLineBGCheck(i_starts[i], i_end, &lin_chk[i], i_flags);
+        lines[i] = &lin_chk[i];
+    }
+
+    u32 hit = 0;
+    if (dComIfG_Bgsp().LineCrossMulti(lines, i_num) != 0) {
+        for (int i = 0; i < i_num; i++) {
+            if (lin_chk[i].ChkHit()) {
+                hit |= 1 << i;
+            }
+        }
+    }
+    return hit;
+}
+#endif
+
 u32 dCamera_c::lineCollisionCheckBush(cXyz* i_start, cXyz* i_end) {
     u32 ret = 0;
     u32 result = dComIfG_Ccsp()->GetMassResultCam();
@@ -5584,11 +5657,21 @@ bool dCamera_c::talktoCamera(s32 param_0) {
                     }
                 }
 
+#if ENABLE_BGS_LINE_MULTI
+                cXyz* starts[3] = {&sp15B0, &talk->field_0x4, &sp15A4};
+                u32 bg_hit = lineBGCheckMulti(starts, 3, &talk->field_0x10, talk->field_0x8c);
+                if (!(bg_hit & 3)
+#else
                 if (!lineBGCheck(&sp15B0, &talk->field_0x10, talk->field_0x8c)
                     && !lineBGCheck(&talk->field_0x4, &talk->field_0x10, talk->field_0x8c)
+#endif
                     && !lineCollisionCheck(sp15B0, talk->field_0x10, listener, speaker, ride_actor))
                 {
+#if ENABLE_BGS_LINE_MULTI
+                    if (!(bg_hit & 4)
+#else
                     if (!lineBGCheck(&sp15A4, &talk->field_0x10, talk->field_0x8c)
+#endif
                         && !lineCollisionCheck(sp15A4, talk->field_0x10, listener, speaker, ride_actor))
                     {
                         sp5A = true;
@@ -6390,8 +6473,13 @@ bool dCamera_c::talktoCamera(s32 param_0) {
         int i = 0;
         for (i = 0; i < 18; i++) {
             mViewCache.mEye = mViewCache.mCenter + mViewCache.mDirection.Xyz();
+#if ENABLE_BGS_LINE_MULTI
+            cXyz* starts[2] = {&sp13E8, &sp13DC};
+            if (lineBGCheckMulti(starts, 2, &mViewCache.mEye, talk->field_0x8c) == 0
+#else
             if (!lineBGCheck(&sp13E8, &mViewCache.mEye, talk->field_0x8c)
                 && !lineBGCheck(&sp13DC, &mViewCache.mEye, talk->field_0x8c)
+#endif
                 && !lineCollisionCheck(sp13E8, mViewCache.mEye, listener, speaker, NULL)
                 && !lineCollisionCheck(sp13DC, mViewCache.mEye, listener, speaker, NULL))
             {
@@ -6428,8 +6516,13 @@ bool dCamera_c::talktoCamera(s32 param_0) {
             int i = 0;
             for (i = 0; i < 18; i++) {
                 mViewCache.mEye = mViewCache.mCenter + mViewCache.mDirection.Xyz();
+#if ENABLE_BGS_LINE_MULTI
+                cXyz* starts[2] = {&sp13D0, &sp13C4};
+                if (lineBGCheckMulti(starts, 2, &mViewCache.mEye, talk->field_0x8c) == 0
+#else
                 if (!lineBGCheck(&sp13D0, &mViewCache.mEye, talk->field_0x8c)
                     && !lineBGCheck(&sp13C4, &mViewCache.mEye, talk->field_0x8c)
+#endif
                     && !lineCollisionCheck(sp13D0, mViewCache.mEye, listener, speaker, NULL)
                     && !lineCollisionCheck(sp13C4, mViewCache.mEye, listener, speaker, NULL))
                 {
@@ -6470,8 +6563,13 @@ bool dCamera_c::talktoCamera(s32 param_0) {
         talk->field_0x9c = talk->field_0x90 + talk->field_0xa8.Xyz();
         talk->field_0xb0 = 60.0f;
 
+#if ENABLE_BGS_LINE_MULTI
+        cXyz* starts[2] = {&sp13B8, &sp13AC};
+        if (lineBGCheckMulti(starts, 2, &talk->field_0x9c, talk->field_0x8c) != 0
+#else
         if (lineBGCheck(&sp13B8, &talk->field_0x9c, talk->field_0x8c)
             || lineBGCheck(&sp13AC, &talk->field_0x9c, talk->field_0x8c)
+#endif
             || lineCollisionCheck(sp13B8, talk->field_0x9c, listener, speaker, NULL)
             || lineCollisionCheck(sp13AC, talk->field_0x9c, listener, speaker, NULL))
         {
@@ -6578,8 +6676,13 @@ bool dCamera_c::talktoCamera(s32 param_0) {
             fopAc_ac_c* midna = daPy_py_c::getMidnaActor();
             for (i = 0; i < 18; i++) {
                 mViewCache.mEye = mViewCache.mCenter + mViewCache.mDirection.Xyz();
+#if ENABLE_BGS_LINE_MULTI
+                cXyz* starts[2] = {&sp1358, &sp134C};
+                if (lineBGCheckMulti(starts, 2, &mViewCache.mEye, talk->field_0x8c) == 0
+#else
                 if (!lineBGCheck(&sp1358, &mViewCache.mEye, talk->field_0x8c)
                     && !lineBGCheck(&sp134C, &mViewCache.mEye, talk->field_0x8c)
+#endif
                     && !lineCollisionCheck(sp1358, mViewCache.mEye, actor2_sp394, midna, NULL)
                     && !lineCollisionCheck(sp134C, mViewCache.mEye, actor2_sp394, midna, NULL))
                 {
@@ -11001,6 +11104,9 @@ static int camera_draw(camera_process_class* i_this) {
 
     j3dSys.setViewMtx(process->viewMtx);
     cMtx_inverse(process->viewMtx, process->invViewMtx);
+#if ENABLE_CULL_BATCH
+    fopAcM_cullingCheckAll();
+#endif
 
     Z2GetAudience()->setAudioCamera(process->viewMtx, process->lookat.eye, process->lookat.center,
                                     process->fovy, process->aspect, getComStat(0x80), camera_id,
@@ -1729,6 +1729,17 @@ void dDlst_list_c::init() {
         mDrawBuffers[*var_r5_2++]->setZSort();
     }
 
+#if ENABLE_DRAW_KEY_SORT
+    // Buffers that outgrow this double their key array on the next frame.
+    for (int i = 0; i < 21; i++) {
+        int sortMode = mDrawBuffers[i]->getSortMode();
+        if (sortMode == J3DDrawBufSortMode_Mat || sortMode == J3DDrawBufSortMode_Z) {
+            u32 keyNum = l_drawlistSize[i] * 2;
+            mDrawBuffers[i]->allocKeyBuffer(keyNum < 0x40 ? 0x40 : keyNum);
+        }
+    }
+#endif
+
     setOpaList();
     setXluList();
     mpCopy2DStart = mpCopy2DDrawLists;
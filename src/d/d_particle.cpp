@@ -1201,6 +1201,9 @@ void dPa_control_c::createCommon(void const* param_0) {
     mCommonResMng->swapTexture(mDoGph_gInf_c::getFrameBufferTimg(), "dummy");
     mEmitterMng = new (mHeap, 0) JPAEmitterManager(3000, 250, *(JKRHeap**)this, 0x13, 2);
     JUT_ASSERT(2531, mEmitterMng != NULL);
+#if ENABLE_JPA_PARALLEL_CALC
+    mEmitterMng->startCalcWorker(*(JKRHeap**)this, OSGetThreadPriority(OSGetCurrentThread()));
+#endif
     mEmitterMng->entryResourceManager(mCommonResMng, 0);
     JKRHeap* prevHeap = mDoExt_setCurrentHeap(mHeap);
     for (u16 i = 0; i < 5; i++) {
@@ -18,6 +18,9 @@
 #include "m_Do/m_Do_graphic.h"
 #include <cstdio>
 #include <cstring>
+#if ENABLE_RES_INDEX
+#include <cctype>
+#endif
 
 dRes_info_c::dRes_info_c() {
     mCount = 0;
@@ -44,7 +47,12 @@ dRes_info_c::~dRes_info_c() {
     }
 }
 
+#if ENABLE_DVD_SCHEDULER
+int dRes_info_c::set(char const* i_arcName, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap,
+                     u8 i_priority) {
+#else
 int dRes_info_c::set(char const* i_arcName, char const* i_path, u8 i_mountDirection, JKRHeap* i_heap) {
+#endif
 #ifdef __MWERKS__
     JUT_ASSERT(120, strlen(i_arcName) <= NAME_MAX);
 #endif
@@ -52,7 +60,11 @@ int dRes_info_c::set(char const* i_arcName, char const* i_path, u8 i_mountDirect
     if (*i_path != '\0') {
         char path[40];
         snprintf(path, sizeof(path), "%s%s.arc", i_path, i_arcName);
+#if ENABLE_DVD_SCHEDULER
+        mDMCommand = mDoDvdThd_mountArchive_c::create(path, i_mountDirection, i_heap, i_priority);
+#else
         mDMCommand = mDoDvdThd_mountArchive_c::create(path, i_mountDirection, i_heap);
+#endif
 
         if (mDMCommand == NULL) {
             return false;
@@ -588,6 +600,7 @@ int dRes_info_c::setRes() {
         }
 
         u32 r28;
+        JKR_HEAP_TRACE_TAG('RS');
 
         if (heap != NULL) {
             heap->lock();
@@ -756,7 +769,139 @@ void dRes_info_c::dump(char* param_1, dRes_info_c* info, int param_3) {
 }
 #endif
 
+#if ENABLE_RES_INDEX
+/**
+ * Lookup index over one dRes_info_c array. Registered infos (count != 0)
+ * are chained per case folded name hash, and a bitmap holds the free infos
+ * so newResInfo still returns the first one. Names are unique among the
+ * registered infos, since setRes looks the name up before registering it.
+ */
+struct dRes_index_c {
+    enum {
+        INFO_MAX = 128,
+        HASH_NUM = 64,
+    };
+
+    void init(dRes_info_c* i_resInfo, int i_infoNum);
+    void entry(dRes_info_c* i_resInfo);
+    void remove(dRes_info_c* i_resInfo);
+    dRes_info_c* search(char const* i_arcName) const;
+    dRes_info_c* getFree() const;
+
+    static u32 getHash(char const* i_arcName);
+
+    /* 0x000 */ dRes_info_c* mpInfo;
+    /* 0x004 */ int mInfoNum;
+    /* 0x008 */ u32 mFree[INFO_MAX / 32];
+    /* 0x018 */ u32 mHash[INFO_MAX];
+    /* 0x218 */ u8 mHead[HASH_NUM];
+    /* 0x258 */ u8 mNext[INFO_MAX];
+};
+
+// One per dRes_control_c array: mObjectInfo and mStageInfo.
+static dRes_index_c l_resIndex[2];
+
+u32 dRes_index_c::getHash(char const* i_arcName) {
+    u32 hash = 0;
+    while (*i_arcName != '\0') {
+        hash = hash * 31 + tolower(*i_arcName);
+        i_arcName++;
+    }
+    return hash;
+}
+
+void dRes_index_c::init(dRes_info_c* i_resInfo, int i_infoNum) {
+    mpInfo = i_resInfo;
+    mInfoNum = i_infoNum;
+    memset(mFree, 0, sizeof(mFree));
+    memset(mHead, 0, sizeof(mHead));
+    for (int i = 0; i < i_infoNum; i++) {
+        if (i_resInfo[i].getCount() != 0) {
+            entry(&i_resInfo[i]);
+        } else {
+            mFree[i >> 5] |= 0x80000000 >> (i & 31);
+        }
+    }
+}
+
+void dRes_index_c::entry(dRes_info_c* i_resInfo) {
+    int no = i_resInfo - mpInfo;
+    u32 hash = getHash(i_resInfo->getArchiveName());
+    mHash[no] = hash;
+    mNext[no] = mHead[hash & (HASH_NUM - 1)];
+    mHead[hash & (HASH_NUM - 1)] = no + 1;
+    mFree[no >> 5] &= ~(0x80000000 >> (no & 31));
+}
+
+void dRes_index_c::remove(dRes_info_c* i_resInfo) {
+    int no = i_resInfo - mpInfo;
+    u8* link = &mHead[mHash[no] & (HASH_NUM - 1)];
+    while (*link != 0) {
+        if (*link == no + 1) {
+            *link = mNext[no];
+            break;
+        }
+        link = &mNext[*link - 1];
+    }
+    mFree[no >> 5] |= 0x80000000 >> (no & 31);
+}
+
+dRes_info_c* dRes_index_c::search(char const* i_arcName) const {
+    u32 hash = getHash(i_arcName);
+    for (int link = mHead[hash & (HASH_NUM - 1)]; link != 0; link = mNext[link - 1]) {
+        if (mHash[link - 1] == hash && !stricmp(i_arcName, mpInfo[link - 1].getArchiveName())) {
+            return &mpInfo[link - 1];
+        }
+    }
+    return NULL;
+}
+
+dRes_info_c* dRes_index_c::getFree() const {
+    for (int i = 0; i < mInfoNum; i += 32) {
+        u32 bits = mFree[i >> 5];
+        if (bits != 0) {
+            int no = i + __cntlzw(bits);
+            return no < mInfoNum ? &mpInfo[no] : NULL;
+        }
+    }
+    return NULL;
+}
+
+/** Returns the index of @p i_resInfo, building it on first use, or NULL if there is none. */
+static dRes_index_c* dRes_getIndex(dRes_info_c* i_resInfo, int i_infoNum) {
+    for (int i = 0; i < ARRAY_SIZE(l_resIndex); i++) {
+        if (l_resIndex[i].mpInfo == i_resInfo) {
+            return &l_resIndex[i];
+        }
+    }
+
+    if (i_infoNum > dRes_index_c::INFO_MAX) {
+        return NULL;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(l_resIndex); i++) {
+        if (l_resIndex[i].mpInfo == NULL) {
+            l_resIndex[i].init(i_resInfo, i_infoNum);
+            return &l_resIndex[i];
+        }
+    }
+    return NULL;
+}
+
+static void dRes_deleteIndex(dRes_info_c* i_resInfo) {
+    for (int i = 0; i < ARRAY_SIZE(l_resIndex); i++) {
+        if (l_resIndex[i].mpInfo == i_resInfo) {
+            l_resIndex[i].mpInfo = NULL;
+        }
+    }
+}
+#endif
+
 dRes_control_c::~dRes_control_c() {
+#if ENABLE_RES_INDEX
+    dRes_deleteIndex(mObjectInfo);
+    dRes_deleteIndex(mStageInfo);
+#endif
     for (int i = 0; i < ARRAY_SIZE(mObjectInfo); i++) {
         mObjectInfo[i].~dRes_info_c();
     }
@@ -766,8 +911,14 @@ dRes_control_c::~dRes_control_c() {
     }
 }
 
+#if ENABLE_DVD_SCHEDULER
+int dRes_control_c::setRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum,
+                           char const* i_path, u8 i_mountDirection, JKRHeap* i_heap,
+                           u8 i_priority) {
+#else
 int dRes_control_c::setRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum,
                            char const* i_path, u8 i_mountDirection, JKRHeap* i_heap) {
+#endif
     dRes_info_c* resInfo = getResInfo(i_arcName, i_resInfo, i_infoNum);
 
     if (resInfo == NULL) {
@@ -780,14 +931,27 @@ int dRes_control_c::setRes(char const* i_arcName, dRes_info_c* i_resInfo, int i_
             return 0;
         }
 
+#if ENABLE_DVD_SCHEDULER
+        if (resInfo->set(i_arcName, i_path, i_mountDirection, i_heap, i_priority) == 0) {
+#else
         if (resInfo->set(i_arcName, i_path, i_mountDirection, i_heap) == 0) {
+#endif
             OSReport_Error("<%s.arc> dRes_control_c::setRes: res info set error !!\n", i_arcName);
             resInfo->~dRes_info_c();
             return 0;
         }
     }
 
+#if ENABLE_RES_INDEX
+    if (resInfo->incCount() == 1) {
+        dRes_index_c* index = dRes_getIndex(i_resInfo, i_infoNum);
+        if (index != NULL) {
+            index->entry(resInfo);
+        }
+    }
+#else
     resInfo->incCount();
+#endif
     return 1;
 }
 
@@ -827,12 +991,24 @@ int dRes_control_c::deleteRes(char const* i_arcName, dRes_info_c* i_resInfo, int
     }
 
     if (resInfo->decCount() == 0) {
+#if ENABLE_RES_INDEX
+        dRes_index_c* index = dRes_getIndex(i_resInfo, i_infoNum);
+        if (index != NULL) {
+            index->remove(resInfo);
+        }
+#endif
         resInfo->~dRes_info_c();
     }
     return 1;
 }
 
 dRes_info_c* dRes_control_c::getResInfo(char const* i_arcName, dRes_info_c* i_resInfo, int i_infoNum) {
+#if ENABLE_RES_INDEX
+    dRes_index_c* index = dRes_getIndex(i_resInfo, i_infoNum);
+    if (index != NULL) {
+        return index->search(i_arcName);
+    }
+#endif
     for (int i = 0; i < i_infoNum; i++) {
         if (i_resInfo->getCount() != 0) {
             if (!stricmp(i_arcName, i_resInfo->getArchiveName())) {
@@ -846,6 +1022,12 @@ dRes_info_c* dRes_control_c::getResInfo(char const* i_arcName, dRes_info_c* i_re
 }
 
 dRes_info_c* dRes_control_c::newResInfo(dRes_info_c* i_resInfo, int i_infoNum) {
+#if ENABLE_RES_INDEX
+    dRes_index_c* index = dRes_getIndex(i_resInfo, i_infoNum);
+    if (index != NULL) {
+        return index->getFree();
+    }
+#endif
     for (int i = 0; i < i_infoNum; i++) {
         if (i_resInfo->getCount() == 0) {
             return i_resInfo;
@@ -1004,11 +1186,20 @@ int dRes_control_c::setObjectRes(char const* i_arcName, void* i_archiveRes, u32
     return 1;
 }
 
+#if ENABLE_DVD_SCHEDULER
+int dRes_control_c::setStageRes(char const* i_arcName, JKRHeap* i_heap, u8 i_priority) {
+#else
 int dRes_control_c::setStageRes(char const* i_arcName, JKRHeap* i_heap) {
+#endif
     char path[20];
 
     snprintf(path, sizeof(path), "/res/Stage/%s/", dComIfGp_getStartStageName());
+#if ENABLE_DVD_SCHEDULER
+    return setRes(i_arcName, mStageInfo, ARRAY_SIZEU(mStageInfo), path, mDoDvd_MOUNT_DIRECTION_TAIL, i_heap,
+                  i_priority);
+#else
     return setRes(i_arcName, mStageInfo, ARRAY_SIZEU(mStageInfo), path, mDoDvd_MOUNT_DIRECTION_TAIL, i_heap);
+#endif
 }
 
 void dRes_control_c::dump() {
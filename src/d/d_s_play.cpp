@@ -738,6 +738,13 @@ static int dScnPly_Execute(dScnPly_c* i_this) {
 
     dKy_itudemo_se();
 
+    #if ENABLE_ROOM_PREFETCH
+    fopAc_ac_c* player = dComIfGp_getPlayer(0);
+    if (player != NULL) {
+        dStage_prefetchRoom(fopAcM_GetPosition_p(player));
+    }
+    #endif
+
     #if DEBUG
     if (mDoCPd_c::isConnect(PAD_3)) {
         if (mDoCPd_c::getTrigStart(PAD_1) && !fapGmHIO_get2Ddraw()) {
@@ -817,6 +824,12 @@ static int dScnPly_Delete(dScnPly_c* i_this) {
     }
     #endif
 
+    #if ENABLE_ROOM_PREFETCH
+    if (!dStage_resetPrefetchRoom()) {
+        return 0;
+    }
+    #endif
+
     daSus_c::reset();
     dMpath_c::remove();
     dTres_c::remove();
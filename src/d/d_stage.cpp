@@ -2,6 +2,7 @@
 
 #include "JSystem/JKernel/JKRAramArchive.h"
 #include "JSystem/JKernel/JKRExpHeap.h"
+#include "JSystem/JKernel/JKRMemArchive.h"
 #include "SSystem/SComponent/c_malloc.h"
 #include "d/actor/d_a_alink.h"
 #include "d/actor/d_a_suspend.h"
@@ -394,6 +395,331 @@ void dStage_roomControl_c::destroyMemoryBlock() {
     }
 }
 
+#if ENABLE_ROOM_PREFETCH
+#if !ENABLE_DVD_SCHEDULER
+#error "--room-prefetch needs the prioritized DVD thread (--dvd-scheduler)"
+#endif
+
+// Room archives behind a loading zone are mounted at prefetch priority while
+// the player is near its door, so the room scene finds them already queued
+// or resident. Prefetches never spill into another heap: a block must be
+// empty and big enough, and the archive heap keeps a reserve.
+// Only doors (TGDR) are followed. SCLS exits, from exit polygons
+// (dBgS::GetExitId) or scene exit actors, go through a scene change that ends
+// the stage, and dStage_resetPrefetchRoom would drop the archive before the
+// next stage could claim it; exit polygons also have no position to measure.
+#define ROOM_PREFETCH_MAX 2
+#define ROOM_PREFETCH_BYTE_MAX 0x200000
+#define ROOM_PREFETCH_RESERVE 0x80000
+
+enum {
+    ROOM_PREFETCH_IDLE,
+    ROOM_PREFETCH_LOADING,
+    ROOM_PREFETCH_DISCARD,
+};
+
+struct dStage_prefetchRoom_c {
+    /* 0x0 */ s8 mRoomNo;
+    /* 0x1 */ u8 mState;
+    /* 0x4 */ u32 mSize;
+};
+
+static const f32 l_prefetchStartDist = 1500.0f;
+static const f32 l_prefetchKeepDist = 2500.0f;
+
+static dStage_prefetchRoom_c l_prefetchRoom[ROOM_PREFETCH_MAX] = {
+    {-1, ROOM_PREFETCH_IDLE, 0},
+    {-1, ROOM_PREFETCH_IDLE, 0},
+};
+static u32 l_prefetchSize;
+static u64 l_prefetchSkip;
+static s8 l_prefetchStayNo = -1;
+static u32 l_prefetchHitNum;
+static u32 l_prefetchMissNum;
+
+/**
+ * Returns the squared distance to the nearest door in @p i_info joining the two
+ * rooms, or @p i_dist if that is nearer. A negative @p i_dist means none yet.
+ */
+static f32 dStage_prefetchRoom_getDoorDist(dStage_KeepDoorInfo* i_info, int i_stayNo, int i_roomNo,
+                                           const cXyz* i_pos, f32 i_dist) {
+    stage_tgsc_data_class* door = i_info->mDrTgData;
+    for (int i = 0; i < i_info->mNum; i++, door++) {
+        int frontNo = (door->base.parameters >> 0xD) & 0x3F;
+        int backNo = (door->base.parameters >> 0x13) & 0x3F;
+        if ((frontNo == i_stayNo && backNo == i_roomNo) ||
+            (frontNo == i_roomNo && backNo == i_stayNo))
+        {
+            f32 dist = i_pos->abs2(door->base.position);
+            if (i_dist < 0.0f || dist < i_dist) {
+                i_dist = dist;
+            }
+        }
+    }
+    return i_dist;
+}
+
+static f32 dStage_prefetchRoom_getDist(int i_stayNo, int i_roomNo, const cXyz* i_pos) {
+    f32 dist = dStage_prefetchRoom_getDoorDist(dStage_GetKeepDoorInfo(), i_stayNo, i_roomNo, i_pos,
+                                               -1.0f);
+    return dStage_prefetchRoom_getDoorDist(dStage_GetRoomKeepDoorInfo(), i_stayNo, i_roomNo, i_pos,
+                                           dist);
+}
+
+/** Returns true if another room sharing @p i_roomNo's memory block is loading. */
+static bool dStage_prefetchRoom_checkBlock(int i_roomNo) {
+    int blockId = dStage_roomControl_c::getMemoryBlockID(i_roomNo);
+    if (blockId < 0) {
+        return false;
+    }
+
+    for (int roomNo = 0; roomNo < 0x40; roomNo++) {
+        if (roomNo != i_roomNo && dStage_roomControl_c::getMemoryBlockID(roomNo) == blockId &&
+            dComIfGp_roomControl_checkStatusFlag(roomNo, 0x02 | 0x04))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool dStage_prefetchRoom_isUsed(int i_roomNo) {
+    int blockId = dStage_roomControl_c::getMemoryBlockID(i_roomNo);
+    for (int i = 0; i < ROOM_PREFETCH_MAX; i++) {
+        int roomNo = l_prefetchRoom[i].mRoomNo;
+        if (roomNo == i_roomNo ||
+            (roomNo >= 0 && blockId >= 0 &&
+             dStage_roomControl_c::getMemoryBlockID(roomNo) == blockId))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds the room behind the nearest door of @p i_stayNo in @p i_info that is
+ * closer than @p io_dist and could be prefetched.
+ */
+static void dStage_prefetchRoom_getNear(dStage_KeepDoorInfo* i_info, int i_stayNo,
+                                        const cXyz* i_pos, int* io_roomNo, f32* io_dist) {
+    stage_tgsc_data_class* door = i_info->mDrTgData;
+    for (int i = 0; i < i_info->mNum; i++, door++) {
+        int frontNo = (door->base.parameters >> 0xD) & 0x3F;
+        int backNo = (door->base.parameters >> 0x13) & 0x3F;
+        int roomNo;
+        if (frontNo == i_stayNo) {
+            roomNo = backNo;
+        } else if (backNo == i_stayNo) {
+            roomNo = frontNo;
+        } else {
+            continue;
+        }
+
+        if (roomNo == i_stayNo || (l_prefetchSkip & (1ULL << roomNo)) ||
+            dComIfGp_roomControl_checkStatusFlag(roomNo, 0x01 | 0x02 | 0x04))
+        {
+            continue;
+        }
+
+        f32 dist = i_pos->abs2(door->base.position);
+        if (dist < *io_dist && !dStage_prefetchRoom_isUsed(roomNo) &&
+            !dStage_prefetchRoom_checkBlock(roomNo) &&
+            dComIfG_getStageResInfo(dComIfG_getRoomArcName(roomNo)) == NULL)
+        {
+            *io_roomNo = roomNo;
+            *io_dist = dist;
+        }
+    }
+}
+
+/**
+ * Starts mounting @p i_roomNo's archive at prefetch priority. Returns false
+ * and marks the room as skipped until the player changes rooms if it does not
+ * fit.
+ */
+static bool dStage_prefetchRoom_start(dStage_prefetchRoom_c* i_prefetch, int i_roomNo) {
+    // Same heap choice as phase_1 of the room scene.
+    JKRExpHeap* block = dStage_roomControl_c::getMemoryBlock(i_roomNo);
+    JKRHeap* heap = block;
+    u32 reserve = 0x100;
+    if (block != NULL) {
+        // The room that used the block last is still being torn down.
+        if (block->getTotalUsedSize() != 0) {
+            return false;
+        }
+    } else {
+        if (dStage_staginfo_GetArchiveHeap(dComIfGp_getStage()->getStagInfo())) {
+            heap = mDoExt_getArchiveHeap();
+        }
+        reserve = ROOM_PREFETCH_RESERVE;
+    }
+
+    const char* arcName = dComIfG_getRoomArcName(i_roomNo);
+    char path[40];
+    snprintf(path, sizeof(path), "/res/Stage/%s/%s.arc", dComIfGp_getStartStageName(), arcName);
+
+    DVDFileInfo fileInfo;
+    s32 entryNum = DVDConvertPathToEntrynum(path);
+    if (entryNum < 0 || !DVDFastOpen(entryNum, &fileInfo)) {
+        l_prefetchSkip |= 1ULL << i_roomNo;
+        return false;
+    }
+
+    u32 size = fileInfo.length;
+    JKRHeap* mountHeap = heap != NULL ? heap : mDoExt_getArchiveHeap();
+    if (l_prefetchSize + size > ROOM_PREFETCH_BYTE_MAX || mountHeap->getFreeSize() < size + reserve) {
+        l_prefetchSkip |= 1ULL << i_roomNo;
+        return false;
+    }
+
+    if (!dComIfG_setStageRes(arcName, heap, mDoDvdThd_PRIORITY_PREFETCH)) {
+        l_prefetchSkip |= 1ULL << i_roomNo;
+        return false;
+    }
+
+    i_prefetch->mRoomNo = i_roomNo;
+    i_prefetch->mState = ROOM_PREFETCH_LOADING;
+    i_prefetch->mSize = size;
+    l_prefetchSize += size;
+    return true;
+}
+
+static void dStage_prefetchRoom_clear(dStage_prefetchRoom_c* i_prefetch) {
+    l_prefetchSize -= i_prefetch->mSize;
+    i_prefetch->mRoomNo = -1;
+    i_prefetch->mState = ROOM_PREFETCH_IDLE;
+    i_prefetch->mSize = 0;
+}
+
+/**
+ * Releases a prefetch nobody claimed. A command still queued is cancelled; one
+ * the DVD thread is running has to finish first, so this returns false until it
+ * does.
+ */
+static bool dStage_prefetchRoom_discard(dStage_prefetchRoom_c* i_prefetch) {
+    int roomNo = i_prefetch->mRoomNo;
+    const char* arcName = dComIfG_getRoomArcName(roomNo);
+    dRes_info_c* resInfo = dComIfG_getStageResInfo(arcName);
+    i_prefetch->mState = ROOM_PREFETCH_DISCARD;
+
+    if (resInfo != NULL) {
+        mDoDvdThd_mountArchive_c* command = resInfo->getDMCommand();
+        if (command != NULL && !command->cancel()) {
+            if (command->sync() == 0) {
+                return false;
+            }
+            // The archive was mounted but never handed to a dRes_info_c.
+            if (command->getArchive() != NULL) {
+                command->getArchive()->unmount();
+            }
+        }
+        dComIfG_deleteStageRes(arcName);
+    }
+
+    JKRExpHeap* block = dStage_roomControl_c::getMemoryBlock(roomNo);
+    if (block != NULL) {
+        block->freeAll();
+    }
+
+    l_prefetchMissNum++;
+    dStage_prefetchRoom_clear(i_prefetch);
+    return true;
+}
+
+/**
+ * Called once a frame with the player position. Hands prefetches over to room
+ * scenes that started loading them, drops those the player walked away from,
+ * and starts the nearest unloaded neighbour of the current room.
+ */
+void dStage_prefetchRoom(const cXyz* i_pos) {
+    int stayNo = dStage_roomControl_c::getStayNo();
+    if (stayNo != l_prefetchStayNo) {
+        l_prefetchStayNo = stayNo;
+        l_prefetchSkip = 0;
+    }
+
+    dStage_prefetchRoom_c* freePrefetch = NULL;
+    dStage_prefetchRoom_c* prefetch = l_prefetchRoom;
+    for (int i = 0; i < ROOM_PREFETCH_MAX; i++, prefetch++) {
+        int roomNo = prefetch->mRoomNo;
+        if (roomNo < 0) {
+            freePrefetch = prefetch;
+            continue;
+        }
+
+        if (dComIfGp_roomControl_checkStatusFlag(roomNo, 0x01 | 0x02 | 0x04)) {
+            // The room scene owns the archive from here on, even if it was
+            // about to be dropped.
+            dRes_info_c* resInfo = dComIfG_getStageResInfo(dComIfG_getRoomArcName(roomNo));
+            if (resInfo != NULL && resInfo->getDMCommand() != NULL) {
+                resInfo->getDMCommand()->setPriority(mDoDvdThd_PRIORITY_CRITICAL);
+            }
+            l_prefetchHitNum++;
+            dStage_prefetchRoom_clear(prefetch);
+            continue;
+        }
+
+        if (prefetch->mState == ROOM_PREFETCH_DISCARD) {
+            dStage_prefetchRoom_discard(prefetch);
+            continue;
+        }
+
+        f32 dist = stayNo >= 0 ? dStage_prefetchRoom_getDist(stayNo, roomNo, i_pos) : -1.0f;
+        if (dist < 0.0f || dist > l_prefetchKeepDist * l_prefetchKeepDist ||
+            dStage_prefetchRoom_checkBlock(roomNo))
+        {
+            dStage_prefetchRoom_discard(prefetch);
+        }
+    }
+
+    if (freePrefetch == NULL || stayNo < 0) {
+        return;
+    }
+
+    int nearNo = -1;
+    f32 nearDist = l_prefetchStartDist * l_prefetchStartDist;
+    dStage_prefetchRoom_getNear(dStage_GetKeepDoorInfo(), stayNo, i_pos, &nearNo, &nearDist);
+    dStage_prefetchRoom_getNear(dStage_GetRoomKeepDoorInfo(), stayNo, i_pos, &nearNo, &nearDist);
+    if (nearNo >= 0) {
+        dStage_prefetchRoom_start(freePrefetch, nearNo);
+    }
+}
+
+/**
+ * Drops every unclaimed prefetch before the stage ends. Returns FALSE while
+ * one is still being read.
+ */
+BOOL dStage_resetPrefetchRoom() {
+    BOOL result = TRUE;
+    dStage_prefetchRoom_c* prefetch = l_prefetchRoom;
+    for (int i = 0; i < ROOM_PREFETCH_MAX; i++, prefetch++) {
+        if (prefetch->mRoomNo < 0) {
+            continue;
+        }
+
+        if (dComIfGp_roomControl_checkStatusFlag(prefetch->mRoomNo, 0x01 | 0x02 | 0x04))
+        {
+            l_prefetchHitNum++;
+            dStage_prefetchRoom_clear(prefetch);
+        } else if (!dStage_prefetchRoom_discard(prefetch)) {
+            result = FALSE;
+        }
+    }
+
+    if (result) {
+        l_prefetchStayNo = -1;
+        l_prefetchSkip = 0;
+    }
+    return result;
+}
+
+void dStage_getPrefetchRoomStat(u32* o_hitNum, u32* o_missNum) {
+    *o_hitNum = l_prefetchHitNum;
+    *o_missNum = l_prefetchMissNum;
+}
+#endif
+
 void dStage_roomControl_c::setArcBank(int i_bank, char const* bankName) {
     JUT_ASSERT(1053, 0 <= i_bank && i_bank < 32);
     strncpy(&mArcBank[i_bank][0], bankName, 9);
@@ -2164,10 +2490,69 @@ static void dStage_setLayerTagName(FuncTable* funcTbl, int tblSize, int i_layerN
     }
 }
 
+#if ENABLE_STAGE_DECODE_INDEX
+// Open addressing table of chunk number + 1 keyed by tag. Files with more
+// than half as many chunks fall back to the per table entry scan, as do
+// tables too short to pay for hashing the file (most layer tables).
+#define DSTAGE_DECODE_HASH_NUM 256
+#define DSTAGE_DECODE_TABLE_MIN 8
+
+static inline u32 dStage_dt_c_hashTag(u32 tag) {
+    return (tag * 0x9E3779B1) >> 24;
+}
+
+/**
+ * Hashes the chunk headers of @p file by tag, keeping the first chunk of
+ * each tag, which is the one the linear scan would have found.
+ */
+static void dStage_dt_c_hashChunk(dStage_fileHeader* file, u8* o_table) {
+    memset(o_table, 0, DSTAGE_DECODE_HASH_NUM);
+    for (int i = 0; i < file->m_chunkCount; i++) {
+        u32 tag = file->m_nodes[i].m_tag;
+        u32 slot = dStage_dt_c_hashTag(tag);
+        while (o_table[slot] != 0 && file->m_nodes[o_table[slot] - 1].m_tag != tag) {
+            slot = (slot + 1) & (DSTAGE_DECODE_HASH_NUM - 1);
+        }
+        if (o_table[slot] == 0) {
+            o_table[slot] = i + 1;
+        }
+    }
+}
+
+static dStage_nodeHeader* dStage_dt_c_searchChunk(dStage_fileHeader* file, const u8* table,
+                                                  u32 tag) {
+    for (u32 slot = dStage_dt_c_hashTag(tag); table[slot] != 0;
+         slot = (slot + 1) & (DSTAGE_DECODE_HASH_NUM - 1))
+    {
+        dStage_nodeHeader* node = &file->m_nodes[table[slot] - 1];
+        if (node->m_tag == tag) {
+            return node;
+        }
+    }
+    return NULL;
+}
+#endif
+
 static void dStage_dt_c_decode(void* i_data, dStage_dt_c* i_stage, FuncTable* funcTbl,
                                int tblSize) {
     if (i_data != NULL) {
         dStage_fileHeader* file = (dStage_fileHeader*)i_data;
+#if ENABLE_STAGE_DECODE_INDEX
+        if (file->m_chunkCount <= DSTAGE_DECODE_HASH_NUM / 2 &&
+            tblSize >= DSTAGE_DECODE_TABLE_MIN)
+        {
+            u8 table[DSTAGE_DECODE_HASH_NUM];
+            dStage_dt_c_hashChunk(file, table);
+            for (int i = 0; i < tblSize; i++) {
+                dStage_nodeHeader* node =
+                    dStage_dt_c_searchChunk(file, table, *(u32*)funcTbl[i].identifier);
+                if (node != NULL && funcTbl[i].function != NULL) {
+                    funcTbl[i].function(i_stage, node, node->m_entryNum, i_data);
+                }
+            }
+            return;
+        }
+#endif
         dStage_nodeHeader* node1 = file->m_nodes;
         for (int i = 0; i < tblSize; i++) {
             node1 = file->m_nodes;
@@ -244,7 +244,11 @@ static int fopAc_Draw(void* i_this) {
     if (!dComIfGp_isPauseFlag()) {
         int var_r28 = dComIfGp_event_moveApproval(actor);
         if ((var_r28 == 2 || (!fopAcM_CheckStatus(actor, fopAc_ac_c::getStopStatus()) &&
+#if ENABLE_CULL_BATCH
+            (!fopAcM_CheckStatus(actor, fopAcStts_CULL_e) || !fopAcM_cullingCheckBatched(actor)))) &&
+#else
             (!fopAcM_CheckStatus(actor, fopAcStts_CULL_e) || !fopAcM_cullingCheck(actor)))) &&
+#endif
             !fopAcM_CheckStatus(actor, 0x21000000))
         {
             fopAcM_OffCondition(actor, fopAcCnd_NODRAW_e);
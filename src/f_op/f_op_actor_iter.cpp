@@ -8,6 +8,10 @@
 #include "SSystem/SComponent/c_tag_iter.h"
 #include "f_op/f_op_actor_tag.h"
 
+#if ENABLE_PROCESS_INDEX
+#include "f_pc/f_pc_searcher.h"
+#endif
+
 int fopAcIt_Executor(fopAcIt_ExecutorFunc i_execFunc, void* i_data) {
     struct {
         fopAcIt_ExecutorFunc func;
@@ -29,3 +33,21 @@ void* fopAcIt_Judge(fopAcIt_JudgeFunc i_judgeFunc, void* i_data) {
 
     return cLsIt_Judge(&g_fopAcTg_Queue, (cNdIt_JudgeFunc)cTgIt_JudgeFilter, &userData);
 }
+
+#if ENABLE_PROCESS_INDEX
+void* fopAcIt_SearchByID(fpc_ProcID i_id) {
+    base_process_class* process;
+    if (fpcSch_SearchIndexByID(&g_fopAcTg_Index, i_id, &process) != fpcSch_INDEX_UNKNOWN) {
+        return process;
+    }
+    return fopAcIt_Judge(fpcSch_JudgeByID, &i_id);
+}
+
+void* fopAcIt_SearchByName(s16 i_name) {
+    base_process_class* process;
+    if (fpcSch_SearchIndexByName(&g_fopAcTg_Index, i_name, &process) != fpcSch_INDEX_UNKNOWN) {
+        return process;
+    }
+    return fopAcIt_Judge(fpcSch_JudgeForPName, &i_name);
+}
+#endif
@@ -24,6 +24,10 @@
 #include "m_Do/m_Do_lib.h"
 #include <cstring>
 
+#if ENABLE_CULL_BATCH
+#include "SSystem/SComponent/c_counter.h"
+#endif
+
 #define MAKE_ITEM_PARAMS(itemNo, itemBitNo, param_2, param_3)                                      \
     ((itemNo & 0xFF) << 0x0 | (itemBitNo & 0xFF) << 0x8 | (param_2 & 0xFF) << 0x10 | (param_3 & 0xF) << 0x18)
 
@@ -148,7 +152,11 @@ s32 fopAcM_SearchByID(fpc_ProcID i_actorID, fopAc_ac_c** i_outActor) {
     if (fpcM_IsCreating(i_actorID)) {
         *i_outActor = NULL;
     } else {
+#if ENABLE_PROCESS_INDEX
+        *i_outActor = (fopAc_ac_c*)fopAcIt_SearchByID(i_actorID);
+#else
         *i_outActor = (fopAc_ac_c*)fopAcIt_Judge((fopAcIt_JudgeFunc)fpcSch_JudgeByID, &i_actorID);
+#endif
         if (*i_outActor == NULL) {
             return 0;
         }
@@ -157,7 +165,11 @@ s32 fopAcM_SearchByID(fpc_ProcID i_actorID, fopAc_ac_c** i_outActor) {
 }
 
 s32 fopAcM_SearchByName(s16 i_procName, fopAc_ac_c** i_outActor) {
+#if ENABLE_PROCESS_INDEX
+    *i_outActor = (fopAc_ac_c*)fopAcIt_SearchByName(i_procName);
+#else
     *i_outActor = (fopAc_ac_c*)fopAcIt_Judge((fopAcIt_JudgeFunc)fpcSch_JudgeForPName, &i_procName);
+#endif
     if (*i_outActor == NULL) {
         return 0;
     } else {
@@ -734,12 +746,18 @@ void fopAcM_SetMin(fopAc_ac_c* i_actor, f32 i_minX, f32 i_minY, f32 i_minZ) {
     i_actor->cull.box.min.x = i_minX;
     i_actor->cull.box.min.y = i_minY;
     i_actor->cull.box.min.z = i_minZ;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 void fopAcM_SetMax(fopAc_ac_c* i_actor, f32 i_maxX, f32 i_maxY, f32 i_maxZ) {
     i_actor->cull.box.max.x = i_maxX;
     i_actor->cull.box.max.y = i_maxY;
     i_actor->cull.box.max.z = i_maxZ;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 void fopAcM_setCullSizeBox(fopAc_ac_c* i_actor, f32 i_minX, f32 i_minY, f32 i_minZ, f32 i_maxX,
@@ -751,6 +769,9 @@ void fopAcM_setCullSizeBox(fopAc_ac_c* i_actor, f32 i_minX, f32 i_minY, f32 i_mi
     i_actor->cull.box.max.x = i_maxX;
     i_actor->cull.box.max.y = i_maxY;
     i_actor->cull.box.max.z = i_maxZ;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 void fopAcM_setCullSizeSphere(fopAc_ac_c* i_actor, f32 i_minX, f32 i_minY, f32 i_minZ, f32 radius) {
@@ -758,6 +779,9 @@ void fopAcM_setCullSizeSphere(fopAc_ac_c* i_actor, f32 i_minX, f32 i_minY, f32 i
     i_actor->cull.sphere.center.y = i_minY;
     i_actor->cull.sphere.center.z = i_minZ;
     i_actor->cull.sphere.radius = radius;
+#if ENABLE_CULL_BATCH
+    i_actor->cullBatch = 0;
+#endif
 }
 
 void fopAcM_setCullSizeBox2(fopAc_ac_c* i_actor, J3DModelData* i_modelData) {
@@ -1066,6 +1090,201 @@ s32 fopAcM_cullingCheck(fopAc_ac_c const* i_actor) {
     return mDoLib_clipper::clip(mtx_p, sphere->center, sphere->radius);
 }
 
+#if ENABLE_CULL_BATCH
+#define fopAcM_CULL_BATCH_MAX 0x200
+
+static struct {
+    u32 frame;
+    u8 generation;
+    f32 far;
+    Mtx view;
+} l_cullBatch;
+
+static struct {
+    fopAc_ac_c* actor[fopAcM_CULL_BATCH_MAX];
+    f32 x[fopAcM_CULL_BATCH_MAX];
+    f32 y[fopAcM_CULL_BATCH_MAX];
+    f32 z[fopAcM_CULL_BATCH_MAX];
+    f32 radius[fopAcM_CULL_BATCH_MAX];
+    f32 far[fopAcM_CULL_BATCH_MAX];
+    u8 result[fopAcM_CULL_BATCH_MAX];
+    u32 num;
+} l_cullSphere;
+
+static struct {
+    fopAc_ac_c* actor[fopAcM_CULL_BATCH_MAX];
+    f32 x[fopAcM_CULL_BATCH_MAX];
+    f32 y[fopAcM_CULL_BATCH_MAX];
+    f32 z[fopAcM_CULL_BATCH_MAX];
+    f32 axis[9][fopAcM_CULL_BATCH_MAX];
+    f32 far[fopAcM_CULL_BATCH_MAX];
+    u8 result[fopAcM_CULL_BATCH_MAX];
+    u32 num;
+} l_cullBox;
+
+static int fopAcM_cullingCheckAllSub(void* i_actor, void*) {
+    fopAc_ac_c* actor = (fopAc_ac_c*)i_actor;
+    actor->cullBatch = 0;
+
+    if (!fopAcM_CheckStatus(actor, fopAcStts_CULL_e)) {
+        return 1;
+    }
+
+    MtxP mtx_p;
+    Mtx concat_mtx;
+    if (fopAcM_GetMtx(actor) == NULL) {
+        mtx_p = j3dSys.getViewMtx();
+    } else {
+        cMtx_concat(j3dSys.getViewMtx(), fopAcM_GetMtx(actor), concat_mtx);
+        mtx_p = concat_mtx;
+    }
+
+    f32 far = l_cullBatch.far;
+    if (fopAcM_getCullSizeFar(actor) > 0.0f) {
+        f32 cullsize_far = fopAcM_getCullSizeFar(actor);
+        if (dComIfGp_event_runCheck()) {
+            cullsize_far *= dComIfGp_event_getCullRate();
+        }
+        far = cullsize_far * mDoLib_clipper::getFar();
+    }
+
+    Vec center;
+    if (fopAcM_CULLSIZE_IS_BOX(fopAcM_GetCullSize(actor))) {
+        if (l_cullBox.num >= fopAcM_CULL_BATCH_MAX) {
+            return 1;
+        }
+
+        cull_box* box;
+        if (fopAcM_GetCullSize(actor) == fopAc_CULLBOX_CUSTOM_e) {
+            box = &actor->cull.box;
+        } else {
+            box = &l_cullSizeBox[fopAcM_CULLSIZE_IDX(fopAcM_GetCullSize(actor))];
+        }
+
+        Vec half;
+        center.x = (box->max.x + box->min.x) * 0.5f;
+        center.y = (box->max.y + box->min.y) * 0.5f;
+        center.z = (box->max.z + box->min.z) * 0.5f;
+        half.x = (box->max.x - box->min.x) * 0.5f;
+        half.y = (box->max.y - box->min.y) * 0.5f;
+        half.z = (box->max.z - box->min.z) * 0.5f;
+
+        Vec view_center;
+        mDoMtx_multVec(mtx_p, &center, &view_center);
+
+        u32 no = l_cullBox.num++;
+        l_cullBox.actor[no] = actor;
+        l_cullBox.x[no] = view_center.x;
+        l_cullBox.y[no] = view_center.y;
+        l_cullBox.z[no] = view_center.z;
+        for (int i = 0; i < 3; i++) {
+            l_cullBox.axis[i][no] = mtx_p[i][0] * half.x;
+            l_cullBox.axis[3 + i][no] = mtx_p[i][1] * half.y;
+            l_cullBox.axis[6 + i][no] = mtx_p[i][2] * half.z;
+        }
+        l_cullBox.far[no] = far;
+        return 1;
+    }
+
+    if (l_cullSphere.num >= fopAcM_CULL_BATCH_MAX) {
+        return 1;
+    }
+
+    f32 radius;
+    if (fopAcM_GetCullSize(actor) == fopAc_CULLSPHERE_CUSTOM_e) {
+        center = fopAcM_getCullSizeSphereCenter(actor);
+        radius = fopAcM_getCullSizeSphereR(actor);
+    } else {
+        cull_sphere* sphere =
+            &l_cullSizeSphere[fopAcM_CULLSIZE_Q_IDX(fopAcM_GetCullSize(actor))];
+        center = sphere->center;
+        radius = sphere->radius;
+    }
+
+    Vec view_center;
+    mDoMtx_multVec(mtx_p, &center, &view_center);
+
+    u32 no = l_cullSphere.num++;
+    l_cullSphere.actor[no] = actor;
+    l_cullSphere.x[no] = view_center.x;
+    l_cullSphere.y[no] = view_center.y;
+    l_cullSphere.z[no] = view_center.z;
+    l_cullSphere.radius[no] = radius;
+    l_cullSphere.far[no] = far;
+    return 1;
+}
+
+/**
+ * Culls every actor in the actor queue against the current view in one
+ * pass and stores the result in each actor's cullBatch. Run once the view
+ * matrix for the frame is set; fopAc_Draw then reads the result through
+ * fopAcM_cullingCheckBatched. Actors that do not fit in the batch are
+ * left unstamped and fall back to fopAcM_cullingCheck.
+ */
+void fopAcM_cullingCheckAll() {
+    if (++l_cullBatch.generation > 0x7F) {
+        l_cullBatch.generation = 1;
+    }
+    l_cullBatch.frame = g_Counter.mCounter0;
+    l_cullBatch.far = mDoLib_clipper::mClipper.getFar();
+    cMtx_copy(j3dSys.getViewMtx(), l_cullBatch.view);
+
+    l_cullSphere.num = 0;
+    l_cullBox.num = 0;
+    fopAcIt_Executor(fopAcM_cullingCheckAllSub, NULL);
+
+    mDoLib_clipper::mClipper.clipSphereBatch(l_cullSphere.num, l_cullSphere.x, l_cullSphere.y,
+                                             l_cullSphere.z, l_cullSphere.radius,
+                                             l_cullSphere.far, l_cullSphere.result);
+
+    const f32* axis[9];
+    for (int i = 0; i < 9; i++) {
+        axis[i] = l_cullBox.axis[i];
+    }
+    mDoLib_clipper::mClipper.clipBoxBatch(l_cullBox.num, l_cullBox.x, l_cullBox.y, l_cullBox.z,
+                                          axis, l_cullBox.far, l_cullBox.result);
+
+    u8 stamp = l_cullBatch.generation << 1;
+    for (u32 i = 0; i < l_cullSphere.num; i++) {
+        l_cullSphere.actor[i]->cullBatch = stamp | l_cullSphere.result[i];
+    }
+    for (u32 i = 0; i < l_cullBox.num; i++) {
+        l_cullBox.actor[i]->cullBatch = stamp | l_cullBox.result[i];
+    }
+}
+
+/**
+ * Returns the result the actor was stamped with by this frame's
+ * fopAcM_cullingCheckAll while the view and far distance are the ones it
+ * ran with, and falls back to fopAcM_cullingCheck otherwise. The cull
+ * setters clear the stamp, so an actor whose cull matrix or shape is
+ * replaced after the batch is checked again. Cull matrices themselves are
+ * written in execute, before the camera draws.
+ */
+s32 fopAcM_cullingCheckBatched(const fopAc_ac_c* i_actor) {
+    if ((i_actor->cullBatch >> 1) == l_cullBatch.generation &&
+        l_cullBatch.frame == g_Counter.mCounter0 &&
+        l_cullBatch.far == mDoLib_clipper::mClipper.getFar())
+    {
+        MtxP view = j3dSys.getViewMtx();
+        BOOL same_view = TRUE;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                if (view[i][j] != l_cullBatch.view[i][j]) {
+                    same_view = FALSE;
+                }
+            }
+        }
+
+        if (same_view) {
+            return i_actor->cullBatch & 1;
+        }
+    }
+
+    return fopAcM_cullingCheck(i_actor);
+}
+#endif
+
 void* event_second_actor(u16 i_flag) {
     (void)i_flag;
     return dComIfGp_getPlayer(0);
@@ -6,14 +6,36 @@
 #include "f_op/f_op_actor_tag.h"
 #include "SSystem/SComponent/c_list.h"
 
+#if ENABLE_PROCESS_INDEX
+#include "f_pc/f_pc_searcher.h"
+#endif
+
 node_list_class g_fopAcTg_Queue = {NULL, NULL, 0};
 
+#if ENABLE_PROCESS_INDEX
+process_search_index g_fopAcTg_Index;
+#endif
+
 int fopAcTg_ToActorQ(create_tag_class* i_createTag) {
+#if ENABLE_PROCESS_INDEX
+    int ret = cTg_Addition(&g_fopAcTg_Queue, i_createTag);
+    if (ret) {
+        fpcSch_AddIndex(&g_fopAcTg_Index, (base_process_class*)i_createTag->mpTagData);
+    }
+    return ret;
+#else
     return cTg_Addition(&g_fopAcTg_Queue, i_createTag);
+#endif
 }
 
 void fopAcTg_ActorQTo(create_tag_class* i_createTag) {
+#if ENABLE_PROCESS_INDEX
+    if (cTg_SingleCutFromTree(i_createTag)) {
+        fpcSch_RemoveIndex(&g_fopAcTg_Index, (base_process_class*)i_createTag->mpTagData);
+    }
+#else
     int _ = cTg_SingleCutFromTree(i_createTag);
+#endif
 }
 
 int fopAcTg_Init(create_tag_class* i_createTag, void* i_data) {
@@ -15,6 +15,11 @@
 #include "f_pc/f_pc_debug_sv.h"
 #include "Z2AudioLib/Z2AudioMgr.h"
 
+#if ENABLE_HEAP_TRACE
+/** Heap trace tag for a process: its profile name with the top bit set. */
+#define FPCBS_TRACE_TAG(profname) (0x8000 | (u16)(profname))
+#endif
+
 BOOL fpcBs_Is_JustOfType(int i_typeA, int i_typeB) {
     if (i_typeB == i_typeA) {
         return TRUE;
@@ -52,6 +57,7 @@ int fpcBs_Execute(base_process_class* i_proc) {
 #endif
 
     if (result == 1) {
+        JKR_HEAP_TRACE_TAG(FPCBS_TRACE_TAG(i_proc->profname));
         layer_class* save_layer = fpcLy_CurrentLayer();
 
         fpcLy_SetCurrentLayer(i_proc->layer_tag.layer);
@@ -116,6 +122,7 @@ base_process_class* fpcBs_Create(s16 i_profname, fpc_ProcID i_procID, void* i_ap
     process_profile_definition* pprofile;
     base_process_class* pprocess;
     u32 size;
+    JKR_HEAP_TRACE_TAG(FPCBS_TRACE_TAG(i_profname));
 
     pprofile = (process_profile_definition*)fpcPf_Get(i_profname);
     size = pprofile->process_size + pprofile->unk_size;
@@ -147,6 +154,7 @@ base_process_class* fpcBs_Create(s16 i_profname, fpc_ProcID i_procID, void* i_ap
 }
 
 int fpcBs_SubCreate(base_process_class* i_proc) {
+    JKR_HEAP_TRACE_TAG(FPCBS_TRACE_TAG(i_proc->profname));
     switch (fpcMtd_Create(i_proc->methods, i_proc)) {
     case cPhs_NEXT_e:
     case cPhs_COMPLEATE_e:
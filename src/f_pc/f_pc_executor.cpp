@@ -16,11 +16,27 @@ base_process_class* fpcEx_Search(fpcLyIt_JudgeFunc i_judgeFunc, void* i_data) {
 
 base_process_class* fpcEx_SearchByID(fpc_ProcID i_id) {
     if (!(i_id == fpcM_UNK_PROCESS_ID_e || i_id == fpcM_ERROR_PROCESS_ID_e)) {
+#if ENABLE_PROCESS_INDEX
+        base_process_class* process;
+        if (fpcSch_SearchIndexByID(&g_fpcLyTg_Index, i_id, &process) != fpcSch_INDEX_UNKNOWN) {
+            return process;
+        }
+#endif
         return fpcEx_Search(fpcSch_JudgeByID, &i_id);
     }
     return NULL;
 }
 
+#if ENABLE_PROCESS_INDEX
+base_process_class* fpcEx_SearchByName(s16 i_name) {
+    base_process_class* process;
+    if (fpcSch_SearchIndexByName(&g_fpcLyTg_Index, i_name, &process) != fpcSch_INDEX_UNKNOWN) {
+        return process;
+    }
+    return fpcEx_Search(fpcSch_JudgeForPName, &i_name);
+}
+#endif
+
 BOOL fpcEx_IsExist(fpc_ProcID i_id) {
     if (fpcEx_SearchByID(i_id) != NULL) {
         return TRUE;
@@ -6,6 +6,12 @@
 #include "f_pc/f_pc_layer_tag.h"
 #include "f_pc/f_pc_layer.h"
 
+#if ENABLE_PROCESS_INDEX
+#include "f_pc/f_pc_searcher.h"
+
+process_search_index g_fpcLyTg_Index;
+#endif
+
 int fpcLyTg_ToQueue(layer_management_tag_class* i_layer_tag, fpc_ProcID i_layerID, u16 i_listID,
                     u16 i_listPriority) {
     if (i_layer_tag->layer == NULL && i_layerID == fpcLy_NONE_e) {
@@ -21,6 +27,9 @@ int fpcLyTg_ToQueue(layer_management_tag_class* i_layer_tag, fpc_ProcID i_layerI
         if (result != 0) {
             i_layer_tag->node_list_id = i_listID;
             i_layer_tag->node_list_priority = result - 1;
+#if ENABLE_PROCESS_INDEX
+            fpcSch_AddIndex(&g_fpcLyTg_Index, (base_process_class*)i_layer_tag->create_tag.mpTagData);
+#endif
             return 1;
         }
     } else if (fpcLy_IntoQueue(i_layer_tag->layer, i_listID, &i_layer_tag->create_tag,
@@ -28,6 +37,9 @@ int fpcLyTg_ToQueue(layer_management_tag_class* i_layer_tag, fpc_ProcID i_layerI
     {
         i_layer_tag->node_list_id = i_listID;
         i_layer_tag->node_list_priority = i_listPriority;
+#if ENABLE_PROCESS_INDEX
+        fpcSch_AddIndex(&g_fpcLyTg_Index, (base_process_class*)i_layer_tag->create_tag.mpTagData);
+#endif
         return 1;
     }
 
@@ -39,6 +51,9 @@ int fpcLyTg_QueueTo(layer_management_tag_class* i_layer_tag) {
         i_layer_tag->layer = NULL;
         i_layer_tag->node_list_id = 0xFFFF;
         i_layer_tag->node_list_priority = 0xFFFF;
+#if ENABLE_PROCESS_INDEX
+        fpcSch_RemoveIndex(&g_fpcLyTg_Index, (base_process_class*)i_layer_tag->create_tag.mpTagData);
+#endif
         return 1;
     }
 
@@ -20,6 +20,9 @@
 #include "f_pc/f_pc_pause.h"
 #include "f_pc/f_pc_priority.h"
 #include "m_Do/m_Do_controller_pad.h"
+#if ENABLE_ANM_BATCH
+#include "m_Do/m_Do_ext.h"
+#endif
 
 void fpcM_Draw(void* i_proc) {
     fpcDw_Execute((base_process_class*)i_proc);
@@ -65,6 +68,9 @@ void fpcM_Management(fpcM_ManagementFunc i_preExecuteFn, fpcM_ManagementFunc i_p
             } else {
                 dPa_control_c::offStatus(1);
             }
+#if ENABLE_ANM_BATCH
+            mDoExt_modelCalcBegin();
+#endif
 
             if (!fpcPi_Handler()) {
                 JUT_ASSERT(353, FALSE);
@@ -81,6 +87,9 @@ void fpcM_Management(fpcM_ManagementFunc i_preExecuteFn, fpcM_ManagementFunc i_p
             if (!fapGm_HIO_c::isCaptureScreen()) {
                 fpcEx_Handler((fpcLnIt_QueueFunc)fpcM_Execute);
             }
+#if ENABLE_ANM_BATCH
+            mDoExt_modelCalcFlush();
+#endif
             if (!fapGm_HIO_c::isCaptureScreen() || fapGm_HIO_c::getCaptureScreenDivH() != 1) {
                 fpcDw_Handler((fpcDw_HandlerFuncFunc)fpcM_DrawIterater, (fpcDw_HandlerFunc)fpcM_Draw);
             }
@@ -18,3 +18,125 @@ void* fpcSch_JudgeByID(void* i_proc, void* i_data) {
 
     return NULL;
 }
+
+#if ENABLE_PROCESS_INDEX
+static inline int fpcSch_IdBucket(fpc_ProcID i_id) {
+    return i_id & (fpcSch_INDEX_BUCKET_NUM - 1);
+}
+
+static inline int fpcSch_NameBucket(s16 i_name) {
+    return (u16)i_name & (fpcSch_INDEX_BUCKET_NUM - 1);
+}
+
+static inline process_search_index_node* fpcSch_IndexNode(process_search_index* i_index,
+                                                          u16 i_no) {
+    return &i_index->nodes[i_no - 1];
+}
+
+void fpcSch_AddIndex(process_search_index* i_index, base_process_class* i_proc) {
+    u16 no = i_index->free_head;
+    if (no != fpcSch_INDEX_NONE) {
+        i_index->free_head = fpcSch_IndexNode(i_index, no)->next_id;
+    } else if (i_index->used_num < fpcSch_INDEX_NODE_NUM) {
+        no = ++i_index->used_num;
+    } else {
+        i_index->overflow++;
+        return;
+    }
+
+    process_search_index_node* node = fpcSch_IndexNode(i_index, no);
+    node->process = i_proc;
+    node->id = i_proc->id;
+    node->name = i_proc->name;
+
+    int id_bucket = fpcSch_IdBucket(node->id);
+    node->next_id = i_index->id_head[id_bucket];
+    i_index->id_head[id_bucket] = no;
+
+    int name_bucket = fpcSch_NameBucket(node->name);
+    node->prev_name = fpcSch_INDEX_NONE;
+    node->next_name = i_index->name_head[name_bucket];
+    if (node->next_name != fpcSch_INDEX_NONE) {
+        fpcSch_IndexNode(i_index, node->next_name)->prev_name = no;
+    }
+    i_index->name_head[name_bucket] = no;
+}
+
+void fpcSch_RemoveIndex(process_search_index* i_index, base_process_class* i_proc) {
+    u16* link = &i_index->id_head[fpcSch_IdBucket(i_proc->id)];
+    while (*link != fpcSch_INDEX_NONE && fpcSch_IndexNode(i_index, *link)->process != i_proc) {
+        link = &fpcSch_IndexNode(i_index, *link)->next_id;
+    }
+
+    if (*link == fpcSch_INDEX_NONE) {
+        // Never indexed; it was one of the overflowed processes.
+        if (i_index->overflow != 0) {
+            i_index->overflow--;
+        }
+        return;
+    }
+
+    u16 no = *link;
+    process_search_index_node* node = fpcSch_IndexNode(i_index, no);
+    *link = node->next_id;
+
+    if (node->prev_name != fpcSch_INDEX_NONE) {
+        fpcSch_IndexNode(i_index, node->prev_name)->next_name = node->next_name;
+    } else {
+        i_index->name_head[fpcSch_NameBucket(node->name)] = node->next_name;
+    }
+    if (node->next_name != fpcSch_INDEX_NONE) {
+        fpcSch_IndexNode(i_index, node->next_name)->prev_name = node->prev_name;
+    }
+
+    node->process = NULL;
+    node->next_id = i_index->free_head;
+    i_index->free_head = no;
+}
+
+int fpcSch_SearchIndexByID(process_search_index* i_index, fpc_ProcID i_id,
+                           base_process_class** o_proc) {
+    if (i_index->overflow != 0) {
+        return fpcSch_INDEX_UNKNOWN;
+    }
+
+    for (u16 no = i_index->id_head[fpcSch_IdBucket(i_id)]; no != fpcSch_INDEX_NONE;
+         no = fpcSch_IndexNode(i_index, no)->next_id)
+    {
+        if (fpcSch_IndexNode(i_index, no)->id == i_id) {
+            *o_proc = fpcSch_IndexNode(i_index, no)->process;
+            return fpcSch_INDEX_FOUND;
+        }
+    }
+
+    *o_proc = NULL;
+    return fpcSch_INDEX_NOT_FOUND;
+}
+
+/**
+ * Finds the process with the given name. When several share it, which one a
+ * queue walk meets first depends on queue order, so fpcSch_INDEX_UNKNOWN is
+ * returned and the caller walks the queue.
+ */
+int fpcSch_SearchIndexByName(process_search_index* i_index, s16 i_name,
+                             base_process_class** o_proc) {
+    if (i_index->overflow != 0) {
+        return fpcSch_INDEX_UNKNOWN;
+    }
+
+    *o_proc = NULL;
+    for (u16 no = i_index->name_head[fpcSch_NameBucket(i_name)]; no != fpcSch_INDEX_NONE;
+         no = fpcSch_IndexNode(i_index, no)->next_name)
+    {
+        if (fpcSch_IndexNode(i_index, no)->name == i_name) {
+            if (*o_proc != NULL) {
+                *o_proc = NULL;
+                return fpcSch_INDEX_UNKNOWN;
+            }
+            *o_proc = fpcSch_IndexNode(i_index, no)->process;
+        }
+    }
+
+    return *o_proc != NULL ? fpcSch_INDEX_FOUND : fpcSch_INDEX_NOT_FOUND;
+}
+#endif
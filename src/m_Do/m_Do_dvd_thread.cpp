@@ -13,6 +13,9 @@
 #include "m_Do/m_Do_Reset.h"
 #include "m_Do/m_Do_controller_pad.h"
 #include "m_Do/m_Do_ext.h"
+#if ENABLE_DVD_SCHEDULER
+#include <cstring>
+#endif
 
 s32 mDoDvdThd::main(void* param_0) {
     JKRThread(OSGetCurrentThread(), 0);
@@ -116,6 +119,10 @@ mDoDvdThd_param_c::mDoDvdThd_param_c() {
     OSInitMessageQueue(&mMessageQueue, &mMessageQueueMessages, 1);
     OSInitMutex(&mMutext);
     cLs_Create(&mNodeList);
+#if ENABLE_DVD_SCHEDULER
+    mHeadOffset = 0;
+    memset(mStat, 0, sizeof(mStat));
+#endif
 }
 
 void mDoDvdThd_param_c::kick() {
@@ -132,6 +139,10 @@ mDoDvdThd_command_c* mDoDvdThd_param_c::getFirstCommand() {
 
 void mDoDvdThd_param_c::addition(mDoDvdThd_command_c* pCommand) {
     OSLockMutex(&mMutext);
+#if ENABLE_DVD_SCHEDULER
+    pCommand->mState = mDoDvdThd_STATE_QUEUED;
+    pCommand->mQueueTime = OSGetTime();
+#endif
     cLs_Addition(&mNodeList, pCommand);
     OSUnlockMutex(&mMutext);
     this->kick();
@@ -144,6 +155,117 @@ void mDoDvdThd_param_c::cut(mDoDvdThd_command_c* param_0) {
     this->kick();
 }
 
+#if ENABLE_DVD_SCHEDULER
+/**
+ * Takes the next command to run. Among the commands queued before the first
+ * barrier, the most urgent priority class wins, and within a class the
+ * command at or after the last disc position, in ascending order, wins
+ * (a one-way elevator). Selecting and cutting happen under the mutex, so a
+ * command is either taken here or cancelled, never both.
+ */
+mDoDvdThd_command_c* mDoDvdThd_param_c::takeCommand() {
+    OSLockMutex(&mMutext);
+    mDoDvdThd_command_c* best = NULL;
+    for (mDoDvdThd_command_c* command = (mDoDvdThd_command_c*)mNodeList.mpHead; command != NULL;
+         command = (mDoDvdThd_command_c*)command->mpNextNode)
+    {
+        if (command->mDiscOffset == mDoDvdThd_OFFSET_BARRIER) {
+            if (best == NULL) {
+                best = command;
+            }
+            break;
+        }
+
+        if (best == NULL || command->mPriority < best->mPriority ||
+            (command->mPriority == best->mPriority &&
+             command->mDiscOffset - mHeadOffset < best->mDiscOffset - mHeadOffset))
+        {
+            best = command;
+        }
+    }
+
+    if (best != NULL) {
+        cLs_SingleCut(best);
+        best->mState = mDoDvdThd_STATE_RUNNING;
+        best->mStartTime = OSGetTime();
+        if (best->mDiscOffset != mDoDvdThd_OFFSET_BARRIER) {
+            mHeadOffset = best->mDiscOffset;
+        }
+    }
+    OSUnlockMutex(&mMutext);
+    return best;
+}
+
+/**
+ * Removes @p i_command from the queue if it has not started yet. A cancelled
+ * command counts as done and can be destroyed right away.
+ */
+bool mDoDvdThd_param_c::cancel(mDoDvdThd_command_c* i_command) {
+    bool result = false;
+    OSLockMutex(&mMutext);
+    if (i_command->mState == mDoDvdThd_STATE_QUEUED) {
+        cLs_SingleCut(i_command);
+        i_command->mState = mDoDvdThd_STATE_CANCELLED;
+        i_command->mIsDone = true;
+        result = true;
+    }
+    OSUnlockMutex(&mMutext);
+    return result;
+}
+
+/** Moves @p i_command to another priority class while it is still queued. */
+void mDoDvdThd_param_c::setPriority(mDoDvdThd_command_c* i_command, u8 i_priority) {
+    JUT_ASSERT(__LINE__, i_priority < mDoDvdThd_PRIORITY_MAX);
+    OSLockMutex(&mMutext);
+    if (i_command->mState == mDoDvdThd_STATE_QUEUED) {
+        i_command->mPriority = i_priority;
+    }
+    OSUnlockMutex(&mMutext);
+}
+
+void mDoDvdThd_param_c::entryStat(u8 i_priority, OSTime i_waitTime, OSTime i_serviceTime) {
+    OSLockMutex(&mMutext);
+    mDoDvdThd_stat_c* stat = &mStat[i_priority];
+    stat->mCount++;
+    stat->mWaitTime += i_waitTime;
+    stat->mServiceTime += i_serviceTime;
+    if (i_waitTime > stat->mMaxWaitTime) {
+        stat->mMaxWaitTime = i_waitTime;
+    }
+    if (i_serviceTime > stat->mMaxServiceTime) {
+        stat->mMaxServiceTime = i_serviceTime;
+    }
+    OSUnlockMutex(&mMutext);
+}
+
+mDoDvdThd_stat_c mDoDvdThd_param_c::getStat(int i_priority) {
+    OSLockMutex(&mMutext);
+    mDoDvdThd_stat_c stat = mStat[i_priority];
+    OSUnlockMutex(&mMutext);
+    return stat;
+}
+
+static void cb(void* param_0) {
+    mDoDvdThd_command_c* pCmd = *(mDoDvdThd_command_c**)param_0;
+    // The owner may destroy the command as soon as execute marks it done,
+    // so everything the statistics need is read beforehand.
+    u8 priority = pCmd->mPriority;
+    OSTime waitTime = pCmd->getQueueWaitTime();
+    OSTime startTime = OSGetTime();
+    s32 result = pCmd->execute();
+    OSTime serviceTime = OSGetTime() - startTime;
+    if (result != 1) {
+        OSReport_Error("mDoDvdThd_param_c::mainLoop() コマンドの実行が失敗しました。\n");
+    }
+    mDoDvdThd::l_param.entryStat(priority, waitTime, serviceTime);
+#if DEBUG
+    if (mDoDvdThd::verbose) {
+        OS_REPORT("<DVD> %08x priority=%d wait=%4dms service=%4dms\n", pCmd, priority,
+                  (u32)OS_TICKS_TO_MSEC(waitTime), (u32)OS_TICKS_TO_MSEC(serviceTime));
+    }
+#endif
+}
+#else
 static void cb(void* param_0) {
     mDoDvdThd_command_c* pCmd = *(mDoDvdThd_command_c**)param_0;
     s32 result = pCmd->execute();
@@ -151,12 +273,17 @@ static void cb(void* param_0) {
         OSReport_Error("mDoDvdThd_param_c::mainLoop() コマンドの実行が失敗しました。\n");
     }
 }
+#endif
 
 void mDoDvdThd_param_c::mainLoop() {
     mDoDvdThd_command_c* command;
     while (this->waitForKick() != 0) {
+#if ENABLE_DVD_SCHEDULER
+        while (command = this->takeCommand()) {
+#else
         while (command = this->getFirstCommand()) {
             this->cut(command);
+#endif
             if (mDoDvdThd::SyncWidthSound) {
                 JASDvd::getThreadPointer()->sendCmdMsg(cb, &command, 4);
             } else {
@@ -169,8 +296,36 @@ void mDoDvdThd_param_c::mainLoop() {
 mDoDvdThd_command_c::mDoDvdThd_command_c() {
     mIsDone = false;
     cNd_ForcedClear(this);
+#if ENABLE_DVD_SCHEDULER
+    mPriority = mDoDvdThd_PRIORITY_NORMAL;
+    mState = mDoDvdThd_STATE_NONE;
+    mDiscOffset = mDoDvdThd_OFFSET_BARRIER;
+    mQueueTime = 0;
+    mStartTime = 0;
+#endif
+}
+
+#if ENABLE_DVD_SCHEDULER
+/** Sets the priority class and looks up where on the disc the file starts. */
+void mDoDvdThd_command_c::setSchedule(s32 i_entryNum, u8 i_priority) {
+    JUT_ASSERT(__LINE__, i_priority < mDoDvdThd_PRIORITY_MAX);
+    mPriority = i_priority;
+
+    DVDFileInfo fileInfo;
+    if (DVDFastOpen(i_entryNum, &fileInfo)) {
+        mDiscOffset = fileInfo.startAddr;
+    }
 }
 
+bool mDoDvdThd_command_c::cancel() {
+    return mDoDvdThd::l_param.cancel(this);
+}
+
+void mDoDvdThd_command_c::setPriority(u8 i_priority) {
+    mDoDvdThd::l_param.setPriority(this, i_priority);
+}
+#endif
+
 mDoDvdThd_callback_c::~mDoDvdThd_callback_c() {}
 
 mDoDvdThd_callback_c::mDoDvdThd_callback_c(mDoDvdThd_callback_func pFunc, void* pData) {
@@ -209,8 +364,14 @@ mDoDvdThd_mountArchive_c::mDoDvdThd_mountArchive_c(u8 param_0) {
     }
 }
 
+#if ENABLE_DVD_SCHEDULER
+mDoDvdThd_mountArchive_c* mDoDvdThd_mountArchive_c::create(char const* pArchivePath,
+                                                           u8 mountDirection, JKRHeap* pHeap,
+                                                           u8 i_priority) {
+#else
 mDoDvdThd_mountArchive_c* mDoDvdThd_mountArchive_c::create(char const* pArchivePath,
                                                            u8 mountDirection, JKRHeap* pHeap) {
+#endif
     mDoDvdThd_mountArchive_c* mountArcCmd =
         new (mDoExt_getCommandHeap(), -4) mDoDvdThd_mountArchive_c(mountDirection);
     if (mountArcCmd != NULL) {
@@ -221,6 +382,9 @@ mDoDvdThd_mountArchive_c* mDoDvdThd_mountArchive_c::create(char const* pArchiveP
             mountArcCmd = NULL;
         } else {
             mountArcCmd->mHeap = pHeap;
+#if ENABLE_DVD_SCHEDULER
+            mountArcCmd->setSchedule(mountArcCmd->mEntryNumber, i_priority);
+#endif
             mDoDvdThd::l_param.addition(mountArcCmd);
             if (mDoDvdThd::DVDLogoMode) {
                 OS_REPORT("\x1b[34m<DVD> mountArchive(%d:%s)\n\x1b[m", mountArcCmd->mEntryNumber, pArchivePath);
@@ -239,6 +403,7 @@ s32 mDoDvdThd_mountArchive_c::execute() {
 #endif
     JKRHeap* heap = mHeap != NULL ? mHeap : mDoExt_getArchiveHeap();
     JKRMemArchive* memArchive = NULL;
+    JKR_HEAP_TRACE_TAG('AR');
 #if DEBUG
     OSTime time1 = OSGetTime();
 #endif
@@ -362,10 +527,17 @@ mDoDvdThd_mountXArchive_c::mDoDvdThd_mountXArchive_c(u8 mountDirection, JKRArchi
     }
 }
 
+#if ENABLE_DVD_SCHEDULER
+mDoDvdThd_mountXArchive_c* mDoDvdThd_mountXArchive_c::create(char const* pArchivePath,
+                                                             u8 mountDirection,
+                                                             JKRArchive::EMountMode mountMode,
+                                                             JKRHeap* pHeap, u8 i_priority) {
+#else
 mDoDvdThd_mountXArchive_c* mDoDvdThd_mountXArchive_c::create(char const* pArchivePath,
                                                              u8 mountDirection,
                                                              JKRArchive::EMountMode mountMode,
                                                              JKRHeap* pHeap) {
+#endif
     mDoDvdThd_mountXArchive_c* mountXArcCmd =
         new (mDoExt_getCommandHeap(), -4) mDoDvdThd_mountXArchive_c(mountDirection, mountMode);
     if (mountXArcCmd != NULL) {
@@ -376,6 +548,9 @@ mDoDvdThd_mountXArchive_c* mDoDvdThd_mountXArchive_c::create(char const* pArchiv
             mountXArcCmd = NULL;
         } else {
             mountXArcCmd->mHeap = pHeap;
+#if ENABLE_DVD_SCHEDULER
+            mountXArcCmd->setSchedule(mountXArcCmd->mEntryNum, i_priority);
+#endif
             mDoDvdThd::l_param.addition(mountXArcCmd);
             if (mDoDvdThd::DVDLogoMode) {
                 OS_WARNING("<DVD> mountXArchive(%d:%s)\n", mountXArcCmd->mEntryNum, pArchivePath);
@@ -448,8 +623,13 @@ mDoDvdThd_toMainRam_c::mDoDvdThd_toMainRam_c(u8 param_0) {
     }
 }
 
+#if ENABLE_DVD_SCHEDULER
+mDoDvdThd_toMainRam_c* mDoDvdThd_toMainRam_c::create(char const* pArchivePath, u8 mountDirection,
+                                                     JKRHeap* pHeap, u8 i_priority) {
+#else
 mDoDvdThd_toMainRam_c* mDoDvdThd_toMainRam_c::create(char const* pArchivePath, u8 mountDirection,
                                                      JKRHeap* pHeap) {
+#endif
     mDoDvdThd_toMainRam_c* toMainRAMCmd =
         new (mDoExt_getCommandHeap(), -4) mDoDvdThd_toMainRam_c(mountDirection);
     if (toMainRAMCmd != NULL) {
@@ -460,6 +640,9 @@ mDoDvdThd_toMainRam_c* mDoDvdThd_toMainRam_c::create(char const* pArchivePath, u
             toMainRAMCmd = NULL;
         } else {
             toMainRAMCmd->mHeap = pHeap;
+#if ENABLE_DVD_SCHEDULER
+            toMainRAMCmd->setSchedule(toMainRAMCmd->mEntryNum, i_priority);
+#endif
             mDoDvdThd::l_param.addition(toMainRAMCmd);
             if (mDoDvdThd::DVDLogoMode) {
                 OS_WARNING("<DVD> toMainRam(%d:%s)\n", toMainRAMCmd->mEntryNum, pArchivePath);
@@ -365,6 +365,156 @@ void mDoExt_modelEntryDL(J3DModel* i_model) {
     i_model->viewCalc();
 }
 
+#if ENABLE_ANM_BATCH
+/**
+ * Model calcs deferred from the execute phase to mDoExt_modelCalcFlush(), which runs them all on
+ * the thread that calls it. J3DModel::calc() and the morfs work on j3dSys and the J3DSys
+ * statics, so the batch only reorders calcs; it does not spread them over threads.
+ */
+enum {
+    mDoExt_CALC_MODEL,
+    mDoExt_CALC_MCA_MORF,
+    mDoExt_CALC_MCA_MORF_SO,
+    mDoExt_CALC_MCA_MORF2,
+};
+
+struct mDoExt_calcJob {
+    /* 0x0 */ J3DModelData* mpModelData;
+    /* 0x4 */ void* mpTarget;
+    /* 0x8 */ u8 mType;
+    /* 0x9 */ bool mRegroup;
+};  // Size: 0xC
+
+#define mDoExt_CALC_JOB_MAX 256
+
+static mDoExt_calcJob l_calcJob[mDoExt_CALC_JOB_MAX];
+static int l_calcJobNum;
+static bool l_calcOpen;
+static bool l_calcFlushing;
+
+static void mDoExt_runCalcJob(const mDoExt_calcJob& i_job) {
+    switch (i_job.mType) {
+    case mDoExt_CALC_MODEL:
+        ((J3DModel*)i_job.mpTarget)->calc();
+        break;
+    case mDoExt_CALC_MCA_MORF:
+        ((mDoExt_McaMorf*)i_job.mpTarget)->modelCalc();
+        break;
+    case mDoExt_CALC_MCA_MORF_SO:
+        ((mDoExt_McaMorfSO*)i_job.mpTarget)->modelCalc();
+        break;
+    case mDoExt_CALC_MCA_MORF2:
+        ((mDoExt_McaMorf2*)i_job.mpTarget)->modelCalc();
+        break;
+    }
+}
+
+static void mDoExt_pushCalcJob(J3DModel* i_model, void* i_target, u8 i_type, bool i_regroup) {
+    if (i_model == NULL) {
+        return;
+    }
+
+    mDoExt_calcJob job;
+    job.mpModelData = i_model->getModelData();
+    job.mpTarget = i_target;
+    job.mType = i_type;
+    job.mRegroup = i_regroup;
+
+    // A request made outside the window could outlive its process, since deletions run before
+    // the next flush. It runs right away, as do requests from joint callbacks during the flush.
+    JUT_ASSERT(__LINE__, l_calcOpen || l_calcFlushing);
+    if (!l_calcOpen) {
+        mDoExt_runCalcJob(job);
+        return;
+    }
+    if (l_calcJobNum >= mDoExt_CALC_JOB_MAX) {
+        JUT_WARN(__LINE__, "%s", "Model Calc Request Over !\n");
+        mDoExt_runCalcJob(job);
+        return;
+    }
+    l_calcJob[l_calcJobNum++] = job;
+}
+
+/**
+ * Drops the pending jobs whose target lies in [i_start, i_end). Jobs keep their order.
+ */
+static void mDoExt_cancelCalcJob(const void* i_start, const void* i_end) {
+    int num = 0;
+    for (int i = 0; i < l_calcJobNum; i++) {
+        if (l_calcJob[i].mpTarget < i_start || l_calcJob[i].mpTarget >= i_end) {
+            l_calcJob[num++] = l_calcJob[i];
+        }
+    }
+    l_calcJobNum = num;
+}
+
+/**
+ * Opens the request window. fpcM_Management calls this once the frame's deletions are done, so
+ * every process that can request a calc is still alive at the flush.
+ */
+void mDoExt_modelCalcBegin() {
+    JUT_ASSERT(__LINE__, l_calcJobNum == 0);
+    l_calcOpen = true;
+}
+
+/**
+ * Defers i_model->calc() to mDoExt_modelCalcFlush(), which runs after every actor has executed
+ * and before the draw phase. Only for models whose matrices nothing reads before drawing.
+ * Requests are only deferred between mDoExt_modelCalcBegin() and the flush; anywhere else the
+ * calc runs right away.
+ * i_regroup says the model's joint callbacks touch nothing but the model itself, so the calc
+ * may be moved next to other models sharing the same J3DModelData instead of keeping its place
+ * in request order.
+ */
+void mDoExt_modelCalcReq(J3DModel* i_model, bool i_regroup) {
+    mDoExt_pushCalcJob(i_model, i_model, mDoExt_CALC_MODEL, i_regroup);
+}
+
+/**
+ * Drops i_model's pending calc, for a model freed before the flush.
+ */
+void mDoExt_modelCalcCancel(J3DModel* i_model) {
+    mDoExt_cancelCalcJob(i_model, i_model + 1);
+}
+
+/**
+ * Runs the calcs requested this frame and closes the request window. Jobs that may not be
+ * regrouped run first, in request order; the rest follow grouped by J3DModelData so shared
+ * joint trees and animations stay in cache.
+ */
+void mDoExt_modelCalcFlush() {
+    l_calcOpen = false;
+    l_calcFlushing = true;
+
+    int regroupNum = 0;
+    for (int i = 0; i < l_calcJobNum; i++) {
+        if (!l_calcJob[i].mRegroup) {
+            mDoExt_runCalcJob(l_calcJob[i]);
+        } else {
+            l_calcJob[regroupNum++] = l_calcJob[i];
+        }
+    }
+
+    for (int i = 1; i < regroupNum; i++) {
+        mDoExt_calcJob job = l_calcJob[i];
+        int j = i;
+        for (; j > 0 && (uintptr_t)l_calcJob[j - 1].mpModelData > (uintptr_t)job.mpModelData;
+             j--)
+        {
+            l_calcJob[j] = l_calcJob[j - 1];
+        }
+        l_calcJob[j] = job;
+    }
+
+    for (int i = 0; i < regroupNum; i++) {
+        mDoExt_runCalcJob(l_calcJob[i]);
+    }
+
+    l_calcJobNum = 0;
+    l_calcFlushing = false;
+}
+#endif
+
 void mDoExt_btkAnmRemove(J3DModelData* i_modelData) {
     for (u16 i = 0; i < i_modelData->getMaterialNum(); i++) {
         J3DMaterialAnm* matAnm = i_modelData->getMaterialNodePointer(i)->getMaterialAnm();
@@ -1035,6 +1185,9 @@ u32 mDoExt_adjustSolidHeapToSystem(JKRSolidHeap* i_heap) {
 }
 
 void mDoExt_destroySolidHeap(JKRSolidHeap* i_heap) {
+#if ENABLE_ANM_BATCH
+    mDoExt_cancelCalcJob(i_heap->getStartAddr(), i_heap->getEndAddr());
+#endif
     JKRDestroySolidHeap(i_heap);
     if (g_printOtherHeapDebug) {
         // "Solid heap destruction"
@@ -1044,6 +1197,9 @@ void mDoExt_destroySolidHeap(JKRSolidHeap* i_heap) {
 
 void mDoExt_destroyExpHeap(JKRExpHeap* i_heap) {
     ASSERTLINE(2576, i_heap != mDoExt_getCurrentHeap());
+#if ENABLE_ANM_BATCH
+    mDoExt_cancelCalcJob(i_heap->getStartAddr(), i_heap->getEndAddr());
+#endif
     JKRDestroyExpHeap(i_heap);
 #if DEBUG
     if (mDoExt::HeapAdjustVerbose) {
@@ -1264,6 +1420,35 @@ void mDoExt_morf_c::frameUpdate() {
     mFrameCtrl.update();
 }
 
+#if ENABLE_KEY_CURSOR
+/**
+ * Allocates i_anmNum sets of per-joint key cursors for a morf. NULL when the heap is short; the
+ * lookups then fall back to a binary search.
+ */
+static u16* mDoExt_newKeyCursor(J3DModelData* i_modelData, int i_anmNum) {
+    u32 num = i_modelData->getJointNum() * J3DAnmTransformKey::KEY_CURSOR_NUM * i_anmNum;
+    u16* cursor = new u16[num];
+    if (cursor != NULL) {
+        memset(cursor, 0, num * sizeof(u16));
+    }
+    return cursor;
+}
+
+/**
+ * Evaluates a joint through the morf's own key cursors, so models sharing one BCK at different
+ * frames do not thrash each other's cursors.
+ */
+static void mDoExt_getAnmTransform(J3DAnmTransform* i_anm, u16 i_jntNo,
+                                   J3DTransformInfo* o_info, u16* i_cursor) {
+    if (i_cursor != NULL && i_anm->getKind() == 8) {
+        i_cursor += i_jntNo * J3DAnmTransformKey::KEY_CURSOR_NUM;
+        static_cast<J3DAnmTransformKey*>(i_anm)->getTransform(i_jntNo, o_info, i_cursor);
+    } else {
+        i_anm->getTransform(i_jntNo, o_info);
+    }
+}
+#endif
+
 mDoExt_McaMorf::mDoExt_McaMorf(J3DModelData* modelData, mDoExt_McaMorfCallBack1_c* callback1,
                                    mDoExt_McaMorfCallBack2_c* callback2, J3DAnmTransform* anmTransform,
                                    int param_4, f32 param_5, int param_6, int param_7, int param_8,
@@ -1275,6 +1460,9 @@ mDoExt_McaMorf::mDoExt_McaMorf(J3DModelData* modelData, mDoExt_McaMorfCallBack1_
 }
 
 mDoExt_McaMorf::~mDoExt_McaMorf() {
+#if ENABLE_ANM_BATCH
+    mDoExt_cancelCalcJob(this, this + 1);
+#endif
     if (field_0x50 && mpSound != NULL) {
         mpSound->stopAnime();
     }
@@ -1288,6 +1476,9 @@ int mDoExt_McaMorf::create(J3DModelData* modelData, mDoExt_McaMorfCallBack1_c* c
     mpSound = NULL;
     mpTransformInfo = NULL;
     mpQuat = NULL;
+#if ENABLE_KEY_CURSOR
+    mpKeyCursor = NULL;
+#endif
     if (!modelData) {
         return 0;
     }
@@ -1337,6 +1528,9 @@ int mDoExt_McaMorf::create(J3DModelData* modelData, mDoExt_McaMorfCallBack1_c* c
             info++;
             quat++;
         }
+#if ENABLE_KEY_CURSOR
+        mpKeyCursor = mDoExt_newKeyCursor(modelData, 1);
+#endif
         mpCallback1 = callback1;
         mpCallback2 = callback2;
         return 1;
@@ -1499,8 +1693,18 @@ void mDoExt_McaMorf::modelCalc() {
     }
 }
 
+#if ENABLE_ANM_BATCH
+void mDoExt_McaMorf::modelCalcReq(bool i_regroup) {
+    mDoExt_pushCalcJob(mpModel, this, mDoExt_CALC_MCA_MORF, i_regroup);
+}
+#endif
+
 void mDoExt_McaMorf::getTransform(u16 param_0, J3DTransformInfo* param_1) {
+#if ENABLE_KEY_CURSOR
+    mDoExt_getAnmTransform(mpAnm, param_0, param_1, mpKeyCursor);
+#else
     mpAnm->getTransform(param_0, param_1);
+#endif
     if (field_0x51) {
         if (param_0 == 0) {
             param_1->mTranslate.x *= mTranslateScale.x;
@@ -1526,6 +1730,9 @@ mDoExt_McaMorfSO::mDoExt_McaMorfSO(J3DModelData* param_0, mDoExt_McaMorfCallBack
 }
 
 mDoExt_McaMorfSO::~mDoExt_McaMorfSO() {
+#if ENABLE_ANM_BATCH
+    mDoExt_cancelCalcJob(this, this + 1);
+#endif
     stopZelAnime();
 }
 
@@ -1537,6 +1744,9 @@ int mDoExt_McaMorfSO::create(J3DModelData* i_modelData, mDoExt_McaMorfCallBack1_
     mpTransformInfo = NULL;
     mpQuat = NULL;
     mpSound = NULL;
+#if ENABLE_KEY_CURSOR
+    mpKeyCursor = NULL;
+#endif
 
     if (i_modelData == NULL) {
         return 0;
@@ -1591,6 +1801,9 @@ int mDoExt_McaMorfSO::create(J3DModelData* i_modelData, mDoExt_McaMorfCallBack1_
                 quat++;
             }
 
+#if ENABLE_KEY_CURSOR
+            mpKeyCursor = mDoExt_newKeyCursor(i_modelData, 1);
+#endif
             mpCallback1 = param_1;
             mpCallback2 = param_2;
             return 1;
@@ -1785,8 +1998,18 @@ void mDoExt_McaMorfSO::modelCalc() {
     }
 }
 
+#if ENABLE_ANM_BATCH
+void mDoExt_McaMorfSO::modelCalcReq(bool i_regroup) {
+    mDoExt_pushCalcJob(mpModel, this, mDoExt_CALC_MCA_MORF_SO, i_regroup);
+}
+#endif
+
 void mDoExt_McaMorfSO::getTransform(u16 param_0, J3DTransformInfo* param_1) {
+#if ENABLE_KEY_CURSOR
+    mDoExt_getAnmTransform(mpAnm, param_0, param_1, mpKeyCursor);
+#else
     mpAnm->getTransform(param_0, param_1);
+#endif
     if (mTranslate) {
         if (param_0 == 0) {
             param_1->mTranslate.x *= mTranslateScale.x;
@@ -1816,6 +2039,9 @@ mDoExt_McaMorf2::mDoExt_McaMorf2(J3DModelData* param_0, mDoExt_McaMorfCallBack1_
 }
 
 mDoExt_McaMorf2::~mDoExt_McaMorf2() {
+#if ENABLE_ANM_BATCH
+    mDoExt_cancelCalcJob(this, this + 1);
+#endif
     stopZelAnime();
 }
 
@@ -1827,6 +2053,9 @@ mDoExt_McaMorf2::~mDoExt_McaMorf2() {
     mpTransformInfo = NULL;
     mpQuat = NULL;
     mpSound = NULL;
+#if ENABLE_KEY_CURSOR
+    mpKeyCursor = NULL;
+#endif
 
     if (param_0 == NULL) {
         return 0;
@@ -1882,6 +2111,10 @@ mDoExt_McaMorf2::~mDoExt_McaMorf2() {
         var_r26++;
     }
 
+#if ENABLE_KEY_CURSOR
+    // The second half of the cursors belongs to field_0x40.
+    mpKeyCursor = mDoExt_newKeyCursor(param_0, 2);
+#endif
     mpCallback1 = param_1;
     mpCallback2 = param_2;
     return 1;
@@ -1934,6 +2167,13 @@ void mDoExt_McaMorf2::calc() {
         } else {
             var_r27 = &mpQuat[jnt_no];
         }
+#if ENABLE_KEY_CURSOR
+        u16* cursor2 = NULL;
+        if (mpKeyCursor != NULL) {
+            cursor2 = mpKeyCursor + mpModel->getModelData()->getJointNum() *
+                                        J3DAnmTransformKey::KEY_CURSOR_NUM;
+        }
+#endif
 
         if (mpAnm == NULL) {
             *var_r30 = mpModel->getModelData()->getJointNodePointer(jnt_no)->getTransformInfo();
@@ -1946,7 +2186,11 @@ void mDoExt_McaMorf2::calc() {
                            var_r27);
             J3DMtxCalcCalcTransformMaya::calcTransform(*var_r30);
         } else if (mCurMorf >= 1.0f || mpTransformInfo == NULL || mpQuat == NULL) {
+#if ENABLE_KEY_CURSOR
+            mDoExt_getAnmTransform(mpAnm, jnt_no, &spF0[0], mpKeyCursor);
+#else
             mpAnm->getTransform(jnt_no, &spF0[0]);
+#endif
             if (field_0x40 == NULL) {
                 if (mpCallback1 != NULL) {
                     mpCallback1->execute(jnt_no, &spF0[0]);
@@ -1957,7 +2201,11 @@ void mDoExt_McaMorf2::calc() {
                 J3DMtxCalcCalcTransformMaya::calcTransform(spF0[0]);
                 *var_r30 = spF0[0];
             } else {
+#if ENABLE_KEY_CURSOR
+                mDoExt_getAnmTransform(field_0x40, jnt_no, &spF0[1], cursor2);
+#else
                 field_0x40->getTransform(jnt_no, &spF0[1]);
+#endif
 
                 sp18[0] = 1.0f - mAnmRate;
                 sp18[1] = mAnmRate;
@@ -1989,7 +2237,11 @@ void mDoExt_McaMorf2::calc() {
             var_f31 = (mCurMorf - mPrevMorf) / (1.0f - mPrevMorf);
             var_f30 = 1.0f - var_f31;
 
+#if ENABLE_KEY_CURSOR
+            mDoExt_getAnmTransform(mpAnm, jnt_no, &sp80, mpKeyCursor);
+#else
             mpAnm->getTransform(jnt_no, &sp80);
+#endif
             if (mpCallback1 != NULL) {
                 mpCallback1->execute(jnt_no, &sp80);
             }
@@ -2013,8 +2265,13 @@ void mDoExt_McaMorf2::calc() {
 
             mDoExt_setJ3DData(spC0, var_r30, jnt_no);
         } else {
+#if ENABLE_KEY_CURSOR
+            mDoExt_getAnmTransform(mpAnm, jnt_no, &spF0[0], mpKeyCursor);
+            mDoExt_getAnmTransform(field_0x40, jnt_no, &spF0[1], cursor2);
+#else
             mpAnm->getTransform(jnt_no, &spF0[0]);
             field_0x40->getTransform(jnt_no, &spF0[1]);
+#endif
 
             sp10[0] = 1.0f - mAnmRate;
             sp10[1] = mAnmRate;
@@ -2170,6 +2427,12 @@ void mDoExt_McaMorf2::modelCalc() {
     }
 }
 
+#if ENABLE_ANM_BATCH
+void mDoExt_McaMorf2::modelCalcReq(bool i_regroup) {
+    mDoExt_pushCalcJob(mpModel, this, mDoExt_CALC_MCA_MORF2, i_regroup);
+}
+#endif
+
 void mDoExt_McaMorf2::stopZelAnime() {
     if (mpSound != NULL) {
         mpSound->deleteObject();
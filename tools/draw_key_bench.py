@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""
+J3DDrawBuffer entry recording replayer and sort benchmark.
+
+Reads a buffer written by J3DDrawBuffer::startRecord/stopRecord (built with
+--draw-key-sort) and replays every draw buffer frame twice:
+  - bucket: the entry table path (hash slot chains, isSame chain walks)
+  - key:    the keyed path (flat array, hashed merge, LSD radix sort)
+
+Usage:
+    python draw_key_bench.py <record.bin> [--repeat N] [--buffer ADDR]
+
+The recording is a 0x10 byte header followed by 0x10 byte records, both
+big-endian:
+    header: magic 'DKRC', version, record count, dropped record count
+    record: type (u8), pad (u8), slot (u16), buffer (u32), a (u32), b (u32)
+
+Reported per draw buffer:
+  - frames, entries and merged packets for both paths
+  - isSame comparisons per entry on the bucket path, probes per entry on the key path
+  - radix passes per frame (bytes that differ between keys)
+  - replay time of both paths; these are Python timings, so only the ratio and the
+    comparison counts carry over to the target
+"""
+
+import argparse
+import struct
+import sys
+import time
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+HEADER = struct.Struct(">4sIII")
+RECORD = struct.Struct(">BBHIII")
+
+TYPE_FRAME = 0
+TYPE_MAT = 1
+TYPE_Z = 2
+TYPE_IMM = 3
+
+SORT_MAT = 0
+SORT_Z = 2
+
+DIFF_CHANGED = 0x80000000
+KEY_MIN = 0x40
+KEY_LIMIT = 0x8000
+
+
+class Frame:
+    __slots__ = ("sort_mode", "table_size", "entries")
+
+    def __init__(self, sort_mode: int, table_size: int):
+        self.sort_mode = sort_mode
+        self.table_size = table_size
+        self.entries: List[Tuple[int, int, int, int]] = []
+
+
+class Stats:
+    def __init__(self, address: int):
+        self.address = address
+        self.sort_mode = None
+        self.frames = 0
+        self.entries = 0
+        self.bucket_merged = 0
+        self.bucket_compares = 0
+        self.bucket_time = 0.0
+        self.key_merged = 0
+        self.key_probes = 0
+        self.key_spilled = 0
+        self.key_max = 0
+        self.key_passes = 0
+        self.key_time = 0.0
+        self.order_errors = 0
+
+
+def read_record(path: Path):
+    data = path.read_bytes()
+    if len(data) < HEADER.size:
+        sys.exit("error: %s is too small to be a draw buffer recording" % path)
+    magic, version, count, dropped = HEADER.unpack_from(data, 0)
+    if magic != b"DKRC":
+        sys.exit("error: %s has bad magic %r" % (path, magic))
+    if version != 1:
+        sys.exit("error: unsupported recording version %d" % version)
+    available = (len(data) - HEADER.size) // RECORD.size
+    if count > available:
+        print("warning: header claims %d records, file holds %d" % (count, available), file=sys.stderr)
+        count = available
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(count)]
+    return records, dropped
+
+
+def split_frames(records) -> Dict[int, List[Frame]]:
+    frames: Dict[int, List[Frame]] = {}
+    current: Dict[int, Frame] = {}
+    for kind, _, slot, buffer, a, b in records:
+        if kind == TYPE_FRAME:
+            frame = Frame(slot, a)
+            frames.setdefault(buffer, []).append(frame)
+            current[buffer] = frame
+            continue
+        frame = current.get(buffer)
+        if frame is None:
+            # Entries made before the buffer's first frameInit in the recording.
+            continue
+        frame.entries.append((kind, slot, a, b))
+    return frames
+
+
+def depth_order(bits: int) -> int:
+    """Matches entryZSort: unsigned order of the f32, inverted so farther sorts first."""
+    order = (~bits & 0xFFFFFFFF) if bits & 0x80000000 else bits | 0x80000000
+    return ~order & 0xFFFFFFFF
+
+
+def make_key(frame: Frame, kind: int, slot: int, a: int, b: int) -> Tuple[int, bool]:
+    if kind == TYPE_MAT:
+        if b & DIFF_CHANGED:
+            return 0, False
+        return (a & (frame.table_size - 1)) << 48 | b, True
+    if kind == TYPE_Z:
+        return slot << 48 | depth_order(a) << 16, False
+    return slot << 48, False
+
+
+def replay_bucket(frame: Frame, stats: Stats):
+    size = frame.table_size
+    table: List[List[int]] = [[] for _ in range(size)]
+    merged = 0
+    compares = 0
+    for kind, slot, a, b in frame.entries:
+        if kind == TYPE_MAT:
+            if b & DIFF_CHANGED:
+                table[0].append(b)
+                continue
+            chain = table[a & (size - 1)]
+            found = False
+            # Chains are walked from the most recent entry, as in entryMatSort.
+            for other in reversed(chain):
+                compares += 1
+                if other == b and not other & DIFF_CHANGED:
+                    found = True
+                    break
+            if found:
+                merged += 1
+            else:
+                chain.append(b)
+        else:
+            table[slot].append(b)
+    stats.bucket_merged += merged
+    stats.bucket_compares += compares
+
+
+def radix_sort(keys: List[Tuple[int, int]]) -> Tuple[List[Tuple[int, int]], int]:
+    passes = 0
+    if len(keys) < 2:
+        return keys, passes
+    for shift in range(0, 64, 8):
+        first = (keys[0][0] >> shift) & 0xFF
+        if all(((key >> shift) & 0xFF) == first for key, _ in keys):
+            continue
+        buckets: List[List[Tuple[int, int]]] = [[] for _ in range(256)]
+        for entry in keys:
+            buckets[(entry[0] >> shift) & 0xFF].append(entry)
+        keys = [entry for bucket in buckets for entry in bucket]
+        passes += 1
+    return keys, passes
+
+
+def initial_key_max(frame: Frame) -> int:
+    """Matches dDlst_list_c::init: twice the entry table size, at least KEY_MIN."""
+    return max(frame.table_size * 2, KEY_MIN)
+
+
+def replay_key(frame: Frame, stats: Stats, key_max: int):
+    """Returns the sorted keys, or None if the frame spilled to the entry table."""
+    keys: List[Tuple[int, int]] = []
+    index: Dict[int, int] = {}
+    merged = 0
+    probes = 0
+    for order, (kind, slot, a, b) in enumerate(frame.entries):
+        key, merge = make_key(frame, kind, slot, a, b)
+        if merge:
+            probes += 1
+            if key in index:
+                merged += 1
+                continue
+        if len(keys) >= key_max:
+            # spillKey moves the frame to the entry table, as replay_bucket models.
+            replay_bucket(frame, Stats(stats.address))
+            return None
+        if merge:
+            index[key] = len(keys)
+        keys.append((key, order))
+    keys, passes = radix_sort(keys)
+    stats.key_merged += merged
+    stats.key_probes += probes
+    stats.key_passes += passes
+    return keys
+
+
+def check_order(frame: Frame, keys: List[Tuple[int, int]], stats: Stats):
+    """Sorted keys must match Python's stable sort and keep entry table slots contiguous."""
+    if keys != sorted(keys, key=lambda entry: entry[0]):
+        stats.order_errors += 1
+        return
+    slots = [key >> 48 for key, _ in keys]
+    if slots != sorted(slots) or any(slot >= frame.table_size for slot in slots):
+        stats.order_errors += 1
+
+
+def replay(frames: Dict[int, List[Frame]], repeat: int) -> List[Stats]:
+    result = []
+    for address, buffer_frames in frames.items():
+        stats = Stats(address)
+        key_max = 0
+        for frame in buffer_frames:
+            if frame.sort_mode not in (SORT_MAT, SORT_Z) or not frame.entries:
+                continue
+            if key_max == 0:
+                key_max = initial_key_max(frame)
+            stats.sort_mode = frame.sort_mode
+            stats.frames += 1
+            stats.entries += len(frame.entries)
+
+            start = time.perf_counter()
+            for i in range(repeat):
+                probe = Stats(address) if i else stats
+                replay_bucket(frame, probe)
+            stats.bucket_time += time.perf_counter() - start
+
+            start = time.perf_counter()
+            for i in range(repeat):
+                probe = Stats(address) if i else stats
+                keys = replay_key(frame, probe, key_max)
+            stats.key_time += time.perf_counter() - start
+
+            if keys is None:
+                # frameInit doubles the key array after a frame that spilled.
+                stats.key_spilled += 1
+                if key_max * 2 < KEY_LIMIT:
+                    key_max *= 2
+            else:
+                check_order(frame, keys, stats)
+            stats.key_max = key_max
+        if stats.frames:
+            result.append(stats)
+    return result
+
+
+def print_stats(result: List[Stats], repeat: int):
+    for stats in result:
+        mode = "Z" if stats.sort_mode == SORT_Z else "Mat"
+        entries = max(stats.entries, 1)
+        print("%08X (%s sort) %d frames, %.1f entries/frame" % (
+            stats.address, mode, stats.frames, stats.entries / stats.frames))
+        print("  bucket  merged %d  compares/entry %.2f  %.1f us/frame" % (
+            stats.bucket_merged, stats.bucket_compares / entries,
+            stats.bucket_time * 1e6 / (stats.frames * repeat)))
+        print("  key     merged %d  probes/entry %.2f  passes/frame %.2f  %.1f us/frame" % (
+            stats.key_merged, stats.key_probes / entries, stats.key_passes / stats.frames,
+            stats.key_time * 1e6 / (stats.frames * repeat)))
+        if stats.key_spilled:
+            print("  key     %d frames spilled to the entry table, grown to %d keys" % (
+                stats.key_spilled, stats.key_max))
+        if not stats.key_spilled and stats.bucket_merged != stats.key_merged:
+            # Both paths merge packets of the same material in the same slot.
+            print("  error: merge counts differ by %d" % (stats.bucket_merged - stats.key_merged))
+        if stats.order_errors:
+            print("  error: %d frames sorted out of order" % stats.order_errors)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a J3DDrawBuffer entry recording")
+    parser.add_argument("record", type=Path, help="Buffer dumped from J3DDrawBuffer::startRecord")
+    parser.add_argument("--repeat", type=int, default=10, help="Replays per frame for timing")
+    parser.add_argument(
+        "--buffer",
+        type=lambda value: int(value, 16),
+        help="Only replay the draw buffer at this address (hex)",
+    )
+    args = parser.parse_args()
+
+    records, dropped = read_record(args.record)
+    if dropped:
+        print("warning: %d records were dropped, results are incomplete" % dropped, file=sys.stderr)
+
+    frames = split_frames(records)
+    if args.buffer is not None:
+        frames = {address: value for address, value in frames.items() if address == args.buffer}
+
+    result = replay(frames, max(args.repeat, 1))
+    print("%d records, %d draw buffers" % (len(records), len(result)))
+    print_stats(result, max(args.repeat, 1))
+    if any(stats.order_errors or stats.bucket_merged != stats.key_merged and not stats.key_spilled
+           for stats in result):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
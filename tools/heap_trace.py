@@ -0,0 +1,321 @@
+#!/usr/bin/env python3
+"""
+JKRHeap allocation trace replayer.
+
+Reads a trace buffer written by JKRHeap::startTrace/stopTrace (built with
+--heap-trace) and replays it offline to rebuild the heap hierarchy and
+the live block layout of every heap over time.
+
+Usage:
+    python heap_trace.py <trace.bin> [--csv OUT] [--small-gap N] [--top N]
+
+The trace is a 0x10 byte header followed by 0x18 byte records, both
+big-endian:
+    header: magic 'HTRC', version, record count, dropped record count
+    record: type (u8), group id (u8), tag (u16), frame (u32), heap (u32),
+            address (u32), size (u32), param (s32)
+
+Reported per heap:
+  - peak and final used bytes
+  - smallest "largest free block" seen and the frame it happened on
+  - fragmentation hot spots: group ids and caller tags whose blocks border
+    small free gaps at the heap's most fragmented frame
+
+Caller tags are set with JKRHeap::setTraceTag: 'AR' for archive mounts,
+'RS' for resource setup, and 0x8000 | profile name for process create and
+execute (shown as "proc N"). Tags are kept per thread, so an archive mount on
+the DVD thread does not change the tag of the process running on the main
+thread.
+
+Block sizes are approximate: JKRExpHeap block headers (0x10 bytes) are
+included, but alignment padding inside the heap is not visible in the trace.
+"""
+
+import argparse
+import bisect
+import csv
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+HEADER = struct.Struct(">4sIII")
+RECORD = struct.Struct(">BBHIIIIi")
+
+TYPE_CREATE = 0
+TYPE_DESTROY = 1
+TYPE_ALLOC = 2
+TYPE_FREE = 3
+TYPE_RESIZE = 4
+TYPE_FREE_ALL = 5
+TYPE_FREE_TAIL = 6
+
+# Per-block header overhead by the upper half of the heap type.
+BLOCK_OVERHEAD = {b"EX": 0x10, b"SL": 0, b"AS": 0}
+
+
+class Block:
+    __slots__ = ("address", "size", "group", "tag", "tail")
+
+    def __init__(self, address: int, size: int, group: int, tag: int, tail: bool):
+        self.address = address
+        self.size = size
+        self.group = group
+        self.tag = tag
+        self.tail = tail
+
+
+class Heap:
+    def __init__(self, address: int, kind: bytes, start: int, size: int, parent: int, frame: int):
+        self.address = address
+        self.kind = kind
+        self.start = start
+        self.size = size
+        self.parent = parent
+        self.created = frame
+        self.destroyed: Optional[int] = None
+        self.overhead = BLOCK_OVERHEAD.get(kind, 0)
+        self.blocks: Dict[int, Block] = {}
+        self.order: List[int] = []
+        self.used = 0
+        self.peak_used = 0
+        self.peak_frame = frame
+        self.min_largest_free = size
+        self.min_largest_frame = frame
+        self.worst_fragmentation = -1
+        self.worst_frame = frame
+        self.hot_spots: Dict[int, int] = {}
+        self.hot_tags: Dict[int, int] = {}
+        self.failed_allocs = 0
+
+    def name(self) -> str:
+        return "%08X (%s)" % (self.address, self.kind.decode("ascii", "replace"))
+
+    def add(self, address: int, size: int, group: int, tag: int, tail: bool, frame: int):
+        if address in self.blocks:
+            self.remove(address)
+        block = Block(address, size + self.overhead, group, tag, tail)
+        self.blocks[address] = block
+        bisect.insort(self.order, address)
+        self.used += block.size
+        if self.used > self.peak_used:
+            self.peak_used = self.used
+            self.peak_frame = frame
+
+    def remove(self, address: int):
+        block = self.blocks.pop(address, None)
+        if block is None:
+            return
+        del self.order[bisect.bisect_left(self.order, address)]
+        self.used -= block.size
+
+    def resize(self, address: int, size: int, frame: int):
+        block = self.blocks.get(address)
+        if block is None:
+            return
+        self.used += size + self.overhead - block.size
+        block.size = size + self.overhead
+        if self.used > self.peak_used:
+            self.peak_used = self.used
+            self.peak_frame = frame
+
+    def clear(self, tail_only: bool):
+        for address in list(self.order):
+            if not tail_only or self.blocks[address].tail:
+                self.remove(address)
+
+    def gaps(self) -> List[Tuple[int, int, Optional[Block], Optional[Block]]]:
+        """Returns (offset, size, left block, right block) for each free gap."""
+        result = []
+        cursor = self.start
+        left: Optional[Block] = None
+        for address in self.order:
+            block = self.blocks[address]
+            begin = address - self.overhead
+            if begin > cursor:
+                result.append((cursor, begin - cursor, left, block))
+            cursor = max(cursor, begin + block.size)
+            left = block
+        end = self.start + self.size
+        if end > cursor:
+            result.append((cursor, end - cursor, left, None))
+        return result
+
+    def sample(self, frame: int, small_gap: int):
+        gaps = self.gaps()
+        largest = max((gap[1] for gap in gaps), default=0)
+        if largest < self.min_largest_free:
+            self.min_largest_free = largest
+            self.min_largest_frame = frame
+
+        free_total = sum(gap[1] for gap in gaps)
+        fragmentation = free_total - largest
+        if fragmentation > self.worst_fragmentation:
+            self.worst_fragmentation = fragmentation
+            self.worst_frame = frame
+            self.hot_spots = {}
+            self.hot_tags = {}
+            for _, size, left, right in gaps:
+                if size >= small_gap:
+                    continue
+                for neighbour in (left, right):
+                    if neighbour is not None:
+                        self.hot_spots[neighbour.group] = self.hot_spots.get(neighbour.group, 0) + size
+                        self.hot_tags[neighbour.tag] = self.hot_tags.get(neighbour.tag, 0) + size
+        return largest
+
+
+def read_trace(path: Path):
+    data = path.read_bytes()
+    if len(data) < HEADER.size:
+        sys.exit("error: %s is too small to be a heap trace" % path)
+    magic, version, count, dropped = HEADER.unpack_from(data, 0)
+    if magic != b"HTRC":
+        sys.exit("error: %s has bad magic %r" % (path, magic))
+    if version != 1:
+        sys.exit("error: unsupported trace version %d" % version)
+    available = (len(data) - HEADER.size) // RECORD.size
+    if count > available:
+        print("warning: header claims %d records, file holds %d" % (count, available), file=sys.stderr)
+        count = available
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(count)]
+    return records, dropped
+
+
+def replay(records, small_gap: int, timeline):
+    heaps: Dict[int, Heap] = {}
+    retired: List[Heap] = []
+    dirty = set()
+    current_frame = None
+
+    def flush(frame):
+        for heap in dirty:
+            largest = heap.sample(frame, small_gap)
+            if timeline is not None:
+                timeline.writerow([frame, "%08X" % heap.address, heap.used, largest])
+        dirty.clear()
+
+    for kind, group, tag, frame, heap_address, address, size, param in records:
+        if frame != current_frame:
+            if current_frame is not None:
+                flush(current_frame)
+            current_frame = frame
+
+        if kind == TYPE_CREATE:
+            if heap_address in heaps:
+                retired.append(heaps.pop(heap_address))
+            heap = Heap(heap_address, struct.pack(">H", tag), address, size, param & 0xFFFFFFFF, frame)
+            heaps[heap_address] = heap
+            dirty.add(heap)
+            continue
+
+        heap = heaps.get(heap_address)
+        if heap is None:
+            # Heap created before tracing started; track it with unknown bounds.
+            heap = Heap(heap_address, b"??", 0, 0, 0, frame)
+            heaps[heap_address] = heap
+
+        if kind == TYPE_DESTROY:
+            if heap in dirty:
+                heap.sample(frame, small_gap)
+                dirty.discard(heap)
+            heap.destroyed = frame
+            retired.append(heaps.pop(heap_address))
+            continue
+
+        if kind == TYPE_ALLOC:
+            if address == 0:
+                heap.failed_allocs += 1
+            else:
+                heap.add(address, size, group, tag, param < 0, frame)
+        elif kind == TYPE_FREE:
+            heap.remove(address)
+        elif kind == TYPE_RESIZE:
+            if param >= 0:
+                heap.resize(address, size, frame)
+        elif kind == TYPE_FREE_ALL:
+            heap.clear(tail_only=False)
+        elif kind == TYPE_FREE_TAIL:
+            heap.clear(tail_only=True)
+        dirty.add(heap)
+
+    if current_frame is not None:
+        flush(current_frame)
+    return retired + list(heaps.values())
+
+
+def tag_name(tag: int) -> str:
+    if tag == 0:
+        return "-"
+    if tag & 0x8000:
+        return "proc %d" % (tag & 0x7FFF)
+    return struct.pack(">H", tag).decode("ascii", "replace")
+
+
+def print_tree(heaps: List[Heap], top: int):
+    by_parent: Dict[int, List[Heap]] = {}
+    known = {heap.address for heap in heaps}
+    for heap in heaps:
+        parent = heap.parent if heap.parent in known else 0
+        by_parent.setdefault(parent, []).append(heap)
+
+    def visit(heap: Heap, depth: int):
+        indent = "  " * depth
+        print("%s%s start %08X size %08X" % (indent, heap.name(), heap.start, heap.size))
+        print("%s  peak used   %08X (frame %d)" % (indent, heap.peak_used, heap.peak_frame))
+        print("%s  final used  %08X" % (indent, heap.used))
+        if heap.size:
+            print("%s  min largest %08X (frame %d)" % (indent, heap.min_largest_free, heap.min_largest_frame))
+        if heap.failed_allocs:
+            print("%s  failed allocs %d" % (indent, heap.failed_allocs))
+        if heap.hot_spots:
+            spots = sorted(heap.hot_spots.items(), key=lambda item: -item[1])[:top]
+            print("%s  small gaps at frame %d by group: %s" % (
+                indent, heap.worst_frame, ", ".join("%02X:%X" % spot for spot in spots)))
+            tags = sorted(heap.hot_tags.items(), key=lambda item: -item[1])[:top]
+            print("%s  small gaps at frame %d by tag: %s" % (
+                indent, heap.worst_frame, ", ".join("%s:%X" % (tag_name(tag), size) for tag, size in tags)))
+        for child in by_parent.get(heap.address, []):
+            if child is not heap:
+                visit(child, depth + 1)
+
+    for root in by_parent.get(0, []):
+        visit(root, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a JKRHeap allocation trace")
+    parser.add_argument("trace", type=Path, help="Trace buffer dumped from JKRHeap::startTrace")
+    parser.add_argument("--csv", type=Path, help="Write a per-frame used/largest-free timeline")
+    parser.add_argument(
+        "--small-gap",
+        type=lambda value: int(value, 0),
+        default=0x100,
+        help="Free gaps below this size count as fragmentation (default: 0x100)",
+    )
+    parser.add_argument("--top", type=int, default=8, help="Number of hot spot groups to list")
+    args = parser.parse_args()
+
+    records, dropped = read_trace(args.trace)
+    if dropped:
+        print("warning: %d records were dropped, results are incomplete" % dropped, file=sys.stderr)
+
+    timeline_file = None
+    timeline = None
+    if args.csv:
+        timeline_file = open(args.csv, "w", newline="")
+        timeline = csv.writer(timeline_file)
+        timeline.writerow(["frame", "heap", "used", "largest_free"])
+
+    try:
+        heaps = replay(records, args.small_gap, timeline)
+    finally:
+        if timeline_file is not None:
+            timeline_file.close()
+
+    print("%d records, %d heaps" % (len(records), len(heaps)))
+    print_tree(heaps, args.top)
+
+
+if __name__ == "__main__":
+    main()
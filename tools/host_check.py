@@ -0,0 +1,388 @@
+#!/usr/bin/env python3
+"""
+Host-side checks for the non-matching (ENABLE_*) features.
+
+Each check is a C++ program in tools/host_check/. Most of the game sources
+cannot be built for the host as-is (u32 is a 32-bit long, the headers expect
+the MWCC runtime), so a check declares the minimal types itself and pulls the
+function definitions under test straight out of the tree. That way a check
+always runs against the code in the tree, not a copy of it.
+
+Code that only moves data through its own structs (JParticle, for one) does
+build for the host with the game headers, so a check can instead compile
+whole tree sources and link against them; such a check is built with the
+game headers too and stubs whatever the sources call outside of themselves.
+
+Directives in a check's leading comment block:
+    // splice: <source> <name> [<name> ...]
+        Copies the definitions of each name ("Class::method" or a free
+        function) from <source> into splice.inc, in order. A name that is
+        defined more than once (e.g. in #if/#else branches) takes "@N" to
+        pick the N-th definition, counting from 1. A definition whose
+        signature differs between #if branches is one definition, copied
+        with its conditional.
+    // region: <source> <first line> => <name>[@N]
+        Copies everything from the line reading <first line> through the end
+        of the definition of <name> (N counts from that line), for file
+        statics and code that differs
+        between #if branches. #endif lines needed to close conditionals opened
+        inside the region are included.
+    // splice(<group>): ..., // region(<group>): ...
+        Writes to splice_<group>.inc instead, for code that only one of the
+        builds a check compares should see.
+    // rewrite: <old> => <new>
+        Replaces text in the spliced code, for the few spots that read
+        big-endian data through native loads or call paired-single code. A
+        rewrite that no longer matches is an error.
+    // args: <arguments>
+        Extra arguments passed to the check when it runs, before any given
+        after "--" on the command line (e.g. a recorded trace to replay).
+        Checks run in the repository root, so paths are relative to it.
+    // tree: <source> [<source> ...]
+        Compiles each source with the game headers and links it into the
+        check, which is then built with the game headers as well. Symbols
+        nothing calls on the host (GX and the like) may stay undefined.
+    // define: <NAME>[=<value>] [...]
+        Preprocessor definitions for the check and its tree sources.
+
+A check prints its results and exits non-zero on failure.
+
+Usage:
+    python tools/host_check.py [check ...] [--list] [--cxx CXX] [--keep DIR] [-- ARGS]
+"""
+
+import argparse
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+ROOT = Path(__file__).resolve().parent.parent
+CHECK_DIR = ROOT / "tools" / "host_check"
+
+DIRECTIVE = re.compile(r"^//\s*(splice|region|rewrite|args|tree|define)(?:\((\w+)\))?:\s*(.*)$")
+# Mirrors the include paths configure.py gives the game sources.
+TREE_INCLUDES = [
+    "include",
+    "src",
+    "libs/JSystem/include",
+    "libs/dolphin/include",
+    "libs/dolphin/include/dolphin",
+    "libs/PowerPC_EABI_Support/MSL/MSL_C/MSL_Common/Include",
+    "libs/PowerPC_EABI_Support/MSL/MSL_C/MSL_Common_Embedded/Math/Include",
+    "libs/PowerPC_EABI_Support/MSL/MSL_C/PPC_EABI/Include",
+    "libs/PowerPC_EABI_Support/MSL/MSL_C++/MSL_Common/Include",
+    "libs/PowerPC_EABI_Support/Runtime/Inc",
+]
+CONDITIONAL = re.compile(r"^\s*#\s*(if|ifdef|ifndef|endif)\b", re.M)
+BRANCH = re.compile(r"[ \t]*#\s*(else|elif)\b")
+
+
+class CheckError(Exception):
+    pass
+
+
+def skip_literal(text: str, i: int) -> int:
+    """Returns the index just past the comment or literal starting at i, or i."""
+    if text.startswith("//", i):
+        end = text.find("\n", i)
+        return len(text) if end < 0 else end
+    if text.startswith("/*", i):
+        end = text.find("*/", i + 2)
+        return len(text) if end < 0 else end + 2
+    if text[i] in "\"'":
+        quote = text[i]
+        i += 1
+        while i < len(text) and text[i] != quote:
+            i += 2 if text[i] == "\\" else 1
+        return i + 1
+    return i
+
+
+def skip_branch(text: str, i: int) -> int:
+    """At the start of an #else or #elif line, returns the start of its #endif line, or i.
+
+    Braces are only counted in the first branch of a conditional, so a signature that
+    differs between branches (each ending in "{") still opens a single body.
+    """
+    if i != 0 and text[i - 1] != "\n":
+        return i
+    if BRANCH.match(text, i) is None:
+        return i
+    depth = 0
+    for directive in CONDITIONAL.finditer(text, i):
+        if directive.group(1) != "endif":
+            depth += 1
+        elif depth == 0:
+            return directive.start()
+        else:
+            depth -= 1
+    return len(text)
+
+
+def open_conditionals(text: str, start: int, end: int) -> int:
+    """Moves start back over the #if lines whose #endif lies between start and end."""
+    depth = 0
+    for directive in CONDITIONAL.finditer(text, start, end):
+        depth += -1 if directive.group(1) == "endif" else 1
+        if depth < 0:
+            opened = []
+            for outer in CONDITIONAL.finditer(text, 0, start):
+                if outer.group(1) == "endif":
+                    opened.pop()
+                else:
+                    opened.append(outer.start())
+            return opened[depth]
+    return start
+
+
+def find_definitions(text: str, name: str) -> List[Tuple[int, int]]:
+    """Returns (start, end) of every top-level definition of name in text."""
+    # Constructors and destructors have no return type, so the name may start the line.
+    pattern = re.compile(r"^(?:[^\s#/][^;{}\n]*?)?(?<![\w:])" + re.escape(name) + r"\s*\(", re.M)
+    result = []
+    for match in pattern.finditer(text):
+        if result and match.start() < result[-1][1]:
+            # The other branch's signature of a definition already found.
+            continue
+        i = match.end()
+        depth = 1
+        # Skip the parameter list, then require a body before any ';'.
+        while i < len(text) and depth:
+            j = skip_literal(text, i)
+            if j != i:
+                i = j
+                continue
+            if text[i] == "(":
+                depth += 1
+            elif text[i] == ")":
+                depth -= 1
+            i += 1
+        while i < len(text) and text[i] not in "{;":
+            j = skip_literal(text, i)
+            i = j if j != i else i + 1
+        if i >= len(text) or text[i] == ";":
+            continue
+        depth = 0
+        while i < len(text):
+            j = skip_literal(text, i)
+            if j == i:
+                j = skip_branch(text, i)
+            if j != i:
+                i = j
+                continue
+            if text[i] == "{":
+                depth += 1
+            elif text[i] == "}":
+                depth -= 1
+                if depth == 0:
+                    i += 1
+                    break
+            i += 1
+        result.append((open_conditionals(text, match.start(), i), i))
+    return result
+
+
+def find_definition(source: Path, text: str, entry: str) -> Tuple[int, int]:
+    name, _, index = entry.partition("@")
+    found = find_definitions(text, name)
+    if not found:
+        raise CheckError("%s: no definition of %s" % (source, name))
+    if index:
+        if int(index) > len(found):
+            raise CheckError("%s: %s has only %d definitions" % (source, name, len(found)))
+        return found[int(index) - 1]
+    if len(found) > 1:
+        raise CheckError("%s: %s is defined %d times, pick one with @N" % (source, name, len(found)))
+    return found[0]
+
+
+def located(source: Path, text: str, start: int, end: int) -> str:
+    line = text.count("\n", 0, start) + 1
+    return '#line %d "%s"\n%s\n' % (line, source.as_posix(), text[start:end])
+
+
+def splice(source: Path, names: List[str]) -> str:
+    text = source.read_text(encoding="utf-8")
+    parts = ["// %s\n" % source.relative_to(ROOT).as_posix()]
+    for entry in names:
+        start, end = find_definition(source, text, entry)
+        parts.append(located(source, text, start, end))
+    return "\n".join(parts)
+
+
+def region(source: Path, first: str, last: str) -> str:
+    text = source.read_text(encoding="utf-8")
+    match = re.search(r"^[ \t]*" + re.escape(first) + r"[ \t]*$", text, re.M)
+    if match is None:
+        raise CheckError("%s: no line reading %r" % (source, first))
+    start = match.start()
+    _, end = find_definition(source, text[start:], last)
+    end += start
+
+    depth = 0
+    for directive in CONDITIONAL.finditer(text, start, end):
+        depth += -1 if directive.group(1) == "endif" else 1
+    while depth > 0:
+        directive = CONDITIONAL.search(text, end)
+        if directive is None or directive.group(1) != "endif":
+            raise CheckError("%s: region ending at %s leaves an #if open" % (source, last))
+        end = text.find("\n", directive.end())
+        end = len(text) if end < 0 else end
+        depth -= 1
+    return "// %s\n%s" % (source.relative_to(ROOT).as_posix(), located(source, text, start, end))
+
+
+class Check:
+    def __init__(self):
+        self.args: List[str] = []
+        self.tree: List[Path] = []
+        self.defines: List[str] = []
+
+
+def prepare(check: Path, work: Path) -> Check:
+    splices: Dict[str, List[str]] = {"": []}
+    rewrites = []
+    result = Check()
+    for line in check.read_text(encoding="utf-8").splitlines():
+        if not line.startswith("//"):
+            if line.strip():
+                break
+            continue
+        match = DIRECTIVE.match(line)
+        if match is None:
+            continue
+        kind, group, value = match.groups()
+        group = group or ""
+        if kind == "splice":
+            fields = value.split()
+            splices.setdefault(group, []).append(splice(ROOT / fields[0], fields[1:]))
+        elif kind == "region":
+            path, _, rest = value.partition(" ")
+            first, sep, last = rest.partition(" => ")
+            if not sep:
+                raise CheckError("%s: bad region %r" % (check.name, value))
+            splices.setdefault(group, []).append(region(ROOT / path, first.strip(), last.strip()))
+        elif kind == "rewrite":
+            old, sep, new = value.partition(" => ")
+            if not sep:
+                raise CheckError("%s: bad rewrite %r" % (check.name, value))
+            rewrites.append((old.strip(), new.strip()))
+        elif kind == "tree":
+            for source in value.split():
+                if not (ROOT / source).is_file():
+                    raise CheckError("%s: no source %s" % (check.name, source))
+                result.tree.append(ROOT / source)
+        elif kind == "define":
+            result.defines.extend(value.split())
+        else:
+            result.args.extend(shlex.split(value))
+
+    code = {group: "\n".join(parts) for group, parts in splices.items()}
+    for old, new in rewrites:
+        if not any(old in text for text in code.values()):
+            raise CheckError("%s: rewrite %r no longer matches the tree" % (check.name, old))
+        code = {group: text.replace(old, new) for group, text in code.items()}
+    for group, text in code.items():
+        name = "splice_%s.inc" % group if group else "splice.inc"
+        (work / name).write_text(text, encoding="utf-8")
+    return result
+
+
+def tree_flags(cxx: str, defines: List[str]) -> List[str]:
+    flags = ["-std=gnu++14", "-nostdinc", "-nostdinc++", "-fno-exceptions", "-fpermissive", "-w"]
+    flags += ["-O2", "-g", "-DVERSION=0", "-DHOST_CHECK_TREE=1"]
+    flags += ["-include", str(CHECK_DIR / "tree_shim.h")]
+    for path in TREE_INCLUDES:
+        flags += ["-I", str(ROOT / path)]
+    # The compiler's own headers come last, so that the vector intrinsics resolve while MSL
+    # keeps providing the C library.
+    builtin = subprocess.run([cxx, "-print-file-name=include"], capture_output=True, text=True)
+    if builtin.returncode == 0 and builtin.stdout.strip():
+        flags += ["-idirafter", builtin.stdout.strip()]
+    return flags + ["-D" + define for define in defines]
+
+
+def build_tree(check: Check, cxx: str, work: Path) -> List[str]:
+    objects = []
+    flags = tree_flags(cxx, check.defines)
+    for source in check.tree:
+        obj = work / (source.relative_to(ROOT).as_posix().replace("/", "_") + ".o")
+        if subprocess.run([cxx] + flags + ["-c", str(source), "-o", str(obj)]).returncode != 0:
+            raise CheckError("%s failed to build" % source.relative_to(ROOT).as_posix())
+        objects.append(str(obj))
+    return objects
+
+
+def run(check: Path, cxx: str, work: Path, extra: List[str]) -> bool:
+    work.mkdir(parents=True, exist_ok=True)
+    try:
+        info = prepare(check, work)
+        objects = build_tree(info, cxx, work)
+    except CheckError as error:
+        print("error: %s" % error)
+        return False
+
+    binary = work / check.stem
+    if info.tree:
+        command = [cxx] + tree_flags(cxx, info.defines) + ["-I", str(work)]
+        command += ["-o", str(binary), str(check)] + objects
+        # Tree sources reach GX and other console code the checks never call. The dolphin
+        # headers also define a few globals, which C++ does not merge.
+        command += ["-no-pie", "-Wl,--unresolved-symbols=ignore-all"]
+        command += ["-Wl,--allow-multiple-definition", "-lm", "-pthread"]
+    else:
+        command = [cxx, "-std=c++17", "-O2", "-g", "-pthread", "-I", str(work), "-o", str(binary)]
+        command += ["-D" + define for define in info.defines] + [str(check)]
+    if subprocess.run(command).returncode != 0:
+        print("error: %s failed to build" % check.name)
+        return False
+    # Arguments name files relative to the repository root.
+    return subprocess.run([str(binary)] + info.args + extra, cwd=ROOT).returncode == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build and run the host-side feature checks")
+    parser.add_argument("checks", nargs="*", help="Checks to run (default: all)")
+    parser.add_argument("--list", action="store_true", help="List the available checks")
+    parser.add_argument("--cxx", default="c++", help="Host C++ compiler (default: c++)")
+    parser.add_argument("--keep", type=Path, help="Build into this directory and keep it")
+    argv = sys.argv[1:]
+    extra: List[str] = []
+    if "--" in argv:
+        extra = argv[argv.index("--") + 1 :]
+        argv = argv[: argv.index("--")]
+    args = parser.parse_args(argv)
+
+    available = sorted(CHECK_DIR.glob("*.cpp"))
+    if args.list:
+        for check in available:
+            print(check.stem)
+        return
+
+    checks = available
+    if args.checks:
+        by_name = {check.stem: check for check in available}
+        missing = [name for name in args.checks if name not in by_name]
+        if missing:
+            sys.exit("error: unknown check %s" % ", ".join(missing))
+        checks = [by_name[name] for name in args.checks]
+
+    failed = []
+    with tempfile.TemporaryDirectory() as temp:
+        base = args.keep if args.keep is not None else Path(temp)
+        for check in checks:
+            print("== %s" % check.stem, flush=True)
+            if not run(check, args.cxx, base / check.stem, extra):
+                failed.append(check.stem)
+
+    if failed:
+        sys.exit("failed: %s" % ", ".join(failed))
+    print("%d checks passed" % len(checks))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,370 @@
+// Scales the number of file entries in an archive and times findNameResource and
+// findPtrResource with the ENABLE_ARCHIVE_INDEX tables (user-013) against the linear scans they
+// replace. The same archive answers both ways: clearing mNameIndex and mPtrIndex sends every
+// lookup down the original loops. Every findNameResource, findFsResource, findDirectory,
+// findTypeResource and findPtrResource must return the same entry both ways.
+//
+// The archives are built the way RARC lays them out: each directory's files, then its
+// subdirectories, then "." and "..". File names come from a small pool, so the larger archives
+// repeat names across directories and the first match in file order must win. Paths go through
+// "." and ".." as well. About half of the files get a data pointer, a few of them shared, and
+// some are removed again between rounds as removeResource does. Prints ns per lookup both ways.
+//
+// tree: libs/JSystem/src/JKernel/JKRArchivePri.cpp
+// define: ENABLE_ARCHIVE_INDEX=1
+
+#include "host_check.h"
+
+#define protected public
+#include "JSystem/JKernel/JKRArchive.h"
+#undef protected
+#include "JSystem/JKernel/JKRHeap.h"
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+void free(void*);
+}
+
+s32 JKRHeap::getFreeSize() {
+    return 0x7FFFFFFF;
+}
+void* JKRHeap::alloc(u32 size, int, JKRHeap*) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, 32, size);
+    return ptr;
+}
+void JKRHeap::free(void* ptr, JKRHeap*) {
+    ::free(ptr);
+}
+
+static const int COUNTS[] = {32, 128, 512, 2048, 8192, 32768};
+static const int FILE_MAX = 32768;
+static const int DIR_MAX = FILE_MAX / 24 + 1;
+static const int ENTRY_MAX = FILE_MAX + DIR_MAX * 3;
+static const int LOOKUP_NUM = 4000;
+static const int ROUND_NUM = 4;
+
+static const char* const l_word[] = {
+    "al", "body", "head", "arm", "leg", "wait", "walk", "run", "jump", "fall", "door", "box",
+    "gate", "tree", "rock", "grass", "water", "fire", "eye", "hand", "ring", "lamp", "cart", "sign",
+    "bird", "fish", "wolf", "horse", "boar", "bomb", "bow", "sword", "shield", "hook", "boot",
+    "mask", "open", "close", "spin", "dead", "damage", "talk", "sit", "look", "turn", "light",
+    "dark", "lv1", "lv2", "lv3", "ev", "obj", "npc", "kago", "saru", "mant", "cow", "goat",
+};
+static const char* const l_ext[] = {".bmd", ".bdl", ".bck", ".btk", ".brk", ".bti", ".bpk", ".dzb"};
+static const u32 l_dirType[] = {'BMDR', 'BCK ', 'BTK ', 'BRK ', 'TEX ', 'DZB '};
+
+#define ARRAY_NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+static SArcDataInfo l_info;
+static JKRArchive::SDIDirEntry l_node[DIR_MAX];
+static JKRArchive::SDIFileEntry l_file[ENTRY_MAX];
+static char l_string[ENTRY_MAX * 24];
+static u32 l_stringSize;
+
+static int l_parent[DIR_MAX];
+static u32 l_dirName[DIR_MAX];
+static int l_fileDir[FILE_MAX];
+static u32 l_fileName[FILE_MAX];
+static int l_fileEntry[FILE_MAX];
+static int l_cursor[DIR_MAX];
+
+static char l_path[LOOKUP_NUM][512];
+static u32 l_type[LOOKUP_NUM];
+static void* l_ptr[LOOKUP_NUM];
+static const void* l_indexed[LOOKUP_NUM];
+static const void* l_linear[LOOKUP_NUM];
+
+static u8 l_heap[0x100];
+alignas(16) static u8 l_archive[sizeof(JKRArchive)];
+
+/** The hash CArcName gives a lower case name. */
+static u16 nameHash(const char* name) {
+    u16 hash = 0;
+    for (; *name != '\0'; name++) {
+        hash = *name + hash * 3;
+    }
+    return hash;
+}
+
+static u32 addString(const char* str) {
+    u32 offset = l_stringSize;
+    strcpy(l_string + offset, str);
+    l_stringSize += strlen(str) + 1;
+    return offset;
+}
+
+static void setEntry(JKRArchive::SDIFileEntry* entry, u16 id, u32 flags, u32 nameOffset,
+                     u32 dataOffset) {
+    entry->file_id = id;
+    entry->name_hash = nameHash(l_string + nameOffset);
+    entry->type_flags_and_name_offset = flags << 24 | nameOffset;
+    entry->data_offset = dataOffset;
+    entry->data_size = 0x20;
+    entry->data = NULL;
+}
+
+/** Lays out an archive of @p fileNum files in about fileNum / 24 directories. */
+static void makeArchive(HostRandom& rnd, int fileNum) {
+    int dirNum = fileNum / 24 + 1;
+    l_stringSize = 0;
+    u32 dot = addString(".");
+    u32 dotDot = addString("..");
+
+    char name[64];
+    for (int d = 0; d < dirNum; d++) {
+        l_parent[d] = d == 0 ? -1 : (int)rnd.below(d);
+        const char* word = l_word[rnd.below(ARRAY_NUM(l_word))];
+        snprintf(name, sizeof(name), d == 0 ? "root" : "%s%d", word, d);
+        l_dirName[d] = addString(name);
+        l_cursor[d] = 0;
+    }
+    for (int f = 0; f < fileNum; f++) {
+        l_fileDir[f] = rnd.below(dirNum);
+        snprintf(name, sizeof(name), "%s_%s%s", l_word[rnd.below(ARRAY_NUM(l_word))],
+                 l_word[rnd.below(ARRAY_NUM(l_word))], l_ext[rnd.below(ARRAY_NUM(l_ext))]);
+        l_fileName[f] = addString(name);
+        l_cursor[l_fileDir[f]]++;
+    }
+    for (int d = 1; d < dirNum; d++) {
+        l_cursor[l_parent[d]]++;
+    }
+
+    // Each directory's range holds its files, its subdirectories, "." and "..".
+    u32 first = 0;
+    for (int d = 0; d < dirNum; d++) {
+        JKRArchive::SDIDirEntry* node = &l_node[d];
+        node->type = d == 0 ? 'ROOT' : l_dirType[rnd.below(ARRAY_NUM(l_dirType))];
+        node->name_offset = l_dirName[d];
+        node->field_0x8 = nameHash(l_string + l_dirName[d]);
+        node->num_entries = l_cursor[d] + 2;
+        node->first_file_index = first;
+        l_cursor[d] = first;
+        first += node->num_entries;
+    }
+    for (int f = 0; f < fileNum; f++) {
+        int index = l_cursor[l_fileDir[f]]++;
+        setEntry(&l_file[index], index, 1, l_fileName[f], f * 0x20);
+        l_fileEntry[f] = index;
+    }
+    for (int d = 1; d < dirNum; d++) {
+        int index = l_cursor[l_parent[d]]++;
+        setEntry(&l_file[index], 0xFFFF, 2, l_dirName[d], d);
+    }
+    for (int d = 0; d < dirNum; d++) {
+        setEntry(&l_file[l_cursor[d]++], 0xFFFF, 2, dot, d);
+        setEntry(&l_file[l_cursor[d]++], 0xFFFF, 2, dotDot, d == 0 ? 0xFFFFFFFF : l_parent[d]);
+    }
+
+    l_info.num_nodes = dirNum;
+    l_info.num_file_entries = first;
+}
+
+/** Writes the path of directory @p d from the root, with a trailing '/' unless it is the root. */
+static char* dirPath(char* out, int d) {
+    if (d == 0) {
+        return out;
+    }
+    out = dirPath(out, l_parent[d]);
+    strcpy(out, l_string + l_dirName[d]);
+    out += strlen(out);
+    *out++ = '/';
+    *out = '\0';
+    return out;
+}
+
+/** A path to a random file, now and then through a "." or a ".." on the way. */
+static void makePath(HostRandom& rnd, char* out, int fileNum) {
+    int f = rnd.below(fileNum);
+    u32 detour = rnd.below(8);
+    if (detour == 0) {
+        strcpy(out, "./");
+        out += 2;
+    } else if (detour == 1 && l_info.num_nodes > 1) {
+        // Into some directory below the root and back up.
+        int d = 1 + rnd.below(l_info.num_nodes - 1);
+        while (l_parent[d] != 0) {
+            d = l_parent[d];
+        }
+        out = dirPath(out, d);
+        strcpy(out, "../");
+        out += 3;
+    }
+    out = dirPath(out, l_fileDir[f]);
+    strcpy(out, rnd.below(8) == 0 ? "missing.bmd" : l_string + l_fileName[f]);
+}
+
+static JKRArchive* l_arc;
+static u16* l_nameIndex;
+static u16* l_ptrIndex;
+
+/** Switches the archive between its index tables and the linear scans. */
+static void useIndex(bool index) {
+    l_arc->mNameIndex = index ? l_nameIndex : NULL;
+    l_arc->mPtrIndex = index ? l_ptrIndex : NULL;
+}
+
+static double timeNames(const void** out) {
+    double start = host_seconds();
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        out[i] = l_arc->findNameResource(l_path[i]);
+    }
+    return (host_seconds() - start) * 1e9 / LOOKUP_NUM;
+}
+
+static double timePtrs(const void** out) {
+    double start = host_seconds();
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        out[i] = l_arc->findPtrResource(l_ptr[i]);
+    }
+    return (host_seconds() - start) * 1e9 / LOOKUP_NUM;
+}
+
+static int entryNo(const void* entry) {
+    return entry != NULL ? (int)((const JKRArchive::SDIFileEntry*)entry - l_file) : -1;
+}
+
+static void compare(const char* what, int num, bool byPtr) {
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        if (byPtr) {
+            HOST_CHECK(l_indexed[i] == l_linear[i], "%d files: %s %p found entry %d, linear %d",
+                       num, what, l_ptr[i], entryNo(l_indexed[i]), entryNo(l_linear[i]));
+        } else {
+            HOST_CHECK(l_indexed[i] == l_linear[i], "%d files: %s %s found entry %d, linear %d",
+                       num, what, l_path[i], entryNo(l_indexed[i]), entryNo(l_linear[i]));
+        }
+    }
+}
+
+/** The path lookups that take a directory or a type along, both ways. */
+static void comparePaths(int num, HostRandom& rnd) {
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        makePath(rnd, l_path[i], num);
+        l_type[i] = l_node[rnd.below(l_info.num_nodes)].type;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        const void** out = pass == 0 ? l_indexed : l_linear;
+        useIndex(pass == 0);
+        for (int i = 0; i < LOOKUP_NUM; i++) {
+            out[i] = l_arc->findFsResource(l_path[i], 0);
+        }
+    }
+    compare("path", num, false);
+
+    for (int pass = 0; pass < 2; pass++) {
+        const void** out = pass == 0 ? l_indexed : l_linear;
+        useIndex(pass == 0);
+        for (int i = 0; i < LOOKUP_NUM; i++) {
+            // The directory part only, which may name a file, ".." of the root, or nothing.
+            char dir[512];
+            strcpy(dir, l_path[i]);
+            char* slash = strrchr(dir, '/');
+            if (slash != NULL) {
+                *slash = '\0';
+            }
+            out[i] = l_arc->findDirectory(slash != NULL ? dir : "..", 0);
+        }
+    }
+    compare("directory of", num, false);
+
+    for (int pass = 0; pass < 2; pass++) {
+        const void** out = pass == 0 ? l_indexed : l_linear;
+        useIndex(pass == 0);
+        for (int i = 0; i < LOOKUP_NUM; i++) {
+            const char* slash = strrchr(l_path[i], '/');
+            out[i] = l_arc->findTypeResource(l_type[i], slash != NULL ? slash + 1 : l_path[i]);
+        }
+    }
+    compare("typed", num, false);
+}
+
+int main() {
+    HostRandom rnd(0x5EED0013);
+    l_arc = (JKRArchive*)l_archive;
+    printf("%7s %10s %10s %10s %10s\n", "entries", "name scan", "name index", "ptr scan",
+           "ptr index");
+
+    for (int c = 0; c < (int)(sizeof(COUNTS) / sizeof(COUNTS[0])); c++) {
+        int num = COUNTS[c];
+        makeArchive(rnd, num);
+        memset(l_archive, 0, sizeof(l_archive));
+        l_arc->mHeap = (JKRHeap*)l_heap;
+        l_arc->mMountDirection = JKRArchive::MOUNT_DIRECTION_HEAD;
+        l_arc->mArcInfoBlock = &l_info;
+        l_arc->mNodes = l_node;
+        l_arc->mFiles = l_file;
+        l_arc->mStringTable = l_string;
+        l_arc->createIndex();
+        HOST_CHECK(l_arc->mNameIndex != NULL, "%d files: no index", num);
+        l_nameIndex = l_arc->mNameIndex;
+        l_ptrIndex = l_arc->mPtrIndex;
+
+        double time[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int round = 0; round < ROUND_NUM; round++) {
+            // Fetch about half of the files, as fetchResource does; one in 16 shares the
+            // pointer of an earlier one.
+            useIndex(true);
+            for (int f = 0; f < num; f++) {
+                JKRArchive::SDIFileEntry* entry = &l_file[l_fileEntry[f]];
+                if (entry->data == NULL && rnd.below(2) == 0) {
+                    entry->data = (void*)(0x80000000u + (u32)f * 0x40);
+                    if (f > 0 && rnd.below(16) == 0) {
+                        void* shared = l_file[l_fileEntry[rnd.below(f)]].data;
+                        if (shared != NULL) {
+                            entry->data = shared;
+                        }
+                    }
+                    l_arc->entryPtrIndex(entry);
+                }
+            }
+
+            for (int i = 0; i < LOOKUP_NUM; i++) {
+                u32 kind = rnd.below(16);
+                if (kind == 0) {
+                    strcpy(l_path[i], rnd.below(2) == 0 ? "." : "..");
+                } else if (kind == 1) {
+                    strcpy(l_path[i], "missing.bmd");
+                } else if (kind == 2) {
+                    strcpy(l_path[i], l_string + l_node[rnd.below(l_info.num_nodes)].name_offset);
+                } else {
+                    strcpy(l_path[i], l_string + l_fileName[rnd.below(num)]);
+                }
+                // A quarter of the pointers are nothing the archive handed out.
+                l_ptr[i] = rnd.below(4) == 0 ? (void*)(0x90000000u + rnd.below(num) * 0x40) :
+                                               (void*)(0x80000000u + rnd.below(num) * 0x40);
+            }
+
+            useIndex(false);
+            time[0] += timeNames(l_linear);
+            useIndex(true);
+            time[1] += timeNames(l_indexed);
+            compare("name", num, false);
+            useIndex(false);
+            time[2] += timePtrs(l_linear);
+            useIndex(true);
+            time[3] += timePtrs(l_indexed);
+            compare("pointer", num, true);
+
+            comparePaths(num, rnd);
+
+            // Remove a third of the fetched files the way removeResource does.
+            useIndex(true);
+            for (int f = 0; f < num; f++) {
+                JKRArchive::SDIFileEntry* entry = &l_file[l_fileEntry[f]];
+                if (entry->data != NULL && rnd.below(3) == 0) {
+                    JKRArchive::SDIFileEntry* found = l_arc->findPtrResource(entry->data);
+                    l_arc->removePtrIndex(found);
+                    found->data = NULL;
+                }
+            }
+        }
+
+        printf("%7u %7.1f ns %7.1f ns %7.1f ns %7.1f ns\n", l_info.num_file_entries,
+               time[0] / ROUND_NUM, time[1] / ROUND_NUM, time[2] / ROUND_NUM,
+               time[3] / ROUND_NUM);
+        useIndex(true);
+        l_arc->destroyIndex();
+    }
+
+    return host_check_result("archive_index");
+}
@@ -0,0 +1,638 @@
+// Replays a recorded cBgS query stream (user-006) through LineCross and GroundCross with and
+// without ENABLE_BGS_BROADPHASE. The recording gives the bodies each RefitBnd saw, the bodies
+// registered and released between refits, and every line and ground check. Each body here is
+// a box the size of its recorded bounds; a line that hits it is cut short at the box and a ground
+// check lands on its top. Move BG bodies drift away from their recorded bounds after each refit,
+// as they do during actor execution.
+//
+// Every query must hit the same bodies in the same order on both builds and end on the same
+// body, point and height. Prints how many bodies each build visits per query and the time per
+// query. The visit counts matter more than the times: a visit costs a whole polygon walk on the
+// target, and only a box test here.
+//
+// The checked-in recording comes from a made-up stage, since no game data ships with the
+// repository. It is written through cBgS::StartBndRecord; run the check with "-- --write" to
+// write it again. A recording taken in the game can be given instead:
+//     python tools/host_check.py bgs_broadphase -- bgs.bin
+//
+// args: tools/host_check/bgs_record.bin
+// region: src/d/d_bg_s.cpp void cBgS_ChkElm::Init() { => cBgS::RecordBody
+// splice: src/d/d_bg_s.cpp cBgS::Regist cBgS::Release cBgS::Ct cBgS::LineCross cBgS::GroundCross
+// rewrite: 'BGRC' => 0x42475243
+
+#include "host_check.h"
+#include <vector>
+
+typedef u32 fpc_ProcID;
+enum { fpcM_ERROR_PROCESS_ID_e = 0xFFFFFFFF };
+static const f32 G_CM3D_F_INF = 1000000000.0f;
+
+static inline int __cntlzw(u32 x) {
+    return x != 0 ? __builtin_clz(x) : 32;
+}
+
+struct fopAc_ac_c;
+
+struct Vec {
+    f32 x, y, z;
+};
+
+struct cXyz : Vec {};
+
+struct cM3dGAab {
+    cXyz mMin;
+    cXyz mMax;
+
+    const cXyz* GetMinP() const { return &mMin; }
+    const cXyz* GetMaxP() const { return &mMax; }
+};
+
+struct cM3dGLin {
+    cXyz mStart;
+    cXyz mEnd;
+
+    const cXyz& GetStartP() const { return mStart; }
+    const cXyz& GetEndP() const { return mEnd; }
+};
+
+struct cBgS_BndRecordHeader {
+    u32 mMagic;
+    u32 mVersion;
+    u32 mCount;
+    u32 mDropped;
+};
+
+struct cBgS_BndRecord {
+    enum EType {
+        TYPE_REFIT,
+        TYPE_BODY,
+        TYPE_REGIST,
+        TYPE_RELEASE,
+        TYPE_LINE,
+        TYPE_GND,
+    };
+
+    enum EFlag {
+        FLAG_NOT_READY = 1,
+        FLAG_MOVE_BG = 2,
+        FLAG_BND_VALID = 4,
+    };
+
+    u8 mType;
+    u8 mFlag;
+    u16 mSlot;
+    u32 mId;
+    f32 mV[6];
+};
+
+/** What a query did, compared between the builds. */
+struct Result {
+    u32 mHitSum;
+    int mHitNum;
+    int mSlot;
+    f32 mValue[3];
+};
+
+struct cBgS_Chk {
+    fpc_ProcID mActorPid;
+    int mVisit;
+    Result mResult;
+
+    fpc_ProcID GetActorPid() const { return mActorPid; }
+    bool ChkSameActorPid(fpc_ProcID pid) const {
+        return mActorPid != fpcM_ERROR_PROCESS_ID_e && pid == mActorPid;
+    }
+    void ClearPi() { mResult.mSlot = -1; }
+    void hit(int slot) {
+        mResult.mHitSum = mResult.mHitSum * 0x01000193 + slot + 1;
+        mResult.mHitNum++;
+    }
+};
+
+struct dBgW_Base;
+
+struct cBgS_LinChk : cBgS_Chk {
+    cM3dGLin mLin;
+    bool mHit;
+
+    cM3dGLin* GetLinP() { return &mLin; }
+    void ClrHit() { mHit = false; }
+    void SetHit() { mHit = true; }
+    bool ChkHit() const { return mHit; }
+    void PreCalc() {}
+    void SetActorInfo(int slot, dBgW_Base*, fpc_ProcID) { mResult.mSlot = slot; }
+};
+
+struct cBgS_GndChk : cBgS_Chk {
+    cXyz mPos;
+    f32 mNowY;
+
+    const cXyz& GetPointP() const { return mPos; }
+    void SetNowY(f32 y) { mNowY = y; }
+    f32 GetNowY() const { return mNowY; }
+    void PreCheck() {}
+    void SetActorInfo(int slot, dBgW_Base*, fpc_ProcID) { mResult.mSlot = slot; }
+};
+
+/** A body whose polygons fill its bounds, standing in for dBgW and friends. */
+struct dBgW_Base {
+    bool mUsed;
+    int mId;
+    u8 mFlag;
+    cM3dGAab mBnd;
+
+    bool ChkUsed() const { return mUsed; }
+    bool ChkMemoryError() const { return false; }
+    void Regist(int id) {
+        mUsed = true;
+        mId = id;
+    }
+    void Release() { mUsed = false; }
+    int GetId() const { return mId; }
+    bool ChkNotReady() const { return mFlag & cBgS_BndRecord::FLAG_NOT_READY; }
+    bool ChkMoveBg() const { return mFlag & cBgS_BndRecord::FLAG_MOVE_BG; }
+    bool ChkBndValid() const { return mFlag & cBgS_BndRecord::FLAG_BND_VALID; }
+    cM3dGAab* GetBnd() const { return (cM3dGAab*)&mBnd; }
+
+    /** Cuts the line short where it enters the box. */
+    bool LineCheck(cBgS_LinChk* p_line) {
+        p_line->mVisit++;
+        if (!ChkBndValid()) {
+            return false;
+        }
+        cXyz& start = p_line->mLin.mStart;
+        cXyz& end = p_line->mLin.mEnd;
+        const f32* s = &start.x;
+        const f32* e = &end.x;
+        const f32* min = &mBnd.mMin.x;
+        const f32* max = &mBnd.mMax.x;
+        f32 enter = 0.0f, leave = 1.0f;
+        for (int i = 0; i < 3; i++) {
+            f32 d = e[i] - s[i];
+            if (d == 0.0f) {
+                if (s[i] < min[i] || s[i] > max[i]) {
+                    return false;
+                }
+                continue;
+            }
+            f32 t0 = (min[i] - s[i]) / d;
+            f32 t1 = (max[i] - s[i]) / d;
+            if (t0 > t1) {
+                f32 t = t0;
+                t0 = t1;
+                t1 = t;
+            }
+            enter = t0 > enter ? t0 : enter;
+            leave = t1 < leave ? t1 : leave;
+            if (enter > leave) {
+                return false;
+            }
+        }
+        end.x = start.x + (end.x - start.x) * enter;
+        end.y = start.y + (end.y - start.y) * enter;
+        end.z = start.z + (end.z - start.z) * enter;
+        p_line->hit(mId);
+        return true;
+    }
+
+    /** Lands on the top of the box, or at the point when it is inside. */
+    bool GroundCross(cBgS_GndChk* p_gnd) {
+        p_gnd->mVisit++;
+        const cXyz& pos = p_gnd->mPos;
+        if (!ChkBndValid() || mBnd.mMin.x > pos.x || mBnd.mMax.x < pos.x ||
+            mBnd.mMin.z > pos.z || mBnd.mMax.z < pos.z || !(mBnd.mMin.y < pos.y))
+        {
+            return false;
+        }
+        f32 y = mBnd.mMax.y < pos.y ? mBnd.mMax.y : pos.y;
+        if (y <= p_gnd->mNowY) {
+            return false;
+        }
+        p_gnd->mNowY = y;
+        p_gnd->hit(mId);
+        return true;
+    }
+};
+
+#define BGS_DECLS                                                                                  \
+    class cBgS_ChkElm {                                                                            \
+    public:                                                                                        \
+        dBgW_Base* m_bgw_base_ptr;                                                                 \
+        bool m_used;                                                                               \
+        u32 m_actor_id;                                                                            \
+        fopAc_ac_c* m_actor_ptr;                                                                   \
+                                                                                                   \
+        void Init();                                                                               \
+        void Release();                                                                            \
+        void Regist2(dBgW_Base*, fpc_ProcID, void*);                                               \
+        bool ChkUsed() const { return m_used; }                                                    \
+    };                                                                                             \
+                                                                                                   \
+    class cBgS {                                                                                   \
+    public:                                                                                        \
+        cBgS_ChkElm m_chk_element[256];                                                            \
+                                                                                                   \
+        bool Regist(dBgW_Base*, fpc_ProcID, void*);                                                \
+        bool Release(dBgW_Base*);                                                                  \
+        bool LineCross(cBgS_LinChk*);                                                              \
+        f32 GroundCross(cBgS_GndChk*);                                                             \
+        void Ct();                                                                                 \
+                                                                                                   \
+        enum {                                                                                     \
+            BND_GRID_NUM = 16,                                                                     \
+            BND_MASK_NUM = 0x100 / 32,                                                             \
+        };                                                                                         \
+                                                                                                   \
+        void ClrBnd();                                                                             \
+        void RefitBnd();                                                                           \
+        void GetBndCandidate(f32, f32, f32, f32, u32*) const;                                      \
+        void RecordBody(u8, int) const;                                                            \
+                                                                                                   \
+        static void RecordBnd(u8, u8, int, u32, const Vec*, const Vec*);                           \
+        static bool StartBndRecord(void*, u32);                                                    \
+        static u32 StopBndRecord();                                                                \
+                                                                                                   \
+        u32 m_bnd_indexed[BND_MASK_NUM];                                                           \
+        u32 m_bnd_always[BND_MASK_NUM];                                                            \
+        u32 m_bnd_grid[BND_GRID_NUM][BND_GRID_NUM][BND_MASK_NUM];                                  \
+        Vec m_bnd_min[0x100];                                                                      \
+        Vec m_bnd_max[0x100];                                                                      \
+    };
+
+namespace ref {
+#define ENABLE_BGS_BROADPHASE 0
+BGS_DECLS
+#include "splice.inc"
+#undef ENABLE_BGS_BROADPHASE
+
+static void refit(cBgS&) {}
+static void setCounter(int slot) {
+    l_SetCounter = slot;
+}
+}  // namespace ref
+
+namespace grid {
+#define ENABLE_BGS_BROADPHASE 1
+BGS_DECLS
+#include "splice.inc"
+#undef ENABLE_BGS_BROADPHASE
+
+static void refit(cBgS& bgs) {
+    bgs.RefitBnd();
+}
+static void setCounter(int slot) {
+    l_SetCounter = slot;
+}
+}  // namespace grid
+
+static u32 swap32(u32 v) {
+    return __builtin_bswap32(v);
+}
+
+static f32 swapF32(f32 v) {
+    u32 bits;
+    memcpy(&bits, &v, 4);
+    bits = swap32(bits);
+    memcpy(&v, &bits, 4);
+    return v;
+}
+
+/** Converts a recording between the target's byte order and the host's, in place. */
+static void swapRecords(cBgS_BndRecord* record, u32 num) {
+    for (u32 i = 0; i < num; i++) {
+        record[i].mSlot = __builtin_bswap16(record[i].mSlot);
+        record[i].mId = swap32(record[i].mId);
+        for (int j = 0; j < 6; j++) {
+            record[i].mV[j] = swapF32(record[i].mV[j]);
+        }
+    }
+}
+
+static void setBody(dBgW_Base* body, const cBgS_BndRecord& record) {
+    body->mFlag = record.mFlag;
+    body->mBnd.mMin.x = record.mV[0];
+    body->mBnd.mMin.y = record.mV[1];
+    body->mBnd.mMin.z = record.mV[2];
+    body->mBnd.mMax.x = record.mV[3];
+    body->mBnd.mMax.y = record.mV[4];
+    body->mBnd.mMax.z = record.mV[5];
+}
+
+/** Moves every Move BG body a little away from the bounds its refit saw. */
+static void driftMoveBg(dBgW_Base* bodies, u32 frame) {
+    for (int i = 0; i < 0x100; i++) {
+        dBgW_Base* body = &bodies[i];
+        if (!body->mUsed || !body->ChkMoveBg()) {
+            continue;
+        }
+        HostRandom rnd(frame * 0x100 + i + 1);
+        f32 dx = rnd.unit() * 600.0f - 300.0f;
+        f32 dz = rnd.unit() * 600.0f - 300.0f;
+        body->mBnd.mMin.x += dx;
+        body->mBnd.mMax.x += dx;
+        body->mBnd.mMin.z += dz;
+        body->mBnd.mMax.z += dz;
+    }
+}
+
+struct Replay {
+    std::vector<Result> mResults;
+    long mVisits[2];
+    int mQueries[2];
+    double mSeconds;
+};
+
+/** Runs the recording through one build of cBgS. */
+template <typename BgS>
+static void replay(const std::vector<cBgS_BndRecord>& records, void (*refit)(BgS&),
+                   void (*setCounter)(int), Replay* out) {
+    static dBgW_Base bodies[0x100];
+    static BgS bgs;
+    memset(bodies, 0, sizeof(bodies));
+    memset(&bgs, 0, sizeof(bgs));
+    bgs.Ct();
+
+    out->mResults.clear();
+    out->mVisits[0] = out->mVisits[1] = 0;
+    out->mQueries[0] = out->mQueries[1] = 0;
+    out->mSeconds = 0.0;
+    bool refitPending = false;
+    u32 frame = 0;
+    for (size_t n = 0; n < records.size(); n++) {
+        const cBgS_BndRecord& record = records[n];
+        if (refitPending && record.mType != cBgS_BndRecord::TYPE_BODY) {
+            refit(bgs);
+            driftMoveBg(bodies, frame);
+            refitPending = false;
+        }
+
+        dBgW_Base* body = &bodies[record.mSlot & 0xFF];
+        switch (record.mType) {
+        case cBgS_BndRecord::TYPE_REFIT:
+            refitPending = true;
+            frame++;
+            break;
+        case cBgS_BndRecord::TYPE_BODY:
+        case cBgS_BndRecord::TYPE_REGIST:
+            setBody(body, record);
+            if (!body->mUsed) {
+                setCounter(record.mSlot);
+                bool failed = bgs.Regist(body, record.mId, NULL);
+                HOST_CHECK(!failed && body->mId == record.mSlot, "record %d: slot %d not taken",
+                           (int)n, record.mSlot);
+            }
+            break;
+        case cBgS_BndRecord::TYPE_RELEASE:
+            HOST_CHECK(body->mUsed, "record %d: slot %d released twice", (int)n, record.mSlot);
+            bgs.Release(body);
+            break;
+        case cBgS_BndRecord::TYPE_LINE: {
+            cBgS_LinChk line;
+            memset(&line, 0, sizeof(line));
+            line.mActorPid = record.mId;
+            line.mLin.mStart.x = record.mV[0];
+            line.mLin.mStart.y = record.mV[1];
+            line.mLin.mStart.z = record.mV[2];
+            line.mLin.mEnd.x = record.mV[3];
+            line.mLin.mEnd.y = record.mV[4];
+            line.mLin.mEnd.z = record.mV[5];
+            double start = host_seconds();
+            bool hit = bgs.LineCross(&line);
+            out->mSeconds += host_seconds() - start;
+            line.mResult.mValue[0] = line.mLin.mEnd.x;
+            line.mResult.mValue[1] = line.mLin.mEnd.y;
+            line.mResult.mValue[2] = hit ? line.mLin.mEnd.z : -1.0f;
+            out->mResults.push_back(line.mResult);
+            out->mVisits[0] += line.mVisit;
+            out->mQueries[0]++;
+            break;
+        }
+        case cBgS_BndRecord::TYPE_GND: {
+            cBgS_GndChk gnd;
+            memset(&gnd, 0, sizeof(gnd));
+            gnd.mActorPid = record.mId;
+            gnd.mPos.x = record.mV[0];
+            gnd.mPos.y = record.mV[1];
+            gnd.mPos.z = record.mV[2];
+            double start = host_seconds();
+            f32 y = bgs.GroundCross(&gnd);
+            out->mSeconds += host_seconds() - start;
+            gnd.mResult.mValue[0] = y;
+            gnd.mResult.mValue[1] = 0.0f;
+            gnd.mResult.mValue[2] = 0.0f;
+            out->mResults.push_back(gnd.mResult);
+            out->mVisits[1] += gnd.mVisit;
+            out->mQueries[1]++;
+            break;
+        }
+        default:
+            HOST_CHECK(false, "record %d: unknown type %d", (int)n, record.mType);
+            break;
+        }
+    }
+}
+
+enum {
+    MAP_SIZE = 40000,
+    STATIC_NUM = 70,
+    KCOL_NUM = 8,
+    MOVE_NUM = 40,
+    FRAME_NUM = 10,
+    QUERY_NUM = 200,
+    CHURN_NUM = 3,
+};
+
+static f32 randomRange(HostRandom& rnd, f32 lo, f32 hi) {
+    return lo + (hi - lo) * rnd.unit();
+}
+
+static void randomBox(HostRandom& rnd, dBgW_Base* body, f32 size_lo, f32 size_hi) {
+    f32 x = randomRange(rnd, -MAP_SIZE / 2, MAP_SIZE / 2);
+    f32 z = randomRange(rnd, -MAP_SIZE / 2, MAP_SIZE / 2);
+    f32 y = randomRange(rnd, -500.0f, 500.0f);
+    f32 sx = randomRange(rnd, size_lo, size_hi);
+    f32 sz = randomRange(rnd, size_lo, size_hi);
+    f32 sy = randomRange(rnd, 100.0f, 2000.0f);
+    body->mBnd.mMin.x = x - sx * 0.5f;
+    body->mBnd.mMax.x = x + sx * 0.5f;
+    body->mBnd.mMin.z = z - sz * 0.5f;
+    body->mBnd.mMax.z = z + sz * 0.5f;
+    body->mBnd.mMin.y = y - 200.0f;
+    body->mBnd.mMax.y = y + sy;
+}
+
+/**
+ * Plays a made-up stage through the broadphase build with recording on: terrain and room
+ * geometry, KCol bodies without bounds, Move BG bodies that move, come and go every frame,
+ * and the ground and line checks of actors walking about and of a camera.
+ */
+static bool writeRecording(const char* path) {
+    static dBgW_Base bodies[0x100];
+    static grid::cBgS bgs;
+    HostRandom rnd(0x5EED0006);
+    bgs.Ct();
+
+    int num = 0;
+    for (int i = 0; i < STATIC_NUM; i++, num++) {
+        bodies[num].mFlag = cBgS_BndRecord::FLAG_BND_VALID;
+        randomBox(rnd, &bodies[num], 1000.0f, i < 3 ? 30000.0f : 6000.0f);
+        bgs.Regist(&bodies[num], 0x1000 + num, NULL);
+    }
+    for (int i = 0; i < KCOL_NUM; i++, num++) {
+        bodies[num].mFlag = 0;
+        bgs.Regist(&bodies[num], 0x1000 + num, NULL);
+    }
+    bodies[num - 1].mFlag = cBgS_BndRecord::FLAG_NOT_READY;
+    int moveStart = num;
+    for (int i = 0; i < MOVE_NUM; i++, num++) {
+        bodies[num].mFlag = cBgS_BndRecord::FLAG_BND_VALID | cBgS_BndRecord::FLAG_MOVE_BG;
+        randomBox(rnd, &bodies[num], 200.0f, 1200.0f);
+        bgs.Regist(&bodies[num], 0x1000 + num, NULL);
+    }
+
+    static u8 buffer[0x40000];
+    grid::cBgS::StartBndRecord(buffer, sizeof(buffer));
+    for (int frame = 0; frame < FRAME_NUM; frame++) {
+        bgs.RefitBnd();
+
+        for (int i = 0; i < CHURN_NUM; i++) {
+            dBgW_Base* body = &bodies[moveStart + rnd.below(MOVE_NUM)];
+            if (body->mUsed) {
+                bgs.Release(body);
+            }
+            randomBox(rnd, body, 200.0f, 1200.0f);
+            bgs.Regist(body, 0x2000 + frame * CHURN_NUM + i, NULL);
+        }
+        for (int i = moveStart; i < num; i++) {
+            f32 dx = randomRange(rnd, -300.0f, 300.0f);
+            f32 dz = randomRange(rnd, -300.0f, 300.0f);
+            bodies[i].mBnd.mMin.x += dx;
+            bodies[i].mBnd.mMax.x += dx;
+            bodies[i].mBnd.mMin.z += dz;
+            bodies[i].mBnd.mMax.z += dz;
+        }
+
+        for (int i = 0; i < QUERY_NUM; i++) {
+            fpc_ProcID pid = fpcM_ERROR_PROCESS_ID_e;
+            if (rnd.below(4) == 0) {
+                pid = 0x1000 + rnd.below(num);
+            }
+
+            cBgS_GndChk gnd;
+            memset(&gnd, 0, sizeof(gnd));
+            gnd.mActorPid = pid;
+            gnd.mPos.x = randomRange(rnd, -MAP_SIZE / 2, MAP_SIZE / 2);
+            gnd.mPos.y = randomRange(rnd, 0.0f, 3000.0f);
+            gnd.mPos.z = randomRange(rnd, -MAP_SIZE / 2, MAP_SIZE / 2);
+            bgs.GroundCross(&gnd);
+
+            cBgS_LinChk line;
+            memset(&line, 0, sizeof(line));
+            line.mActorPid = pid;
+            line.mLin.mStart = gnd.mPos;
+            f32 length = i % 4 == 0 ? randomRange(rnd, 1000.0f, 10000.0f) :
+                                      randomRange(rnd, 50.0f, 800.0f);
+            line.mLin.mEnd.x = gnd.mPos.x + randomRange(rnd, -1.0f, 1.0f) * length;
+            line.mLin.mEnd.y = gnd.mPos.y + randomRange(rnd, -1.0f, 0.3f) * length;
+            line.mLin.mEnd.z = gnd.mPos.z + randomRange(rnd, -1.0f, 1.0f) * length;
+            bgs.LineCross(&line);
+        }
+    }
+
+    cBgS_BndRecordHeader* header = (cBgS_BndRecordHeader*)buffer;
+    u32 count = grid::cBgS::StopBndRecord();
+    if (header->mDropped != 0) {
+        printf("recording buffer too small: %d records dropped\n", header->mDropped);
+        return false;
+    }
+    swapRecords((cBgS_BndRecord*)(header + 1), count);
+    header->mMagic = swap32(header->mMagic);
+    header->mVersion = swap32(header->mVersion);
+    header->mCount = swap32(header->mCount);
+    header->mDropped = swap32(header->mDropped);
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("cannot write %s\n", path);
+        return false;
+    }
+    fwrite(buffer, 1, sizeof(cBgS_BndRecordHeader) + count * sizeof(cBgS_BndRecord), file);
+    fclose(file);
+    printf("wrote %d records to %s\n", count, path);
+    return true;
+}
+
+static bool readRecording(const char* path, std::vector<cBgS_BndRecord>* records) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("cannot read %s\n", path);
+        return false;
+    }
+    cBgS_BndRecordHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && swap32(header.mMagic) == 0x42475243 &&
+              swap32(header.mVersion) == 1;
+    if (ok) {
+        records->resize(swap32(header.mCount));
+        ok = fread(records->data(), sizeof(cBgS_BndRecord), records->size(), file) ==
+             records->size();
+    }
+    fclose(file);
+    if (!ok) {
+        printf("%s is not a cBgS recording\n", path);
+        return false;
+    }
+    swapRecords(records->data(), records->size());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "tools/host_check/bgs_record.bin";
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--write") == 0) {
+            return writeRecording(path) ? 0 : 1;
+        }
+        path = argv[i];
+    }
+
+    std::vector<cBgS_BndRecord> records;
+    if (!readRecording(path, &records)) {
+        return 1;
+    }
+
+    static Replay full, grid;
+    double fullSeconds = 0.0, gridSeconds = 0.0;
+    for (int loop = 0; loop < 20; loop++) {
+        replay<ref::cBgS>(records, ref::refit, ref::setCounter, &full);
+        replay<grid::cBgS>(records, grid::refit, grid::setCounter, &grid);
+        fullSeconds += full.mSeconds;
+        gridSeconds += grid.mSeconds;
+    }
+
+    HOST_CHECK(full.mResults.size() == grid.mResults.size(), "query counts differ");
+    for (size_t i = 0; i < full.mResults.size() && i < grid.mResults.size(); i++) {
+        const Result& a = full.mResults[i];
+        const Result& b = grid.mResults[i];
+        HOST_CHECK(a.mHitSum == b.mHitSum && a.mHitNum == b.mHitNum && a.mSlot == b.mSlot,
+                   "query %d: hit %d bodies ending in slot %d, broadphase %d ending in %d", (int)i,
+                   a.mHitNum, a.mSlot, b.mHitNum, b.mSlot);
+        HOST_CHECK(memcmp(a.mValue, b.mValue, sizeof(a.mValue)) == 0,
+                   "query %d: ends at %g %g %g, broadphase at %g %g %g", (int)i, a.mValue[0],
+                   a.mValue[1], a.mValue[2], b.mValue[0], b.mValue[1], b.mValue[2]);
+    }
+
+    int hits = 0;
+    for (size_t i = 0; i < full.mResults.size(); i++) {
+        hits += full.mResults[i].mSlot >= 0;
+    }
+    int queries = full.mQueries[0] + full.mQueries[1];
+    printf("%d records, %d line and %d ground checks, %d hit\n", (int)records.size(),
+           full.mQueries[0], full.mQueries[1], hits);
+    printf("bodies visited per line check: full scan %.1f, broadphase %.1f\n",
+           (double)full.mVisits[0] / full.mQueries[0], (double)grid.mVisits[0] / grid.mQueries[0]);
+    printf("bodies visited per ground check: full scan %.1f, broadphase %.1f\n",
+           (double)full.mVisits[1] / full.mQueries[1], (double)grid.mVisits[1] / grid.mQueries[1]);
+    printf("full scan %.2f us/query, broadphase %.2f us/query\n",
+           fullSeconds * 1e6 / (queries * 20), gridSeconds * 1e6 / (queries * 20));
+
+    return host_check_result("bgs_broadphase");
+}
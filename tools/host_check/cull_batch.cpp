@@ -0,0 +1,265 @@
+// Runs J3DUClipper::clipSphereBatch and clipBoxBatch (user-010) on random spheres and boxes and
+// compares every result with J3DUClipper::clip, the scalar test fopAcM_cullingCheck uses. The
+// batch inputs are built the way fopAcM_cullingCheckAll builds them: centers in view space, box
+// half extents as the matrix columns scaled by the half size, and a far distance per item. About
+// a third of the items get their own far distance, which the scalar side applies with setFar.
+//
+// Spheres go through the same view space center and compares, so they must agree bit for bit.
+// Boxes use a separating plane test instead of the eight corners, so the two may round apart
+// when a box touches a plane; a mismatch is only accepted when the box is within a hair of the
+// plane that decides it. Prints the items per millisecond of both paths.
+//
+// tree: libs/JSystem/src/J3DU/J3DUClipper.cpp
+// define: ENABLE_CULL_BATCH=1
+// splice: libs/dolphin/src/mtx/mtxvec.c C_MTXMultVec
+// splice: libs/dolphin/src/mtx/vec.c C_VECNormalize C_VECCrossProduct
+
+#include "host_check.h"
+
+#define private public
+#include "JSystem/J3DU/J3DUClipper.h"
+#undef private
+#include <dolphin/mtx.h>
+#include <cmath>
+
+#include "splice.inc"
+
+extern "C" {
+double __fabs(double x) {
+    return __builtin_fabs(x);
+}
+double __frsqrte(double x) {
+    return 1.0 / __builtin_sqrt(x);
+}
+void PSMTXMultVec(const Mtx m, const Vec* src, Vec* dst) {
+    C_MTXMultVec(m, src, dst);
+}
+void PSVECNormalize(const Vec* src, Vec* unit) {
+    C_VECNormalize(src, unit);
+}
+void PSVECCrossProduct(const Vec* a, const Vec* b, Vec* axb) {
+    C_VECCrossProduct(a, b, axb);
+}
+}
+
+enum {
+    ITEM_NUM = 100000,
+    LOOP_NUM = 10,
+};
+
+static const f32 FAR = 10000.0f;
+
+struct Item {
+    Mtx mtx;
+    Vec min;
+    Vec max;
+    f32 radius;
+    f32 far;
+};
+
+static struct {
+    f32 x[ITEM_NUM];
+    f32 y[ITEM_NUM];
+    f32 z[ITEM_NUM];
+    f32 radius[ITEM_NUM];
+    f32 axis[9][ITEM_NUM];
+    f32 far[ITEM_NUM];
+    u8 result[ITEM_NUM];
+} l_batch;
+
+static Item l_item[ITEM_NUM];
+static u8 l_scalar[ITEM_NUM];
+
+static f32 randomRange(HostRandom& rnd, f32 lo, f32 hi) {
+    return lo + (hi - lo) * rnd.unit();
+}
+
+/** An actor matrix concatenated with the view: any linear part, spread around the frustum. */
+static void makeItem(HostRandom& rnd, Item* item) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            item->mtx[i][j] = randomRange(rnd, -1.5f, 1.5f);
+        }
+    }
+    item->mtx[0][3] = randomRange(rnd, -9000.0f, 9000.0f);
+    item->mtx[1][3] = randomRange(rnd, -7000.0f, 7000.0f);
+    item->mtx[2][3] = randomRange(rnd, -12000.0f, 1000.0f);
+
+    f32* min = &item->min.x;
+    f32* max = &item->max.x;
+    for (int i = 0; i < 3; i++) {
+        f32 a = randomRange(rnd, -600.0f, 600.0f);
+        f32 b = randomRange(rnd, -600.0f, 600.0f);
+        min[i] = a < b ? a : b;
+        max[i] = a < b ? b : a;
+    }
+    item->radius = randomRange(rnd, 0.0f, 800.0f);
+    item->far = rnd.below(3) == 0 ? randomRange(rnd, 500.0f, 12000.0f) : FAR;
+}
+
+/** Fills the sphere inputs as fopAcM_cullingCheckAllSub does, from the box center. */
+static void prepareSpheres() {
+    for (int i = 0; i < ITEM_NUM; i++) {
+        Item* item = &l_item[i];
+        Vec center = {(item->max.x + item->min.x) * 0.5f, (item->max.y + item->min.y) * 0.5f,
+                      (item->max.z + item->min.z) * 0.5f};
+        Vec view_center;
+        MTXMultVec(item->mtx, &center, &view_center);
+        l_batch.x[i] = view_center.x;
+        l_batch.y[i] = view_center.y;
+        l_batch.z[i] = view_center.z;
+        l_batch.radius[i] = item->radius;
+        l_batch.far[i] = item->far;
+    }
+}
+
+/** Fills the box inputs as fopAcM_cullingCheckAllSub does. */
+static void prepareBoxes() {
+    for (int i = 0; i < ITEM_NUM; i++) {
+        Item* item = &l_item[i];
+        Vec center = {(item->max.x + item->min.x) * 0.5f, (item->max.y + item->min.y) * 0.5f,
+                      (item->max.z + item->min.z) * 0.5f};
+        Vec half = {(item->max.x - item->min.x) * 0.5f, (item->max.y - item->min.y) * 0.5f,
+                    (item->max.z - item->min.z) * 0.5f};
+        Vec view_center;
+        MTXMultVec(item->mtx, &center, &view_center);
+        l_batch.x[i] = view_center.x;
+        l_batch.y[i] = view_center.y;
+        l_batch.z[i] = view_center.z;
+        for (int j = 0; j < 3; j++) {
+            l_batch.axis[j][i] = item->mtx[j][0] * half.x;
+            l_batch.axis[3 + j][i] = item->mtx[j][1] * half.y;
+            l_batch.axis[6 + j][i] = item->mtx[j][2] * half.z;
+        }
+        l_batch.far[i] = item->far;
+    }
+}
+
+/** clip() with the item's far distance, as fopAcM_cullingCheck applies it. */
+static int scalarSphere(J3DUClipper& clipper, Item* item) {
+    Vec center = {(item->max.x + item->min.x) * 0.5f, (item->max.y + item->min.y) * 0.5f,
+                  (item->max.z + item->min.z) * 0.5f};
+    clipper.setFar(item->far);
+    int ret = clipper.clip(item->mtx, center, item->radius);
+    clipper.setFar(FAR);
+    return ret;
+}
+
+static int scalarBox(J3DUClipper& clipper, Item* item) {
+    clipper.setFar(item->far);
+    int ret = clipper.clip(item->mtx, &item->min, &item->max);
+    clipper.setFar(FAR);
+    return ret;
+}
+
+/**
+ * How far the box lies from flipping the result of the plane that decides it, in double
+ * precision, relative to the size of the numbers involved.
+ */
+static double boxMargin(J3DUClipper& clipper, int i) {
+    const Vec* normal[4] = {&clipper._04, &clipper._10, &clipper._1C, &clipper._28};
+    double cx = l_batch.x[i], cy = l_batch.y[i], cz = l_batch.z[i];
+    double scale = fabs(cx) + fabs(cy) + fabs(cz);
+    double margin = 1e30;
+    for (int p = 0; p < 6; p++) {
+        double dist, extent = 0.0;
+        for (int k = 0; k < 3; k++) {
+            double ax = l_batch.axis[k * 3][i];
+            double ay = l_batch.axis[k * 3 + 1][i];
+            double az = l_batch.axis[k * 3 + 2][i];
+            scale += fabs(ax) + fabs(ay) + fabs(az);
+            if (p < 4) {
+                extent += fabs(ax * normal[p]->x + ay * normal[p]->y + az * normal[p]->z);
+            } else {
+                extent += fabs(az);
+            }
+        }
+        if (p < 4) {
+            dist = cx * normal[p]->x + cy * normal[p]->y + cz * normal[p]->z;
+        } else if (p == 4) {
+            dist = cz + clipper.mNear;
+        } else {
+            dist = -cz - l_batch.far[i];
+        }
+        double gap = fabs(dist - extent);
+        if (gap < margin) {
+            margin = gap;
+        }
+    }
+    return margin / scale;
+}
+
+int main() {
+    HostRandom rnd(0x5EED0010);
+    J3DUClipper clipper;
+    clipper.setFovy(60.0f);
+    clipper.setAspect(1.7777778f);
+    clipper.setNear(1.0f);
+    clipper.setFar(FAR);
+    clipper.calcViewFrustum();
+
+    for (int i = 0; i < ITEM_NUM; i++) {
+        makeItem(rnd, &l_item[i]);
+    }
+    printf("cull_batch: %d items, %d loops\n", ITEM_NUM, LOOP_NUM);
+
+    int culled = 0;
+    double scalarTime = host_seconds();
+    for (int loop = 0; loop < LOOP_NUM; loop++) {
+        for (int i = 0; i < ITEM_NUM; i++) {
+            l_scalar[i] = scalarSphere(clipper, &l_item[i]);
+        }
+    }
+    scalarTime = host_seconds() - scalarTime;
+    double batchTime = host_seconds();
+    for (int loop = 0; loop < LOOP_NUM; loop++) {
+        prepareSpheres();
+        clipper.clipSphereBatch(ITEM_NUM, l_batch.x, l_batch.y, l_batch.z, l_batch.radius,
+                                l_batch.far, l_batch.result);
+    }
+    batchTime = host_seconds() - batchTime;
+    for (int i = 0; i < ITEM_NUM; i++) {
+        HOST_CHECK(l_batch.result[i] == l_scalar[i], "sphere %d: batch %d, clip %d", i,
+                   l_batch.result[i], l_scalar[i]);
+        culled += l_scalar[i];
+    }
+    printf("spheres: %d culled; clip %d items/ms, batch %d items/ms\n", culled,
+           (int)(ITEM_NUM * LOOP_NUM / (scalarTime * 1000.0)),
+           (int)(ITEM_NUM * LOOP_NUM / (batchTime * 1000.0)));
+
+    culled = 0;
+    scalarTime = host_seconds();
+    for (int loop = 0; loop < LOOP_NUM; loop++) {
+        for (int i = 0; i < ITEM_NUM; i++) {
+            l_scalar[i] = scalarBox(clipper, &l_item[i]);
+        }
+    }
+    scalarTime = host_seconds() - scalarTime;
+    const f32* axis[9];
+    for (int i = 0; i < 9; i++) {
+        axis[i] = l_batch.axis[i];
+    }
+    batchTime = host_seconds();
+    for (int loop = 0; loop < LOOP_NUM; loop++) {
+        prepareBoxes();
+        clipper.clipBoxBatch(ITEM_NUM, l_batch.x, l_batch.y, l_batch.z, axis, l_batch.far,
+                             l_batch.result);
+    }
+    batchTime = host_seconds() - batchTime;
+    int touching = 0;
+    for (int i = 0; i < ITEM_NUM; i++) {
+        if (l_batch.result[i] != l_scalar[i]) {
+            double margin = boxMargin(clipper, i);
+            HOST_CHECK(margin < 1e-5, "box %d: batch %d, clip %d, %g from the deciding plane", i,
+                       l_batch.result[i], l_scalar[i], margin);
+            touching++;
+        }
+        culled += l_scalar[i];
+    }
+    HOST_CHECK(touching * 1000 < ITEM_NUM, "boxes: %d touching mismatches", touching);
+    printf("boxes: %d culled, %d round apart on a plane; clip %d items/ms, batch %d items/ms\n",
+           culled, touching, (int)(ITEM_NUM * LOOP_NUM / (scalarTime * 1000.0)),
+           (int)(ITEM_NUM * LOOP_NUM / (batchTime * 1000.0)));
+
+    return host_check_result("cull_batch");
+}
@@ -0,0 +1,112 @@
+// Checks the ENABLE_FAST_DECOMP Yaz0/Yay0 decoders (user-001) against the original ones.
+// Every corpus file is encoded on the host, then decoded in full and in part by both builds;
+// the output must match the input byte for byte. Decodes that skip leading bytes must match
+// between the builds. Prints the full-decode throughput of both builds.
+//
+// splice: libs/JSystem/src/JKernel/JKRDecomp.cpp JKRDecomp::decodeSZP JKRDecomp::decodeSZS copyBackReference JKRDecomp::decodeSZPFull JKRDecomp::decodeSZSFull
+// rewrite: *(int*)(src_buffer + 4) => (int)be32(src_buffer + 4)
+// rewrite: *(u32*)src_buffer => be32(src_buffer)
+
+#include "host_check.h"
+#include "szs_corpus.h"
+
+namespace ref {
+#define ENABLE_FAST_DECOMP 0
+struct JKRDecomp {
+    static void decodeSZP(u8*, u8*, u32, u32);
+    static void decodeSZS(u8*, u8*, u32, u32);
+    static void decodeSZPFull(u8*, u8*, u32);
+    static void decodeSZSFull(u8*, u8*, u32);
+};
+#include "splice.inc"
+#undef ENABLE_FAST_DECOMP
+}  // namespace ref
+
+namespace fast {
+#define ENABLE_FAST_DECOMP 1
+struct JKRDecomp {
+    static void decodeSZP(u8*, u8*, u32, u32);
+    static void decodeSZS(u8*, u8*, u32, u32);
+    static void decodeSZPFull(u8*, u8*, u32);
+    static void decodeSZSFull(u8*, u8*, u32);
+};
+#include "splice.inc"
+#undef ENABLE_FAST_DECOMP
+}  // namespace fast
+
+typedef void (*DecodeFunc)(u8*, u8*, u32, u32);
+
+static const u32 GUARD = 64;
+
+static void checkDecode(const char* name, DecodeFunc refDecode, DecodeFunc fastDecode, Bytes& enc,
+                        const Bytes& raw) {
+    u32 size = raw.size();
+    DecodeFunc decode[2] = {refDecode, fastDecode};
+
+    for (int i = 0; i < 2; i++) {
+        const char* build = i == 0 ? "ref" : "fast";
+        Bytes out(size + GUARD, 0xCD);
+        decode[i](&enc[0], &out[0], size, 0);
+        HOST_CHECK(memcmp(&out[0], &raw[0], size) == 0, "%s %s: full decode of %u bytes differs",
+                   build, name, size);
+        HOST_CHECK(out[size] == 0xCD, "%s %s: full decode of %u bytes wrote past the end", build, name,
+                   size);
+
+        if (size > 1) {
+            u32 limit = size / 2;
+            Bytes part(size + GUARD, 0xCD);
+            decode[i](&enc[0], &part[0], limit, 0);
+            HOST_CHECK(memcmp(&part[0], &raw[0], limit) == 0 && part[limit] == 0xCD,
+                       "%s %s: partial decode of %u/%u bytes differs", build, name, limit, size);
+        }
+    }
+
+    // Skipped bytes are not written, so back-references into them read whatever the
+    // destination held (reads start up to MAX_DIST bytes early); both builds must still agree.
+    if (size > 1) {
+        u32 skip = size / 3;
+        u32 length = size - skip;
+        Bytes out[2];
+        for (int i = 0; i < 2; i++) {
+            out[i].assign(MAX_DIST + size + GUARD, 0xCD);
+            decode[i](&enc[0], &out[i][MAX_DIST], length, skip);
+        }
+        HOST_CHECK(out[0] == out[1], "%s: decode skipping %u of %u bytes differs between builds", name,
+                   skip, size);
+    }
+}
+
+static double bench(DecodeFunc decode, std::vector<Bytes>& enc, const std::vector<Bytes>& raw) {
+    Bytes out(256 * 1024);
+    double bytes = 0;
+    double start = host_seconds();
+    for (int rep = 0; rep < 50; rep++) {
+        for (size_t i = 0; i < enc.size(); i++) {
+            decode(&enc[i][0], &out[0], raw[i].size(), 0);
+            bytes += raw[i].size();
+        }
+    }
+    return bytes / (host_seconds() - start) / 1e6;
+}
+
+int main() {
+    std::vector<Bytes> corpus = makeCorpus();
+    std::vector<Bytes> szs;
+    std::vector<Bytes> szp;
+    for (const Bytes& raw : corpus) {
+        szs.push_back(encodeYaz0(raw));
+        szp.push_back(encodeYay0(raw));
+    }
+
+    for (size_t i = 0; i < corpus.size(); i++) {
+        checkDecode("SZS", ref::JKRDecomp::decodeSZS, fast::JKRDecomp::decodeSZS, szs[i], corpus[i]);
+        checkDecode("SZP", ref::JKRDecomp::decodeSZP, fast::JKRDecomp::decodeSZP, szp[i], corpus[i]);
+    }
+    printf("%zu files, round trip through both builds\n", corpus.size());
+
+    printf("SZS ref %.1f MB/s, fast %.1f MB/s\n", bench(ref::JKRDecomp::decodeSZS, szs, corpus),
+           bench(fast::JKRDecomp::decodeSZS, szs, corpus));
+    printf("SZP ref %.1f MB/s, fast %.1f MB/s\n", bench(ref::JKRDecomp::decodeSZP, szp, corpus),
+           bench(fast::JKRDecomp::decodeSZP, szp, corpus));
+    return host_check_result("decomp_fast");
+}
@@ -0,0 +1,626 @@
+// Replays a J3DDrawBuffer entry recording through the entry table and through
+// ENABLE_DRAW_KEY_SORT's key array (user-025), in head and in tail draw mode, and compares what
+// the two draw. entryMatSort must return the same for every entry, so that the same packets
+// merge. Both paths must draw the same packets with the same shapes, slot by slot, and visit
+// the slots in the same order: the key array keeps each packet's entry table slot in the top
+// bits of its key. Within a Z sort bucket the key array must draw farther packets first.
+// Frames that overflow the key array spill to the entry table and must draw exactly what it
+// draws. Prints the entries per frame and the time per frame of both paths.
+//
+// draw_key_record.bin next to this file is a recording made by J3DDrawBuffer::startRecord on
+// a made-up scene, as no game data ships with the repository: Mat sorted buffers of 0x80,
+// 0x20 and 1 slots, Z sorted ones of 0x100 and 0x10, packets from 300 materials over 120
+// textures, now and then a changed material or an entryImm packet, and frames large enough to
+// spill. tools/draw_key_bench.py replays it as well. Running the check with "-- --write"
+// records the scene again and rewrites the file before replaying it.
+//
+// tree: libs/JSystem/src/J3DGraphBase/J3DPacket.cpp
+// define: ENABLE_DRAW_KEY_SORT=1
+// splice: libs/JSystem/src/J3DGraphBase/J3DDrawBuffer.cpp J3DDrawBuffer::calcZRatio J3DDrawBuffer::initialize J3DDrawBuffer::allocBuffer J3DDrawBuffer::~J3DDrawBuffer J3DDrawBuffer::frameInit J3DDrawBuffer::entryMatSort J3DDrawBuffer::entryZSort J3DDrawBuffer::entryImm J3DDrawBuffer::draw J3DDrawBuffer::drawHead J3DDrawBuffer::drawTail
+// region: libs/JSystem/src/J3DGraphBase/J3DDrawBuffer.cpp J3DDrawKey* J3DDrawBuffer::sKeyWork; => J3DDrawBuffer::record
+// rewrite: -J3DCalcZValue(j3dSys.getViewMtx(), tmp) => -hostCalcZValue(j3dSys.getViewMtx(), tmp)
+// args: tools/host_check/draw_key_record.bin
+
+#include "host_check.h"
+
+// Materials, textures and the system state are filled in field by field.
+#define private public
+#define protected public
+#include "JSystem/J3DGraphBase/J3DDrawBuffer.h"
+#include "JSystem/J3DGraphBase/J3DMatBlock.h"
+#include "JSystem/J3DGraphBase/J3DMaterial.h"
+#include "JSystem/J3DGraphBase/J3DPacket.h"
+#include "JSystem/J3DGraphBase/J3DSys.h"
+#include "JSystem/J3DGraphBase/J3DTexture.h"
+#include "JSystem/JKernel/JKRHeap.h"
+#undef private
+#undef protected
+#include <dolphin/os.h>
+
+/** J3DCalcZValue is paired-single code; this is the same dot product. */
+static f32 hostCalcZValue(MtxP m, Vec v) {
+    return m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3];
+}
+
+#include "splice.inc"
+
+J3DDrawBuffer::drawFunc J3DDrawBuffer::drawFuncTable[2] = {
+    &J3DDrawBuffer::drawHead,
+    &J3DDrawBuffer::drawTail,
+};
+
+J3DSys::J3DSys() {}
+J3DSys j3dSys;
+JKRHeap* JKRHeap::sCurrentHeap;
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+void* host_fopen(const char*, const char*) __asm__("fopen");
+size_t host_fread(void*, size_t, size_t, void*) __asm__("fread");
+size_t host_fwrite(const void*, size_t, size_t, void*) __asm__("fwrite");
+int host_fclose(void*) __asm__("fclose");
+int host_strcmp(const char*, const char*) __asm__("strcmp");
+BOOL OSDisableInterrupts() {
+    return FALSE;
+}
+BOOL OSRestoreInterrupts(BOOL) {
+    return FALSE;
+}
+}
+
+static void* hostAlloc(size_t size, int align) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, align < 16 ? 16 : align, size);
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void* operator new[](size_t size, int align) {
+    return hostAlloc(size, align);
+}
+void* operator new[](size_t size, JKRHeap*, int align) {
+    return hostAlloc(size, align);
+}
+
+/** Packets log what they draw: their own number and, for material packets, their shapes. */
+static int l_drawLog[0x10000];
+static int l_drawLogNum;
+
+static void logDraw(int value) {
+    if (l_drawLogNum < (int)(sizeof(l_drawLog) / sizeof(l_drawLog[0]))) {
+        l_drawLog[l_drawLogNum++] = value;
+    }
+}
+
+enum {
+    LOG_PACKET = 0x10000000,
+    LOG_SHAPE = 0x20000000,
+    LOG_MASK = 0x0FFFFFFF,
+};
+
+struct HostTevBlock : public J3DTevBlock {
+    u16 mTexNo;
+
+    virtual void ptrToIndex() {}
+    virtual void indexToPtr() {}
+    virtual u32 getType() { return 'HTEV'; }
+    virtual u16 getTexNo(u32) const { return mTexNo; }
+};
+
+struct HostShapePacket : public J3DShapePacket {
+    int mId;
+};
+
+struct HostMatPacket : public J3DMatPacket {
+    int mId;
+
+    virtual void draw() {
+        logDraw(LOG_PACKET | mId);
+        for (J3DPacket* shape = mpShapePacket; shape != NULL; shape = shape->getNextPacket()) {
+            logDraw(LOG_SHAPE | ((HostShapePacket*)shape)->mId);
+        }
+    }
+};
+
+struct HostImmPacket : public J3DPacket {
+    int mId;
+    virtual void draw() { logDraw(LOG_PACKET | mId); }
+};
+
+static const int TEXTURE_MAX = 0x400;
+static ResTIMG l_timg[TEXTURE_MAX];
+static u32 l_timgHash[TEXTURE_MAX];
+static int l_timgNum;
+static J3DTexture l_texture(TEXTURE_MAX, l_timg);
+
+/** Returns a texture number whose entryMatSort hash is hash, or 0xFFFF for hash 0. */
+static u16 textureFor(u32 hash) {
+    if (hash == 0) {
+        return 0xFFFF;
+    }
+    for (int i = 0; i < l_timgNum; i++) {
+        if (l_timgHash[i] == hash) {
+            return i;
+        }
+    }
+    if (l_timgNum == TEXTURE_MAX) {
+        printf("too many textures in the recording\n");
+        exit(1);
+    }
+    // entryMatSort hashes the image address, which is the header address plus imageOffset.
+    l_timg[l_timgNum].imageOffset = ((uintptr_t)hash << 5) - (uintptr_t)&l_timg[l_timgNum];
+    l_timgHash[l_timgNum] = hash;
+    return l_timgNum++;
+}
+
+/** One entry as recorded, in host byte order. */
+struct Entry {
+    u8 mType;
+    u16 mSlot;
+    u32 mA;
+    u32 mB;
+};
+
+/** The frames one draw buffer saw, in recording order. */
+struct Buffer {
+    u32 mAddress;
+    int mSortMode;
+    u32 mTableSize;
+    int mFrameNum;
+    int mFrameStart[0x200];
+    int mFrameEnd[0x200];
+    Entry* mEntry;
+    int mEntryNum;
+};
+
+static const int BUFFER_MAX = 16;
+static const int ENTRY_MAX = 0x40000;
+
+static u32 swap32(u32 v) {
+    return v >> 24 | (v >> 8 & 0xFF00) | (v << 8 & 0xFF0000) | v << 24;
+}
+
+static u16 swap16(u16 v) {
+    return (u16)(v >> 8 | v << 8);
+}
+
+/** Splits a big-endian recording into per-buffer frames. Returns the number of buffers. */
+static int readRecord(const char* path, Buffer* buffers) {
+    void* file = host_fopen(path, "rb");
+    if (file == NULL) {
+        printf("cannot open %s\n", path);
+        return 0;
+    }
+    J3DDrawRecordHeader header;
+    if (host_fread(&header, sizeof(header), 1, file) != 1 || swap32(header.mMagic) != 'DKRC') {
+        printf("%s is not a draw buffer recording\n", path);
+        host_fclose(file);
+        return 0;
+    }
+    u32 count = swap32(header.mCount);
+    J3DDrawRecord* records = new J3DDrawRecord[count];
+    count = host_fread(records, sizeof(J3DDrawRecord), count, file);
+    host_fclose(file);
+
+    int bufferNum = 0;
+    for (u32 i = 0; i < count; i++) {
+        J3DDrawRecord& record = records[i];
+        u32 address = swap32(record.mBuffer);
+        Buffer* buffer = NULL;
+        for (int j = 0; j < bufferNum; j++) {
+            if (buffers[j].mAddress == address) {
+                buffer = &buffers[j];
+            }
+        }
+        if (buffer == NULL) {
+            if (record.mType != J3DDrawRecord::TYPE_FRAME || bufferNum == BUFFER_MAX) {
+                continue;
+            }
+            buffer = &buffers[bufferNum++];
+            memset(buffer, 0, sizeof(*buffer));
+            buffer->mAddress = address;
+            buffer->mEntry = new Entry[ENTRY_MAX];
+        }
+
+        if (record.mType == J3DDrawRecord::TYPE_FRAME) {
+            if (buffer->mFrameNum != 0) {
+                buffer->mFrameEnd[buffer->mFrameNum - 1] = buffer->mEntryNum;
+            }
+            if (buffer->mFrameNum == 0x200) {
+                continue;
+            }
+            buffer->mSortMode = swap16(record.mSlot);
+            buffer->mTableSize = swap32(record.mA);
+            buffer->mFrameStart[buffer->mFrameNum++] = buffer->mEntryNum;
+            buffer->mFrameEnd[buffer->mFrameNum - 1] = buffer->mEntryNum;
+            continue;
+        }
+        if (buffer->mEntryNum == ENTRY_MAX) {
+            continue;
+        }
+        Entry& entry = buffer->mEntry[buffer->mEntryNum++];
+        entry.mType = record.mType;
+        entry.mSlot = swap16(record.mSlot);
+        entry.mA = swap32(record.mA);
+        entry.mB = swap32(record.mB);
+        buffer->mFrameEnd[buffer->mFrameNum - 1] = buffer->mEntryNum;
+    }
+    delete[] records;
+    return bufferNum;
+}
+
+/** The packets for one replay of one frame into one draw buffer. */
+struct FramePackets {
+    HostMatPacket* mMat;
+    HostShapePacket* mShape;
+    HostImmPacket* mImm;
+    J3DMaterial* mMaterial;
+    HostTevBlock* mTevBlock;
+    Mtx* mZMtx;
+    int mNum;
+    int* mSlot;
+    int* mRet;
+
+    FramePackets(int num) : mNum(num) {
+        mMat = new HostMatPacket[num];
+        mShape = new HostShapePacket[num];
+        mImm = new HostImmPacket[num];
+        mMaterial = (J3DMaterial*)new u8[num * sizeof(J3DMaterial)];
+        mTevBlock = new HostTevBlock[num];
+        mZMtx = new Mtx[num];
+        mSlot = new int[num];
+        mRet = new int[num];
+    }
+};
+
+/** Enters the frame's entries into buffer and draws it; the draw log is left in l_drawLog. */
+static void replayFrame(J3DDrawBuffer* buffer, const Entry* entries, int num,
+                        FramePackets& packets) {
+    buffer->frameInit();
+    for (int i = 0; i < num; i++) {
+        const Entry& entry = entries[i];
+        packets.mRet[i] = -1;
+        if (entry.mType == J3DDrawRecord::TYPE_IMM) {
+            HostImmPacket* packet = &packets.mImm[i];
+            packet->mId = i;
+            packets.mRet[i] = buffer->entryImm(packet, entry.mSlot);
+            continue;
+        }
+
+        HostMatPacket* packet = &packets.mMat[i];
+        HostShapePacket* shape = &packets.mShape[i];
+        packet->mId = i;
+        shape->mId = i;
+        packet->mpShapePacket = shape;
+        packet->mDiffFlag = entry.mB;
+        if (entry.mType == J3DDrawRecord::TYPE_MAT) {
+            J3DMaterial* material = &packets.mMaterial[i];
+            packets.mTevBlock[i].mTexNo = textureFor(entry.mA);
+            material->mTevBlock = &packets.mTevBlock[i];
+            packet->mpMaterial = material;
+            packets.mRet[i] = buffer->entryMatSort(packet);
+        } else {
+            union {
+                u32 u;
+                f32 f;
+            } depth;
+            depth.u = entry.mA;
+            Mtx& mtx = packets.mZMtx[i];
+            memset(mtx, 0, sizeof(Mtx));
+            mtx[2][3] = -depth.f;
+            buffer->setZMtx(mtx);
+            packets.mRet[i] = buffer->entryZSort(packet);
+        }
+    }
+
+    l_drawLogNum = 0;
+    buffer->draw();
+}
+
+/** The slot each drawn packet sits in, read back from the entry table. */
+static void tableSlots(J3DDrawBuffer* table, FramePackets& packets) {
+    for (u32 slot = 0; slot < table->mEntryTableSize; slot++) {
+        for (J3DPacket* packet = table->mpBuffer[slot]; packet != NULL;
+             packet = packet->getNextPacket())
+        {
+            if (packet >= packets.mMat && packet < packets.mMat + packets.mNum) {
+                packets.mSlot[(HostMatPacket*)packet - packets.mMat] = slot;
+            } else {
+                packets.mSlot[(HostImmPacket*)packet - packets.mImm] = slot;
+            }
+        }
+    }
+}
+
+/** A drawn packet and its shapes, as a run of the draw log. */
+struct Drawn {
+    int mSlot;
+    int mStart;
+    int mEnd;
+};
+
+static int splitLog(const int* log, int logNum, const FramePackets& packets, Drawn* drawn) {
+    int num = 0;
+    for (int i = 0; i < logNum; i++) {
+        if (log[i] & LOG_PACKET) {
+            drawn[num].mSlot = packets.mSlot[log[i] & LOG_MASK];
+            drawn[num].mStart = i;
+            drawn[num].mEnd = i + 1;
+            num++;
+        } else if (num != 0) {
+            drawn[num - 1].mEnd = i + 1;
+        }
+    }
+    return num;
+}
+
+static bool sameDrawn(const int* logA, const Drawn& a, const int* logB, const Drawn& b) {
+    if (a.mEnd - a.mStart != b.mEnd - b.mStart) {
+        return false;
+    }
+    return memcmp(logA + a.mStart, logB + b.mStart, (a.mEnd - a.mStart) * sizeof(int)) == 0;
+}
+
+static const int SPLIT_MAX = 0x8000;
+static int l_tableLog[0x10000];
+static Drawn l_tableDrawn[SPLIT_MAX];
+static Drawn l_keyDrawn[SPLIT_MAX];
+
+/**
+ * Compares a frame drawn from the key array (in l_drawLog) with the same frame drawn from the
+ * entry table (in l_tableLog): the slots must come in the same order, and each slot must hold
+ * the same packets with the same shapes.
+ */
+static bool compareFrame(const FramePackets& keyPackets, int tableLogNum, bool spilled,
+                         bool zSort, const Entry* entries, u32 address, const char* name,
+                         int frame) {
+    if (spilled) {
+        if (l_drawLogNum != tableLogNum ||
+            memcmp(l_drawLog, l_tableLog, tableLogNum * sizeof(int)) != 0)
+        {
+            HOST_CHECK(false, "%08X %s frame %d: spilled frame draws differently", address, name,
+                       frame);
+            return false;
+        }
+        return true;
+    }
+
+    int tableNum = splitLog(l_tableLog, tableLogNum, keyPackets, l_tableDrawn);
+    int keyNum = splitLog(l_drawLog, l_drawLogNum, keyPackets, l_keyDrawn);
+    if (tableNum != keyNum) {
+        HOST_CHECK(false, "%08X %s frame %d: %d packets drawn, entry table draws %d", address,
+                   name, frame, keyNum, tableNum);
+        return false;
+    }
+
+    for (int start = 0; start < keyNum;) {
+        int end = start + 1;
+        while (end < keyNum && l_keyDrawn[end].mSlot == l_keyDrawn[start].mSlot) {
+            end++;
+        }
+        for (int i = start; i < end; i++) {
+            if (l_tableDrawn[i].mSlot != l_keyDrawn[start].mSlot) {
+                HOST_CHECK(false, "%08X %s frame %d: packet %d in slot %d, entry table slot %d",
+                           address, name, frame, i, l_keyDrawn[start].mSlot,
+                           l_tableDrawn[i].mSlot);
+                return false;
+            }
+            bool found = false;
+            for (int j = start; j < end && !found; j++) {
+                found = sameDrawn(l_drawLog, l_keyDrawn[i], l_tableLog, l_tableDrawn[j]);
+            }
+            if (!found) {
+                HOST_CHECK(false, "%08X %s frame %d: slot %d packet %d differs from entry table",
+                           address, name, frame, l_keyDrawn[i].mSlot, i);
+                return false;
+            }
+            if (zSort && i != start) {
+                const Entry& prev = entries[l_drawLog[l_keyDrawn[i - 1].mStart] & LOG_MASK];
+                const Entry& cur = entries[l_drawLog[l_keyDrawn[i].mStart] & LOG_MASK];
+                union {
+                    u32 u;
+                    f32 f;
+                } prevDepth, curDepth;
+                prevDepth.u = prev.mA;
+                curDepth.u = cur.mA;
+                if (prev.mType == J3DDrawRecord::TYPE_Z && cur.mType == J3DDrawRecord::TYPE_Z &&
+                    prevDepth.f < curDepth.f)
+                {
+                    HOST_CHECK(false, "%08X %s frame %d: bucket %d draws nearer packet first",
+                               address, name, frame, l_keyDrawn[i].mSlot);
+                    return false;
+                }
+            }
+        }
+        start = end;
+    }
+    return true;
+}
+
+static bool replayBuffer(const Buffer& record, int drawMode) {
+    const char* name = drawMode == J3DDrawBufDrawMode_Head ? "head" : "tail";
+    J3DDrawBuffer table;
+    J3DDrawBuffer key;
+    J3DDrawBuffer* buffers[2] = {&table, &key};
+    for (int i = 0; i < 2; i++) {
+        buffers[i]->allocBuffer(record.mTableSize);
+        buffers[i]->mSortMode = record.mSortMode;
+        buffers[i]->mDrawMode = drawMode;
+    }
+    // As dDlst_list_c::init sizes it.
+    u32 keyNum = record.mTableSize * 2;
+    key.allocKeyBuffer(keyNum < 0x40 ? 0x40 : keyNum);
+
+    int maxEntries = 1;
+    for (int f = 0; f < record.mFrameNum; f++) {
+        int num = record.mFrameEnd[f] - record.mFrameStart[f];
+        maxEntries = num > maxEntries ? num : maxEntries;
+    }
+    FramePackets* tablePackets = new FramePackets(maxEntries);
+    FramePackets* keyPackets = new FramePackets(maxEntries);
+
+    int entryNum = 0;
+    int spillNum = 0;
+    f64 time[2] = {0.0, 0.0};
+    bool ok = true;
+    for (int f = 0; f < record.mFrameNum && ok; f++) {
+        const Entry* entries = &record.mEntry[record.mFrameStart[f]];
+        int num = record.mFrameEnd[f] - record.mFrameStart[f];
+        entryNum += num;
+
+        f64 start = host_seconds();
+        replayFrame(&table, entries, num, *tablePackets);
+        time[0] += host_seconds() - start;
+        int tableLogNum = l_drawLogNum;
+        memcpy(l_tableLog, l_drawLog, tableLogNum * sizeof(int));
+        tableSlots(&table, *tablePackets);
+        for (int i = 0; i < num; i++) {
+            keyPackets->mSlot[i] = tablePackets->mSlot[i];
+        }
+
+        start = host_seconds();
+        replayFrame(&key, entries, num, *keyPackets);
+        time[1] += host_seconds() - start;
+        bool spilled = key.mKeySpilled;
+        spillNum += spilled;
+
+        for (int i = 0; i < num; i++) {
+            if (keyPackets->mRet[i] != tablePackets->mRet[i]) {
+                HOST_CHECK(false, "%08X %s frame %d: entry %d returns %d, entry table %d",
+                           record.mAddress, name, f, i, keyPackets->mRet[i],
+                           tablePackets->mRet[i]);
+                ok = false;
+                break;
+            }
+        }
+        if (ok) {
+            bool zSort = record.mSortMode == J3DDrawBufSortMode_Z;
+            ok = compareFrame(*keyPackets, tableLogNum, spilled, zSort, entries, record.mAddress,
+                              name, f);
+        }
+    }
+
+    if (drawMode == J3DDrawBufDrawMode_Head) {
+        printf("%08X (%s sort, %d slots) %d frames, %.1f entries/frame, %d spilled\n",
+               record.mAddress, record.mSortMode == J3DDrawBufSortMode_Z ? "Z" : "Mat",
+               record.mTableSize, record.mFrameNum, (f64)entryNum / record.mFrameNum, spillNum);
+    }
+    printf("  %s: entry table %.2f us/frame, key array %.2f us/frame\n", name,
+           time[0] * 1e6 / record.mFrameNum, time[1] * 1e6 / record.mFrameNum);
+    return ok;
+}
+
+/** The made-up scene the checked-in recording was made from. */
+static void writeRecord(const char* path) {
+    static const u32 sizes[5] = {0x80, 0x20, 0x1, 0x100, 0x10};
+    static const int sortModes[5] = {
+        J3DDrawBufSortMode_Mat, J3DDrawBufSortMode_Mat, J3DDrawBufSortMode_Mat,
+        J3DDrawBufSortMode_Z,   J3DDrawBufSortMode_Z,
+    };
+    static const int FRAME_NUM = 10;
+    static const int MATERIAL_NUM = 300;
+    static const int TEXTURE_NUM = 120;
+
+    HostRandom rnd(0x0DC025);
+    u32 materialHash[MATERIAL_NUM];
+    for (int i = 0; i < MATERIAL_NUM; i++) {
+        // Images 0x2000 bytes apart in main memory, some materials untextured.
+        u32 texture = rnd.below(TEXTURE_NUM);
+        materialHash[i] = rnd.below(10) == 0 ? 0 : (0x80400000 + texture * 0x2000) >> 5;
+    }
+
+    J3DDrawBuffer* buffers[5];
+    for (int i = 0; i < 5; i++) {
+        buffers[i] = new J3DDrawBuffer();
+        buffers[i]->allocBuffer(sizes[i]);
+        buffers[i]->mSortMode = sortModes[i];
+    }
+
+    u32 capacity = 0x8000;
+    u32 size = sizeof(J3DDrawRecordHeader) + capacity * sizeof(J3DDrawRecord);
+    J3DDrawRecordHeader* header = (J3DDrawRecordHeader*)hostAlloc(size, 0x20);
+    J3DDrawBuffer::startRecord(header, size);
+    FramePackets* packets = new FramePackets(0x400);
+    Entry entries[0x400];
+    for (int frame = 0; frame < FRAME_NUM; frame++) {
+        for (int b = 0; b < 5; b++) {
+            J3DDrawBuffer* buffer = buffers[b];
+            u32 keyNum = sizes[b] * 2 < 0x40 ? 0x40 : sizes[b] * 2;
+            // Every few frames a buffer gets more packets than its key array holds.
+            int num = keyNum / 4 + rnd.below(keyNum / 2);
+            if (frame % 5 == 3) {
+                num = keyNum * 3 / 2 + rnd.below(keyNum / 2);
+            }
+            for (int i = 0; i < num; i++) {
+                Entry& entry = entries[i];
+                int material = rnd.below(MATERIAL_NUM);
+                entry.mSlot = 0;
+                entry.mB = material + 1;
+                if (rnd.below(16) == 0) {
+                    entry.mType = J3DDrawRecord::TYPE_IMM;
+                    entry.mSlot = rnd.below(sizes[b]);
+                    entry.mA = 0;
+                } else if (sortModes[b] == J3DDrawBufSortMode_Z) {
+                    union {
+                        f32 f;
+                        u32 u;
+                    } depth;
+                    // Mostly in front of the camera, between the near and far planes.
+                    depth.f = rnd.below(20) == 0 ? -10.0f : 20000.0f * rnd.unit() - 5000.0f;
+                    entry.mType = J3DDrawRecord::TYPE_Z;
+                    entry.mA = depth.u;
+                } else {
+                    entry.mType = J3DDrawRecord::TYPE_MAT;
+                    entry.mA = materialHash[material];
+                    if (rnd.below(24) == 0) {
+                        entry.mB |= J3DDiffFlag_Changed;
+                    }
+                }
+            }
+            replayFrame(buffer, entries, num, *packets);
+        }
+    }
+    J3DDrawBuffer::stopRecord();
+
+    // The recording is in native order; the file is big-endian, as on the console.
+    u32 count = header->mCount;
+    J3DDrawRecord* records = (J3DDrawRecord*)(header + 1);
+    for (u32 i = 0; i < count; i++) {
+        records[i].mSlot = swap16(records[i].mSlot);
+        records[i].mBuffer = swap32(records[i].mBuffer);
+        records[i].mA = swap32(records[i].mA);
+        records[i].mB = swap32(records[i].mB);
+    }
+    header->mMagic = swap32(header->mMagic);
+    header->mVersion = swap32(header->mVersion);
+    header->mCount = swap32(header->mCount);
+    header->mDropped = swap32(header->mDropped);
+
+    void* file = host_fopen(path, "wb");
+    host_fwrite(header, sizeof(J3DDrawRecordHeader) + count * sizeof(J3DDrawRecord), 1, file);
+    host_fclose(file);
+    printf("wrote %d records to %s\n", count, path);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: draw_key_sort <record.bin> [--write]\n");
+        return 1;
+    }
+    j3dSys.mTexture = &l_texture;
+    memset(j3dSys.mViewMtx, 0, sizeof(Mtx));
+    j3dSys.mViewMtx[0][0] = j3dSys.mViewMtx[1][1] = j3dSys.mViewMtx[2][2] = 1.0f;
+    if (argc > 2 && host_strcmp(argv[2], "--write") == 0) {
+        writeRecord(argv[1]);
+    }
+
+    static Buffer buffers[BUFFER_MAX];
+    int bufferNum = readRecord(argv[1], buffers);
+    HOST_CHECK(bufferNum != 0, "no draw buffers in %s", argv[1]);
+    for (int i = 0; i < bufferNum; i++) {
+        for (int mode = 0; mode < J3DDrawBufDrawMode_MAX; mode++) {
+            replayBuffer(buffers[i], mode);
+        }
+    }
+    return host_check_result("draw_key_sort");
+}
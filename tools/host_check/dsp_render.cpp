@@ -0,0 +1,362 @@
+// Runs the ENABLE_DSP_RENDERER software renderer (user-019) as the mixing backend: with a render
+// source set, JASDriver::finishDSPFrame renders each DAC frame in software, and channels come
+// from JASChannel through JASDSPChannel exactly as on the console. The wave memory is made up of
+// sine tones in PCM16, PCM8 and 4 and 2 bit ADPCM (predictor 0, so the decoded samples are
+// known).
+//
+// Checks that every format comes out of the DAC buffer in the shape it went in (correlation
+// with the source), that a voice panned left lands in the samples readDspBuffer puts first,
+// that one-shot voices finish and hand their JASChannel back, that looping voices keep playing
+// until released, and that clearing the render source returns finishDSPFrame to the DSP.
+//
+// Then profiles a frame at 8 to 64 looping ADPCM voices with envelopes and vibrato: the time
+// JASDSPChannel::updateAll (JASChannel::updateDSPChannel for every voice) and renderFrame take
+// per subframe, and how many voices the renderer keeps up with in real time on this host.
+//
+// tree: libs/JSystem/src/JAudio2/JASDSPInterface.cpp libs/JSystem/src/JAudio2/JASAiCtrl.cpp
+// tree: libs/JSystem/src/JAudio2/JASDSPChannel.cpp libs/JSystem/src/JAudio2/JASChannel.cpp
+// tree: libs/JSystem/src/JAudio2/JASOscillator.cpp libs/JSystem/src/JAudio2/JASLfo.cpp
+// tree: libs/JSystem/src/JAudio2/JASDriverIF.cpp libs/JSystem/src/JAudio2/JASCallback.cpp
+// tree: libs/JSystem/src/JAudio2/JASCalc.cpp libs/JSystem/src/JAudio2/JASCmdStack.cpp
+// tree: libs/JSystem/src/JSupport/JSUList.cpp libs/JSystem/src/JMath/JMATrigonometric.cpp
+// define: ENABLE_DSP_RENDERER=1
+
+#include "host_check.h"
+
+#include "JSystem/JAudio2/JASAiCtrl.h"
+#include "JSystem/JAudio2/JASAudioThread.h"
+#include "JSystem/JAudio2/JASChannel.h"
+#include "JSystem/JAudio2/JASDSPChannel.h"
+#include "JSystem/JAudio2/JASDSPInterface.h"
+#include "JSystem/JAudio2/JASHeapCtrl.h"
+#include "JSystem/JAudio2/JASProbe.h"
+#include <dolphin/os.h>
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+void free(void*);
+double sin(double);
+double sqrt(double);
+}
+
+static void* hostAlloc(size_t size) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, 32, size + 32);
+    memset(ptr, 0, size + 32);
+    return ptr;
+}
+
+void* operator new(size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+void* operator new[](size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+
+/** Live JASChannels, so finished voices can be seen to give theirs back. */
+static int l_channelNum;
+
+JASGenericMemPool::JASGenericMemPool() {}
+JASGenericMemPool::~JASGenericMemPool() {}
+void JASGenericMemPool::newMemPool(u32, int) {}
+void* JASGenericMemPool::alloc(u32 size) {
+    l_channelNum++;
+    return hostAlloc(size);
+}
+void JASGenericMemPool::free(void* ptr, u32) {
+    if (ptr != NULL) {
+        l_channelNum--;
+        ::free(ptr);
+    }
+}
+
+int __float_huge[] = {0x7F800000};
+
+JKRSolidHeap* JASDram;
+volatile int JASAudioThread::snIntCount;
+u32 JASWaveInfo::one = 1;
+
+void JASProbe::start(s32, const char*) {}
+void JASProbe::stop(s32) {}
+void JASReport(const char*, ...) {}
+
+/** Subframes handed to the DSP, which never runs here. */
+static int l_syncNum;
+
+void JASDsp::syncFrame(u32, u32, u32) {
+    l_syncNum++;
+}
+void JASDsp::releaseHalt(u32) {}
+void JASChannel::receiveBankDisposeMsg() {}
+bool JASChannel::checkBankDispose() const {
+    return false;
+}
+
+extern "C" {
+OSTick OSGetTick() {
+    return 0;
+}
+BOOL OSDisableInterrupts() {
+    return FALSE;
+}
+BOOL OSRestoreInterrupts(BOOL) {
+    return FALSE;
+}
+void DCInvalidateRange(void*, u32) {}
+void DCFlushRange(void*, u32) {}
+void DCStoreRange(void*, u32) {}
+void DCZeroRange(void* addr, u32 size) {
+    memset(addr, 0, size);
+}
+}
+
+/** Wave memory standing in for ARAM; every wave is a sine of 64 samples per period. */
+static u8 l_aram[0x40000];
+static const int l_period = 64;
+static const int l_waveLength = 0x2000;
+
+enum {
+    WAVE_ADPCM4,
+    WAVE_ADPCM2,
+    WAVE_PCM8,
+    WAVE_PCM16,
+};
+
+static s32 sineAt(int pos, s32 amplitude) {
+    return (s32)(amplitude * sin(pos * 6.283185307179586 / l_period));
+}
+
+/** Writes a wave of @p format at @p addr and returns its expected samples. */
+static void makeWave(int format, u32 addr, JASWaveInfo* o_info, s16* o_expect) {
+    u8* dst = l_aram + addr;
+    for (int i = 0; i < l_waveLength; i++) {
+        s32 sample;
+        switch (format) {
+        case WAVE_ADPCM4: {
+            // Scale 1 << 11 with coefficients 0: each nibble is a sample / 0x800.
+            s32 nibble = sineAt(i, 7);
+            if (i % 16 == 0) {
+                dst[i / 16 * 9] = 0xB0;
+            }
+            u8* byte = &dst[i / 16 * 9 + 1 + (i % 16) / 2];
+            *byte |= (i & 1) ? (nibble & 0xF) : (nibble & 0xF) << 4;
+            sample = nibble << 11;
+            break;
+        }
+        case WAVE_ADPCM2: {
+            s32 crumb = sineAt(i, 2) / 2 + sineAt(i, 2) % 2;
+            if (i % 16 == 0) {
+                dst[i / 16 * 5] = 0xB0;
+            }
+            u8* byte = &dst[i / 16 * 5 + 1 + (i % 16) / 4];
+            *byte |= (crumb & 3) << (6 - (i % 4) * 2);
+            sample = crumb << 13;
+            break;
+        }
+        case WAVE_PCM8:
+            dst[i] = (u8)sineAt(i, 100);
+            sample = (s8)dst[i] << 8;
+            break;
+        default:
+            sample = sineAt(i, 20000);
+            dst[i * 2] = sample >> 8;
+            dst[i * 2 + 1] = sample;
+            break;
+        }
+        o_expect[i] = sample;
+    }
+
+    o_info->field_0x00 = format;
+    o_info->field_0x02 = 0;
+    o_info->field_0x18 = l_waveLength;
+}
+
+/** JASChannel's default mix configs, as the console reads them. */
+static const u16 l_mixConfig[6] = {0x150, 0x210, 0x352, 0x412, 0, 0};
+
+static JASChannel* playWave(const JASWaveInfo& info, u32 addr, bool loop, f32 pitch) {
+    JASChannel* channel = new JASChannel(NULL, NULL);
+    channel->setPriority(0x7F);
+    channel->field_0xdc.field_0x0 = 0;
+    channel->field_0xdc.field_0x4 = info;
+    if (loop) {
+        // Loops from a block boundary, whose history is 0 for these waves.
+        channel->field_0xdc.field_0x4.field_0x02 = 1;
+        channel->field_0xdc.field_0x4.field_0x10 = l_period * 4;
+        channel->field_0xdc.field_0x4.field_0x14 = l_waveLength;
+    }
+    channel->field_0x104 = addr;
+    // MixConfig's bytes and bitfields are laid out for the console; redo the defaults
+    // field by field so the host reads the same buses and pan modes.
+    for (int i = 0; i < 6; i++) {
+        u16 config = l_mixConfig[i];
+        channel->mMixConfig[i].parts.upper = config >> 8;
+        channel->mMixConfig[i].parts.lower0 = (config >> 4) & 0xF;
+        channel->mMixConfig[i].parts.lower1 = config & 0xF;
+    }
+    channel->setInitPitch(pitch);
+    channel->play();
+    return channel;
+}
+
+/** Runs one DAC frame the way the audio thread does and returns its stereo output. */
+static void runFrame(s16* o_output) {
+    JASDriver::finishDSPFrame();
+    JASDriver::readDspBuffer(o_output, JASDriver::getFrameSamples());
+}
+
+static f64 correlate(const s16* a, const s16* b, int num) {
+    f64 ab = 0.0, aa = 0.0, bb = 0.0;
+    for (int i = 0; i < num; i++) {
+        ab += (f64)a[i] * b[i];
+        aa += (f64)a[i] * a[i];
+        bb += (f64)b[i] * b[i];
+    }
+    return aa == 0.0 || bb == 0.0 ? 0.0 : ab / sqrt(aa * bb);
+}
+
+static const char* l_formatName[] = {"adpcm4", "adpcm2", "pcm8", "pcm16"};
+
+static void checkFormats(const JASWaveInfo* infos, s16 (*expect)[l_waveLength]) {
+    const u32 frameSamples = JASDriver::getFrameSamples();
+    s16* output = new s16[frameSamples * 2];
+    for (int format = 0; format < 4; format++) {
+        JASChannel* channel = playWave(infos[format], format * 0x8000, false, 1.0f);
+        HOST_CHECK(channel != NULL && l_channelNum == 1, "%s: no channel",
+                   l_formatName[format]);
+
+        // Skip the frames the DAC buffers delay it by, then follow it until it ends.
+        s16 left[l_waveLength + 0x1000] = {};
+        int num = 0;
+        for (int frame = 0; frame < 40 && num < l_waveLength; frame++) {
+            runFrame(output);
+            for (u32 i = 0; i < frameSamples && num < l_waveLength + 0x1000; i++) {
+                if (num != 0 || output[i * 2] != 0) {
+                    left[num++] = output[i * 2];
+                    HOST_CHECK(output[i * 2 + 1] == output[i * 2], "%s: pan 0.5 is not centred",
+                               l_formatName[format]);
+                }
+            }
+        }
+        // Capture starts at the first sample that is not silent, and the resampler lags by
+        // a few samples, so line the two up first.
+        f64 best = -1.0;
+        for (int lag = -8; lag <= 8; lag++) {
+            f64 value = lag >= 0 ? correlate(left + lag, expect[format], l_waveLength - 8) :
+                                   correlate(left, expect[format] - lag, l_waveLength - 8);
+            best = value > best ? value : best;
+        }
+        HOST_CHECK(best > 0.99, "%s: output does not follow the wave (%.3f)",
+                   l_formatName[format], best);
+
+        for (int frame = 0; frame < 4; frame++) {
+            runFrame(output);
+        }
+        HOST_CHECK(l_channelNum == 0, "%s: finished voice kept its JASChannel",
+                   l_formatName[format]);
+        printf("%-6s correlation %.4f\n", l_formatName[format], best);
+    }
+    delete[] output;
+}
+
+/** A voice panned hard left must come out only in the samples readDspBuffer puts first. */
+static void checkPan(const JASWaveInfo& info) {
+    const u32 frameSamples = JASDriver::getFrameSamples();
+    s16* output = new s16[frameSamples * 2];
+    JASChannel* channel = playWave(info, WAVE_PCM16 * 0x8000, false, 1.0f);
+    channel->setInitPan(0.0f);
+    s32 left = 0, right = 0;
+    for (int frame = 0; frame < 8; frame++) {
+        runFrame(output);
+        for (u32 i = 0; i < frameSamples; i++) {
+            left += output[i * 2] != 0;
+            right += output[i * 2 + 1] != 0;
+        }
+    }
+    HOST_CHECK(left != 0 && right == 0, "panned left: %d left and %d right samples", left, right);
+    for (int frame = 0; frame < 30 && l_channelNum != 0; frame++) {
+        runFrame(output);
+    }
+    delete[] output;
+}
+
+static void profile(const JASWaveInfo& info) {
+    const u32 frameSamples = JASDriver::getFrameSamples();
+    s16* output = new s16[frameSamples * 2];
+    static const JASOscillator::Point l_release[2] = {
+        {0x0001, 0x000A, 0x0000},
+        {0x000F, 0x0000, 0x0000},
+    };
+    static const JASOscillator::Data l_env = {0, 1.0f, NULL, l_release, 1.0f, 0.0f};
+    const int frames = 200;
+    const f64 subframeTime = 0x50 / 32028.5;
+
+    JASChannel* voices[64];
+    int voiceNum = 0;
+    for (int target = 8; target <= 64; target *= 2) {
+        while (voiceNum < target) {
+            JASChannel* channel = playWave(info, 0, true, 0.5f + voiceNum * 0.013f);
+            channel->setOscInit(0, &l_env);
+            channel->setVibrate(0.02f, 5.0f);
+            voices[voiceNum++] = channel;
+        }
+        runFrame(output);
+
+        f64 update = 0.0, render = 0.0;
+        f64 start = host_seconds();
+        for (int i = 0; i < frames * 7; i++) {
+            f64 mid = host_seconds();
+            JASDSPChannel::updateAll();
+            f64 end = host_seconds();
+            JASDsp::renderFrame();
+            update += end - mid;
+            render += host_seconds() - end;
+        }
+        f64 total = host_seconds() - start;
+        HOST_CHECK(l_channelNum == target, "%d voices dropped to %d", target, l_channelNum);
+
+        f64 perVoice = total / (frames * 7 * target);
+        printf("%2d voices: update %5.2f us, render %6.2f us per subframe; %4.2f us per "
+               "voice, %.0f voices in real time (host)\n",
+               target, update * 1e6 / (frames * 7), render * 1e6 / (frames * 7), perVoice * 1e6,
+               subframeTime / perVoice);
+    }
+    for (int i = 0; i < voiceNum; i++) {
+        voices[i]->release(1);
+    }
+    for (int frame = 0; frame < 10 && l_channelNum != 0; frame++) {
+        runFrame(output);
+    }
+    HOST_CHECK(l_channelNum == 0, "%d voices left after release", l_channelNum);
+    delete[] output;
+}
+
+int main() {
+    JASDsp::CH_BUF = (JASDsp::TChannel*)hostAlloc(sizeof(JASDsp::TChannel) * 64);
+    JASDSPChannel::initAll();
+    JASDriver::sDspDacBuffer = new s16*[3];
+    for (int i = 0; i < 3; i++) {
+        JASDriver::sDspDacBuffer[i] = (s16*)hostAlloc(JASDriver::getDacSize() * 2);
+    }
+
+    JASWaveInfo infos[4];
+    static s16 expect[4][l_waveLength];
+    for (int format = 0; format < 4; format++) {
+        makeWave(format, format * 0x8000, &infos[format], expect[format]);
+    }
+
+    JASDsp::setRenderSource(l_aram, sizeof(l_aram));
+    checkFormats(infos, expect);
+    checkPan(infos[WAVE_PCM16]);
+    HOST_CHECK(l_syncNum == 0, "a rendered frame was also sent to the DSP");
+    profile(infos[WAVE_ADPCM4]);
+
+    JASDsp::setRenderSource(NULL, 0);
+    s16* output = new s16[JASDriver::getFrameSamples() * 2];
+    runFrame(output);
+    runFrame(output);
+    HOST_CHECK(l_syncNum != 0, "finishDSPFrame did not go back to the DSP");
+    delete[] output;
+
+    return host_check_result("dsp_render");
+}
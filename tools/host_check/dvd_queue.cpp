@@ -0,0 +1,381 @@
+// Simulates the DVD thread's command queue with and without ENABLE_DVD_SCHEDULER (user-016)
+// on a fake disc, and checks the scheduler's ordering rules: every command that is not
+// cancelled runs exactly once, nothing moves across a barrier (a command without a file,
+// such as a callback), a cancelled command never runs, and the per-class statistics count
+// every command. Prints the queue wait per priority class for both builds.
+//
+// The disc seeks in 2 ms + 60 ms * sqrt(distance / 1.4 GB) and reads 3 MB/s. The load is
+// modeled on room changes: each one queues the stage and room archives as critical, 15 to 40
+// actor archives as normal and the neighbouring rooms as prefetch, and cancels the prefetches
+// of the previous rooms that are still queued. Room changes come 1 to 12 s apart, with
+// normal reads and callbacks trickling in between.
+//
+// splice(list): src/SSystem/SComponent/c_node.cpp cNd_Join cNd_LengthOf cNd_Last cNd_SingleCut cNd_Addition cNd_SetObject cNd_ClearObject cNd_ForcedClear
+// splice(list): src/SSystem/SComponent/c_list.cpp cLs_Init cLs_SingleCut cLs_Addition cLs_Create
+// splice: src/m_Do/m_Do_dvd_thread.cpp mDoDvdThd_param_c::getFirstCommand mDoDvdThd_param_c::addition mDoDvdThd_param_c::cut
+// splice(fifo): src/m_Do/m_Do_dvd_thread.cpp cb@2
+// splice(sched): src/m_Do/m_Do_dvd_thread.cpp mDoDvdThd_param_c::takeCommand mDoDvdThd_param_c::cancel mDoDvdThd_param_c::entryStat cb@1
+
+#include "host_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define DEBUG 0
+#define JUT_ASSERT(...)
+#define OSReport_Error(...) printf(__VA_ARGS__)
+
+typedef s64 OSTime;
+struct OSMutex {};
+static void OSLockMutex(OSMutex*) {}
+static void OSUnlockMutex(OSMutex*) {}
+
+/** The simulated clock, in microseconds. */
+static OSTime l_now;
+
+static OSTime OSGetTime() {
+    return l_now;
+}
+
+typedef struct node_class {
+    struct node_class* mpPrevNode;
+    void* mpData;
+    struct node_class* mpNextNode;
+} node_class;
+
+typedef struct node_list_class {
+    node_class* mpHead;
+    node_class* mpTail;
+    int mSize;
+} node_list_class;
+
+#define NODE_GET_PREV(pNode) (pNode ? pNode->mpPrevNode : NULL)
+#define NODE_GET_NEXT(pNode) (pNode ? pNode->mpNextNode : NULL)
+
+#include "splice_list.inc"
+
+enum mDoDvdThd_Priority {
+    mDoDvdThd_PRIORITY_CRITICAL,
+    mDoDvdThd_PRIORITY_NORMAL,
+    mDoDvdThd_PRIORITY_PREFETCH,
+    mDoDvdThd_PRIORITY_MAX,
+};
+
+enum mDoDvdThd_State {
+    mDoDvdThd_STATE_NONE,
+    mDoDvdThd_STATE_QUEUED,
+    mDoDvdThd_STATE_RUNNING,
+    mDoDvdThd_STATE_CANCELLED,
+};
+
+#define mDoDvdThd_OFFSET_BARRIER 0xFFFFFFFF
+
+class mDoDvdThd_command_c : public node_class {
+public:
+    bool mIsDone;
+    u8 mPriority;
+    u8 mState;
+    u32 mDiscOffset;
+    OSTime mQueueTime;
+    OSTime mStartTime;
+
+    mDoDvdThd_command_c() {
+        mIsDone = false;
+        cNd_ForcedClear(this);
+        mPriority = mDoDvdThd_PRIORITY_NORMAL;
+        mState = mDoDvdThd_STATE_NONE;
+        mDiscOffset = mDoDvdThd_OFFSET_BARRIER;
+        mQueueTime = 0;
+        mStartTime = 0;
+    }
+    virtual ~mDoDvdThd_command_c() {}
+    virtual s32 execute() = 0;
+    OSTime getQueueWaitTime() const { return mStartTime - mQueueTime; }
+};
+
+struct mDoDvdThd_stat_c {
+    u32 mCount;
+    OSTime mWaitTime;
+    OSTime mMaxWaitTime;
+    OSTime mServiceTime;
+    OSTime mMaxServiceTime;
+};
+
+#define DVD_PARAM_DECL                                                                             \
+    class mDoDvdThd_param_c {                                                                      \
+    public:                                                                                        \
+        void kick() {}                                                                             \
+        mDoDvdThd_command_c* getFirstCommand();                                                    \
+        void addition(mDoDvdThd_command_c*);                                                       \
+        void cut(mDoDvdThd_command_c*);                                                            \
+        mDoDvdThd_command_c* takeCommand();                                                        \
+        bool cancel(mDoDvdThd_command_c*);                                                         \
+        void entryStat(u8 i_priority, OSTime i_waitTime, OSTime i_serviceTime);                    \
+                                                                                                   \
+        node_list_class mNodeList;                                                                 \
+        OSMutex mMutext;                                                                           \
+        u32 mHeadOffset;                                                                           \
+        mDoDvdThd_stat_c mStat[mDoDvdThd_PRIORITY_MAX];                                            \
+    };                                                                                             \
+                                                                                                   \
+    struct mDoDvdThd {                                                                             \
+        static mDoDvdThd_param_c l_param;                                                          \
+        static u8 verbose;                                                                         \
+    };                                                                                             \
+    mDoDvdThd_param_c mDoDvdThd::l_param;                                                          \
+    u8 mDoDvdThd::verbose;
+
+namespace fifo {
+#define ENABLE_DVD_SCHEDULER 0
+DVD_PARAM_DECL
+#include "splice.inc"
+#include "splice_fifo.inc"
+#undef ENABLE_DVD_SCHEDULER
+
+/** mainLoop's inner loop. */
+static mDoDvdThd_command_c* take() {
+    mDoDvdThd_command_c* command = mDoDvdThd::l_param.getFirstCommand();
+    if (command != NULL) {
+        mDoDvdThd::l_param.cut(command);
+    }
+    return command;
+}
+}  // namespace fifo
+
+namespace sched {
+#define ENABLE_DVD_SCHEDULER 1
+DVD_PARAM_DECL
+#include "splice.inc"
+#include "splice_sched.inc"
+#undef ENABLE_DVD_SCHEDULER
+
+static mDoDvdThd_command_c* take() {
+    return mDoDvdThd::l_param.takeCommand();
+}
+}  // namespace sched
+
+/** Where the fake disc's head is, and the commands in the order they ran. */
+static u32 l_head;
+static std::vector<int> l_runOrder;
+
+struct SimCommand : public mDoDvdThd_command_c {
+    int mSeq;
+    u32 mOffset;
+    u32 mSize;
+    OSTime mArrival;
+    int mRoom;
+    bool mCancelled;
+    int mRunNum;
+
+    /** Reads the file from the fake disc, or does nothing for a barrier. */
+    virtual s32 execute() {
+        mRunNum++;
+        l_runOrder.push_back(mSeq);
+        if (mDiscOffset != mDoDvdThd_OFFSET_BARRIER) {
+            double distance = fabs((double)mOffset - (double)l_head);
+            double ms = 2.0 + 60.0 * sqrt(distance / 1.4e9) + mSize / 3.0e3;
+            l_now += (OSTime)(ms * 1000.0);
+            l_head = mOffset + mSize;
+        } else {
+            l_now += 50;
+        }
+        mIsDone = true;
+        return 1;
+    }
+};
+
+/** Builds the workload. Commands are sorted by arrival; mSeq is their queue order. */
+static std::vector<SimCommand> buildLoad() {
+    std::mt19937 random(0x16);
+    std::vector<SimCommand> commands;
+    auto push = [&](OSTime time, int priority, bool barrier, int room) {
+        SimCommand command;
+        command.mArrival = time;
+        command.mPriority = priority;
+        command.mOffset = random() % 1400000000;
+        command.mSize = 20000 + random() % 400000;
+        command.mDiscOffset = barrier ? mDoDvdThd_OFFSET_BARRIER : command.mOffset;
+        command.mRoom = room;
+        command.mCancelled = false;
+        command.mRunNum = 0;
+        commands.push_back(command);
+    };
+
+    OSTime time = 0;
+    for (int room = 0; room < 60; room++) {
+        push(time, mDoDvdThd_PRIORITY_CRITICAL, false, room);
+        push(time, mDoDvdThd_PRIORITY_CRITICAL, false, room);
+        int actorNum = 15 + random() % 26;
+        OSTime burst = time;
+        for (int i = 0; i < actorNum; i++) {
+            burst += random() % 20000;
+            push(burst, mDoDvdThd_PRIORITY_NORMAL, random() % 50 == 0, room);
+        }
+        int neighbourNum = 2 + random() % 3;
+        for (int i = 0; i < neighbourNum; i++) {
+            push(burst + random() % 100000, mDoDvdThd_PRIORITY_PREFETCH, false, room);
+        }
+
+        // Sound, menus and the like until the next room change, 1 to 12 s later.
+        OSTime next = time + 1000000 + random() % 11000000;
+        for (OSTime t = time + random() % 300000; t < next; t += 200000 + random() % 600000) {
+            push(t, mDoDvdThd_PRIORITY_NORMAL, random() % 10 == 0, room);
+        }
+        time = next;
+    }
+
+    std::stable_sort(commands.begin(), commands.end(), [](const SimCommand& a, const SimCommand& b) {
+        return a.mArrival < b.mArrival;
+    });
+    for (size_t i = 0; i < commands.size(); i++) {
+        commands[i].mSeq = i;
+    }
+    return commands;
+}
+
+struct Result {
+    double mWait[mDoDvdThd_PRIORITY_MAX];
+    double mMaxWait[mDoDvdThd_PRIORITY_MAX];
+    int mCount[mDoDvdThd_PRIORITY_MAX];
+    int mCancelNum;
+    double mEndTime;
+};
+
+/** Runs the mainLoop of one build over the workload, checking the ordering rules. */
+template <typename Param>
+static Result simulate(const char* name, std::vector<SimCommand> commands, Param* param,
+                       mDoDvdThd_command_c* (*take)(), void (*run)(void*), bool scheduler) {
+    memset(param, 0, sizeof(*param));
+    cLs_Create(&param->mNodeList);
+    l_now = 0;
+    l_head = 0;
+    l_runOrder.clear();
+
+    Result result = {};
+    size_t next = 0;
+    int room = -1;
+    while (true) {
+        // Queue everything that arrived while the last command ran.
+        while (next < commands.size() && commands[next].mArrival <= l_now) {
+            SimCommand& command = commands[next++];
+            if (scheduler && command.mRoom != room) {
+                // Entering a room cancels the previous room's prefetches that are still queued.
+                room = command.mRoom;
+                for (size_t i = 0; i < next - 1; i++) {
+                    SimCommand& old = commands[i];
+                    if (old.mPriority == mDoDvdThd_PRIORITY_PREFETCH && old.mRoom < room) {
+                        bool queued = old.mState == mDoDvdThd_STATE_QUEUED;
+                        bool cancelled = sched::mDoDvdThd::l_param.cancel(&old);
+                        HOST_CHECK(cancelled == queued, "%s: cancel of %d returned %d in state %d",
+                                   name, old.mSeq, cancelled, old.mState);
+                        if (cancelled) {
+                            HOST_CHECK(old.mIsDone, "%s: cancelled %d is not done", name, old.mSeq);
+                            old.mCancelled = true;
+                            result.mCancelNum++;
+                        }
+                    }
+                }
+            }
+            // The game thread queues it on arrival, while the DVD thread is busy.
+            OSTime now = l_now;
+            l_now = command.mArrival;
+            param->addition(&command);
+            l_now = now;
+        }
+
+        mDoDvdThd_command_c* command = take();
+        if (command == NULL) {
+            if (next == commands.size()) {
+                break;
+            }
+            l_now = commands[next].mArrival;
+            continue;
+        }
+        if (!scheduler) {
+            // The FIFO build does not stamp the start time.
+            command->mStartTime = l_now;
+        }
+        SimCommand* sim = (SimCommand*)command;
+        OSTime wait = l_now - sim->mArrival;
+        result.mWait[sim->mPriority] += wait / 1000.0;
+        result.mMaxWait[sim->mPriority] = std::max(result.mMaxWait[sim->mPriority], wait / 1000.0);
+        result.mCount[sim->mPriority]++;
+        run(&command);
+    }
+    result.mEndTime = l_now / 1000.0;
+
+    // Every command runs once, unless it was cancelled before it started.
+    int runNum = 0;
+    for (const SimCommand& command : commands) {
+        HOST_CHECK(command.mRunNum == (command.mCancelled ? 0 : 1), "%s: %d ran %d times", name,
+                   command.mSeq, command.mRunNum);
+        runNum += command.mRunNum;
+    }
+
+    // Nothing moves across a barrier: whatever was queued before it runs before it, and
+    // whatever was queued after it runs after it.
+    std::vector<int> position(commands.size(), -1);
+    for (size_t i = 0; i < l_runOrder.size(); i++) {
+        position[l_runOrder[i]] = i;
+    }
+    for (const SimCommand& barrier : commands) {
+        if (barrier.mDiscOffset != mDoDvdThd_OFFSET_BARRIER) {
+            continue;
+        }
+        for (const SimCommand& command : commands) {
+            if (position[command.mSeq] < 0) {
+                continue;
+            }
+            bool before = command.mSeq < barrier.mSeq;
+            HOST_CHECK(before == (position[command.mSeq] < position[barrier.mSeq]),
+                       "%s: %d queued %s barrier %d ran %s it", name, command.mSeq,
+                       before ? "before" : "after", barrier.mSeq, before ? "after" : "before");
+        }
+    }
+
+    if (scheduler) {
+        int statNum = 0;
+        for (int i = 0; i < mDoDvdThd_PRIORITY_MAX; i++) {
+            HOST_CHECK(param->mStat[i].mCount == (u32)result.mCount[i],
+                       "%s: class %d counted %u of %d", name, i, param->mStat[i].mCount,
+                       result.mCount[i]);
+            HOST_CHECK(param->mStat[i].mWaitTime / 1000 == (OSTime)result.mWait[i] ||
+                           param->mStat[i].mWaitTime / 1000 == (OSTime)result.mWait[i] + 1,
+                       "%s: class %d waited %lld ms, simulated %.0f ms", name, i,
+                       (long long)(param->mStat[i].mWaitTime / 1000), result.mWait[i]);
+            statNum += param->mStat[i].mCount;
+        }
+        HOST_CHECK(statNum == runNum, "%s: statistics count %d of %d", name, statNum, runNum);
+    }
+
+    static const char* const l_className[] = {"critical", "normal", "prefetch"};
+    printf("%-9s %6.0f ms", name, result.mEndTime);
+    for (int i = 0; i < mDoDvdThd_PRIORITY_MAX; i++) {
+        printf(" | %s %4d wait avg %5.1f max %4.0f ms", l_className[i], result.mCount[i],
+               result.mWait[i] / result.mCount[i], result.mMaxWait[i]);
+    }
+    printf("\n");
+    return result;
+}
+
+int main() {
+    std::vector<SimCommand> commands = buildLoad();
+    int barrierNum = 0;
+    for (const SimCommand& command : commands) {
+        barrierNum += command.mDiscOffset == mDoDvdThd_OFFSET_BARRIER;
+    }
+    printf("%zu commands, %d barriers\n", commands.size(), barrierNum);
+
+    Result fifoResult = simulate("fifo", commands, &fifo::mDoDvdThd::l_param, fifo::take,
+                                 fifo::cb, false);
+    Result schedResult = simulate("scheduler", commands, &sched::mDoDvdThd::l_param, sched::take,
+                                  sched::cb, true);
+    printf("%d prefetches cancelled\n", schedResult.mCancelNum);
+
+    // The point of the scheduler: urgent reads wait less than in a plain FIFO.
+    HOST_CHECK(schedResult.mWait[0] / schedResult.mCount[0] <
+                   fifoResult.mWait[0] / fifoResult.mCount[0],
+               "critical reads wait longer than with the FIFO");
+    return host_check_result("dvd_queue");
+}
@@ -0,0 +1,338 @@
+// Checks the ENABLE_STREAM_DECOMP double-buffered SZS reader in JKRDvdRipper (user-003).
+// JKRDecompressFromDVD is built with and without the flag and decodes every Yaz0 corpus file
+// from a fake disc: whole files, files cut short by maxDest, offset reads, and reads that
+// fail and are retried. Async reads only land in memory when they are synced, so touching a
+// window before waiting for it shows up as corrupt output. Every build must match the input
+// byte for byte, leave no read in flight and free its buffers, and the stream build must not
+// allocate more than the serial one.
+//
+// The disc also keeps a model clock: a read takes DVD_REQUEST_MS plus its length at
+// DVD_BYTES_PER_MS, and decoding costs DECODE_BYTES_PER_MS per compressed byte, charged
+// whenever the decoder comes back for more data. Prints the peak allocation, the time to the
+// first decodable byte and the total time of both builds for each buffer size.
+//
+// region: libs/JSystem/src/JKernel/JKRDvdRipper.cpp static OSMutex decompMutex; => nextSrcData@2
+// rewrite: endPtr = dest + (header->length - fileOffset); => endPtr = dest + (be32((u8*)&header->length) - fileOffset);
+
+#include "host_check.h"
+#include "szs_corpus.h"
+#include <map>
+
+#define JUT_ASSERT(line, cond)                                                                     \
+    if (!(cond)) {                                                                                 \
+        printf("assert %d: %s\n", line, #cond);                                                    \
+        exit(1);                                                                                   \
+    }
+#define IS_NOT_ALIGNED(x, a) (((uintptr_t)(x) & ((a) - 1)) != 0)
+
+struct OSMutex {
+    int mLocked;
+};
+static void OSInitMutex(OSMutex* mutex) {
+    mutex->mLocked = 0;
+}
+static void OSLockMutex(OSMutex* mutex) {
+    HOST_CHECK(mutex->mLocked == 0, "decompMutex locked twice");
+    mutex->mLocked = 1;
+}
+static void OSUnlockMutex(OSMutex* mutex) {
+    mutex->mLocked = 0;
+}
+static BOOL OSDisableInterrupts() {
+    return FALSE;
+}
+static void OSRestoreInterrupts(BOOL) {}
+static void VIWaitForRetrace() {}
+static void DCInvalidateRange(void*, u32) {}
+static void DCStoreRangeNoSync(void*, u32) {}
+
+struct SYaz0Header {
+    u32 signature;
+    u32 length;
+};
+
+struct DVDFileInfo {};
+
+// Roughly the GameCube drive streaming one file, and Yaz0 decoding on the CPU.
+static const f64 DVD_REQUEST_MS = 0.2;
+static const f64 DVD_BYTES_PER_MS = 3000.0;
+static const f64 DECODE_BYTES_PER_MS = 8000.0;
+
+/** One file on a fake disc. Async reads are copied in by sync, not when they are issued. */
+struct FakeDisc {
+    Bytes mFile;
+    u8* mPendingAddr;
+    s32 mPendingLength;
+    s32 mPendingOffset;
+    bool mPending;
+    bool mPendingFail;
+    u32 mFailEvery;
+    u32 mReads;
+    u32 mAsyncReads;
+    u32 mFailures;
+    int mLiveAllocs;
+    std::map<void*, u32> mAllocSize;
+    u32 mLiveBytes;
+    u32 mPeakBytes;
+    f64 mNow;
+    f64 mDiscFree;
+    f64 mPendingDone;
+    f64 mFirstByte;
+    u32 mUndecoded;
+
+    void reset(const Bytes& file, u32 failEvery) {
+        mFile = file;
+        mFile.resize((mFile.size() + 31) & ~31);
+        mPending = false;
+        mFailEvery = failEvery;
+        mReads = 0;
+        mAsyncReads = 0;
+        mFailures = 0;
+        mLiveBytes = 0;
+        mPeakBytes = 0;
+        mNow = 0.0;
+        mDiscFree = 0.0;
+        mFirstByte = -1.0;
+        mUndecoded = 0;
+    }
+
+    /** Starts a read once the drive is free and returns when it is done. */
+    f64 schedule(s32 length) {
+        f64 start = mNow > mDiscFree ? mNow : mDiscFree;
+        mDiscFree = start + DVD_REQUEST_MS + length / DVD_BYTES_PER_MS;
+        return mDiscFree;
+    }
+
+    /** Charges the decoding of everything delivered so far. */
+    void decode() {
+        mNow += mUndecoded / DECODE_BYTES_PER_MS;
+        mUndecoded = 0;
+    }
+
+    void deliver(s32 length) {
+        mUndecoded += length;
+        if (mFirstByte < 0.0) {
+            mFirstByte = mNow;
+        }
+    }
+
+    bool fail() {
+        mReads++;
+        if (mFailEvery != 0 && mReads % mFailEvery == 0) {
+            mFailures++;
+            return true;
+        }
+        return false;
+    }
+
+    void checkRequest(void* addr, s32 length, s32 offset) {
+        HOST_CHECK(((uintptr_t)addr & 31) == 0, "DVD read into unaligned buffer");
+        HOST_CHECK((length & 31) == 0 && (offset & 3) == 0, "DVD read of %d bytes at %d", length,
+                   offset);
+        HOST_CHECK(offset >= 0 && offset + length <= (s32)mFile.size(), "DVD read past the file");
+        HOST_CHECK(!mPending, "DVD read issued while another is in flight");
+    }
+};
+
+static FakeDisc disc;
+
+static s32 DVDReadPrio(DVDFileInfo*, void* addr, s32 length, s32 offset, s32) {
+    disc.checkRequest(addr, length, offset);
+    disc.decode();
+    disc.mNow = disc.schedule(length);
+    if (disc.fail()) {
+        return -1;
+    }
+    memcpy(addr, &disc.mFile[offset], length);
+    disc.deliver(length);
+    return length;
+}
+
+static BOOL DVDReadAsyncPrio(DVDFileInfo*, void* addr, s32 length, s32 offset, void (*)(s32, DVDFileInfo*),
+                             s32) {
+    disc.checkRequest(addr, length, offset);
+    disc.mAsyncReads++;
+    disc.mPending = true;
+    disc.mPendingFail = disc.fail();
+    disc.mPendingAddr = (u8*)addr;
+    disc.mPendingLength = length;
+    disc.mPendingOffset = offset;
+    disc.mPendingDone = disc.schedule(length);
+    memset(addr, 0xEE, length);
+    return TRUE;
+}
+
+struct JKRDvdFile {
+    DVDFileInfo mFileInfo;
+
+    DVDFileInfo* getFileInfo() { return &mFileInfo; }
+    s32 sync() {
+        HOST_CHECK(disc.mPending, "sync without a read in flight");
+        disc.mPending = false;
+        disc.decode();
+        if (disc.mNow < disc.mPendingDone) {
+            disc.mNow = disc.mPendingDone;
+        }
+        if (disc.mPendingFail) {
+            return -1;
+        }
+        memcpy(disc.mPendingAddr, &disc.mFile[disc.mPendingOffset], disc.mPendingLength);
+        disc.deliver(disc.mPendingLength);
+        return disc.mPendingLength;
+    }
+    static void doneProcess(s32, DVDFileInfo*) {}
+};
+
+static void* JKRAllocFromSysHeap(u32 size, int align) {
+    disc.mLiveAllocs++;
+    disc.mLiveBytes += size;
+    if (disc.mLiveBytes > disc.mPeakBytes) {
+        disc.mPeakBytes = disc.mLiveBytes;
+    }
+    u32 alignment = align < 0 ? -align : align;
+    void* ptr =
+        aligned_alloc(alignment < 8 ? 8 : alignment, (size + alignment - 1) & ~(alignment - 1));
+    disc.mAllocSize[ptr] = size;
+    return ptr;
+}
+
+static void JKRFree(void* ptr) {
+    disc.mLiveAllocs--;
+    disc.mLiveBytes -= disc.mAllocSize[ptr];
+    disc.mAllocSize.erase(ptr);
+    free(ptr);
+}
+
+#define DVD_RIPPER_DECLS                                                                           \
+    struct JKRDvdRipper {                                                                          \
+        static u32 sSZSBufferSize;                                                                 \
+        static u32 getSZSBufferSize() { return sSZSBufferSize; }                                   \
+        static bool isErrorRetry() { return true; }                                                \
+    };                                                                                             \
+    static int JKRDecompressFromDVD(JKRDvdFile*, void*, u32, u32, u32, u32, u32*);                 \
+    static int decompSZS_subroutine(u8*, u8*);                                                     \
+    static u8* firstSrcData();                                                                     \
+    static u8* nextSrcData(u8*);
+
+namespace ref {
+#define ENABLE_STREAM_DECOMP 0
+DVD_RIPPER_DECLS
+#include "splice.inc"
+#undef ENABLE_STREAM_DECOMP
+
+static int decompress(JKRDvdFile* file, void* dst, u32 fileSize, u32 maxDest, u32 offset, u32* ts,
+                      u32 bufferSize) {
+    JKRDvdRipper::sSZSBufferSize = bufferSize;
+    return JKRDecompressFromDVD(file, dst, fileSize, maxDest, offset, 0, ts);
+}
+}  // namespace ref
+
+namespace stream {
+#define ENABLE_STREAM_DECOMP 1
+DVD_RIPPER_DECLS
+static void requestSrcData(int);
+static bool waitSrcData();
+#include "splice.inc"
+#undef ENABLE_STREAM_DECOMP
+
+static int decompress(JKRDvdFile* file, void* dst, u32 fileSize, u32 maxDest, u32 offset, u32* ts,
+                      u32 bufferSize) {
+    JKRDvdRipper::sSZSBufferSize = bufferSize;
+    return JKRDecompressFromDVD(file, dst, fileSize, maxDest, offset, 0, ts);
+}
+}  // namespace stream
+
+typedef int (*DecompressFunc)(JKRDvdFile*, void*, u32, u32, u32, u32*, u32);
+
+struct Totals {
+    u32 mReads;
+    u32 mAsyncReads;
+    u32 mFailures;
+    u32 mPeakBytes[2];
+    f64 mFirstByte[2];
+    f64 mTime[2];
+};
+
+static void checkRead(const char* build, DecompressFunc decompress, const Bytes& szs, const Bytes& raw,
+                      u32 maxDest, u32 offset, u32 failEvery, u32 bufferSize, Totals* totals) {
+    disc.reset(szs, failEvery);
+    disc.mLiveAllocs = 0;
+
+    u32 expect = raw.size() - offset < maxDest ? raw.size() - offset : maxDest;
+    Bytes out(raw.size() + 64, 0xCD);
+    u32 ts = 0;
+    JKRDvdFile file;
+    int result = decompress(&file, &out[0], disc.mFile.size(), maxDest, offset, &ts, bufferSize);
+
+    HOST_CHECK(result == 0, "%s: %zu bytes, offset %u, max %u: result %d", build, raw.size(), offset,
+               maxDest, result);
+    HOST_CHECK(ts == expect, "%s: %zu bytes, offset %u, max %u: wrote %u, expected %u", build,
+               raw.size(), offset, maxDest, ts, expect);
+    HOST_CHECK(memcmp(&out[0], &raw[offset], expect) == 0 && out[expect] == 0xCD,
+               "%s: %zu bytes, offset %u, max %u, buffer %#x, fail every %u: output differs", build,
+               raw.size(), offset, maxDest, bufferSize, failEvery);
+    HOST_CHECK(!disc.mPending, "%s: returned with a read in flight", build);
+    HOST_CHECK(disc.mLiveAllocs == 0, "%s: %d buffers not freed", build, disc.mLiveAllocs);
+
+    totals->mReads += disc.mReads;
+    totals->mAsyncReads += disc.mAsyncReads;
+    totals->mFailures += disc.mFailures;
+
+    // Peak memory counts every read; timing only whole files read without failures.
+    int size = bufferSize == 0x400 ? 0 : 1;
+    if (disc.mPeakBytes > totals->mPeakBytes[size]) {
+        totals->mPeakBytes[size] = disc.mPeakBytes;
+    }
+    if (failEvery == 0 && offset == 0 && maxDest == raw.size()) {
+        disc.decode();
+        totals->mFirstByte[size] += disc.mFirstByte;
+        totals->mTime[size] += disc.mNow;
+    }
+}
+
+int main() {
+    std::vector<Bytes> corpus = makeCorpus();
+    static const u32 bufferSizes[] = {0x400, 0x1000};
+    static const u32 failEvery[] = {0, 3};
+
+    Totals totals[2] = {};
+    for (const Bytes& raw : corpus) {
+        Bytes szs = encodeYaz0(raw);
+        u32 size = raw.size();
+        for (u32 bufferSize : bufferSizes) {
+            for (u32 fail : failEvery) {
+                for (int build = 0; build < 2; build++) {
+                    const char* name = build == 0 ? "ref" : "stream";
+                    DecompressFunc decompress = build == 0 ? ref::decompress : stream::decompress;
+                    checkRead(name, decompress, szs, raw, size, 0, fail, bufferSize, &totals[build]);
+                    if (size > 1) {
+                        checkRead(name, decompress, szs, raw, size / 2, 0, fail, bufferSize,
+                                  &totals[build]);
+                        checkRead(name, decompress, szs, raw, size, size / 3, fail, bufferSize,
+                                  &totals[build]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int size = 0; size < 2; size++) {
+        HOST_CHECK(totals[1].mPeakBytes[size] <= totals[0].mPeakBytes[size],
+                   "buffer %#x: stream build peaks at %u bytes, serial at %u", bufferSizes[size],
+                   totals[1].mPeakBytes[size], totals[0].mPeakBytes[size]);
+    }
+
+    printf("%zu files\n", corpus.size());
+    printf("ref    %u reads, %u failed\n", totals[0].mReads, totals[0].mFailures);
+    printf("stream %u reads (%u async), %u failed\n", totals[1].mReads, totals[1].mAsyncReads,
+           totals[1].mFailures);
+    printf("times are sums over the %zu whole files read without failures\n", corpus.size());
+    for (int size = 0; size < 2; size++) {
+        for (int build = 0; build < 2; build++) {
+            printf("buffer %#6x %-6s peak %5u bytes, first byte %7.2f ms, total %8.2f ms\n",
+                   bufferSizes[size], build == 0 ? "ref" : "stream", totals[build].mPeakBytes[size],
+                   totals[build].mFirstByte[size], totals[build].mTime[size]);
+        }
+    }
+    return host_check_result("dvd_stream");
+}
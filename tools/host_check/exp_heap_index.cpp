@@ -0,0 +1,498 @@
+// Replays an allocation trace through JKRExpHeap with and without ENABLE_EXPHEAP_SIZE_INDEX
+// (user-004). Every allocation must land at the same heap offset in both builds, and the
+// index build's bins are validated with checkFreeIndex along the way. Prints the replay
+// time of both builds, the latency of single allocations, and the free list: how many blocks
+// it holds and the largest one, sampled every 256 operations. Since both builds place every
+// block alike, their free lists must match at every sample.
+//
+// Without arguments a synthetic trace is generated: mostly short-lived small blocks, some
+// medium and long-lived large blocks, aligned and tail allocations, resizes and the odd
+// freeAll. A trace recorded with JKRHeap::startTrace (--heap-trace) can be given instead,
+// optionally with the address of the heap to replay:
+//     python tools/host_check.py exp_heap_index -- trace.bin [heap]
+//
+// region(index): libs/JSystem/src/JKernel/JKRExpHeap.cpp #if ENABLE_EXPHEAP_SIZE_INDEX => getFreeBin
+// splice(index): libs/JSystem/src/JKernel/JKRExpHeap.cpp JKRExpHeap::resetFreeIndex JKRExpHeap::indexFreeBlock JKRExpHeap::unindexFreeBlock JKRExpHeap::findIndexedFreeBlock JKRExpHeap::checkFreeIndex
+// splice: libs/JSystem/src/JKernel/JKRExpHeap.cpp JKRExpHeap::do_alloc JKRExpHeap::allocFromHead@1 JKRExpHeap::allocFromHead@2 JKRExpHeap::allocFromTail@1 JKRExpHeap::allocFromTail@2 JKRExpHeap::do_free JKRExpHeap::do_freeAll JKRExpHeap::do_freeTail JKRExpHeap::do_resize JKRExpHeap::appendUsedList JKRExpHeap::setFreeBlock JKRExpHeap::removeFreeBlock JKRExpHeap::removeUsedBlock JKRExpHeap::recycleFreeBlock JKRExpHeap::joinTwoBlocks
+// splice: libs/JSystem/src/JKernel/JKRExpHeap.cpp JKRExpHeap::CMemBlock::initiate JKRExpHeap::CMemBlock::allocFore JKRExpHeap::CMemBlock::allocBack JKRExpHeap::CMemBlock::free JKRExpHeap::CMemBlock::getHeapBlock
+// rewrite: JKRExpHeap::CMemBlock* mPrev; => HostPtr32<JKRExpHeap::CMemBlock> mPrev;
+// rewrite: JKRExpHeap::CMemBlock* mNext; => HostPtr32<JKRExpHeap::CMemBlock> mNext;
+// rewrite: u32 start; => uintptr_t start;
+// rewrite: 'HM' => 0x484D
+// rewrite: u32 endAddr = => uintptr_t endAddr =
+// rewrite: u32 nextAddr = => uintptr_t nextAddr =
+
+#include "host_check.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#define DEBUG 0
+#define ALIGN_PREV(x, a) ((x) & ~((a) - 1))
+#define ALIGN_NEXT(x, a) (((x) + (a) - 1) & ~((a) - 1))
+#define JUT_WARN(...)
+#define OS_REPORT(...)
+#define JUTWarningConsole_f(...)
+
+struct JUTException {
+    static void panic(const char* file, int line, const char* msg) {
+        printf("panic %s:%d: %s", file, line, msg);
+        exit(1);
+    }
+};
+
+static inline int __cntlzw(u32 x) {
+    return x != 0 ? __builtin_clz(x) : 32;
+}
+
+/**
+ * Heap links are stored inside the heap, so they are kept 32 bits wide as on the target;
+ * block headers then stay 0x10 bytes and the heap layout matches.
+ */
+static uintptr_t host_ptr_base;
+
+template <typename T>
+struct HostPtr32 {
+    u32 mOffset;
+
+    HostPtr32& operator=(T* ptr) {
+        mOffset = ptr != NULL ? (u32)((uintptr_t)ptr - host_ptr_base) : 0;
+        return *this;
+    }
+    operator T*() const { return mOffset != 0 ? (T*)(host_ptr_base + mOffset) : NULL; }
+    T* operator->() const { return *this; }
+};
+
+#define EXP_HEAP_DECLS                                                                             \
+    class JKRExpHeap;                                                                              \
+    struct JKRHeap {                                                                               \
+        void* mStart;                                                                              \
+        void* mEnd;                                                                                \
+        u32 mSize;                                                                                 \
+        bool mErrorFlag;                                                                           \
+        void lock() {}                                                                             \
+        void unlock() {}                                                                           \
+        bool getErrorFlag() const { return mErrorFlag; }                                           \
+        static void callErrorHandler(JKRHeap*, u32, int) {}                                        \
+        void callAllDisposer() {}                                                                  \
+        void dispose(void*, u32) {}                                                                \
+        void dump() {}                                                                             \
+    };                                                                                             \
+    static JKRHeap* JKRGetCurrentHeap() { return NULL; }                                           \
+    class JKRExpHeap : public JKRHeap {                                                            \
+    public:                                                                                        \
+        class CMemBlock {                                                                          \
+        public:                                                                                    \
+            void initiate(CMemBlock*, CMemBlock*, u32, u8, u8);                                    \
+            CMemBlock* allocFore(u32, u8, u8, u8, u8);                                             \
+            CMemBlock* allocBack(u32, u8, u8, u8, u8);                                             \
+            int free(JKRExpHeap*);                                                                 \
+            static CMemBlock* getHeapBlock(void*);                                                 \
+            bool isValid() const { return mMagic == 0x484D; }                                      \
+            bool isTempMemBlock() const { return mFlags & 0x80; }                                  \
+            int getAlignment() const { return mFlags & 0x7f; }                                     \
+            void* getContent() const { return (void*)(this + 1); }                                 \
+                                                                                                   \
+            u16 mMagic;                                                                            \
+            u8 mFlags;                                                                             \
+            u8 mGroupId;                                                                           \
+            u32 size;                                                                              \
+            HostPtr32<CMemBlock> mPrev;                                                            \
+            HostPtr32<CMemBlock> mNext;                                                            \
+        };                                                                                         \
+                                                                                                   \
+        void init(void* data, u32 size);                                                           \
+        void* do_alloc(u32, int);                                                                  \
+        void do_free(void*);                                                                       \
+        void do_freeAll();                                                                         \
+        void do_freeTail();                                                                        \
+        s32 do_resize(void*, u32);                                                                 \
+        void* allocFromHead(u32, int);                                                             \
+        void* allocFromHead(u32);                                                                  \
+        void* allocFromTail(u32, int);                                                             \
+        void* allocFromTail(u32);                                                                  \
+        void appendUsedList(CMemBlock*);                                                           \
+        void setFreeBlock(CMemBlock*, CMemBlock*, CMemBlock*);                                     \
+        void removeFreeBlock(CMemBlock*);                                                          \
+        void removeUsedBlock(CMemBlock*);                                                          \
+        void recycleFreeBlock(CMemBlock*);                                                         \
+        void joinTwoBlocks(CMemBlock*);                                                            \
+        void resetFreeIndex();                                                                     \
+        void indexFreeBlock(CMemBlock*);                                                           \
+        void unindexFreeBlock(CMemBlock*);                                                         \
+        CMemBlock* findIndexedFreeBlock(u32, int, u32*);                                           \
+        bool checkFreeIndex();                                                                     \
+                                                                                                   \
+        enum { FREE_BIN_NUM = 29 };                                                                \
+        u8 mAllocMode;                                                                             \
+        u8 mCurrentGroupId;                                                                        \
+        CMemBlock* mHeadFreeList;                                                                  \
+        CMemBlock* mTailFreeList;                                                                  \
+        CMemBlock* mHeadUsedList;                                                                  \
+        CMemBlock* mTailUsedList;                                                                  \
+        u32 mFreeBinMask;                                                                          \
+        CMemBlock* mFreeBins[FREE_BIN_NUM];                                                        \
+    };                                                                                             \
+    static u32 DBfoundSize;                                                                        \
+    static u32 DBfoundOffset;                                                                      \
+    static JKRExpHeap::CMemBlock* DBfoundBlock;                                                    \
+    static JKRExpHeap::CMemBlock* DBnewFreeBlock;                                                  \
+    static JKRExpHeap::CMemBlock* DBnewUsedBlock;
+
+namespace ref {
+#define ENABLE_EXPHEAP_SIZE_INDEX 0
+EXP_HEAP_DECLS
+#include "splice.inc"
+#undef ENABLE_EXPHEAP_SIZE_INDEX
+
+void JKRExpHeap::init(void* data, u32 size) {
+    mStart = data;
+    mEnd = (u8*)data + size;
+    mSize = size;
+    mErrorFlag = false;
+    mAllocMode = 0;
+    mCurrentGroupId = 0;
+    do_freeAll();
+}
+
+bool JKRExpHeap::checkFreeIndex() {
+    return true;
+}
+}  // namespace ref
+
+namespace indexed {
+#define ENABLE_EXPHEAP_SIZE_INDEX 1
+EXP_HEAP_DECLS
+#include "splice_index.inc"
+#include "splice.inc"
+#undef ENABLE_EXPHEAP_SIZE_INDEX
+
+void JKRExpHeap::init(void* data, u32 size) {
+    mStart = data;
+    mEnd = (u8*)data + size;
+    mSize = size;
+    mErrorFlag = false;
+    mAllocMode = 0;
+    mCurrentGroupId = 0;
+    do_freeAll();
+}
+}  // namespace indexed
+
+/** One operation, in the form JKRHeap::trace records it. */
+struct Op {
+    u8 mType;
+    u32 mAddress;
+    u32 mSize;
+    s32 mParam;
+};
+
+enum {
+    TYPE_CREATE,
+    TYPE_DESTROY,
+    TYPE_ALLOC,
+    TYPE_FREE,
+    TYPE_RESIZE,
+    TYPE_FREE_ALL,
+    TYPE_FREE_TAIL,
+};
+
+static std::vector<Op> makeTrace(u32 heapSize, u32 count) {
+    std::vector<Op> ops;
+    std::vector<u32> live;
+    std::vector<u32> lifetime;
+    HostRandom rnd(0xE4E4);
+    u32 nextId = 1;
+    u32 used = 0;
+
+    for (u32 i = 0; i < count; i++) {
+        u32 roll = rnd.below(1000);
+        if (roll == 0) {
+            ops.push_back({TYPE_FREE_ALL, 0, 0, 0});
+            live.clear();
+            lifetime.clear();
+            used = 0;
+            continue;
+        }
+
+        bool full = used > heapSize / 10 * 6;
+        if (!live.empty() && (full || roll < 420)) {
+            // Short-lived blocks are freed first, long-lived ones rarely.
+            u32 pick = rnd.below(live.size());
+            if (lifetime[pick] > 1 && !full && rnd.below(8) != 0) {
+                continue;
+            }
+            ops.push_back({TYPE_FREE, live[pick], 0, 0});
+            used -= ops[live[pick] >> 16].mSize;
+            live[pick] = live.back();
+            live.pop_back();
+            lifetime[pick] = lifetime.back();
+            lifetime.pop_back();
+            continue;
+        }
+
+        if (!live.empty() && roll < 450) {
+            u32 pick = rnd.below(live.size());
+            ops.push_back({TYPE_RESIZE, live[pick], 16 + rnd.below(512), 0});
+            continue;
+        }
+
+        u32 size;
+        u32 life;
+        u32 kind = rnd.below(100);
+        if (kind < 75) {
+            size = 4 + rnd.below(256);
+            life = 1;
+        } else if (kind < 96) {
+            size = 0x400 + rnd.below(0x10000);
+            life = rnd.below(2) + 1;
+        } else {
+            size = 0x40000 + rnd.below(0x80000);
+            life = 2;
+        }
+        static const s32 aligns[] = {4, 4, 4, 8, 0x20, 0x20, -4, -0x20};
+        s32 align = aligns[rnd.below(8)];
+
+        // The address field carries the op index in the high half, so frees find their block.
+        u32 id = (u32)ops.size() << 16 | (nextId++ & 0xFFFF);
+        ops.push_back({TYPE_ALLOC, id, size, align});
+        live.push_back(id);
+        lifetime.push_back(life);
+        used += size;
+    }
+    return ops;
+}
+
+static bool readTrace(const char* path, u32 heapFilter, std::vector<Op>* ops, u32* heapSize) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("cannot open %s\n", path);
+        return false;
+    }
+    std::vector<u8> data;
+    u8 buffer[0x1000];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) != 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(file);
+
+    if (data.size() < 0x10 || memcmp(&data[0], "HTRC", 4) != 0 || be32(&data[4]) != 1) {
+        printf("%s is not a version 1 heap trace\n", path);
+        return false;
+    }
+    u32 count = be32(&data[8]);
+    if (count > (data.size() - 0x10) / 0x18) {
+        count = (data.size() - 0x10) / 0x18;
+    }
+
+    // Without a filter, replay the heap with the most allocations.
+    if (heapFilter == 0) {
+        std::map<u32, u32> allocs;
+        for (u32 i = 0; i < count; i++) {
+            const u8* rec = &data[0x10 + i * 0x18];
+            if (rec[0] == TYPE_ALLOC) {
+                allocs[be32(rec + 8)]++;
+            }
+        }
+        for (const auto& entry : allocs) {
+            if (heapFilter == 0 || entry.second > allocs[heapFilter]) {
+                heapFilter = entry.first;
+            }
+        }
+    }
+
+    *heapSize = 0;
+    for (u32 i = 0; i < count; i++) {
+        const u8* rec = &data[0x10 + i * 0x18];
+        if (be32(rec + 8) != heapFilter) {
+            continue;
+        }
+        Op op = {rec[0], be32(rec + 12), be32(rec + 16), (s32)be32(rec + 20)};
+        if (op.mType == TYPE_CREATE) {
+            *heapSize = op.mSize;
+            ops->clear();
+        } else if (op.mType == TYPE_DESTROY) {
+            break;
+        } else {
+            ops->push_back(op);
+        }
+    }
+    if (*heapSize == 0) {
+        *heapSize = 0x1000000;
+    }
+    printf("%s: heap %08x, %zu operations\n", path, heapFilter, ops->size());
+    return true;
+}
+
+/** Per-allocation latency and free list samples of one replay. */
+struct Stats {
+    std::vector<double> mAllocTime;
+    std::vector<u32> mFreeNum;
+    std::vector<u32> mLargestFree;
+};
+
+/** Result of one replay: heap offset of each allocation, or -1 when it failed. */
+template <typename Heap>
+static double replay(const std::vector<Op>& ops, u8* arena, u32 heapSize, bool check,
+                     std::vector<s64>* offsets, Stats* stats = NULL) {
+    Heap heap;
+    heap.init(arena, heapSize);
+    std::map<u32, void*> blocks;
+
+    double start = host_seconds();
+    for (size_t i = 0; i < ops.size(); i++) {
+        const Op& op = ops[i];
+        switch (op.mType) {
+        case TYPE_ALLOC: {
+            double allocStart = stats != NULL ? host_seconds() : 0.0;
+            void* ptr = heap.do_alloc(op.mSize, op.mParam);
+            if (stats != NULL) {
+                stats->mAllocTime.push_back(host_seconds() - allocStart);
+            }
+            if (offsets != NULL) {
+                offsets->push_back(ptr != NULL ? (u8*)ptr - arena : -1);
+            }
+            if (ptr != NULL && op.mAddress != 0) {
+                blocks[op.mAddress] = ptr;
+            }
+            break;
+        }
+        case TYPE_FREE: {
+            auto it = blocks.find(op.mAddress);
+            if (it != blocks.end()) {
+                heap.do_free(it->second);
+                blocks.erase(it);
+            }
+            break;
+        }
+        case TYPE_RESIZE: {
+            auto it = blocks.find(op.mAddress);
+            if (it != blocks.end()) {
+                s32 result = heap.do_resize(it->second, op.mSize);
+                if (offsets != NULL) {
+                    offsets->push_back(result);
+                }
+            }
+            break;
+        }
+        case TYPE_FREE_ALL:
+            heap.do_freeAll();
+            blocks.clear();
+            break;
+        case TYPE_FREE_TAIL:
+            heap.do_freeTail();
+            for (auto it = blocks.begin(); it != blocks.end();) {
+                if (Heap::CMemBlock::getHeapBlock(it->second) == NULL ||
+                    !Heap::CMemBlock::getHeapBlock(it->second)->isTempMemBlock())
+                {
+                    ++it;
+                } else {
+                    it = blocks.erase(it);
+                }
+            }
+            break;
+        }
+        if (check && i % 256 == 0) {
+            HOST_CHECK(heap.checkFreeIndex(), "free index broken after op %zu", i);
+        }
+        if (stats != NULL && i % 256 == 0) {
+            u32 num = 0;
+            u32 largest = 0;
+            typedef typename Heap::CMemBlock Block;
+            for (Block* block = heap.mHeadFreeList; block != NULL; block = block->mNext) {
+                num++;
+                largest = std::max(largest, block->size);
+            }
+            stats->mFreeNum.push_back(num);
+            stats->mLargestFree.push_back(largest);
+        }
+    }
+    return host_seconds() - start;
+}
+
+/**
+ * Allocation latency in ns, less the cost of reading the clock, and the free list averaged
+ * over the samples, with the worst sample in parentheses.
+ */
+static void printStats(const char* name, Stats* stats, double timerCost) {
+    std::vector<double>& time = stats->mAllocTime;
+    std::sort(time.begin(), time.end());
+    double sum = 0.0;
+    for (double t : time) {
+        sum += t;
+    }
+    double freeSum = 0.0;
+    double largestSum = 0.0;
+    u32 freeMax = 0;
+    u32 largestMin = 0xFFFFFFFF;
+    for (size_t i = 0; i < stats->mFreeNum.size(); i++) {
+        freeSum += stats->mFreeNum[i];
+        largestSum += stats->mLargestFree[i];
+        freeMax = std::max(freeMax, stats->mFreeNum[i]);
+        largestMin = std::min(largestMin, stats->mLargestFree[i]);
+    }
+    size_t samples = stats->mFreeNum.size();
+    printf("%-5s %9.1f %9.1f %9.1f %9.1f %5.0f (%4u) %6.0f K (%4u K)\n", name,
+           (sum / time.size() - timerCost) * 1e9, (time[time.size() / 2] - timerCost) * 1e9,
+           (time[time.size() * 99 / 100] - timerCost) * 1e9,
+           (time[time.size() * 999 / 1000] - timerCost) * 1e9,
+           freeSum / samples, freeMax, largestSum / samples / 1024, largestMin / 1024);
+}
+
+int main(int argc, char** argv) {
+    std::vector<Op> ops;
+    u32 heapSize = 0x800000;
+    if (argc > 1) {
+        if (!readTrace(argv[1], argc > 2 ? strtoul(argv[2], NULL, 16) : 0, &ops, &heapSize)) {
+            return 1;
+        }
+    } else {
+        ops = makeTrace(heapSize, 400000);
+    }
+
+    u8* arena = (u8*)aligned_alloc(0x20, heapSize + 0x20);
+    host_ptr_base = (uintptr_t)arena - 0x10;
+
+    std::vector<s64> refOffsets;
+    std::vector<s64> indexOffsets;
+    replay<ref::JKRExpHeap>(ops, arena, heapSize, false, &refOffsets);
+    replay<indexed::JKRExpHeap>(ops, arena, heapSize, true, &indexOffsets);
+    HOST_CHECK(refOffsets.size() == indexOffsets.size(), "result count differs");
+    size_t failed = 0;
+    for (size_t i = 0; i < refOffsets.size() && i < indexOffsets.size(); i++) {
+        HOST_CHECK(refOffsets[i] == indexOffsets[i], "result %zu: ref %lld, index %lld", i,
+                   (long long)refOffsets[i], (long long)indexOffsets[i]);
+        failed += refOffsets[i] < 0;
+    }
+    printf("%zu operations, %zu results compared, %zu failed in both builds\n", ops.size(),
+           refOffsets.size(), failed);
+
+    double refTime = 0;
+    double indexTime = 0;
+    for (int rep = 0; rep < 3; rep++) {
+        refTime += replay<ref::JKRExpHeap>(ops, arena, heapSize, false, NULL);
+        indexTime += replay<indexed::JKRExpHeap>(ops, arena, heapSize, false, NULL);
+    }
+    printf("replay: ref %.1f ms, index %.1f ms\n", refTime * 1000 / 3, indexTime * 1000 / 3);
+
+    Stats refStats;
+    Stats indexStats;
+    for (int rep = 0; rep < 3; rep++) {
+        replay<ref::JKRExpHeap>(ops, arena, heapSize, false, NULL, &refStats);
+        replay<indexed::JKRExpHeap>(ops, arena, heapSize, false, NULL, &indexStats);
+    }
+    HOST_CHECK(refStats.mFreeNum == indexStats.mFreeNum, "free block counts differ");
+    HOST_CHECK(refStats.mLargestFree == indexStats.mLargestFree, "largest free blocks differ");
+    double timerCost = host_seconds();
+    for (int i = 0; i < 1000; i++) {
+        host_seconds();
+    }
+    timerCost = (host_seconds() - timerCost) / 1000;
+    printf("%-5s %9s %9s %9s %9s %11s %14s\n", "", "alloc avg", "p50", "p99", "p99.9",
+           "free blocks", "largest free");
+    printStats("ref", &refStats, timerCost);
+    printStats("index", &indexStats, timerCost);
+
+    free(arena);
+    return host_check_result("exp_heap_index");
+}
@@ -0,0 +1,141 @@
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+/**
+ * Shared shims for the host checks run by tools/host_check.py.
+ * Types match the target's widths, not dolphin/types.h's spelling of them.
+ * Checks built against tree sources (HOST_CHECK_TREE) take the game's own
+ * types and MSL headers instead.
+ */
+
+#if HOST_CHECK_TREE
+#include <types.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef int8_t s8;
+typedef uint8_t u8;
+typedef int16_t s16;
+typedef uint16_t u16;
+typedef int32_t s32;
+typedef uint32_t u32;
+typedef int64_t s64;
+typedef uint64_t u64;
+typedef float f32;
+typedef double f64;
+typedef int BOOL;
+
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+#endif
+
+#define READU32_BE(ptr, offset) \
+    (((u32)ptr[offset] << 24) | ((u32)ptr[offset + 1] << 16) | ((u32)ptr[offset + 2] << 8) | (u32)ptr[offset + 3]);
+
+static int host_check_failures;
+
+/** Records a failure without stopping, so one run reports every mismatch. */
+#define HOST_CHECK(cond, ...)                                                                      \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            if (host_check_failures++ < 20) {                                                      \
+                printf("FAIL %s:%d: ", __FILE__, __LINE__);                                        \
+                printf(__VA_ARGS__);                                                               \
+                printf("\n");                                                                      \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+/** Prints the summary line and returns the process exit status. */
+static int host_check_result(const char* name) {
+    if (host_check_failures != 0) {
+        printf("%s: %d failures\n", name, host_check_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+static inline u32 be32(const u8* p) {
+    return (u32)p[0] << 24 | (u32)p[1] << 16 | (u32)p[2] << 8 | p[3];
+}
+
+static inline u16 be16(const u8* p) {
+    return (u16)(p[0] << 8 | p[1]);
+}
+
+static inline void put_be32(u8* p, u32 v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/** xorshift32, so generated data is the same on every host. */
+struct HostRandom {
+    u32 mState;
+
+    explicit HostRandom(u32 seed) : mState(seed != 0 ? seed : 1) {}
+    u32 next() {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+    u32 below(u32 n) { return next() % n; }
+    f32 unit() { return (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+#if HOST_CHECK_TREE
+struct host_timespec {
+    long tv_sec;
+    long tv_nsec;
+};
+extern "C" int clock_gettime(int, host_timespec*);
+
+/** Wall clock seconds since an arbitrary epoch. */
+static inline double host_seconds() {
+    host_timespec now;
+    clock_gettime(1 /* CLOCK_MONOTONIC */, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+#else
+/** Wall clock seconds since an arbitrary epoch. */
+static inline double host_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#if HOST_CHECK_TREE
+typedef unsigned long host_thread;
+extern "C" int pthread_create(host_thread*, const void*, void* (*)(void*), void*);
+extern "C" int pthread_join(host_thread, void**);
+#else
+#include <pthread.h>
+typedef pthread_t host_thread;
+#endif
+
+/** Runs func(arg) on a host thread of its own, for checks that need real concurrency. */
+static inline host_thread host_thread_start(void* (*func)(void*), void* arg) {
+    host_thread thread;
+    if (pthread_create(&thread, NULL, func, arg) != 0) {
+        printf("pthread_create failed\n");
+        exit(1);
+    }
+    return thread;
+}
+
+static inline void host_thread_join(host_thread thread) {
+    pthread_join(thread, NULL);
+}
+
+#endif
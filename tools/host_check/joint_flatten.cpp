@@ -0,0 +1,395 @@
+// Evaluates joint trees with J3DJoint::recursiveCalc and with ENABLE_JOINT_FLATTEN's
+// calcOrdered (user-022) and compares the J3DMtxBuffer they fill: every animation matrix and
+// scale flag must match bit for bit, for trees whose basic mtx calc is Basic, Softimage or
+// Maya. The joint callbacks must also see the same calls in the same order with the same
+// J3DSys state. Prints the time per joint of both walks.
+//
+// calcOrdered keeps its state in a J3DJointCalcContext, so on a tree without callbacks it must
+// leave the J3DSys and J3DMtxCalc statics alone. Four threads then walk trees of their own at
+// the same time, over and over, and must get the matrices a walk on its own got.
+//
+// The trees are built through J3DJointTree::makeHierarchy from random INF1 style hierarchies
+// of 1 to 120 joints, some long chains and some wide fans, with random transforms, scale
+// compensation and now and then an exact unit scale. Some joints carry their own mtx calc of
+// another mode, and in two trees of three some have callbacks that move J3DSys::mCurrentMtx or
+// mCurrentS the way game callbacks do. Trees deeper than calcOrdered handles must keep using
+// recursiveCalc.
+//
+// tree: libs/JSystem/src/J3DGraphAnimator/J3DJoint.cpp
+// tree: libs/JSystem/src/J3DGraphAnimator/J3DJointTree.cpp
+// tree: libs/JSystem/src/J3DGraphBase/J3DTransform.cpp
+// tree: libs/JSystem/src/JMath/JMATrigonometric.cpp
+// define: ENABLE_JOINT_FLATTEN=1
+// splice: libs/dolphin/src/mtx/mtx.c C_MTXCopy C_MTXConcat
+
+#include "host_check.h"
+
+// The joint and tree fields are private; the hierarchy below is built the way the model
+// loader builds it.
+#define private public
+#include "JSystem/J3DGraphAnimator/J3DJoint.h"
+#include "JSystem/J3DGraphAnimator/J3DJointTree.h"
+#undef private
+#include "JSystem/J3DGraphAnimator/J3DMtxBuffer.h"
+#include "JSystem/J3DGraphBase/J3DSys.h"
+#include <dolphin/mtx.h>
+
+#include "splice.inc"
+
+Mtx J3DSys::mCurrentMtx;
+Vec J3DSys::mCurrentS;
+Vec J3DSys::mParentS;
+
+J3DDrawMtxData::J3DDrawMtxData() {}
+J3DDrawMtxData::~J3DDrawMtxData() {}
+
+void J3DMtxBuffer::initialize() {
+    memset(this, 0, sizeof(*this));
+}
+
+extern "C" {
+void PSMTXCopy(const Mtx src, Mtx dst) {
+    C_MTXCopy(src, dst);
+}
+void PSMTXConcat(const Mtx a, const Mtx b, Mtx ab) {
+    C_MTXConcat(a, b, ab);
+}
+}
+
+void* __memcpy(void* dst, const void* src, int size) {
+    return memcpy(dst, src, size);
+}
+
+/** The paired-single version has no host path; this does the same multiplies. */
+void JMAMTXApplyScale(const Mtx src, Mtx dst, f32 xScale, f32 yScale, f32 zScale) {
+    for (int i = 0; i < 3; i++) {
+        dst[i][0] = src[i][0] * xScale;
+        dst[i][1] = src[i][1] * yScale;
+        dst[i][2] = src[i][2] * zScale;
+        dst[i][3] = src[i][3];
+    }
+}
+
+static const int JOINT_MAX = 120;
+static const int TREE_NUM = 3000;
+static const int THREAD_NUM = 4;
+static const int THREAD_CALC_NUM = 20000;
+
+enum {
+    kTypeEnd = 0x00,
+    kTypeBeginChild = 0x01,
+    kTypeEndChild = 0x02,
+    kTypeJoint = 0x10,
+};
+
+static J3DMtxCalcNoAnm<J3DMtxCalcCalcTransformBasic, J3DMtxCalcJ3DSysInitBasic> l_basic;
+static J3DMtxCalcNoAnm<J3DMtxCalcCalcTransformSoftimage, J3DMtxCalcJ3DSysInitBasic> l_softimage;
+static J3DMtxCalcNoAnm<J3DMtxCalcCalcTransformMaya, J3DMtxCalcJ3DSysInitMaya> l_maya;
+static J3DMtxCalc* const l_mtxCalc[] = {&l_basic, &l_softimage, &l_maya};
+
+/** Everything the joint callbacks see, in call order. */
+static u32 l_trace[JOINT_MAX * 8];
+static int l_traceNum;
+
+static u32 hashState(u32 hash) {
+    const u32* words = (const u32*)J3DSys::mCurrentMtx;
+    for (int i = 0; i < 12; i++) {
+        hash = hash * 31 + words[i];
+    }
+    const u32* scale = (const u32*)&J3DSys::mCurrentS;
+    const u32* parent = (const u32*)&J3DSys::mParentS;
+    for (int i = 0; i < 3; i++) {
+        hash = hash * 31 + scale[i];
+        hash = hash * 31 + parent[i];
+    }
+    return hash * 31 + (u32)(size_t)J3DJoint::mCurrentMtxCalc;
+}
+
+static int traceCallBack(J3DJoint* joint, int timing) {
+    l_trace[l_traceNum++] = joint->getJntNo() * 2 + timing;
+    l_trace[l_traceNum++] = hashState(0);
+    return 1;
+}
+
+/** Like a game callback: bends the current matrix or scale the children start from. */
+static int moveCallBack(J3DJoint* joint, int timing) {
+    traceCallBack(joint, timing);
+    if (timing == 0) {
+        J3DSys::mCurrentMtx[0][3] += 1.5f;
+        J3DSys::mCurrentMtx[1][1] *= 0.75f;
+        J3DSys::mCurrentS.y *= 2.0f;
+    }
+    return 1;
+}
+
+struct TestTree {
+    J3DJoint mJoint[JOINT_MAX];
+    J3DJoint* mJointPtr[JOINT_MAX];
+    int mParent[JOINT_MAX];
+    J3DModelHierarchy mHierarchy[JOINT_MAX * 3 + 1];
+    int mHierarchyNum;
+    int mJointNum;
+    int mDepth;
+    bool mCallBack;
+    J3DJointTree mTree;
+    Mtx mAnmMtx[JOINT_MAX];
+    u8 mScaleFlag[JOINT_MAX];
+    J3DMtxBuffer mMtxBuffer;
+
+    void emit(int no, int depth) {
+        if (depth > mDepth) {
+            mDepth = depth;
+        }
+        mHierarchy[mHierarchyNum].mType = kTypeJoint;
+        mHierarchy[mHierarchyNum++].mValue = no;
+        bool child = false;
+        for (int i = no + 1; i < mJointNum; i++) {
+            if (mParent[i] == no) {
+                if (!child) {
+                    mHierarchy[mHierarchyNum++].mType = kTypeBeginChild;
+                    child = true;
+                }
+                emit(i, depth + 1);
+            }
+        }
+        if (child) {
+            mHierarchy[mHierarchyNum++].mType = kTypeEndChild;
+        }
+    }
+
+    void make(HostRandom& random) {
+        mJointNum = 1 + random.below(JOINT_MAX);
+        int shape = random.below(4);
+        mCallBack = random.below(3) != 0;
+        for (int i = 0; i < mJointNum; i++) {
+            J3DJoint* joint = &mJoint[i];
+            joint->mJntNo = i;
+            joint->mChild = NULL;
+            joint->mYounger = NULL;
+            joint->mScaleCompensate = random.below(3) == 0;
+            joint->mMtxCalc = random.below(5) == 0 ? l_mtxCalc[random.below(3)] : NULL;
+            u32 callBack = random.below(6);
+            joint->mCallBack = callBack == 0 ? traceCallBack : callBack == 1 ? moveCallBack : NULL;
+            if (!mCallBack) {
+                joint->mCallBack = NULL;
+            }
+
+            J3DTransformInfo& info = joint->mTransformInfo;
+            bool unit = random.below(3) == 0;
+            info.mScale.x = unit ? 1.0f : 0.5f + random.unit() * 1.5f;
+            info.mScale.y = unit ? 1.0f : 0.5f + random.unit() * 1.5f;
+            info.mScale.z = unit ? 1.0f : 0.5f + random.unit() * 1.5f;
+            info.mRotation.x = random.next();
+            info.mRotation.y = random.next();
+            info.mRotation.z = random.next();
+            info.mTranslate.x = random.unit() * 200.0f - 100.0f;
+            info.mTranslate.y = random.unit() * 200.0f - 100.0f;
+            info.mTranslate.z = random.unit() * 200.0f - 100.0f;
+
+            // Chains run deeper than calcOrdered handles; fans give joints many brothers.
+            if (i == 0) {
+                mParent[i] = -1;
+            } else if (shape == 0) {
+                mParent[i] = i - 1;
+            } else if (shape == 1) {
+                mParent[i] = random.below(i < 4 ? i : 4);
+            } else {
+                mParent[i] = random.below(3) == 0 ? i - 1 : random.below(i);
+            }
+            mJointPtr[i] = joint;
+        }
+
+        mHierarchyNum = 0;
+        mDepth = 0;
+        emit(0, 1);
+        mHierarchy[mHierarchyNum++].mType = kTypeEnd;
+
+        mTree.mJointNodePointer = mJointPtr;
+        mTree.mJointNum = mJointNum;
+        mTree.mRootNode = NULL;
+        mTree.setBasicMtxCalc(l_mtxCalc[random.below(3)]);
+        const J3DModelHierarchy* hierarchy = mHierarchy;
+        mTree.makeHierarchy(NULL, &hierarchy, NULL, NULL);
+        mTree.makeCalcOrder();
+
+        mMtxBuffer.mpAnmMtx = mAnmMtx;
+        mMtxBuffer.mpScaleFlagArr = mScaleFlag;
+    }
+
+    /** Runs one walk and returns a hash of the matrices and what the callbacks saw. */
+    u32 calc(bool ordered, const Vec& scale, const f32 (&mtx)[3][4]) {
+        J3DJoint** calcJoint = mTree.mCalcJoint;
+        if (!ordered) {
+            mTree.mCalcJoint = NULL;
+        }
+        memset(mAnmMtx, 0, sizeof(mAnmMtx));
+        memset(mScaleFlag, 0xFF, sizeof(mScaleFlag));
+        l_traceNum = 0;
+        if (!ordered) {
+            J3DJoint::mCurrentMtxCalc = NULL;
+        }
+        mTree.calc(&mMtxBuffer, scale, mtx);
+        mTree.mCalcJoint = calcJoint;
+
+        u32 hash = mJointNum;
+        const u32* words = (const u32*)mAnmMtx;
+        for (int i = 0; i < mJointNum * 12; i++) {
+            hash = hash * 31 + words[i];
+        }
+        for (int i = 0; i < mJointNum; i++) {
+            hash = hash * 31 + mScaleFlag[i];
+        }
+        for (int i = 0; i < l_traceNum; i++) {
+            hash = hash * 31 + l_trace[i];
+        }
+        return hash;
+    }
+};
+
+static TestTree l_tree;
+
+/** Fills the statics with values no walk leaves, and checks that they are still there. */
+static J3DMtxCalc* const l_mtxCalcMark = (J3DMtxCalc*)&l_tree;
+
+static void markStatics() {
+    memset(J3DSys::mCurrentMtx, 0x7F, sizeof(Mtx));
+    memset(&J3DSys::mCurrentS, 0x7F, sizeof(Vec));
+    memset(&J3DSys::mParentS, 0x7F, sizeof(Vec));
+    J3DJoint::mCurrentMtxCalc = l_mtxCalcMark;
+    J3DMtxCalc::mJoint = NULL;
+    J3DMtxCalc::mMtxBuffer = NULL;
+}
+
+static bool checkStatics() {
+    u8 mark[sizeof(Mtx)];
+    memset(mark, 0x7F, sizeof(mark));
+    return memcmp(J3DSys::mCurrentMtx, mark, sizeof(Mtx)) == 0 &&
+           memcmp(&J3DSys::mCurrentS, mark, sizeof(Vec)) == 0 &&
+           memcmp(&J3DSys::mParentS, mark, sizeof(Vec)) == 0 &&
+           J3DJoint::mCurrentMtxCalc == l_mtxCalcMark && J3DMtxCalc::mJoint == NULL &&
+           J3DMtxCalc::mMtxBuffer == NULL;
+}
+
+/** One thread's tree, and the matrices a walk on its own gave. */
+struct ThreadJob {
+    TestTree mTree;
+    Vec mScale;
+    Mtx mMtx;
+    Mtx mRef[JOINT_MAX];
+    int mDiffer;
+};
+
+static ThreadJob l_job[THREAD_NUM];
+
+static void* threadMain(void* arg) {
+    ThreadJob* job = (ThreadJob*)arg;
+    TestTree& tree = job->mTree;
+    for (int i = 0; i < THREAD_CALC_NUM; i++) {
+        memset(tree.mAnmMtx, 0, sizeof(tree.mAnmMtx));
+        tree.mTree.calc(&tree.mMtxBuffer, job->mScale, job->mMtx);
+        if (memcmp(job->mRef, tree.mAnmMtx, tree.mJointNum * sizeof(Mtx)) != 0) {
+            job->mDiffer++;
+        }
+    }
+    return NULL;
+}
+
+/** Walks a callback-free tree per thread, all at once. */
+static void checkThreads(HostRandom& random) {
+    for (int t = 0; t < THREAD_NUM; t++) {
+        ThreadJob& job = l_job[t];
+        do {
+            job.mTree.make(random);
+        } while (job.mTree.mCallBack || job.mTree.mTree.mCalcJoint == NULL ||
+                 job.mTree.mJointNum < 40);
+        job.mScale.x = job.mScale.y = job.mScale.z = 0.5f + random.unit();
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                job.mMtx[i][j] = i == j ? 1.0f : random.unit() * 0.1f;
+            }
+        }
+        job.mTree.calc(true, job.mScale, job.mMtx);
+        memcpy(job.mRef, job.mTree.mAnmMtx, sizeof(job.mRef));
+        job.mDiffer = 0;
+    }
+
+    host_thread thread[THREAD_NUM];
+    for (int t = 0; t < THREAD_NUM; t++) {
+        thread[t] = host_thread_start(threadMain, &l_job[t]);
+    }
+    for (int t = 0; t < THREAD_NUM; t++) {
+        host_thread_join(thread[t]);
+        HOST_CHECK(l_job[t].mDiffer == 0, "thread %d: %d of %d walks differ", t,
+                   l_job[t].mDiffer, THREAD_CALC_NUM);
+    }
+}
+
+int main() {
+    HostRandom random(22);
+    double time[2] = {0.0, 0.0};
+    long jointNum = 0;
+    int flatNum = 0;
+    int deepNum = 0;
+    for (int t = 0; t < TREE_NUM; t++) {
+        TestTree& tree = l_tree;
+        tree.make(random);
+
+        // makeCalcOrder lists every joint in recursiveCalc's order, or gives up on deep trees.
+        bool deep = tree.mDepth > 32;
+        if (deep) {
+            deepNum++;
+            HOST_CHECK(tree.mTree.mCalcJoint == NULL, "tree %d of depth %d was flattened", t,
+                       tree.mDepth);
+        } else {
+            flatNum++;
+            HOST_CHECK(tree.mTree.mCalcJoint != NULL && tree.mTree.mCalcNum == tree.mJointNum,
+                       "tree %d: %d of %d joints flattened", t, tree.mTree.mCalcNum,
+                       tree.mJointNum);
+        }
+
+        Vec scale = {1.0f, 1.0f, 1.0f};
+        if (random.below(2) == 0) {
+            scale.x = scale.y = scale.z = 0.5f + random.unit();
+        }
+        Mtx mtx;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                mtx[i][j] = i == j ? 1.0f : random.unit() * 0.1f;
+            }
+        }
+        mtx[0][3] = random.unit() * 1000.0f;
+
+        u32 a = tree.calc(false, scale, mtx);
+        Mtx ref[JOINT_MAX];
+        memcpy(ref, tree.mAnmMtx, sizeof(ref));
+        if (!tree.mCallBack && !deep) {
+            markStatics();
+        }
+        u32 b = tree.calc(true, scale, mtx);
+        if (!tree.mCallBack && !deep) {
+            HOST_CHECK(checkStatics(), "tree %d: calcOrdered touched the statics", t);
+        }
+        HOST_CHECK(a == b, "tree %d (%d joints, depth %d, calc %d) differs", t, tree.mJointNum,
+                   tree.mDepth, (int)(tree.mTree.getBasicMtxCalc() == &l_maya));
+        HOST_CHECK(memcmp(ref, tree.mAnmMtx, tree.mJointNum * sizeof(Mtx)) == 0,
+                   "tree %d animation matrices differ", t);
+
+        if (!deep) {
+            for (int pass = 0; pass < 2; pass++) {
+                double start = host_seconds();
+                for (int i = 0; i < 20; i++) {
+                    tree.calc(pass == 1, scale, mtx);
+                }
+                time[pass] += host_seconds() - start;
+            }
+            jointNum += tree.mJointNum * 20;
+        }
+    }
+
+    checkThreads(random);
+
+    printf("%d trees flattened, %d deep ones left recursive\n", flatNum, deepNum);
+    printf("recursive %.1f ns, flattened %.1f ns per joint\n", time[0] / jointNum * 1e9,
+           time[1] / jointNum * 1e9);
+    return host_check_result("joint_flatten");
+}
@@ -0,0 +1,364 @@
+// Times JPAResource::calcParticleBatch (ENABLE_JPA_FIELD_BATCH, user-011) against the
+// per-particle calc_p/calc_c loop it replaces, in particles per millisecond of JPAEmitterManager
+// calc. The JParticle sources are built for the host with the flag on. Two managers play the same
+// script over synthetic resources whose fields are all ones the batch handles (gravity, air,
+// vortex, drag), with fade and add types mixed in, and some resources with children. The
+// reference manager gives every emitter an empty particle callback, which keeps it on the
+// per-particle loop; the cost of that empty call is included in its time. After every frame both
+// managers must hold the same emitters with bit-identical particles.
+//
+// tree: libs/JSystem/src/JParticle/JPAEmitterManager.cpp libs/JSystem/src/JParticle/JPAEmitter.cpp
+// tree: libs/JSystem/src/JParticle/JPAResource.cpp libs/JSystem/src/JParticle/JPAParticle.cpp
+// tree: libs/JSystem/src/JParticle/JPABaseShape.cpp libs/JSystem/src/JParticle/JPAExtraShape.cpp
+// tree: libs/JSystem/src/JParticle/JPAChildShape.cpp libs/JSystem/src/JParticle/JPAExTexShape.cpp
+// tree: libs/JSystem/src/JParticle/JPADynamicsBlock.cpp
+// tree: libs/JSystem/src/JParticle/JPAFieldBlock.cpp libs/JSystem/src/JParticle/JPAKeyBlock.cpp
+// tree: libs/JSystem/src/JParticle/JPAMath.cpp
+// tree: libs/JSystem/src/JSupport/JSUList.cpp libs/JSystem/src/JMath/JMATrigonometric.cpp
+// define: ENABLE_JPA_FIELD_BATCH=1
+// splice: libs/dolphin/src/mtx/mtx.c C_MTXIdentity C_MTXCopy C_MTXConcat C_MTXScale C_MTXRotAxisRad
+// splice: libs/dolphin/src/mtx/mtxvec.c C_MTXMultVec C_MTXMultVecSR
+// splice: libs/dolphin/src/mtx/vec.c C_VECSquareMag C_VECMag C_VECNormalize C_VECCrossProduct
+// splice: libs/JSystem/src/JParticle/JPAResourceManager.cpp JPAResourceManager::getResource
+
+#include "host_check.h"
+
+#include "JSystem/JKernel/JKRHeap.h"
+#include "JSystem/JParticle/JPABaseShape.h"
+#include "JSystem/JParticle/JPAChildShape.h"
+#include "JSystem/JParticle/JPADynamicsBlock.h"
+#include "JSystem/JParticle/JPAEmitter.h"
+#include "JSystem/JParticle/JPAEmitterManager.h"
+#include "JSystem/JParticle/JPAExtraShape.h"
+#include "JSystem/JParticle/JPAFieldBlock.h"
+#include "JSystem/JParticle/JPAParticle.h"
+#include "JSystem/JParticle/JPAResource.h"
+#include "JSystem/JParticle/JPAResourceManager.h"
+#include <dolphin/mtx.h>
+#include <dolphin/os.h>
+
+#include "splice.inc"
+
+int __float_epsilon[] = {0x34000000};
+int __float_nan[] = {0x7FC00000};
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+
+double __frsqrte(double x) {
+    return 1.0 / __builtin_sqrt(x);
+}
+
+void PSMTXIdentity(Mtx m) {
+    C_MTXIdentity(m);
+}
+void PSMTXCopy(const Mtx src, Mtx dst) {
+    C_MTXCopy(src, dst);
+}
+void PSMTXConcat(const Mtx a, const Mtx b, Mtx ab) {
+    C_MTXConcat(a, b, ab);
+}
+void PSMTXScale(Mtx m, f32 xS, f32 yS, f32 zS) {
+    C_MTXScale(m, xS, yS, zS);
+}
+void PSMTXRotAxisRad(Mtx m, const Vec* axis, f32 rad) {
+    C_MTXRotAxisRad(m, axis, rad);
+}
+void PSMTXMultVec(const Mtx m, const Vec* src, Vec* dst) {
+    C_MTXMultVec(m, src, dst);
+}
+void PSMTXMultVecSR(const Mtx m, const Vec* src, Vec* dst) {
+    C_MTXMultVecSR(m, src, dst);
+}
+f32 PSVECMag(const Vec* v) {
+    return C_VECMag(v);
+}
+void PSVECCrossProduct(const Vec* a, const Vec* b, Vec* axb) {
+    C_VECCrossProduct(a, b, axb);
+}
+
+OSTick OSGetTick() {
+    return 0;
+}
+}
+
+void JMAVECScaleAdd(const Vec* vec1, const Vec* vec2, Vec* dst, f32 scale) {
+    dst->x = vec1->x * scale + vec2->x;
+    dst->y = vec1->y * scale + vec2->y;
+    dst->z = vec1->z * scale + vec2->z;
+}
+
+// JPAResource::init sizes its function lists as 4 bytes per pointer, so every host
+// allocation is doubled. Memory starts zeroed so padding compares equal between runs.
+static void* hostAlloc(size_t size) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, 32, size * 2 + 32);
+    memset(ptr, 0, size * 2 + 32);
+    return ptr;
+}
+
+void* JKRHeap::alloc(u32 size, int, JKRHeap*) {
+    return hostAlloc(size);
+}
+void* operator new(size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+void* operator new[](size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+
+static const int RES_NUM = 16;
+static const int EMTR_NUM = 48;
+static const int FRAME_NUM = 400;
+static const u32 PTCL_NUM = 0x10000;
+
+/** The field types JPAFieldBlock::isBatchable accepts: gravity, air, vortex and drag. */
+static const u32 l_batchFieldType[] = {0, 1, 4, 6};
+
+/** Resource blocks, laid out like the headers the JParticle sources read them through. */
+struct ResourceData {
+    JPABaseShapeData mBsp;
+    JPADynamicsBlockData mDyn;
+    JPAChildShapeData mCsp;
+    JPAFieldBlockData mFld[3];
+    bool mHasCsp;
+    u8 mFldNum;
+};
+
+static f32 range(HostRandom& rnd, f32 lo, f32 hi) {
+    return lo + (hi - lo) * rnd.unit();
+}
+
+static void makeResourceData(ResourceData* data, int no, HostRandom& rnd) {
+    memset(data, 0, sizeof(ResourceData));
+
+    JPABaseShapeData& bsp = data->mBsp;
+    bsp.mFlags = rnd.below(10) | rnd.below(7) << 4 | rnd.below(5) << 7;
+    bsp.mBaseSizeX = range(rnd, 5.0f, 30.0f);
+    bsp.mBaseSizeY = range(rnd, 5.0f, 30.0f);
+    bsp.mClrPrm.a = 0xFF;
+    bsp.mClrEnv.a = 0xFF;
+
+    // Busy emitters that never stop, so that the particle loops dominate the frame.
+    JPADynamicsBlockData& dyn = data->mDyn;
+    dyn.mFlags = (no % 7) << 8 | rnd.below(0x20);
+    if (no % 7 == 1) {
+        // The first fixed interval point on a sphere divides by zero, which only PPC shrugs off.
+        dyn.mFlags &= ~JPADynFlag_FixedInterval;
+    }
+    dyn.mEmitterScl.set(1.0f, 1.0f, 1.0f);
+    dyn.mEmitterDir.set(range(rnd, -1.0f, 1.0f), 1.0f, range(rnd, -1.0f, 1.0f));
+    dyn.mInitialVelOmni = range(rnd, 0.0f, 3.0f);
+    dyn.mInitialVelAxis = range(rnd, 0.0f, 2.0f);
+    dyn.mInitialVelRndm = range(rnd, 0.0f, 1.0f);
+    dyn.mInitialVelDir = range(rnd, 0.0f, 4.0f);
+    dyn.mSpread = range(rnd, 0.0f, 0.5f);
+    dyn.mInitialVelRatio = range(rnd, 0.0f, 1.0f);
+    dyn.mRate = range(rnd, 4.0f, 12.0f);
+    dyn.mRateRndm = range(rnd, 0.0f, 0.5f);
+    dyn.mLifeTimeRndm = range(rnd, 0.0f, 0.5f);
+    dyn.mVolumeSweep = range(rnd, 0.3f, 1.0f);
+    dyn.mVolumeMinRad = range(rnd, 0.0f, 0.5f);
+    dyn.mAirResist = range(rnd, 0.9f, 1.0f);
+    dyn.mMoment = range(rnd, 0.0f, 1.0f);
+    dyn.mEmitterRot.set(rnd.next(), rnd.next(), rnd.next());
+    dyn.mMaxFrame = 0;
+    dyn.mLifeTime = 60 + rnd.below(90);
+    dyn.mVolumeSize = 5 + rnd.below(60);
+    dyn.mDivNumber = 2 + rnd.below(16);
+
+    // Children that fields move (0x200000) as well as ones they leave alone.
+    data->mHasCsp = no % 3 == 0;
+    JPAChildShapeData& csp = data->mCsp;
+    csp.mFlags = rnd.below(10) | rnd.below(7) << 4 | rnd.below(5) << 7 | rnd.below(0x20) << 16;
+    if (no != 9) {
+        csp.mFlags |= 0x200000;
+    }
+    csp.mPosRndm = range(rnd, 0.0f, 5.0f);
+    csp.mBaseVel = range(rnd, 0.0f, 2.0f);
+    csp.mBaseVelRndm = range(rnd, 0.0f, 1.0f);
+    csp.mVelInfRate = range(rnd, 0.0f, 1.0f);
+    csp.mGravity = range(rnd, -0.5f, 0.0f);
+    csp.mScaleX = range(rnd, 0.5f, 2.0f);
+    csp.mScaleY = range(rnd, 0.5f, 2.0f);
+    csp.mTiming = range(rnd, 0.6f, 1.0f);
+    csp.mLife = 5 + rnd.below(15);
+    csp.mRate = 1;
+    csp.mStep = 4 + rnd.below(4);
+
+    // Every batched type shows up with every add type, with and without fades.
+    data->mFldNum = 1 + rnd.below(3);
+    for (int i = 0; i < data->mFldNum; i++) {
+        JPAFieldBlockData& fld = data->mFld[i];
+        fld.mFlags = l_batchFieldType[(no + i) % 4] | rnd.below(3) << 8 | rnd.below(0x10) << 16;
+        fld.mPos.set(range(rnd, -50.0f, 50.0f), range(rnd, -50.0f, 50.0f),
+                     range(rnd, -50.0f, 50.0f));
+        fld.mDir.set(range(rnd, -1.0f, 1.0f), range(rnd, -1.0f, 1.0f), range(rnd, -1.0f, 1.0f));
+        fld.mMag = range(rnd, 0.01f, 1.0f);
+        fld.mMagRndm = range(rnd, 0.0f, 0.5f);
+        fld.mVal1 = range(rnd, 0.0f, 1.0f);
+        fld.mFadeInTime = range(rnd, 0.0f, 0.3f);
+        fld.mFadeOutTime = range(rnd, 0.7f, 1.0f);
+        fld.mEnTime = 0.0f;
+        fld.mDisTime = 1.0f;
+        fld.mCycle = rnd.below(8);
+    }
+}
+
+static JPAResource* makeResource(const ResourceData* data, int no) {
+    JPAResource* res = new (NULL, 0) JPAResource();
+    res->pBsp = new (NULL, 0) JPABaseShape((const u8*)&data->mBsp, NULL);
+    res->pDyn = new (NULL, 0) JPADynamicsBlock((const u8*)&data->mDyn);
+    if (data->mHasCsp) {
+        res->pCsp = new (NULL, 0) JPAChildShape((const u8*)&data->mCsp);
+    }
+    res->ppFld = new (NULL, 0) JPAFieldBlock*[data->mFldNum];
+    for (int i = 0; i < data->mFldNum; i++) {
+        res->ppFld[i] = new (NULL, 0) JPAFieldBlock((const u8*)&data->mFld[i], NULL);
+    }
+    res->fldNum = data->mFldNum;
+    res->mUsrIdx = no;
+    res->init(NULL);
+    return res;
+}
+
+/** Does nothing; its presence keeps JPAResource::calc on the per-particle loop. */
+struct EmptyCallBack : public JPAParticleCallBack {
+    virtual void execute(JPABaseEmitter*, JPABaseParticle*) {}
+};
+
+/** One manager playing the script. */
+struct Run {
+    JPAEmitterManager* mMgr;
+    JPAResourceManager* mResMgr;
+    ResourceData mData[RES_NUM];
+    EmptyCallBack mPtclCB;
+    bool mPerParticle;
+    double mTime;
+    double mPtclNum;
+
+    void init(bool perParticle) {
+        mMgr = new (NULL, 0) JPAEmitterManager(PTCL_NUM, EMTR_NUM, NULL, 1, 1);
+        mResMgr = (JPAResourceManager*)hostAlloc(sizeof(JPAResourceManager));
+        mResMgr->pResAry = new (NULL, 0) JPAResource*[RES_NUM];
+        HostRandom rnd(0x4A5046);
+        for (int i = 0; i < RES_NUM; i++) {
+            makeResourceData(&mData[i], i, rnd);
+            mResMgr->pResAry[i] = makeResource(&mData[i], i);
+        }
+        mResMgr->resMaxNum = mResMgr->resRegNum = RES_NUM;
+        mMgr->entryResourceManager(mResMgr, 0);
+        mPerParticle = perParticle;
+        mTime = 0.0;
+        mPtclNum = 0.0;
+    }
+
+    void create(HostRandom& rnd) {
+        JGeometry::TVec3<f32> pos(range(rnd, -100.0f, 100.0f), range(rnd, 0.0f, 50.0f),
+                                  range(rnd, -100.0f, 100.0f));
+        HOST_CHECK(mMgr->createSimpleEmitterID(pos, rnd.below(RES_NUM), 0, 0, NULL,
+                                               mPerParticle ? &mPtclCB : NULL) != NULL,
+                   "ran out of emitters");
+    }
+
+    /** Keeps the emitters topped up, now and then swapping one out, and times calc. */
+    void frame(HostRandom& script) {
+        if (mMgr->getEmitterNumber() != 0 && script.below(8) == 0) {
+            u32 skip = script.below(mMgr->getEmitterNumber());
+            JSULink<JPABaseEmitter>* link = mMgr->pEmtrUseList[0].getFirst();
+            for (u32 i = 0; i < skip; i++) {
+                link = link->getNext();
+            }
+            mMgr->forceDeleteEmitter(link->getObject());
+        }
+        while (mMgr->getEmitterNumber() < EMTR_NUM) {
+            create(script);
+        }
+
+        mPtclNum += mMgr->getParticleNumber();
+        double start = host_seconds();
+        mMgr->calc(0);
+        mTime += host_seconds() - start;
+    }
+};
+
+static int l_frame;
+
+static void compareParticles(const char* what, int index, JPAList<JPABaseParticle>& a,
+                             JPAList<JPABaseParticle>& b) {
+    HOST_CHECK(a.getNum() == b.getNum(), "frame %d: emitter %d has %u/%u %s particles", l_frame,
+               index, (u32)a.getNum(), (u32)b.getNum(), what);
+    JPANode<JPABaseParticle>* na = a.getFirst();
+    JPANode<JPABaseParticle>* nb = b.getFirst();
+    for (; na != NULL && nb != NULL; na = na->getNext(), nb = nb->getNext()) {
+        HOST_CHECK(memcmp(na->getObject(), nb->getObject(), sizeof(JPABaseParticle)) == 0,
+                   "frame %d: emitter %d %s particle differs", l_frame, index, what);
+    }
+}
+
+#define EMITTER_RANGE(first, last)                                                                 \
+    __builtin_offsetof(JPABaseEmitter, first), __builtin_offsetof(JPABaseEmitter, last)
+
+static void compareFrame(Run* runA, Run* runB) {
+    JPAEmitterManager* a = runA->mMgr;
+    JPAEmitterManager* b = runB->mMgr;
+    HOST_CHECK(a->getEmitterNumber() == b->getEmitterNumber(), "frame %d: %d/%d emitters",
+               l_frame, a->getEmitterNumber(), b->getEmitterNumber());
+    HOST_CHECK(a->getParticleNumber() == b->getParticleNumber(), "frame %d: %d/%d particles",
+               l_frame, a->getParticleNumber(), b->getParticleNumber());
+
+    // Everything but the links and pointers, which differ between the managers.
+    static const size_t ranges[][2] = {
+        {EMITTER_RANGE(mLocalScl, mLink)},
+        {EMITTER_RANGE(mGlobalRot, mAlivePtclBase)},
+        {EMITTER_RANGE(mStatus, mGroupID)},
+    };
+
+    JSULink<JPABaseEmitter>* la = a->pEmtrUseList[0].getFirst();
+    JSULink<JPABaseEmitter>* lb = b->pEmtrUseList[0].getFirst();
+    for (int i = 0; la != NULL && lb != NULL; la = la->getNext(), lb = lb->getNext(), i++) {
+        JPABaseEmitter* ea = la->getObject();
+        JPABaseEmitter* eb = lb->getObject();
+        HOST_CHECK(ea->pRes->getUsrIdx() == eb->pRes->getUsrIdx(),
+                   "frame %d: emitter %d resource", l_frame, i);
+        for (int j = 0; j < 3; j++) {
+            HOST_CHECK(memcmp((u8*)ea + ranges[j][0], (u8*)eb + ranges[j][0],
+                              ranges[j][1] - ranges[j][0]) == 0,
+                       "frame %d: emitter %d differs", l_frame, i);
+        }
+        compareParticles("base", i, ea->mAlivePtclBase, eb->mAlivePtclBase);
+        compareParticles("child", i, ea->mAlivePtclChld, eb->mAlivePtclChld);
+    }
+}
+
+static Run l_runs[2];
+
+int main() {
+    Run* batched = &l_runs[0];
+    Run* perParticle = &l_runs[1];
+    batched->init(false);
+    perParticle->init(true);
+    HostRandom batchedScript(0x5C1F1);
+    HostRandom perParticleScript(0x5C1F1);
+    u32 peak = 0;
+    for (l_frame = 0; l_frame < FRAME_NUM; l_frame++) {
+        // Alternate which one runs first, so neither always finds the caches warm.
+        if (l_frame & 1) {
+            perParticle->frame(perParticleScript);
+            batched->frame(batchedScript);
+        } else {
+            batched->frame(batchedScript);
+            perParticle->frame(perParticleScript);
+        }
+        compareFrame(batched, perParticle);
+        if (batched->mMgr->getParticleNumber() > (int)peak) {
+            peak = batched->mMgr->getParticleNumber();
+        }
+    }
+    HOST_CHECK(peak < PTCL_NUM, "the pool ran dry");
+
+    printf("%d frames, %d emitters, up to %u particles\n", FRAME_NUM, EMTR_NUM, peak);
+    printf("per particle: %.0f particles/ms\n", perParticle->mPtclNum / (perParticle->mTime * 1e3));
+    printf("batched:      %.0f particles/ms\n", batched->mPtclNum / (batched->mTime * 1e3));
+    return host_check_result("jpa_field_batch");
+}
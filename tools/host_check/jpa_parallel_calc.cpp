@@ -0,0 +1,594 @@
+// Checks the ENABLE_JPA_PARALLEL_CALC emitter calc (user-012) against serial calc.
+// The JParticle sources are built for the host with the flag on, and the calc workers run on
+// real host threads. Managers play the same script over synthetic resources covering every
+// volume type, every field type, child and extra shapes, and emitters whose callbacks move,
+// spawn and delete emitters, themselves included. With a pool that never runs dry, a parallel
+// manager must hold the same emitters in the same order with bit-identical particles as a
+// serial one after every frame. With a pool too small for the script, two parallel managers
+// must still match each other byte for byte, children included, however the threads ran.
+//
+// tree: libs/JSystem/src/JParticle/JPAEmitterManager.cpp libs/JSystem/src/JParticle/JPAEmitter.cpp
+// tree: libs/JSystem/src/JParticle/JPAResource.cpp libs/JSystem/src/JParticle/JPAParticle.cpp
+// tree: libs/JSystem/src/JParticle/JPABaseShape.cpp libs/JSystem/src/JParticle/JPAExtraShape.cpp
+// tree: libs/JSystem/src/JParticle/JPAChildShape.cpp libs/JSystem/src/JParticle/JPAExTexShape.cpp
+// tree: libs/JSystem/src/JParticle/JPADynamicsBlock.cpp
+// tree: libs/JSystem/src/JParticle/JPAFieldBlock.cpp libs/JSystem/src/JParticle/JPAKeyBlock.cpp
+// tree: libs/JSystem/src/JParticle/JPAMath.cpp
+// tree: libs/JSystem/src/JSupport/JSUList.cpp libs/JSystem/src/JMath/JMATrigonometric.cpp
+// define: ENABLE_JPA_PARALLEL_CALC=1 JPA_CALC_WORKER_NUM=3 JPA_CALC_RUN_MIN=2
+// splice: libs/dolphin/src/mtx/mtx.c C_MTXIdentity C_MTXCopy C_MTXConcat C_MTXScale C_MTXRotAxisRad
+// splice: libs/dolphin/src/mtx/mtxvec.c C_MTXMultVec C_MTXMultVecSR
+// splice: libs/dolphin/src/mtx/vec.c C_VECSquareMag C_VECMag C_VECNormalize C_VECCrossProduct
+// splice: libs/JSystem/src/JParticle/JPAResourceManager.cpp JPAResourceManager::getResource
+
+#include "host_check.h"
+
+#include "JSystem/JKernel/JKRHeap.h"
+#include "JSystem/JKernel/JKRThread.h"
+#include "JSystem/JParticle/JPABaseShape.h"
+#include "JSystem/JParticle/JPAChildShape.h"
+#include "JSystem/JParticle/JPADynamicsBlock.h"
+#include "JSystem/JParticle/JPAEmitter.h"
+#include "JSystem/JParticle/JPAEmitterManager.h"
+#include "JSystem/JParticle/JPAExtraShape.h"
+#include "JSystem/JParticle/JPAFieldBlock.h"
+#include "JSystem/JParticle/JPAParticle.h"
+#include "JSystem/JParticle/JPAResource.h"
+#include "JSystem/JParticle/JPAResourceManager.h"
+#include <dolphin/mtx.h>
+#include <dolphin/os.h>
+
+#include "splice.inc"
+
+int __float_epsilon[] = {0x34000000};
+int __float_nan[] = {0x7FC00000};
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+
+double __frsqrte(double x) {
+    return 1.0 / __builtin_sqrt(x);
+}
+
+void PSMTXIdentity(Mtx m) {
+    C_MTXIdentity(m);
+}
+void PSMTXCopy(const Mtx src, Mtx dst) {
+    C_MTXCopy(src, dst);
+}
+void PSMTXConcat(const Mtx a, const Mtx b, Mtx ab) {
+    C_MTXConcat(a, b, ab);
+}
+void PSMTXScale(Mtx m, f32 xS, f32 yS, f32 zS) {
+    C_MTXScale(m, xS, yS, zS);
+}
+void PSMTXRotAxisRad(Mtx m, const Vec* axis, f32 rad) {
+    C_MTXRotAxisRad(m, axis, rad);
+}
+void PSMTXMultVec(const Mtx m, const Vec* src, Vec* dst) {
+    C_MTXMultVec(m, src, dst);
+}
+void PSMTXMultVecSR(const Mtx m, const Vec* src, Vec* dst) {
+    C_MTXMultVecSR(m, src, dst);
+}
+f32 PSVECMag(const Vec* v) {
+    return C_VECMag(v);
+}
+void PSVECCrossProduct(const Vec* a, const Vec* b, Vec* axb) {
+    C_VECCrossProduct(a, b, axb);
+}
+}
+
+void JMAVECScaleAdd(const Vec* vec1, const Vec* vec2, Vec* dst, f32 scale) {
+    dst->x = vec1->x * scale + vec2->x;
+    dst->y = vec1->y * scale + vec2->y;
+    dst->z = vec1->z * scale + vec2->z;
+}
+
+// JPAResource::init sizes its function lists as 4 bytes per pointer, so every host
+// allocation is doubled. Memory starts zeroed so padding compares equal between runs.
+static void* hostAlloc(size_t size) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, 32, size * 2 + 32);
+    memset(ptr, 0, size * 2 + 32);
+    return ptr;
+}
+
+void* JKRHeap::alloc(u32 size, int, JKRHeap*) {
+    return hostAlloc(size);
+}
+void* operator new(size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+void* operator new[](size_t size, JKRHeap*, int) {
+    return hostAlloc(size);
+}
+
+/**
+ * Game threads run on host threads of their own, started by OSResumeThread. Message queues only
+ * count messages; a receive spins until one is there.
+ */
+struct HostThread {
+    JKRThread* mThread;
+    host_thread mHost;
+};
+
+static HostThread l_threads[8];
+static int l_threadNum;
+static OSThread l_mainThread;
+static __thread OSThread* l_currentThread;
+static u32 l_sendNum;
+
+JKRDisposer::JKRDisposer() : mLink(this) {
+    mHeap = NULL;
+}
+JKRDisposer::~JKRDisposer() {}
+
+JKRThread::JKRThread(JKRHeap* heap, u32, int message_count, int) : mThreadListLink(this) {
+    mHeap = heap;
+    mThreadRecord = (OSThread*)hostAlloc(sizeof(OSThread));
+    mMesgBuffer = NULL;
+    mMessageCount = message_count;
+    OSInitMessageQueue(&mMessageQueue, mMesgBuffer, mMessageCount);
+
+    HOST_CHECK(l_threadNum < 8, "too many threads");
+    l_threads[l_threadNum].mThread = this;
+    l_threadNum++;
+}
+JKRThread::~JKRThread() {}
+
+static void* runThread(void* arg) {
+    JKRThread* thread = ((HostThread*)arg)->mThread;
+    l_currentThread = thread->getThreadRecord();
+    thread->run();
+    return NULL;
+}
+
+extern "C" {
+int sched_yield();
+
+OSTick OSGetTick() {
+    return 0;
+}
+OSThread* OSGetCurrentThread() {
+    return l_currentThread != NULL ? l_currentThread : &l_mainThread;
+}
+s32 OSResumeThread(OSThread* thread) {
+    for (int i = 0; i < l_threadNum; i++) {
+        if (l_threads[i].mThread->getThreadRecord() == thread) {
+            l_threads[i].mHost = host_thread_start(runThread, &l_threads[i]);
+        }
+    }
+    return 0;
+}
+
+void OSInitMessageQueue(OSMessageQueue* mq, void*, s32) {
+    mq->usedCount = 0;
+}
+int OSSendMessage(OSMessageQueue* mq, void*, s32) {
+    __atomic_fetch_add(&mq->usedCount, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&l_sendNum, 1, __ATOMIC_RELAXED);
+    return TRUE;
+}
+int OSReceiveMessage(OSMessageQueue* mq, void* msg, s32) {
+    for (;;) {
+        s32 num = __atomic_load_n(&mq->usedCount, __ATOMIC_SEQ_CST);
+        if (num != 0 && __atomic_compare_exchange_n(&mq->usedCount, &num, num - 1, false,
+                                                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+            break;
+        }
+        sched_yield();
+    }
+    if (msg != NULL) {
+        *(OSMessage*)msg = NULL;
+    }
+    return TRUE;
+}
+}
+
+static const int RES_NUM = 24;
+static const int EMTR_NUM = 160;
+static const int FRAME_NUM = 900;
+static const int CALLBACK_MAX = 0x2000;
+
+/** Resource blocks, laid out like the headers the JParticle sources read them through. */
+struct ResourceData {
+    JPABaseShapeData mBsp;
+    JPADynamicsBlockData mDyn;
+    JPAExtraShapeData mEsp;
+    JPAChildShapeData mCsp;
+    JPAFieldBlockData mFld[3];
+    bool mHasEsp;
+    bool mHasCsp;
+    u8 mFldNum;
+};
+
+static f32 range(HostRandom& rnd, f32 lo, f32 hi) {
+    return lo + (hi - lo) * rnd.unit();
+}
+
+static void makeResourceData(ResourceData* data, int no, HostRandom& rnd) {
+    memset(data, 0, sizeof(ResourceData));
+
+    JPABaseShapeData& bsp = data->mBsp;
+    bsp.mFlags = rnd.below(10) | rnd.below(7) << 4 | rnd.below(5) << 7;
+    bsp.mBaseSizeX = range(rnd, 5.0f, 30.0f);
+    bsp.mBaseSizeY = range(rnd, 5.0f, 30.0f);
+    bsp.mClrPrm.r = rnd.below(256);
+    bsp.mClrPrm.a = 0xFF;
+    bsp.mClrEnv.g = rnd.below(256);
+    bsp.mClrEnv.a = 0xFF;
+    bsp.mAnmRndm = rnd.below(256);
+
+    JPADynamicsBlockData& dyn = data->mDyn;
+    dyn.mFlags = (no % 7) << 8 | rnd.below(0x20);
+    if (no % 7 == 1) {
+        // The first fixed interval point on a sphere divides by zero, which only PPC shrugs off.
+        dyn.mFlags &= ~JPADynFlag_FixedInterval;
+    }
+    dyn.mEmitterScl.set(1.0f, 1.0f, 1.0f);
+    dyn.mEmitterDir.set(range(rnd, -1.0f, 1.0f), 1.0f, range(rnd, -1.0f, 1.0f));
+    dyn.mInitialVelOmni = range(rnd, 0.0f, 3.0f);
+    dyn.mInitialVelAxis = range(rnd, 0.0f, 2.0f);
+    dyn.mInitialVelRndm = range(rnd, 0.0f, 1.0f);
+    dyn.mInitialVelDir = range(rnd, 0.0f, 4.0f);
+    dyn.mSpread = range(rnd, 0.0f, 0.5f);
+    dyn.mInitialVelRatio = range(rnd, 0.0f, 1.0f);
+    dyn.mRate = range(rnd, 0.5f, 6.0f);
+    dyn.mRateRndm = range(rnd, 0.0f, 0.5f);
+    dyn.mLifeTimeRndm = range(rnd, 0.0f, 0.5f);
+    dyn.mVolumeSweep = range(rnd, 0.3f, 1.0f);
+    dyn.mVolumeMinRad = range(rnd, 0.0f, 0.5f);
+    dyn.mAirResist = range(rnd, 0.9f, 1.0f);
+    dyn.mMoment = range(rnd, 0.0f, 1.0f);
+    dyn.mEmitterRot.set(rnd.next(), rnd.next(), rnd.next());
+    dyn.mMaxFrame = rnd.below(3) == 0 ? 0 : 30 + rnd.below(200);
+    dyn.mStartFrame = rnd.below(6);
+    dyn.mLifeTime = 15 + rnd.below(70);
+    dyn.mVolumeSize = 5 + rnd.below(60);
+    dyn.mDivNumber = 2 + rnd.below(16);
+    dyn.mRateStep = rnd.below(3);
+
+    data->mHasEsp = rnd.below(2) == 0;
+    JPAExtraShapeData& esp = data->mEsp;
+    esp.mFlags = rnd.below(4) | rnd.below(3) << 8 | rnd.below(3) << 10 | rnd.below(4) << 12 |
+                 rnd.below(4) << 14 | rnd.below(4) << 16 | rnd.below(2) << 24;
+    esp.mScaleInTiming = range(rnd, 0.0f, 0.4f);
+    esp.mScaleOutTiming = range(rnd, 0.6f, 1.0f);
+    esp.mScaleInValueX = range(rnd, 0.0f, 1.0f);
+    esp.mScaleOutValueX = range(rnd, 0.0f, 2.0f);
+    esp.mScaleInValueY = range(rnd, 0.0f, 1.0f);
+    esp.mScaleOutValueY = range(rnd, 0.0f, 2.0f);
+    esp.mScaleOutRandom = range(rnd, 0.0f, 0.5f);
+    esp.mScaleAnmCycleX = 1 + rnd.below(20);
+    esp.mScaleAnmCycleY = 1 + rnd.below(20);
+    esp.mAlphaInTiming = range(rnd, 0.0f, 0.4f);
+    esp.mAlphaOutTiming = range(rnd, 0.6f, 1.0f);
+    esp.mAlphaInValue = range(rnd, 0.0f, 1.0f);
+    esp.mAlphaBaseValue = range(rnd, 0.0f, 1.0f);
+    esp.mAlphaOutValue = range(rnd, 0.0f, 1.0f);
+    esp.mAlphaWaveFrequency = range(rnd, 0.0f, 1.0f);
+    esp.mAlphaWaveRandom = range(rnd, 0.0f, 1.0f);
+    esp.mAlphaWaveAmplitude = range(rnd, 0.0f, 1.0f);
+    esp.mRotateAngle = range(rnd, 0.0f, 1.0f);
+    esp.mRotateAngleRandom = range(rnd, 0.0f, 1.0f);
+    esp.mRotateSpeed = range(rnd, 0.0f, 0.2f);
+    esp.mRotateSpeedRandom = range(rnd, 0.0f, 1.0f);
+    esp.mRotateDirection = range(rnd, 0.0f, 1.0f);
+
+    data->mHasCsp = rnd.below(3) == 0;
+    JPAChildShapeData& csp = data->mCsp;
+    csp.mFlags = rnd.below(10) | rnd.below(7) << 4 | rnd.below(5) << 7 | rnd.below(0x200) << 16;
+    csp.mPosRndm = range(rnd, 0.0f, 5.0f);
+    csp.mBaseVel = range(rnd, 0.0f, 2.0f);
+    csp.mBaseVelRndm = range(rnd, 0.0f, 1.0f);
+    csp.mVelInfRate = range(rnd, 0.0f, 1.0f);
+    csp.mGravity = range(rnd, -0.5f, 0.0f);
+    csp.mScaleX = range(rnd, 0.5f, 2.0f);
+    csp.mScaleY = range(rnd, 0.5f, 2.0f);
+    csp.mInheritScale = range(rnd, 0.0f, 1.0f);
+    csp.mInheritAlpha = range(rnd, 0.0f, 1.0f);
+    csp.mInheritRGB = range(rnd, 0.0f, 1.0f);
+    csp.mPrmClr.b = rnd.below(256);
+    csp.mEnvClr.r = rnd.below(256);
+    csp.mTiming = range(rnd, 0.6f, 1.0f);
+    csp.mLife = 5 + rnd.below(15);
+    csp.mRate = 1 + rnd.below(2);
+    csp.mStep = 2 + rnd.below(4);
+    csp.mRotSpeed = rnd.below(0x800);
+
+    // Every field type shows up, several times over.
+    data->mFldNum = rnd.below(4);
+    for (int i = 0; i < data->mFldNum; i++) {
+        JPAFieldBlockData& fld = data->mFld[i];
+        fld.mFlags = (no * 3 + i) % 9 | rnd.below(3) << 8 | rnd.below(0x10) << 16;
+        fld.mPos.set(range(rnd, -50.0f, 50.0f), range(rnd, -50.0f, 50.0f),
+                     range(rnd, -50.0f, 50.0f));
+        fld.mDir.set(range(rnd, -1.0f, 1.0f), range(rnd, -1.0f, 1.0f), range(rnd, -1.0f, 1.0f));
+        fld.mMag = range(rnd, 0.01f, 1.0f);
+        fld.mMagRndm = range(rnd, 0.0f, 0.5f);
+        fld.mVal1 = range(rnd, 0.0f, 1.0f);
+        fld.mFadeInTime = range(rnd, 0.0f, 0.3f);
+        fld.mFadeOutTime = range(rnd, 0.7f, 1.0f);
+        fld.mEnTime = 0.0f;
+        fld.mDisTime = 1.0f;
+        fld.mCycle = rnd.below(8);
+    }
+}
+
+static JPAResource* makeResource(const ResourceData* data, int no) {
+    JPAResource* res = new (NULL, 0) JPAResource();
+    res->pBsp = new (NULL, 0) JPABaseShape((const u8*)&data->mBsp, NULL);
+    res->pDyn = new (NULL, 0) JPADynamicsBlock((const u8*)&data->mDyn);
+    if (data->mHasEsp) {
+        res->pEsp = new (NULL, 0) JPAExtraShape((const u8*)&data->mEsp);
+    }
+    if (data->mHasCsp) {
+        res->pCsp = new (NULL, 0) JPAChildShape((const u8*)&data->mCsp);
+    }
+    if (data->mFldNum != 0) {
+        res->ppFld = new (NULL, 0) JPAFieldBlock*[data->mFldNum];
+        for (int i = 0; i < data->mFldNum; i++) {
+            res->ppFld[i] = new (NULL, 0) JPAFieldBlock((const u8*)&data->mFld[i], NULL);
+        }
+    }
+    res->fldNum = data->mFldNum;
+    res->mUsrIdx = no;
+    res->init(NULL);
+    return res;
+}
+
+struct Run;
+
+/**
+ * Emitter callback that moves its emitter after the one before it in the list, and now and then
+ * spawns an emitter or deletes itself.
+ */
+struct ScriptCallBack : public JPAEmitterCallBack {
+    HostRandom mRnd;
+    Run* mRun;
+
+    ScriptCallBack() : mRnd(1), mRun(NULL) {}
+    virtual void execute(JPABaseEmitter*);
+    virtual void executeAfter(JPABaseEmitter*);
+};
+
+/** Particle callback that damps its particle. */
+struct DampCallBack : public JPAParticleCallBack {
+    virtual void execute(JPABaseEmitter*, JPABaseParticle* ptcl) {
+        ptcl->mVelocity.x *= 0.98f;
+        ptcl->mVelocity.y *= 0.98f;
+        ptcl->mVelocity.z *= 0.98f;
+    }
+};
+
+/** One manager playing the script. */
+struct Run {
+    JPAEmitterManager* mMgr;
+    JPAResourceManager* mResMgr;
+    ResourceData mData[RES_NUM];
+    ScriptCallBack mEmtrCB[CALLBACK_MAX];
+    DampCallBack mPtclCB;
+    int mCallBackNum;
+    u32 mSpawnNum;
+    u32 mSelfDeleteNum;
+    u32 mPeak;
+
+    void init(u32 ptclNum, bool parallel) {
+        mMgr = new (NULL, 0) JPAEmitterManager(ptclNum, EMTR_NUM, NULL, 1, 1);
+        mResMgr = (JPAResourceManager*)hostAlloc(sizeof(JPAResourceManager));
+        mResMgr->pResAry = new (NULL, 0) JPAResource*[RES_NUM];
+        HostRandom rnd(0x4A5041);
+        for (int i = 0; i < RES_NUM; i++) {
+            makeResourceData(&mData[i], i, rnd);
+            mResMgr->pResAry[i] = makeResource(&mData[i], i);
+        }
+        mResMgr->resMaxNum = mResMgr->resRegNum = RES_NUM;
+        mMgr->entryResourceManager(mResMgr, 0);
+        if (parallel) {
+            mMgr->startCalcWorker(NULL, 0);
+        }
+        mCallBackNum = 0;
+        mSpawnNum = 0;
+        mSelfDeleteNum = 0;
+        mPeak = 0;
+    }
+
+    /** Creates an emitter picked by rnd, a quarter of them with an emitter callback. */
+    void create(HostRandom& rnd, const JGeometry::TVec3<f32>& pos) {
+        u16 res = rnd.below(RES_NUM);
+        u32 kind = rnd.below(8);
+        JPAEmitterCallBack* emtrCB = NULL;
+        JPAParticleCallBack* ptclCB = NULL;
+        if (kind < 2 && mCallBackNum < CALLBACK_MAX) {
+            ScriptCallBack* cb = &mEmtrCB[mCallBackNum];
+            cb->mRnd = HostRandom(0x1000 + mCallBackNum);
+            cb->mRun = this;
+            mCallBackNum++;
+            emtrCB = cb;
+        } else if (kind == 2) {
+            ptclCB = &mPtclCB;
+        }
+        HOST_CHECK(mMgr->createSimpleEmitterID(pos, res, 0, 0, emtrCB, ptclCB) != NULL,
+                   "ran out of emitters");
+    }
+
+    void frame(HostRandom& script) {
+        u32 spawn = script.below(4);
+        for (u32 i = 0; i < spawn; i++) {
+            JGeometry::TVec3<f32> pos(range(script, -100.0f, 100.0f), range(script, 0.0f, 50.0f),
+                                      range(script, -100.0f, 100.0f));
+            create(script, pos);
+        }
+
+        // The game deletes emitters from outside calc too. Deleting down to a third of the
+        // emitters keeps spawns from callbacks from running out of them.
+        u32 deleteNum = script.below(16) == 0 ? 1 : 0;
+        if (mMgr->getEmitterNumber() > EMTR_NUM / 3) {
+            deleteNum = mMgr->getEmitterNumber() - EMTR_NUM / 3;
+        }
+        for (; deleteNum != 0 && mMgr->getEmitterNumber() != 0; deleteNum--) {
+            u32 skip = script.below(mMgr->getEmitterNumber());
+            JSULink<JPABaseEmitter>* link = mMgr->pEmtrUseList[0].getFirst();
+            for (u32 i = 0; i < skip; i++) {
+                link = link->getNext();
+            }
+            mMgr->forceDeleteEmitter(link->getObject());
+        }
+
+        mMgr->calc(0);
+        if (mMgr->getParticleNumber() > (int)mPeak) {
+            mPeak = mMgr->getParticleNumber();
+        }
+    }
+};
+
+void ScriptCallBack::execute(JPABaseEmitter* emtr) {
+    emtr->mGlobalTrs.x += range(mRnd, -1.0f, 1.0f);
+    emtr->mGlobalTrs.z += range(mRnd, -1.0f, 1.0f);
+
+    // Follows the particles of the emitter before it, which serial calc has already moved.
+    JSULink<JPABaseEmitter>* prev = emtr->mLink.getPrev();
+    if (prev != NULL) {
+        JPANode<JPABaseParticle>* node = prev->getObject()->mAlivePtclBase.getFirst();
+        if (node != NULL) {
+            emtr->mGlobalTrs.y = node->getObject()->mPosition.y;
+        }
+    }
+
+    u32 roll = mRnd.below(1000);
+    if (roll < 6) {
+        mRun->mSelfDeleteNum++;
+        emtr->mpEmtrMgr->forceDeleteEmitter(emtr);
+    } else if (roll < 30) {
+        mRun->mSpawnNum++;
+        mRun->create(mRnd, emtr->mGlobalTrs);
+    }
+}
+
+void ScriptCallBack::executeAfter(JPABaseEmitter* emtr) {
+    if (mRnd.below(500) == 0) {
+        emtr->becomeInvalidEmitter();
+    }
+}
+
+static int l_frame;
+static const char* l_pair;
+static bool l_exactChild;
+
+static void compareBytes(const char* what, int index, const void* a, const void* b, size_t size) {
+    HOST_CHECK(memcmp(a, b, size) == 0, "%s, frame %d: %s %d differs", l_pair, l_frame, what,
+               index);
+}
+
+static void compareParticles(const char* what, int index, JPAList<JPABaseParticle>& a,
+                             JPAList<JPABaseParticle>& b, bool child) {
+    HOST_CHECK(a.getNum() == b.getNum(), "%s, frame %d: emitter %d has %u/%u %s particles",
+               l_pair, l_frame, index, (u32)a.getNum(), (u32)b.getNum(), what);
+    JPANode<JPABaseParticle>* na = a.getFirst();
+    JPANode<JPABaseParticle>* nb = b.getFirst();
+    for (; na != NULL && nb != NULL; na = na->getNext(), nb = nb->getNext()) {
+        JPABaseParticle pa;
+        JPABaseParticle pb;
+        memcpy(&pa, na->getObject(), sizeof(JPABaseParticle));
+        memcpy(&pb, nb->getObject(), sizeof(JPABaseParticle));
+        if (child && !l_exactChild) {
+            // init_c leaves these to whatever the pool node last held.
+            pa.mEnvClr.a = pb.mEnvClr.a = 0;
+            pa.mTexAnmIdx = pb.mTexAnmIdx = 0;
+            pa.mAnmRandom = pb.mAnmRandom = 0;
+        }
+        compareBytes(what, index, &pa, &pb, sizeof(JPABaseParticle));
+    }
+}
+
+#define EMITTER_RANGE(first, last)                                                                 \
+    __builtin_offsetof(JPABaseEmitter, first), __builtin_offsetof(JPABaseEmitter, last)
+
+static void compareFrame(Run* runA, Run* runB) {
+    JPAEmitterManager* a = runA->mMgr;
+    JPAEmitterManager* b = runB->mMgr;
+    HOST_CHECK(a->getEmitterNumber() == b->getEmitterNumber(), "%s, frame %d: %d/%d emitters",
+               l_pair, l_frame, a->getEmitterNumber(), b->getEmitterNumber());
+    HOST_CHECK(a->getParticleNumber() == b->getParticleNumber(), "%s, frame %d: %d/%d particles",
+               l_pair, l_frame, a->getParticleNumber(), b->getParticleNumber());
+
+    // Everything but the links and pointers, which differ between the managers.
+    static const size_t ranges[][2] = {
+        {EMITTER_RANGE(mLocalScl, mLink)},
+        {EMITTER_RANGE(mGlobalRot, mAlivePtclBase)},
+        {EMITTER_RANGE(mStatus, mGroupID)},
+    };
+
+    JSULink<JPABaseEmitter>* la = a->pEmtrUseList[0].getFirst();
+    JSULink<JPABaseEmitter>* lb = b->pEmtrUseList[0].getFirst();
+    for (int i = 0; la != NULL && lb != NULL; la = la->getNext(), lb = lb->getNext(), i++) {
+        JPABaseEmitter* ea = la->getObject();
+        JPABaseEmitter* eb = lb->getObject();
+        HOST_CHECK(ea->pRes->getUsrIdx() == eb->pRes->getUsrIdx(),
+                   "%s, frame %d: emitter %d resource", l_pair, l_frame, i);
+        for (int j = 0; j < 3; j++) {
+            compareBytes("emitter", i, (u8*)ea + ranges[j][0], (u8*)eb + ranges[j][0],
+                         ranges[j][1] - ranges[j][0]);
+        }
+        compareParticles("base", i, ea->mAlivePtclBase, eb->mAlivePtclBase, false);
+        compareParticles("child", i, ea->mAlivePtclChld, eb->mAlivePtclChld, true);
+    }
+}
+
+static Run l_runs[5];
+
+int main() {
+    // Finds how many particles the script needs, then sizes the small pool well below that.
+    Run* probe = &l_runs[0];
+    probe->init(0x10000, false);
+    HostRandom probeScript(0x5C121);
+    for (int i = 0; i < FRAME_NUM; i++) {
+        probe->frame(probeScript);
+    }
+    u32 smallNum = probe->mPeak * 3 / 4;
+
+    Run* serial = &l_runs[1];
+    Run* parallel = &l_runs[2];
+    Run* smallA = &l_runs[3];
+    Run* smallB = &l_runs[4];
+    serial->init(0x10000, false);
+    parallel->init(0x10000, true);
+    smallA->init(smallNum, true);
+    smallB->init(smallNum, true);
+    HostRandom serialScript(0x5C121);
+    HostRandom parallelScript(0x5C121);
+    HostRandom smallAScript(0x5C121);
+    HostRandom smallBScript(0x5C121);
+    u32 emtrPeak = 0;
+    u32 dryFrameNum = 0;
+    for (l_frame = 0; l_frame < FRAME_NUM; l_frame++) {
+        serial->frame(serialScript);
+        parallel->frame(parallelScript);
+        smallA->frame(smallAScript);
+        smallB->frame(smallBScript);
+        l_pair = "parallel";
+        l_exactChild = false;
+        compareFrame(serial, parallel);
+        l_pair = "small pool";
+        l_exactChild = true;
+        compareFrame(smallA, smallB);
+        if (serial->mMgr->getEmitterNumber() > (int)emtrPeak) {
+            emtrPeak = serial->mMgr->getEmitterNumber();
+        }
+        if (smallA->mMgr->getParticleNumber() < serial->mMgr->getParticleNumber()) {
+            dryFrameNum++;
+        }
+    }
+    HOST_CHECK(l_sendNum != 0, "no emitter run was spread over the slots");
+    HOST_CHECK(dryFrameNum != 0, "the small pool never ran dry");
+
+    printf("%d frames, %d slots, up to %u emitters\n", FRAME_NUM, JPA_CALC_WORKER_NUM, emtrPeak);
+    printf("up to %u particles; the pool of %u fell short in %u frames\n", serial->mPeak,
+           smallNum, dryFrameNum);
+    printf("%d emitter callbacks, %u spawned and %u self-deleted from callbacks\n",
+           serial->mCallBackNum, serial->mSpawnNum, serial->mSelfDeleteNum);
+    printf("%u worker wake-ups and completions\n", l_sendNum);
+    return host_check_result("jpa_parallel_calc");
+}
@@ -0,0 +1,287 @@
+// Plays BCK and BTK key animations with and without ENABLE_KEY_CURSOR's per-channel key
+// cursors (user-021). The cursors belong to the animation's user (the morf or the material
+// animation binding), so one loaded animation is shared here by several actors, each passing
+// its own cursor array at its own frame; the reference passes no cursor and takes the plain
+// binary search. Every joint transform and texture SRT must match bit for bit at every sampled
+// frame. Prints the time per animation sample of both.
+//
+// The files are made up, since the loader reads them natively and no game data ships with
+// the repository. They hold 60 joints and 24 texture matrices whose channels have 0 to 40
+// keys of either tangent layout, with repeated key times here and there. The first quarter of
+// the samples is one actor alone; after that four actors take turns, each played forward,
+// backward, at several rates and with random seeks.
+//
+// tree: libs/JSystem/src/J3DGraphAnimator/J3DAnimation.cpp
+// tree: libs/JSystem/src/J3DGraphLoader/J3DAnmLoader.cpp libs/JSystem/src/JUtility/JUTNameTab.cpp
+// define: ENABLE_KEY_CURSOR=1
+
+#include "host_check.h"
+
+#include "JSystem/J3DGraphAnimator/J3DAnimation.h"
+#include "JSystem/J3DGraphBase/J3DStruct.h"
+#include "JSystem/J3DGraphBase/J3DTransform.h"
+#include "JSystem/J3DGraphLoader/J3DAnmLoader.h"
+
+static const int JOINT_NUM = 60;
+static const int TEX_MTX_NUM = 24;
+static const int FRAME_MAX = 120;
+static const int STEP_NUM = 6000;
+static const int ACTOR_NUM = 4;
+static const u32 FILE_SIZE = 0x80000;
+
+/** Builds a key file: the file header, one block and the data the block points to. */
+struct KeyWriter {
+    u8* mBuf;
+    u32 mSize;
+    u32 mBlock;
+
+    KeyWriter(u32 type, u32 blockSize) {
+        mBuf = new u8[FILE_SIZE];
+        memset(mBuf, 0, FILE_SIZE);
+        JUTDataFileHeader* header = (JUTDataFileHeader*)mBuf;
+        header->mMagic = 'J3D1';
+        header->mType = type;
+        header->mBlockNum = 1;
+        mBlock = 0x20;
+        mSize = mBlock + ((blockSize + 0x1F) & ~0x1F);
+    }
+
+    void* block() { return mBuf + mBlock; }
+
+    /** Reserves size bytes and returns their offset from the block. */
+    u32 alloc(u32 size) {
+        u32 offset = mSize - mBlock;
+        mSize = (mSize + size + 3) & ~3;
+        if (mSize > FILE_SIZE) {
+            printf("key file is too big\n");
+            exit(1);
+        }
+        return offset;
+    }
+
+    void* at(u32 offset) { return mBuf + mBlock + offset; }
+};
+
+/** Key values for one kind of channel, and the tables indexing into them. */
+template <typename T>
+struct KeyPool {
+    T mData[0x8000];
+    u32 mNum;
+
+    KeyPool() : mNum(0) {}
+
+    /** Appends a random channel and points table at it. */
+    void add(HostRandom& random, J3DAnmKeyTableBase* table, f32 range) {
+        u32 keyNum = random.below(8) == 0 ? random.below(2) : 2 + random.below(39);
+        u32 stride = random.below(2) == 0 ? 3 : 4;
+        table->mMaxFrame = keyNum;
+        table->mOffset = mNum;
+        table->mType = stride == 3 ? 0 : 1;
+        if (keyNum == 1) {
+            mData[mNum++] = (T)(random.unit() * range);
+            return;
+        }
+
+        f32 time = random.below(4);
+        for (u32 i = 0; i < keyNum; i++) {
+            if (i != 0 && random.below(6) != 0) {
+                time += 1 + random.below(8);
+            }
+            if (time > FRAME_MAX) {
+                time = FRAME_MAX;
+            }
+            mData[mNum++] = (T)time;
+            for (u32 j = 1; j < stride; j++) {
+                mData[mNum++] = (T)((random.unit() * 2.0f - 1.0f) * range);
+            }
+        }
+    }
+
+    u32 write(KeyWriter& file) {
+        u32 offset = file.alloc(mNum * sizeof(T));
+        memcpy(file.at(offset), mData, mNum * sizeof(T));
+        return offset;
+    }
+};
+
+static KeyPool<f32> l_scale;
+static KeyPool<s16> l_rot;
+static KeyPool<f32> l_trans;
+
+static void fillTables(HostRandom& random, J3DAnmTransformKeyTable* tables, u32 num) {
+    l_scale.mNum = l_rot.mNum = l_trans.mNum = 0;
+    for (u32 i = 0; i < num; i++) {
+        l_scale.add(random, &tables[i].mScaleInfo, 2.0f);
+        l_rot.add(random, &tables[i].mRotationInfo, 32767.0f);
+        l_trans.add(random, &tables[i].mTranslateInfo, 500.0f);
+    }
+}
+
+static void writeTransform(u32 seed, KeyWriter& file) {
+    HostRandom random(seed);
+    J3DAnmTransformKeyData* data = (J3DAnmTransformKeyData*)file.block();
+    data->mHeader.mType = 'ANK1';
+    data->mFrameMax = FRAME_MAX;
+    data->field_0xc = JOINT_NUM;
+
+    u32 tableOffset = file.alloc(JOINT_NUM * 3 * sizeof(J3DAnmTransformKeyTable));
+    fillTables(random, (J3DAnmTransformKeyTable*)file.at(tableOffset), JOINT_NUM * 3);
+    data->mTableOffset = (void*)(size_t)tableOffset;
+    data->field_0x18 = (void*)(size_t)l_scale.write(file);
+    data->field_0x1c = (void*)(size_t)l_rot.write(file);
+    data->field_0x20 = (void*)(size_t)l_trans.write(file);
+    data->mHeader.mSize = file.mSize - file.mBlock;
+}
+
+static void writeTextureSRT(u32 seed, KeyWriter& file) {
+    HostRandom random(seed);
+    J3DAnmTextureSRTKeyData* data = (J3DAnmTextureSRTKeyData*)file.block();
+    data->mHeader.mType = 'TTK1';
+    data->field_0xa = FRAME_MAX;
+    data->field_0xc = TEX_MTX_NUM * 3;
+
+    u32 tableOffset = file.alloc(TEX_MTX_NUM * 3 * sizeof(J3DAnmTransformKeyTable));
+    fillTables(random, (J3DAnmTransformKeyTable*)file.at(tableOffset), TEX_MTX_NUM * 3);
+    data->mTableOffset = (void*)(size_t)tableOffset;
+    data->mScaleValOffset = (void*)(size_t)l_scale.write(file);
+    data->mRotValOffset = (void*)(size_t)l_rot.write(file);
+    data->mTransValOffset = (void*)(size_t)l_trans.write(file);
+    data->mHeader.mNextOffset = file.mSize - file.mBlock;
+}
+
+/** The frames and actors both versions are sampled at: see the comment at the top. */
+static void makeFrames(HostRandom& random, f32* frames, int* actors) {
+    f32 frame[ACTOR_NUM];
+    f32 rate[ACTOR_NUM];
+    for (int actor = 0; actor < ACTOR_NUM; actor++) {
+        frame[actor] = FRAME_MAX * actor / ACTOR_NUM;
+        rate[actor] = actor & 1 ? 1.0f : 0.5f;
+    }
+    for (int i = 0; i < STEP_NUM; i++) {
+        int actor = i >= STEP_NUM / 4 ? i % ACTOR_NUM : 0;
+        if (random.below(500) == 0) {
+            frame[actor] = random.unit() * (FRAME_MAX + 10) - 5;
+        } else if (random.below(300) == 0) {
+            static const f32 rates[] = {0.25f, 0.5f, 1.0f, 1.5f, 3.0f, -0.5f, -1.0f};
+            rate[actor] = rates[random.below(7)];
+        }
+        frame[actor] += rate[actor];
+        if (frame[actor] >= FRAME_MAX + 3) {
+            frame[actor] -= FRAME_MAX + 5;
+        } else if (frame[actor] < -2) {
+            frame[actor] += FRAME_MAX + 5;
+        }
+        frames[i] = frame[actor];
+        actors[i] = actor;
+    }
+}
+
+static f32 l_frames[STEP_NUM];
+static int l_actors[STEP_NUM];
+
+/** Each actor's cursors, as its morf or J3DTexMtxAnm would keep them. */
+static u16 l_bckCursor[ACTOR_NUM][JOINT_NUM * J3DAnmTransformKey::KEY_CURSOR_NUM];
+static u16 l_btkCursor[ACTOR_NUM][TEX_MTX_NUM * 5];
+
+static void checkTransform(J3DAnmTransformKey* anm, double* time) {
+    memset(l_bckCursor, 0, sizeof(l_bckCursor));
+    for (int i = 0; i < STEP_NUM; i++) {
+        u16* cursor = l_bckCursor[l_actors[i]];
+        for (u16 joint = 0; joint < JOINT_NUM; joint++) {
+            J3DTransformInfo a, b;
+            memset(&a, 0, sizeof(a));
+            memset(&b, 0, sizeof(b));
+            anm->calcTransform(l_frames[i], joint, &a,
+                               &cursor[joint * J3DAnmTransformKey::KEY_CURSOR_NUM]);
+            anm->calcTransform(l_frames[i], joint, &b);
+            HOST_CHECK(memcmp(&a, &b, sizeof(a)) == 0, "bck frame %g joint %d differs",
+                       l_frames[i], joint);
+        }
+    }
+
+    J3DTransformInfo info;
+    volatile f32 sink = 0.0f;
+    for (int pass = 0; pass < 2; pass++) {
+        memset(l_bckCursor, 0, sizeof(l_bckCursor));
+        double start = host_seconds();
+        for (int i = 0; i < STEP_NUM; i++) {
+            u16* cursor = pass == 0 ? NULL : l_bckCursor[l_actors[i]];
+            for (u16 joint = 0; joint < JOINT_NUM; joint++) {
+                anm->calcTransform(l_frames[i], joint, &info, cursor);
+                sink = sink + info.mTranslate.x;
+                if (cursor != NULL) {
+                    cursor += J3DAnmTransformKey::KEY_CURSOR_NUM;
+                }
+            }
+        }
+        time[pass] += host_seconds() - start;
+    }
+}
+
+static void checkTextureSRT(J3DAnmTextureSRTKey* anm, double* time) {
+    memset(l_btkCursor, 0, sizeof(l_btkCursor));
+    for (int i = 0; i < STEP_NUM; i++) {
+        u16* cursor = l_btkCursor[l_actors[i]];
+        for (u16 mtx = 0; mtx < TEX_MTX_NUM; mtx++) {
+            J3DTextureSRTInfo a, b;
+            memset(&a, 0, sizeof(a));
+            memset(&b, 0, sizeof(b));
+            anm->calcTransform(l_frames[i], mtx, &a, &cursor[mtx * 5]);
+            anm->calcTransform(l_frames[i], mtx, &b);
+            HOST_CHECK(memcmp(&a, &b, sizeof(a)) == 0, "btk frame %g matrix %d differs",
+                       l_frames[i], mtx);
+        }
+    }
+
+    J3DTextureSRTInfo info;
+    volatile f32 sink = 0.0f;
+    for (int pass = 0; pass < 2; pass++) {
+        memset(l_btkCursor, 0, sizeof(l_btkCursor));
+        double start = host_seconds();
+        for (int i = 0; i < STEP_NUM; i++) {
+            u16* cursor = pass == 0 ? NULL : l_btkCursor[l_actors[i]];
+            for (u16 mtx = 0; mtx < TEX_MTX_NUM; mtx++) {
+                anm->calcTransform(l_frames[i], mtx, &info, cursor);
+                sink = sink + info.mTranslationX;
+                if (cursor != NULL) {
+                    cursor += 5;
+                }
+            }
+        }
+        time[pass] += host_seconds() - start;
+    }
+}
+
+int main() {
+    double bckTime[2] = {0.0, 0.0};
+    double btkTime[2] = {0.0, 0.0};
+    for (u32 seed = 1; seed <= 8; seed++) {
+        HostRandom random(seed * 7919);
+        makeFrames(random, l_frames, l_actors);
+
+        KeyWriter bckFile('bck1', sizeof(J3DAnmTransformKeyData));
+        writeTransform(seed, bckFile);
+        J3DAnmTransformKey* bck = (J3DAnmTransformKey*)J3DAnmLoaderDataBase::load(bckFile.mBuf);
+        HOST_CHECK(bck != NULL, "bck did not load");
+        checkTransform(bck, bckTime);
+
+        KeyWriter btkFile('btk1', sizeof(J3DAnmTextureSRTKeyData));
+        writeTextureSRT(seed, btkFile);
+        J3DAnmTextureSRTKey* btk = (J3DAnmTextureSRTKey*)J3DAnmLoaderDataBase::load(btkFile.mBuf);
+        HOST_CHECK(btk != NULL, "btk did not load");
+        checkTextureSRT(btk, btkTime);
+
+        delete bck;
+        delete btk;
+        delete[] bckFile.mBuf;
+        delete[] btkFile.mBuf;
+    }
+
+    double samples = 8.0 * STEP_NUM;
+    printf("bck: search %.1f ns, cursor %.1f ns per joint\n",
+           bckTime[0] / (samples * JOINT_NUM) * 1e9, bckTime[1] / (samples * JOINT_NUM) * 1e9);
+    printf("btk: search %.1f ns, cursor %.1f ns per texture matrix\n",
+           btkTime[0] / (samples * TEX_MTX_NUM) * 1e9,
+           btkTime[1] / (samples * TEX_MTX_NUM) * 1e9);
+    return host_check_result("key_cursor");
+}
@@ -0,0 +1,472 @@
+// Checks the ENABLE_PCM_MIX_SIMD mixing in JASCalc (user-018) against the original JASDriver
+// loops, bit for bit. The paired-single kernels cannot run on the host, so their asm blocks are
+// read from JASCalc.cpp and run by a small interpreter of the instructions they use, with the
+// GQRs OSInitFastCast sets up. Every JASDriver mix mode is run on random and full-scale
+// buffers through the original loops, the scalar fallbacks (sPairedMix cleared) and the
+// interpreted kernels, with guard samples around the output. JASCalc::mix also gets odd
+// lengths, and bcopyfast/bzerofast both the lfd/stfd path and the word path.
+//
+// Prints host throughput of the original loops and the scalar fallbacks, and how many
+// instructions the paired-single loops take per output sample. Host timings say nothing about
+// Gekko; the instruction counts are what to compare against the compiled scalar loops.
+//
+// splice: libs/JSystem/src/JAudio2/JASAiCtrl.cpp JASDriver::mixMonoTrack JASDriver::mixMonoTrackWide JASDriver::mixExtraTrack JASDriver::mixInterleaveTrack
+// splice: libs/JSystem/src/JAudio2/JASCalc.cpp JASCalc::imixcopy JASCalc::bcopyfast JASCalc::bzerofast
+// splice(simd): libs/JSystem/src/JAudio2/JASCalc.cpp JASCalc::mixMono JASCalc::mixMonoWide JASCalc::mixStereo JASCalc::mix
+// rewrite: defined(__MWERKS__) => HOST_PAIRED
+// rewrite: #ifdef __MWERKS__ => #if HOST_PAIRED
+// rewrite: reinterpret_cast<u32> => (u32)(uintptr_t)
+
+#include "host_check.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define JUT_ASSERT(...)
+#define HOST_PAIRED 1
+
+static std::string readText(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+/** Gekko GQRs: load type/scale in bits 16-29, store type/scale in bits 0-13. */
+static u32 l_gqr[8];
+
+/** Reads the GQR values OSInitFastCast moves into GQR2-5 (li, oris, mtspr). */
+static bool readFastCast(const std::string& text) {
+    static const std::regex body("OSInitFastCast\\(void\\) \\{([\\s\\S]*?)\\n\\}");
+    static const std::regex op("li r3, (\\w+)\\s+oris r3, r3, (\\w+)\\s+mtspr (\\w+), r3");
+    std::smatch match;
+    if (!std::regex_search(text, match, body)) {
+        return false;
+    }
+    std::string code = match[1];
+    int num = 0;
+    for (std::sregex_iterator it(code.begin(), code.end(), op), end; it != end; ++it, num++) {
+        u32 spr = std::stoul((*it)[3], NULL, 0);
+        u32 value = std::stoul((*it)[1], NULL, 0) | std::stoul((*it)[2], NULL, 0) << 16;
+        if (spr < 0x390 || spr > 0x397) {
+            return false;
+        }
+        l_gqr[spr - 0x390] = value;
+    }
+    return num != 0;
+}
+
+static f32 dequantize(const void* p, u32 type, int scale) {
+    f32 value;
+    switch (type) {
+    case 0: memcpy(&value, p, 4); return value;
+    case 4: value = *(const u8*)p; break;
+    case 5: value = *(const u16*)p; break;
+    case 6: value = *(const s8*)p; break;
+    case 7: value = *(const s16*)p; break;
+    default: HOST_CHECK(false, "GQR load type %u", type); return 0.0f;
+    }
+    return std::ldexp(value, -scale);
+}
+
+template <typename T>
+static T saturate(f32 value) {
+    if (!(value > std::numeric_limits<T>::min())) {
+        return std::numeric_limits<T>::min();
+    }
+    if (value >= std::numeric_limits<T>::max()) {
+        return std::numeric_limits<T>::max();
+    }
+    return (T)value;
+}
+
+static void quantize(void* p, f32 value, u32 type, int scale) {
+    value = std::ldexp(value, scale);
+    switch (type) {
+    case 0: memcpy(p, &value, 4); break;
+    case 4: *(u8*)p = saturate<u8>(value); break;
+    case 5: *(u16*)p = saturate<u16>(value); break;
+    case 6: *(s8*)p = saturate<s8>(value); break;
+    case 7: *(s16*)p = saturate<s16>(value); break;
+    default: HOST_CHECK(false, "GQR store type %u", type); break;
+    }
+}
+
+static int typeSize(u32 type) {
+    return type == 0 ? 4 : type == 4 || type == 6 ? 1 : 2;
+}
+
+static int signExtend6(u32 value) {
+    return (int)(value << 26) >> 26;
+}
+
+/** One paired-single asm block from JASCalc.cpp. */
+struct Kernel {
+    struct Op {
+        std::string mName;
+        std::vector<std::string> mArgs;
+    };
+
+    std::vector<std::string> mParams;
+    std::vector<Op> mOps;
+    std::map<std::string, size_t> mLabels;
+    /** Instructions run and output samples over every call, for the per-sample count. */
+    u64 mRunNum;
+    u64 mSampleNum;
+};
+
+static std::map<std::string, Kernel> l_kernels;
+
+static bool readKernel(const std::string& text, const char* name) {
+    std::regex def(std::string("static void ") + name +
+                   "\\(([^)]*)\\) \\{([\\s\\S]*?)asm \\{([\\s\\S]*?)\\n\\s*\\}");
+    std::smatch match;
+    if (!std::regex_search(text, match, def)) {
+        return false;
+    }
+    Kernel kernel = {};
+    std::string params = match[1];
+    static const std::regex param("(\\w+)\\s*(,|$)");
+    for (std::sregex_iterator it(params.begin(), params.end(), param), end; it != end; ++it) {
+        kernel.mParams.push_back((*it)[1]);
+    }
+    HOST_CHECK(match[2].str().find("OSInitFastCast();") != std::string::npos,
+               "%s does not set up the GQRs", name);
+
+    std::istringstream lines(match[3]);
+    std::string line;
+    while (std::getline(lines, line)) {
+        static const std::regex label("\\s*(\\w+):\\s*");
+        static const std::regex op("\\s*(\\w+)\\s+(.*?)\\s*");
+        std::smatch parts;
+        if (std::regex_match(line, parts, label)) {
+            kernel.mLabels[parts[1]] = kernel.mOps.size();
+        } else if (std::regex_match(line, parts, op)) {
+            Kernel::Op entry;
+            entry.mName = parts[1];
+            std::stringstream args(parts[2]);
+            std::string arg;
+            while (std::getline(args, arg, ',')) {
+                entry.mArgs.push_back(std::regex_replace(arg, std::regex("^\\s+|\\s+$"), ""));
+            }
+            kernel.mOps.push_back(entry);
+        }
+    }
+    l_kernels[name] = kernel;
+    return !kernel.mOps.empty();
+}
+
+/** Runs @p name with its parameters bound to @p args; every other name is an FPR pair. */
+static void runKernel(const char* name, std::vector<uintptr_t> args, u32 sampleNum) {
+    Kernel& kernel = l_kernels[name];
+    std::map<std::string, uintptr_t> gpr;
+    std::map<std::string, f32[2]> fpr;
+    for (size_t i = 0; i < kernel.mParams.size() && i < args.size(); i++) {
+        gpr[kernel.mParams[i]] = args[i];
+    }
+    static const std::regex memory("(-?\\w+)\\((\\w+)\\)");
+
+    uintptr_t ctr = 0;
+    for (size_t pc = 0; pc < kernel.mOps.size(); pc++) {
+        const Kernel::Op& op = kernel.mOps[pc];
+        const std::vector<std::string>& a = op.mArgs;
+        kernel.mRunNum++;
+        if (op.mName == "psq_l" || op.mName == "psq_lu" || op.mName == "psq_st" ||
+            op.mName == "psq_stu")
+        {
+            std::smatch parts;
+            if (a.size() != 4 || !std::regex_match(a[1], parts, memory)) {
+                HOST_CHECK(false, "%s: bad operands to %s", name, op.mName.c_str());
+                return;
+            }
+            bool update = op.mName.back() == 'u';
+            bool load = op.mName[4] == 'l';
+            uintptr_t address = gpr[parts[2]] + std::stol(parts[1], NULL, 0);
+            bool single = std::stoi(a[2]) != 0;
+            u32 gqr = l_gqr[std::stoi(a[3])];
+            u32 type = load ? (gqr >> 16) & 7 : gqr & 7;
+            int scale = signExtend6(load ? gqr >> 24 : gqr >> 8);
+            f32* f = fpr[a[0]];
+            for (int i = 0; i < (single ? 1 : 2); i++) {
+                void* p = (void*)(address + i * typeSize(type));
+                if (load) {
+                    f[i] = dequantize(p, type, scale);
+                } else {
+                    quantize(p, f[i], type, scale);
+                }
+            }
+            if (load && single) {
+                f[1] = 1.0f;
+            }
+            if (update) {
+                gpr[parts[2]] = address;
+            }
+        } else if (op.mName == "subi") {
+            gpr[a[0]] = gpr[a[1]] - std::stol(a[2], NULL, 0);
+        } else if (op.mName == "mtctr") {
+            ctr = gpr[a[0]];
+        } else if (op.mName == "bdnz") {
+            if (--ctr != 0) {
+                pc = kernel.mLabels.at(a[0]) - 1;
+            }
+        } else if (op.mName == "ps_merge00") {
+            f32 result[2] = {fpr[a[1]][0], fpr[a[2]][0]};
+            memcpy(fpr[a[0]], result, sizeof(result));
+        } else if (op.mName == "ps_add") {
+            for (int i = 0; i < 2; i++) {
+                fpr[a[0]][i] = fpr[a[1]][i] + fpr[a[2]][i];
+            }
+        } else if (op.mName == "ps_madd") {
+            for (int i = 0; i < 2; i++) {
+                fpr[a[0]][i] = (f32)((f64)fpr[a[1]][i] * fpr[a[2]][i] + fpr[a[3]][i]);
+            }
+        } else {
+            HOST_CHECK(false, "%s: no model of %s", name, op.mName.c_str());
+            return;
+        }
+    }
+    kernel.mSampleNum += sampleNum;
+}
+
+static f32 l_monoGain[2];
+static f32 l_wideGain[2];
+
+static void mixStereoPS(s16* dst, const s16* srcL, const s16* srcR, u32 n, const f32* gain) {
+    runKernel("mixStereoPS", {(uintptr_t)dst, (uintptr_t)srcL, (uintptr_t)srcR, n,
+                              (uintptr_t)gain}, n * 2);
+}
+
+static void mixPS(s16* dst, const s16* src, u32 n) {
+    runKernel("mixPS", {(uintptr_t)dst, (uintptr_t)src, n}, n * 2);
+}
+
+static void imixcopyPS(const s16* s1, const s16* s2, s16* dst, u32 n) {
+    runKernel("imixcopyPS", {(uintptr_t)s1, (uintptr_t)s2, (uintptr_t)dst, n}, n * 2);
+}
+
+namespace JASProbe {
+static void start(s32, const char*) {}
+static void stop(s32) {}
+}  // namespace JASProbe
+
+#define JAS_DECL                                                                                 \
+    struct JASCalc {                                                                             \
+        static void imixcopy(const s16* s1, const s16* s2, s16* dst, u32 n);                     \
+        static void bcopyfast(const void* src, void* dest, u32 size);                            \
+        static void bzerofast(void* dest, u32 size);                                             \
+        static void mixMono(s16* dst, const s16* src, u32 n);                                    \
+        static void mixMonoWide(s16* dst, const s16* src, u32 n);                                \
+        static void mixStereo(s16* dst, const s16* srcL, const s16* srcR, u32 n);                \
+        static void mix(s16* dst, const s16* src, u32 n);                                        \
+        static bool sPairedMix;                                                                  \
+                                                                                                 \
+        template <typename A, typename B>                                                        \
+        static A clamp(B x) {                                                                    \
+            if (x <= std::numeric_limits<A>::min())                                              \
+                return std::numeric_limits<A>::min();                                            \
+            if (x >= std::numeric_limits<A>::max())                                              \
+                return std::numeric_limits<A>::max();                                            \
+            return x;                                                                            \
+        }                                                                                        \
+    };                                                                                           \
+    bool JASCalc::sPairedMix;                                                                    \
+                                                                                                 \
+    namespace JASDriver {                                                                        \
+    typedef s16* (*MixCallback)(s32);                                                            \
+    static u32 getFrameSamples() {                                                               \
+        return 7 * 0x50;                                                                         \
+    }                                                                                            \
+    void mixMonoTrack(s16*, u32, MixCallback);                                                   \
+    void mixMonoTrackWide(s16*, u32, MixCallback);                                               \
+    void mixExtraTrack(s16*, u32, MixCallback);                                                  \
+    void mixInterleaveTrack(s16*, u32, MixCallback);                                             \
+    }
+
+namespace ref {
+#define ENABLE_PCM_MIX_SIMD 0
+JAS_DECL
+#include "splice.inc"
+#undef ENABLE_PCM_MIX_SIMD
+}  // namespace ref
+
+namespace simd {
+#define ENABLE_PCM_MIX_SIMD 1
+JAS_DECL
+#include "splice.inc"
+#include "splice_simd.inc"
+#undef ENABLE_PCM_MIX_SIMD
+}  // namespace simd
+
+static const u32 l_frameSamples = 7 * 0x50;
+static const int l_guard = 8;
+static s16* l_source;
+
+static s16* getSource(s32) {
+    return l_source;
+}
+
+static s16* getNothing(s32) {
+    return NULL;
+}
+
+/** Mostly random samples, with runs at full scale so sums saturate both ways. */
+static void fill(HostRandom& random, s16* buffer, u32 num) {
+    for (u32 i = 0; i < num; i++) {
+        switch (random.below(8)) {
+        case 0: buffer[i] = 0x7FFF; break;
+        case 1: buffer[i] = -0x8000; break;
+        case 2: buffer[i] = random.below(3) - 1; break;
+        default: buffer[i] = random.next(); break;
+        }
+    }
+}
+
+typedef void (*MixFunc)(s16*, u32, s16* (*)(s32));
+
+struct Mode {
+    const char* mName;
+    MixFunc mRef;
+    MixFunc mSimd;
+};
+
+static const Mode l_modes[] = {
+    {"mono", ref::JASDriver::mixMonoTrack, simd::JASDriver::mixMonoTrack},
+    {"mono wide", ref::JASDriver::mixMonoTrackWide, simd::JASDriver::mixMonoTrackWide},
+    {"extra", ref::JASDriver::mixExtraTrack, simd::JASDriver::mixExtraTrack},
+    {"interleave", ref::JASDriver::mixInterleaveTrack, simd::JASDriver::mixInterleaveTrack},
+};
+
+static void checkModes(HostRandom& random) {
+    const u32 dacNum = l_frameSamples * 2 + l_guard * 2;
+    std::vector<s16> source(l_frameSamples * 2);
+    std::vector<s16> dac[3];
+    for (int pass = 0; pass < 4000; pass++) {
+        const Mode& mode = l_modes[pass % 4];
+        // Full frames as the DAC callback mixes them, and odd sizes and offsets.
+        u32 num = pass % 8 < 4 ? l_frameSamples : random.below(l_frameSamples + 1);
+        u32 offset = random.below(2);
+        fill(random, source.data(), source.size());
+        l_source = source.data();
+        dac[0].resize(dacNum);
+        fill(random, dac[0].data(), dacNum);
+        dac[1] = dac[2] = dac[0];
+
+        s16* (*callback)(s32) = pass % 97 == 0 ? getNothing : getSource;
+        mode.mRef(dac[0].data() + l_guard + offset, num, callback);
+        simd::JASCalc::sPairedMix = false;
+        mode.mSimd(dac[1].data() + l_guard + offset, num, callback);
+        simd::JASCalc::sPairedMix = true;
+        mode.mSimd(dac[2].data() + l_guard + offset, num, callback);
+        HOST_CHECK(dac[1] == dac[0], "%s, %u samples: scalar mix differs", mode.mName, num);
+        HOST_CHECK(dac[2] == dac[0], "%s, %u samples: paired mix differs", mode.mName, num);
+    }
+}
+
+static void checkCalc(HostRandom& random) {
+    std::vector<s16> src(1200), s2(600), out[2];
+    for (int pass = 0; pass < 2000; pass++) {
+        u32 num = random.below(600);
+        fill(random, src.data(), src.size());
+        fill(random, s2.data(), s2.size());
+        out[0].resize(1224);
+        fill(random, out[0].data(), out[0].size());
+        out[1] = out[0];
+        for (int build = 0; build < 2; build++) {
+            simd::JASCalc::sPairedMix = build != 0;
+            simd::JASCalc::mix(out[build].data() + l_guard, src.data(), num);
+        }
+        HOST_CHECK(out[0] == out[1], "mix of %u samples differs", num);
+
+        for (int build = 0; build < 2; build++) {
+            simd::JASCalc::sPairedMix = build != 0;
+            simd::JASCalc::imixcopy(src.data(), s2.data(), out[build].data() + l_guard, num);
+        }
+        ref::JASCalc::imixcopy(src.data(), s2.data(), out[0].data() + l_guard, num);
+        HOST_CHECK(out[0] == out[1], "imixcopy of %u samples differs", num);
+    }
+
+    // Doubleword aligned buffers take lfd/stfd, word aligned ones the u32 loop.
+    alignas(8) u8 source[0x210], copy[2][0x210];
+    for (int pass = 0; pass < 2000; pass++) {
+        u32 size = random.below(0x20) * 0x10;
+        u32 srcOffset = random.below(3) * 4, dstOffset = random.below(3) * 4;
+        for (u32 i = 0; i < sizeof(source); i++) {
+            source[i] = random.next();
+            copy[0][i] = copy[1][i] = random.next();
+        }
+        ref::JASCalc::bcopyfast(source + srcOffset, copy[0] + dstOffset, size);
+        simd::JASCalc::bcopyfast(source + srcOffset, copy[1] + dstOffset, size);
+        HOST_CHECK(memcmp(copy[0], copy[1], sizeof(copy[0])) == 0, "bcopyfast of %#x differs",
+                   size);
+        ref::JASCalc::bzerofast(copy[0] + dstOffset, size);
+        simd::JASCalc::bzerofast(copy[1] + dstOffset, size);
+        HOST_CHECK(memcmp(copy[0], copy[1], sizeof(copy[0])) == 0, "bzerofast of %#x differs",
+                   size);
+    }
+}
+
+static void timeModes() {
+    HostRandom random(0x1801);
+    std::vector<s16> source(l_frameSamples * 2), dac(l_frameSamples * 2);
+    fill(random, source.data(), source.size());
+    l_source = source.data();
+    const int passes = 20000;
+    for (const Mode& mode : l_modes) {
+        double time[2];
+        for (int build = 0; build < 2; build++) {
+            MixFunc func = build == 0 ? mode.mRef : mode.mSimd;
+            simd::JASCalc::sPairedMix = false;
+            double start = host_seconds();
+            for (int pass = 0; pass < passes; pass++) {
+                func(dac.data(), l_frameSamples, getSource);
+            }
+            time[build] = host_seconds() - start;
+        }
+        double samples = (double)passes * l_frameSamples * 2;
+        printf("%-10s original %6.0f, fallback %6.0f samples/us (host)\n", mode.mName,
+               samples / (time[0] * 1e6), samples / (time[1] * 1e6));
+    }
+    simd::JASCalc::sPairedMix = true;
+}
+
+int main() {
+    std::filesystem::path root = std::filesystem::path(__FILE__).parent_path() / "../..";
+    std::string calc = readText(root / "libs/JSystem/src/JAudio2/JASCalc.cpp");
+    HOST_CHECK(readFastCast(readText(root / "libs/dolphin/include/dolphin/os.h")),
+               "no GQR setup in OSInitFastCast");
+    for (const char* name : {"mixStereoPS", "mixPS", "imixcopyPS"}) {
+        HOST_CHECK(readKernel(calc, name), "no asm for %s in JASCalc.cpp", name);
+    }
+    static const std::regex gain("static const f32 (l_\\w+Gain)\\[2\\] = \\{(\\S+)f, (\\S+)f\\};");
+    for (std::sregex_iterator it(calc.begin(), calc.end(), gain), end; it != end; ++it) {
+        f32* values = (*it)[1] == "l_monoGain" ? l_monoGain :
+                      (*it)[1] == "l_wideGain" ? l_wideGain :
+                                                 NULL;
+        HOST_CHECK(values != NULL, "unknown gain %s", (*it)[1].str().c_str());
+        if (values != NULL) {
+            values[0] = std::stof((*it)[2]);
+            values[1] = std::stof((*it)[3]);
+        }
+    }
+    HOST_CHECK(l_monoGain[0] != 0.0f && l_wideGain[0] != 0.0f, "gains not found");
+    if (host_check_failures != 0) {
+        return host_check_result("pcm_mix");
+    }
+
+    HostRandom random(0x18);
+    checkModes(random);
+    checkCalc(random);
+    timeModes();
+    for (auto& entry : l_kernels) {
+        Kernel& kernel = entry.second;
+        printf("%-11s %.2f instructions per sample (Gekko)\n", entry.first.c_str(),
+               (double)kernel.mRunNum / kernel.mSampleNum);
+    }
+    return host_check_result("pcm_mix");
+}
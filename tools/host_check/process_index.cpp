@@ -0,0 +1,134 @@
+// Scales the number of queued actors and times fopAcIt_SearchByID and fopAcIt_SearchByName
+// with ENABLE_PROCESS_INDEX (user-009) against the judge walks over g_fopAcTg_Queue they replace.
+// Every lookup must return what the walk returns. The layer queues share the same index code
+// through g_fpcLyTg_Index, so only the actor queue is run here.
+//
+// Actor IDs go up as processes are made, and names come from a pool of profile names, so some
+// names are shared and their lookups fall back to the walk. Past fpcSch_INDEX_NODE_NUM actors the
+// index overflows and every lookup walks; the last rows show that cost. At each count, half of the
+// actors leave and come back in a new order between the timed rounds. Prints ns per lookup for
+// both and how many name lookups the index could answer.
+//
+// tree: src/SSystem/SComponent/c_list.cpp src/SSystem/SComponent/c_list_iter.cpp
+// tree: src/SSystem/SComponent/c_node.cpp src/SSystem/SComponent/c_node_iter.cpp
+// tree: src/SSystem/SComponent/c_tag.cpp src/SSystem/SComponent/c_tag_iter.cpp
+// tree: src/SSystem/SComponent/c_tree.cpp
+// tree: src/f_op/f_op_actor_tag.cpp src/f_op/f_op_actor_iter.cpp src/f_pc/f_pc_searcher.cpp
+// define: ENABLE_PROCESS_INDEX=1
+
+#include "host_check.h"
+
+#include "SSystem/SComponent/c_list.h"
+#include "SSystem/SComponent/c_tag.h"
+#include "f_op/f_op_actor_iter.h"
+#include "f_op/f_op_actor_tag.h"
+#include "f_pc/f_pc_base.h"
+#include "f_pc/f_pc_searcher.h"
+
+static const int COUNTS[] = {25, 50, 100, 200, 400, 800, 1000, 1500};
+static const int ACTOR_MAX = 1500;
+static const int NAME_NUM = 700;
+static const int LOOKUP_NUM = 4000;
+static const int ROUND_NUM = 4;
+
+struct HostActor {
+    base_process_class mBase;
+    create_tag_class mTag;
+};
+
+static HostActor l_actor[ACTOR_MAX];
+static fpc_ProcID l_lookupID[LOOKUP_NUM];
+static s16 l_lookupName[LOOKUP_NUM];
+static void* l_indexed[LOOKUP_NUM];
+static void* l_walked[LOOKUP_NUM];
+
+static void* searchByIDWalk(fpc_ProcID id) {
+    return fopAcIt_Judge(fpcSch_JudgeByID, &id);
+}
+
+static void* searchByNameWalk(s16 name) {
+    return fopAcIt_Judge(fpcSch_JudgeForPName, &name);
+}
+
+/** Times one lookup function over l_lookupID or l_lookupName, in ns per lookup. */
+static double timeLookups(void* (*byID)(fpc_ProcID), void* (*byName)(s16), void** out) {
+    double start = host_seconds();
+    for (int i = 0; i < LOOKUP_NUM; i++) {
+        out[i] = byID != NULL ? byID(l_lookupID[i]) : byName(l_lookupName[i]);
+    }
+    return (host_seconds() - start) * 1e9 / LOOKUP_NUM;
+}
+
+static void queue(HostActor* actor) {
+    fopAcTg_Init(&actor->mTag, &actor->mBase);
+    HOST_CHECK(fopAcTg_ToActorQ(&actor->mTag), "actor %d not queued", actor->mBase.id);
+}
+
+int main() {
+    HostRandom rnd(0x5EED0009);
+    fpc_ProcID nextID = 1;
+    printf("%6s %10s %10s %10s %10s %8s\n", "actors", "id walk", "id index", "name walk",
+           "name index", "by index");
+
+    for (int c = 0; c < (int)(sizeof(COUNTS) / sizeof(COUNTS[0])); c++) {
+        int num = COUNTS[c];
+        for (int i = 0; i < num; i++) {
+            HostActor* actor = &l_actor[i];
+            memset(actor, 0, sizeof(*actor));
+            actor->mBase.id = nextID;
+            nextID += 1 + rnd.below(3);
+            actor->mBase.name = (s16)rnd.below(NAME_NUM);
+            queue(actor);
+        }
+
+        double time[4] = {0.0, 0.0, 0.0, 0.0};
+        int answered = 0;
+        for (int round = 0; round < ROUND_NUM; round++) {
+            for (int i = 0; i < LOOKUP_NUM; i++) {
+                // A quarter of the IDs and names belong to no queued actor.
+                HostActor* actor = &l_actor[rnd.below(num)];
+                l_lookupID[i] = rnd.below(4) == 0 ? nextID + rnd.below(1000) : actor->mBase.id;
+                l_lookupName[i] = rnd.below(4) == 0 ? (s16)(NAME_NUM + rnd.below(100)) :
+                                                      actor->mBase.name;
+            }
+
+            time[0] += timeLookups(searchByIDWalk, NULL, l_walked);
+            time[1] += timeLookups(fopAcIt_SearchByID, NULL, l_indexed);
+            for (int i = 0; i < LOOKUP_NUM; i++) {
+                HOST_CHECK(l_indexed[i] == l_walked[i], "%d actors: ID %d found %p, walk %p",
+                           num, l_lookupID[i], l_indexed[i], l_walked[i]);
+            }
+
+            time[2] += timeLookups(NULL, searchByNameWalk, l_walked);
+            time[3] += timeLookups(NULL, fopAcIt_SearchByName, l_indexed);
+            for (int i = 0; i < LOOKUP_NUM; i++) {
+                HOST_CHECK(l_indexed[i] == l_walked[i], "%d actors: name %d found %p, walk %p",
+                           num, l_lookupName[i], l_indexed[i], l_walked[i]);
+                base_process_class* process;
+                answered += fpcSch_SearchIndexByName(&g_fopAcTg_Index, l_lookupName[i],
+                                                     &process) != fpcSch_INDEX_UNKNOWN;
+            }
+
+            // Half of the actors leave and come back at the end of the queue.
+            for (int i = 0; i < num; i++) {
+                if (rnd.below(2) == 0) {
+                    fopAcTg_ActorQTo(&l_actor[i].mTag);
+                    queue(&l_actor[i]);
+                }
+            }
+        }
+
+        printf("%6d %8.1f ns %8.1f ns %8.1f ns %8.1f ns %7d%%\n", num, time[0] / ROUND_NUM,
+               time[1] / ROUND_NUM, time[2] / ROUND_NUM, time[3] / ROUND_NUM,
+               answered * 100 / (LOOKUP_NUM * ROUND_NUM));
+
+        for (int i = 0; i < num; i++) {
+            fopAcTg_ActorQTo(&l_actor[i].mTag);
+        }
+        HOST_CHECK(g_fopAcTg_Queue.mSize == 0, "%d actors: queue not empty", num);
+        HOST_CHECK(g_fopAcTg_Index.overflow == 0, "%d actors: overflow left at %d", num,
+                   g_fopAcTg_Index.overflow);
+    }
+
+    return host_check_result("process_index");
+}
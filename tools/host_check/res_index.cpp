@@ -0,0 +1,341 @@
+// Replays scene loads through dRes_control_c with and without ENABLE_RES_INDEX (user-014).
+// Every setRes, deleteRes and lookup must pick the same dRes_info_c in both builds, and
+// the arrays must hold the same names and counts after every room. Prints the replay time
+// of both builds.
+//
+// There is no captured resource trace, so the scenes are modeled from the actor sources:
+// each actor in src/d/actor loads the archives it names (l_arcName, dComIfG_resLoad and
+// dComIfG_getObjectRes literals) and looks them up as often as it has getObjectRes/getRes
+// call sites, split between create and a few later animation or model switches. A room
+// loads 20 to 60 actors next to the resident archives, runs for a while and then deletes
+// them again; each stage keeps its stage and room archives in mStageInfo.
+//
+// region(index): src/d/d_resorce.cpp struct dRes_index_c { => dRes_deleteIndex
+// splice: src/d/d_resorce.cpp dRes_control_c::setRes dRes_control_c::deleteRes dRes_control_c::getResInfo dRes_control_c::newResInfo
+
+#include "host_check.h"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define DEBUG 0
+#define ARRAY_SIZE(a) ((int)(sizeof(a) / sizeof((a)[0])))
+#define stricmp strcasecmp
+#define OSReport_Error(...) printf(__VA_ARGS__)
+
+struct JKRHeap;
+
+static inline int __cntlzw(u32 x) {
+    return x != 0 ? __builtin_clz(x) : 32;
+}
+
+/** The part of dRes_info_c the lookups touch, padded to its size on the target. */
+#define RES_CONTROL_DECL                                                                           \
+    struct dRes_info_c {                                                                           \
+        dRes_info_c() { mCount = 0; }                                                              \
+        int set(char const* i_arcName, char const*, u8, JKRHeap*) {                                \
+            strncpy(mArchiveName, i_arcName, sizeof(mArchiveName) - 1);                            \
+            return true;                                                                           \
+        }                                                                                          \
+        int getCount() { return mCount; }                                                          \
+        char* getArchiveName() { return mArchiveName; }                                            \
+        u32 incCount() { return ++mCount; }                                                        \
+        u32 decCount() { return --mCount; }                                                        \
+                                                                                                   \
+        char mArchiveName[11];                                                                     \
+        u16 mCount;                                                                                \
+        u8 mPad[0x28 - 0xE];                                                                       \
+    };                                                                                             \
+                                                                                                   \
+    struct dRes_control_c {                                                                        \
+        static int setRes(char const*, dRes_info_c*, int, char const*, u8, JKRHeap*);              \
+        static int deleteRes(char const*, dRes_info_c*, int);                                      \
+        static dRes_info_c* getResInfo(char const*, dRes_info_c*, int);                            \
+        static dRes_info_c* newResInfo(dRes_info_c*, int);                                         \
+                                                                                                   \
+        dRes_info_c mObjectInfo[128];                                                              \
+        dRes_info_c mStageInfo[64];                                                                \
+    };
+
+namespace ref {
+#define ENABLE_RES_INDEX 0
+RES_CONTROL_DECL
+#include "splice.inc"
+#undef ENABLE_RES_INDEX
+}  // namespace ref
+
+namespace indexed {
+#define ENABLE_RES_INDEX 1
+RES_CONTROL_DECL
+#include "splice_index.inc"
+#include "splice.inc"
+#undef ENABLE_RES_INDEX
+}  // namespace indexed
+
+enum OpKind {
+    OP_SET,
+    OP_DELETE,
+    OP_GET,
+    OP_ROOM_END,
+};
+
+struct Op {
+    u8 mKind;
+    u8 mStage;
+    const char* mName;
+};
+
+struct Actor {
+    std::vector<std::string> mArcNames;
+    int mLookupNum;
+};
+
+/** Collects the archives each actor source names and how often it looks resources up. */
+static std::vector<Actor> scanActors(const std::filesystem::path& dir) {
+    static const std::regex literal("\"([A-Za-z][A-Za-z0-9_]{0,9})\"");
+    static const std::regex single(
+        "(?:l_\\w*[aA]rc\\w*(?:\\[\\w*\\])*\\s*=\\s*|resLoad\\([^,;]+,\\s*|getObjectRes\\(\\s*)"
+        "\"([A-Za-z][A-Za-z0-9_]{0,9})\"");
+    static const std::regex list("l_\\w*[aA]rc\\w*(?:\\[\\w*\\])+\\s*=\\s*\\{([^}]*)\\}");
+    static const std::regex lookup("get(?:Object)?Res\\(");
+
+    std::vector<Actor> actors;
+    std::vector<std::filesystem::path> sources;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() == ".cpp") {
+            sources.push_back(entry.path());
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+
+    for (const auto& source : sources) {
+        std::ifstream file(source);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        std::string text = stream.str();
+
+        std::set<std::string> names;
+        for (std::sregex_iterator it(text.begin(), text.end(), single), end; it != end; ++it) {
+            names.insert((*it)[1]);
+        }
+        for (std::sregex_iterator it(text.begin(), text.end(), list), end; it != end; ++it) {
+            std::string body = (*it)[1];
+            for (std::sregex_iterator n(body.begin(), body.end(), literal); n != end; ++n) {
+                names.insert((*n)[1]);
+            }
+        }
+        if (names.empty()) {
+            continue;
+        }
+
+        Actor actor;
+        actor.mArcNames.assign(names.begin(), names.end());
+        actor.mLookupNum = (int)std::distance(
+            std::sregex_iterator(text.begin(), text.end(), lookup), std::sregex_iterator());
+        actors.push_back(actor);
+    }
+    return actors;
+}
+
+static const char* const l_residentArc[] = {"Alink", "Always", "Event", "Kmdl", "Wmdl", "Midna"};
+static const int l_roomFrame = 300;
+
+/** Builds the replay: stages of rooms, each loading a set of actors from the scan. */
+static std::vector<Op> buildScenes(const std::vector<Actor>& actors,
+                                   std::vector<std::string>& stageNames) {
+    std::mt19937 random(0x14);
+    std::vector<Op> ops;
+    auto push = [&](int kind, int stage, const char* name) {
+        Op op = {(u8)kind, (u8)stage, name};
+        ops.push_back(op);
+    };
+
+    stageNames.push_back("Stg_00");
+    for (int room = 0; room < 32; room++) {
+        char name[12];
+        snprintf(name, sizeof(name), "R%02d_00", room);
+        stageNames.push_back(name);
+    }
+    for (const char* name : l_residentArc) {
+        push(OP_SET, 0, name);
+    }
+
+    for (int stage = 0; stage < 8; stage++) {
+        push(OP_SET, 1, stageNames[0].c_str());
+        for (int room = 0; room < 6; room++) {
+            const char* roomArc = stageNames[1 + (stage * 6 + room) % 32].c_str();
+            push(OP_SET, 1, roomArc);
+
+            // mObjectInfo holds 128 archives; a room stays well below that, as in the game.
+            std::vector<const Actor*> loaded;
+            std::set<std::string> roomArcs;
+            int actorNum = 20 + random() % 41;
+            while ((int)loaded.size() < actorNum) {
+                const Actor& actor = actors[random() % actors.size()];
+                std::set<std::string> grown = roomArcs;
+                grown.insert(actor.mArcNames.begin(), actor.mArcNames.end());
+                if (grown.size() + ARRAY_SIZE(l_residentArc) > 100) {
+                    break;
+                }
+                roomArcs.swap(grown);
+                loaded.push_back(&actor);
+                for (const auto& name : actor.mArcNames) {
+                    push(OP_SET, 0, name.c_str());
+                }
+                int createLookup = (actor.mLookupNum + 1) / 2;
+                for (int i = 0; i < createLookup; i++) {
+                    push(OP_GET, 0, actor.mArcNames[i % actor.mArcNames.size()].c_str());
+                }
+            }
+
+            for (int frame = 0; frame < l_roomFrame; frame++) {
+                // The player and the stage are looked up every frame.
+                for (int i = 0; i < 4; i++) {
+                    push(OP_GET, 0, l_residentArc[0]);
+                }
+                push(OP_GET, 1, roomArc);
+                push(OP_GET, 1, stageNames[0].c_str());
+                for (const Actor* actor : loaded) {
+                    // The remaining call sites fire on the odd animation or model switch.
+                    if ((int)(random() % (l_roomFrame * 2)) < actor->mLookupNum) {
+                        const auto& name = actor->mArcNames[random() % actor->mArcNames.size()];
+                        push(OP_GET, 0, name.c_str());
+                    }
+                }
+                // Misses, as from actors checking an archive that is not loaded.
+                if (random() % 8 == 0) {
+                    push(OP_GET, 0, actors[random() % actors.size()].mArcNames[0].c_str());
+                }
+            }
+
+            for (auto it = loaded.rbegin(); it != loaded.rend(); ++it) {
+                for (const auto& name : (*it)->mArcNames) {
+                    push(OP_DELETE, 0, name.c_str());
+                }
+            }
+            push(OP_DELETE, 1, roomArc);
+            push(OP_ROOM_END, 0, NULL);
+        }
+        push(OP_DELETE, 1, stageNames[0].c_str());
+    }
+
+    for (const char* name : l_residentArc) {
+        push(OP_DELETE, 0, name);
+    }
+    push(OP_ROOM_END, 0, NULL);
+    return ops;
+}
+
+/** Runs the replay, storing each op's result: the info index, or -1. */
+template <typename Control, typename Info>
+static void replay(Control& control, const std::vector<Op>& ops, std::vector<int>* results) {
+    for (const Op& op : ops) {
+        Info* infos = op.mStage ? control.mStageInfo : control.mObjectInfo;
+        int infoNum = op.mStage ? ARRAY_SIZE(control.mStageInfo) : ARRAY_SIZE(control.mObjectInfo);
+        int result;
+        switch (op.mKind) {
+        case OP_SET:
+            result = Control::setRes(op.mName, infos, infoNum, "", 0, NULL);
+            if (result != 0) {
+                result = Control::getResInfo(op.mName, infos, infoNum) - infos;
+            }
+            break;
+        case OP_DELETE:
+            result = Control::deleteRes(op.mName, infos, infoNum);
+            break;
+        case OP_GET: {
+            Info* info = Control::getResInfo(op.mName, infos, infoNum);
+            result = info != NULL ? info - infos : -1;
+            break;
+        }
+        default:
+            result = 0;
+            break;
+        }
+        if (results != NULL) {
+            results->push_back(result);
+        }
+    }
+}
+
+template <typename Info>
+static std::string dumpInfo(Info* infos, int infoNum) {
+    std::string text;
+    for (int i = 0; i < infoNum; i++) {
+        if (infos[i].getCount() != 0) {
+            char entry[32];
+            snprintf(entry, sizeof(entry), "%d:%s:%d ", i, infos[i].getArchiveName(),
+                     infos[i].getCount());
+            text += entry;
+        }
+    }
+    return text;
+}
+
+static ref::dRes_control_c l_refControl;
+static indexed::dRes_control_c l_indexControl;
+
+int main() {
+    std::filesystem::path root = std::filesystem::path(__FILE__).parent_path() / "../..";
+    std::vector<Actor> actors = scanActors(root / "src/d/actor");
+    HOST_CHECK(actors.size() > 100, "only %zu actors name an archive", actors.size());
+    if (actors.empty()) {
+        return host_check_result("res_index");
+    }
+
+    std::vector<std::string> stageNames;
+    std::vector<Op> ops = buildScenes(actors, stageNames);
+
+    // Compare op by op, and the arrays after every room.
+    std::vector<int> refResult, indexResult;
+    int gets = 0, misses = 0, rooms = 0;
+    for (size_t i = 0; i < ops.size(); i++) {
+        std::vector<Op> one(1, ops[i]);
+        refResult.clear();
+        indexResult.clear();
+        replay<ref::dRes_control_c, ref::dRes_info_c>(l_refControl, one, &refResult);
+        replay<indexed::dRes_control_c, indexed::dRes_info_c>(l_indexControl, one, &indexResult);
+        HOST_CHECK(refResult[0] == indexResult[0], "op %zu (%d %s): info %d, index build %d", i,
+                   ops[i].mKind, ops[i].mName, refResult[0], indexResult[0]);
+        HOST_CHECK(ops[i].mKind != OP_SET || refResult[0] >= 0, "op %zu: setRes %s failed", i,
+                   ops[i].mName);
+        if (ops[i].mKind == OP_GET) {
+            gets++;
+            misses += refResult[0] < 0;
+        } else if (ops[i].mKind == OP_ROOM_END) {
+            rooms++;
+            HOST_CHECK(dumpInfo(l_refControl.mObjectInfo, 128) ==
+                               dumpInfo(l_indexControl.mObjectInfo, 128),
+                       "room %d: object infos differ", rooms);
+            HOST_CHECK(dumpInfo(l_refControl.mStageInfo, 64) ==
+                               dumpInfo(l_indexControl.mStageInfo, 64),
+                       "room %d: stage infos differ", rooms);
+        }
+    }
+    HOST_CHECK(dumpInfo(l_refControl.mObjectInfo, 128).empty(), "archives left registered");
+    printf("%zu actors, %d rooms, %zu ops, %d lookups (%d misses)\n", actors.size(), rooms - 1,
+           ops.size(), gets, misses);
+
+    // The replay leaves both arrays empty, so it can run again for timing.
+    const int passes = 20;
+    double start = host_seconds();
+    for (int i = 0; i < passes; i++) {
+        replay<ref::dRes_control_c, ref::dRes_info_c>(l_refControl, ops, NULL);
+    }
+    double refTime = host_seconds() - start;
+    start = host_seconds();
+    for (int i = 0; i < passes; i++) {
+        replay<indexed::dRes_control_c, indexed::dRes_info_c>(l_indexControl, ops, NULL);
+    }
+    double indexTime = host_seconds() - start;
+    printf("linear scan %.1f ns/op, index %.1f ns/op\n", refTime * 1e9 / (passes * ops.size()),
+           indexTime * 1e9 / (passes * ops.size()));
+
+    return host_check_result("res_index");
+}
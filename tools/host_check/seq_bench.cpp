@@ -0,0 +1,486 @@
+// Drives the ENABLE_SEQ_BENCH sequence bench (user-020): JASSeqParser::runBench plays a
+// sequence on a private root track, once reading every instruction as parse does and once
+// through the decode cache (parseDecoded). Both runs must count the same instructions and
+// leave the tracks in the same state wherever the sequence syncs with the CPU.
+//
+// The sequence is made up: a root track opens child tracks, and every track loops over random
+// notes, waits, register arithmetic (also in the register-argument 0x9x forms), calls, loops,
+// conditional jumps and port writes, stopping at a sync command now and then. The callback
+// records the tick and each track's registers, ports and parameters at every sync, and its
+// return value feeds the branches that follow. The root counts down and finishes, so both runs
+// must also end on the same tick. Every sequence is written over the one before it, so a decode
+// cache entry that outlived its data shows up as a mismatch. Prints the instructions per second
+// of both interpreters and how often the decode cache hit.
+//
+// tree: libs/JSystem/src/JAudio2/JASSeqParser.cpp libs/JSystem/src/JAudio2/JASTrack.cpp
+// tree: libs/JSystem/src/JAudio2/JASSeqCtrl.cpp libs/JSystem/src/JAudio2/JASSeqReader.cpp
+// tree: libs/JSystem/src/JAudio2/JASTrackPort.cpp libs/JSystem/src/JAudio2/JASRegisterParam.cpp
+// tree: libs/JSystem/src/JAudio2/JASCalc.cpp libs/JSystem/src/JAudio2/JASOscillator.cpp
+// tree: libs/JSystem/src/JAudio2/JASLfo.cpp libs/JSystem/src/JSupport/JSUList.cpp
+// tree: libs/JSystem/src/JMath/JMATrigonometric.cpp libs/JSystem/src/JGadget/linklist.cpp
+// define: ENABLE_SEQ_BENCH=1
+
+#include "host_check.h"
+
+#include "JSystem/JAudio2/JASAiCtrl.h"
+#include "JSystem/JAudio2/JASBank.h"
+#include "JSystem/JAudio2/JASDriverIF.h"
+#include "JSystem/JAudio2/JASHeapCtrl.h"
+#include "JSystem/JAudio2/JASSeqParser.h"
+#include "JSystem/JAudio2/JASTrack.h"
+#include <dolphin/os.h>
+
+extern "C" {
+int posix_memalign(void**, size_t, size_t);
+void free(void*);
+}
+
+void* operator new(size_t size, JKRHeap*, int) {
+    void* ptr = NULL;
+    posix_memalign(&ptr, 32, size);
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+JASGenericMemPool::JASGenericMemPool() {}
+JASGenericMemPool::~JASGenericMemPool() {}
+void JASGenericMemPool::newMemPool(u32, int) {}
+void* JASGenericMemPool::alloc(u32 size) {
+    return operator new(size, (JKRHeap*)NULL, 0);
+}
+void JASGenericMemPool::free(void* ptr, u32) {
+    ::free(ptr);
+}
+
+int __float_huge[] = {0x7F800000};
+
+template <>
+JASDefaultBankTable* JASGlobalInstance<JASDefaultBankTable>::sInstance = NULL;
+
+void JASReport(const char*, ...) {}
+
+f32 JASDriver::getDacRate() {
+    return 32000.0f;
+}
+u32 JASDriver::getSubFrames() {
+    return 7;
+}
+bool JASDriver::registerSubFrameCallback(DriverCallback, void*) {
+    return true;
+}
+
+extern "C" {
+OSTime OSGetTime() {
+    return (OSTime)(host_seconds() * OS_TIMER_CLOCK);
+}
+BOOL OSDisableInterrupts() {
+    return FALSE;
+}
+BOOL OSRestoreInterrupts(BOOL) {
+    return FALSE;
+}
+}
+
+/**
+ * Assembles sequence data. JASSeqReader loads 16 and 24 bit arguments natively, so they are
+ * written in host order: a 16 bit value low byte first, and a 24 bit value as the bytes a
+ * native load from the byte before it reads, which makes that byte the low byte of the value.
+ * Addresses are therefore passed through a register, except for jumps to labels aligned for
+ * them.
+ */
+struct SeqWriter {
+    enum {
+        DATA_MAX = 0x10000,
+        FIXUP_MAX = 0x1000,
+        LABEL_MAX = 0x400,
+    };
+
+    u8 mData[DATA_MAX];
+    u32 mSize;
+    u32 mFixupPos[FIXUP_MAX];
+    int mFixupLabel[FIXUP_MAX];
+    bool mFixup24[FIXUP_MAX];
+    int mFixupNum;
+    u32 mLabels[LABEL_MAX];
+    int mLabelNum;
+
+    SeqWriter() : mSize(0), mFixupNum(0), mLabelNum(0) {}
+    int label() { return mLabelNum++; }
+    void place(int label) { mLabels[label] = mSize; }
+    /** Pads with nops so that the next label placed ends in @p lowByte. */
+    void align(u8 lowByte) {
+        while ((mSize & 0xFF) != lowByte) {
+            u8_(0xFE);
+        }
+    }
+    u32 pos() const { return mSize; }
+    void u8_(u32 value) { mData[mSize++] = value; }
+    void u16_(u32 value) {
+        u8_(value);
+        u8_(value >> 8);
+    }
+    void fixup(int label, bool is24) {
+        mFixupPos[mFixupNum] = mSize;
+        mFixupLabel[mFixupNum] = label;
+        mFixup24[mFixupNum++] = is24;
+    }
+    void addr16(int label) {
+        fixup(label, false);
+        u16_(0);
+    }
+    void addr24(int label) {
+        fixup(label, true);
+        u16_(0);
+        u8_(0);
+    }
+    void midi(u32 value) {
+        if (value >= 0x80) {
+            u8_(0x80 | value >> 7);
+        }
+        u8_(value & 0x7F);
+    }
+    bool finish() {
+        for (int i = 0; i < mFixupNum; i++) {
+            u32 pos = mFixupPos[i];
+            u32 target = mLabels[mFixupLabel[i]];
+            if (mFixup24[i]) {
+                if (mData[pos - 1] != (target & 0xFF)) {
+                    return false;
+                }
+                target >>= 8;
+            }
+            mData[pos] = target;
+            mData[pos + 1] = target >> 8;
+        }
+        return true;
+    }
+};
+
+enum {
+    SEQ_REG_ARG1 = 0x90,
+    SEQ_REG_ARG2 = 0x91,
+    SEQ_REG_ARG3 = 0x92,
+    SEQ_OPEN_TRACK = 0xC1,
+    SEQ_CALL = 0xC3,
+    SEQ_RET = 0xC5,
+    SEQ_JMP = 0xC7,
+    SEQ_JMP_F = 0xC8,
+    SEQ_LOOP_S = 0xCB,
+    SEQ_LOOP_E = 0xCC,
+    SEQ_WRITE_PORT = 0xD1,
+    SEQ_REG_LOAD = 0xD8,
+    SEQ_REG = 0xDA,
+    SEQ_TEMPO = 0xE0,
+    SEQ_WAIT = 0xF0,
+    SEQ_WAIT_BYTE = 0xF1,
+    SEQ_SYNC_CPU = 0xF9,
+    SEQ_NOP = 0xFE,
+    SEQ_FINISH = 0xFF,
+};
+
+/** Holds addresses for the register forms of jumps, calls and track opens. */
+static const u8 REG_ADDR = 12;
+/** Counts the root's rounds down. */
+static const u8 REG_ROUND = 13;
+
+/** A register the random instructions work on; 0 to 2 are bytes, 3 the branch condition. */
+static u8 randomReg(HostRandom& random) {
+    return random.below(REG_ADDR);
+}
+
+static void writeLoadAddr(SeqWriter& seq, int label) {
+    seq.u8_(SEQ_REG_LOAD);
+    seq.u8_(REG_ADDR);
+    seq.addr16(label);
+}
+
+static void writeRegOp(SeqWriter& seq, HostRandom& random) {
+    // Random (8) draws from a static generator that the second run would continue.
+    seq.u8_(SEQ_REG);
+    seq.u8_("\0\1\2\3\4\5\6\7\11\12"[random.below(10)]);
+    seq.u8_(randomReg(random));
+    seq.u16_(random.below(0x10));
+}
+
+/** Writes a random instruction; calls go to @p subroutine, or become a nop without one. */
+static void writeOp(SeqWriter& seq, HostRandom& random, int subroutine) {
+    switch (random.below(12)) {
+    case 0: {
+        // Note with a gate time, so the track waits on it.
+        seq.u8_(random.below(0x80));
+        seq.u8_(random.below(2) << 6);
+        seq.u8_(random.below(0x80));
+        seq.midi(1 + random.below(random.below(8) != 0 ? 0x10 : 0x100));
+        break;
+    }
+    case 1: {
+        u32 id = 1 + random.below(7);
+        seq.u8_(random.below(0x80));
+        seq.u8_(id);
+        seq.u8_(random.below(0x80));
+        seq.u8_(SEQ_WAIT_BYTE);
+        seq.u8_(1 + random.below(8));
+        seq.u8_(0x80 | id);
+        break;
+    }
+    case 2:
+        seq.u8_(SEQ_WAIT);
+        seq.midi(1 + random.below(random.below(8) != 0 ? 0x10 : 0x100));
+        break;
+    case 3:
+        seq.u8_(SEQ_REG_LOAD);
+        seq.u8_(randomReg(random));
+        seq.u16_(random.next());
+        break;
+    case 4:
+        writeRegOp(seq, random);
+        break;
+    case 5:
+        // The same with the operand read from a register.
+        seq.u8_(SEQ_REG_ARG3);
+        seq.u8_(0x20);
+        seq.u8_(SEQ_REG);
+        seq.u8_("\1\2\3\5\6\7"[random.below(6)]);
+        seq.u8_(randomReg(random));
+        seq.u8_(randomReg(random));
+        break;
+    case 6:
+        seq.u8_(SEQ_WRITE_PORT);
+        seq.u8_(random.below(16));
+        seq.u8_(randomReg(random));
+        break;
+    case 7:
+        if (subroutine < 0) {
+            seq.u8_(SEQ_NOP);
+            break;
+        }
+        writeLoadAddr(seq, subroutine);
+        seq.u8_(SEQ_REG_ARG1);
+        seq.u8_(0x80);
+        seq.u8_(SEQ_CALL);
+        seq.u8_(REG_ADDR);
+        break;
+    case 8: {
+        // Skips a load depending on the result of a register operation.
+        int skip = seq.label();
+        writeLoadAddr(seq, skip);
+        writeRegOp(seq, random);
+        seq.u8_(SEQ_REG_ARG2);
+        seq.u8_(0x40);
+        seq.u8_(SEQ_JMP_F);
+        seq.u8_(1 + random.below(5));
+        seq.u8_(REG_ADDR);
+        seq.u8_(SEQ_REG_LOAD);
+        seq.u8_(randomReg(random));
+        seq.u16_(random.next());
+        seq.place(skip);
+        break;
+    }
+    case 9:
+        seq.u8_(SEQ_SYNC_CPU);
+        seq.u16_(random.below(0x100));
+        break;
+    case 10:
+        seq.u8_(SEQ_TEMPO);
+        seq.u16_(60 + random.below(200));
+        break;
+    default:
+        seq.u8_(SEQ_NOP);
+        break;
+    }
+}
+
+/** Writes a track that loops over @p opNum random instructions forever. */
+static void writeTrack(SeqWriter& seq, HostRandom& random, int opNum) {
+    int subroutine = seq.label();
+    int top = seq.label();
+    seq.align(SEQ_JMP);
+    seq.place(top);
+    for (int i = 0; i < opNum; i++) {
+        if (random.below(16) == 0) {
+            seq.u8_(SEQ_LOOP_S);
+            seq.u16_(2 + random.below(3));
+            writeOp(seq, random, subroutine);
+            seq.u8_(SEQ_WAIT_BYTE);
+            seq.u8_(1);
+            seq.u8_(SEQ_LOOP_E);
+        }
+        writeOp(seq, random, subroutine);
+    }
+    seq.u8_(SEQ_WAIT_BYTE);
+    seq.u8_(1);
+    seq.u8_(SEQ_JMP);
+    seq.addr24(top);
+
+    seq.place(subroutine);
+    for (int i = 0; i < 4; i++) {
+        writeOp(seq, random, -1);
+    }
+    seq.u8_(SEQ_RET);
+}
+
+static bool makeSequence(u32 seed, int childNum, int rounds, SeqWriter& seq) {
+    HostRandom random(seed);
+    int children[JASTrack::MAX_CHILDREN];
+    for (int i = 0; i < childNum; i++) {
+        children[i] = seq.label();
+        writeLoadAddr(seq, children[i]);
+        seq.u8_(SEQ_REG_ARG2);
+        seq.u8_(0x40);
+        seq.u8_(SEQ_OPEN_TRACK);
+        seq.u8_(i);
+        seq.u8_(REG_ADDR);
+    }
+    seq.u8_(SEQ_REG_LOAD);
+    seq.u8_(REG_ROUND);
+    seq.u16_(rounds);
+    int top = seq.label();
+    seq.place(top);
+    for (int i = 0; i < 24; i++) {
+        writeOp(seq, random, -1);
+    }
+    seq.u8_(SEQ_SYNC_CPU);
+    seq.u16_(0xFFFF);
+    seq.u8_(SEQ_WAIT_BYTE);
+    seq.u8_(1);
+    writeLoadAddr(seq, top);
+    seq.u8_(SEQ_REG);
+    seq.u8_(2);
+    seq.u8_(REG_ROUND);
+    seq.u16_(1);
+    seq.u8_(SEQ_REG_ARG2);
+    seq.u8_(0x40);
+    seq.u8_(SEQ_JMP_F);
+    seq.u8_(2);
+    seq.u8_(REG_ADDR);
+    seq.u8_(SEQ_FINISH);
+
+    for (int i = 0; i < childNum; i++) {
+        seq.place(children[i]);
+        writeTrack(seq, random, 16 + random.below(48));
+    }
+    return seq.finish();
+}
+
+/** Track state at every sync, in order. */
+struct Trace {
+    enum { WORD_MAX = 0x100000 };
+
+    u32 mWords[WORD_MAX];
+    u32 mSize;
+
+    void push(u32 word) {
+        if (mSize < WORD_MAX) {
+            mWords[mSize] = word;
+        }
+        mSize++;
+    }
+    bool operator==(const Trace& other) const {
+        return mSize == other.mSize && mSize <= WORD_MAX &&
+               memcmp(mWords, other.mWords, mSize * sizeof(u32)) == 0;
+    }
+};
+
+static Trace* l_trace;
+static const JASSeqParser::TBenchStat* l_stat;
+static u32 l_syncNum;
+
+static void traceTrack(JASTrack* track) {
+    for (int i = 0; i < 14; i++) {
+        l_trace->push(track->readReg(JASRegisterParam::RegID(i)));
+    }
+    for (int i = 0; i < 16; i++) {
+        l_trace->push(track->getPort(i));
+    }
+    l_trace->push(track->getTimebase());
+    l_trace->push(track->getTranspose());
+    l_trace->push(track->getSeqCtrl()->getSeqReader()->getLoopCount());
+}
+
+static u16 syncCallback(JASTrack* track, u16 param) {
+    l_syncNum++;
+    l_trace->push(l_stat->mTicks);
+    l_trace->push(param);
+    traceTrack(track);
+    if (param == 0xFFFF) {
+        for (int i = 0; i < JASTrack::MAX_CHILDREN; i++) {
+            if (track->getChild(i) != NULL) {
+                traceTrack(track->getChild(i));
+            }
+        }
+    }
+    return (l_syncNum * 0x9E37 ^ param) & 0xFFFF;
+}
+
+struct BenchRun {
+    JASSeqParser::TBenchStat mStat;
+    Trace mTrace;
+    u32 mOps;
+};
+
+static void runSequence(SeqWriter& seq, bool decode, u32 ticks, BenchRun* o_run) {
+    o_run->mTrace.mSize = 0;
+    l_trace = &o_run->mTrace;
+    l_stat = &o_run->mStat;
+    l_syncNum = 0;
+    s32 result = JASSeqParser::runBench(seq.mData, 0, ticks, decode, &o_run->mStat);
+    HOST_CHECK(result == 0, "runBench returned %d", result);
+
+    const JASSeqParser::TBenchStat& stat = o_run->mStat;
+    o_run->mOps = stat.mNoteOn + stat.mNoteOff;
+    for (int i = 0; i < 96; i++) {
+        o_run->mOps += stat.mCmd[i];
+    }
+    for (int i = 0; i < 255; i++) {
+        o_run->mOps += stat.mExtCmd[i];
+    }
+}
+
+int main() {
+    JASSeqParser::registerSeqCallback(syncCallback);
+    JASTrack::TChannelMgr::newMemPool(4);
+
+    const u32 ticks = 100000;
+    u32 finished = 0, opNum = 0, hitNum = 0, missNum = 0;
+    f64 time[2] = {};
+    for (u32 seed = 1; seed <= 24; seed++) {
+        // Every seed rewrites the same buffer, so the decode cache is dropped first, as the
+        // sequence data managers do before they load over a region.
+        static SeqWriter seq;
+        JASSeqParser::invalidateDecodeCache(seq.mData, sizeof(seq.mData));
+        seq = SeqWriter();
+        bool made = makeSequence(seed, 1 + seed % 8, 20 + seed, seq);
+        HOST_CHECK(made, "seed %u: a jump target is not aligned", seed);
+
+        static BenchRun runs[2];
+        for (int decode = 0; decode < 2; decode++) {
+            f64 start = host_seconds();
+            runSequence(seq, decode, ticks, &runs[decode]);
+            time[decode] += host_seconds() - start;
+        }
+        const JASSeqParser::TBenchStat& plain = runs[0].mStat;
+        const JASSeqParser::TBenchStat& decoded = runs[1].mStat;
+        HOST_CHECK(plain.mTicks == decoded.mTicks, "seed %u: ran %u and %u ticks", seed,
+                   plain.mTicks, decoded.mTicks);
+        HOST_CHECK(plain.mNoteOn == decoded.mNoteOn && plain.mNoteOff == decoded.mNoteOff &&
+                       memcmp(plain.mCmd, decoded.mCmd, sizeof(plain.mCmd)) == 0 &&
+                       memcmp(plain.mExtCmd, decoded.mExtCmd, sizeof(plain.mExtCmd)) == 0,
+                   "seed %u: instruction counts differ", seed);
+        HOST_CHECK(runs[0].mTrace == runs[1].mTrace, "seed %u: track state differs at a sync",
+                   seed);
+        HOST_CHECK(plain.mDecodeHit + plain.mDecodeMiss == 0, "seed %u: plain run decoded", seed);
+        HOST_CHECK(decoded.mDecodeHit + decoded.mDecodeMiss != 0, "seed %u: nothing decoded",
+                   seed);
+        HOST_CHECK(runs[0].mTrace.mSize > 100, "seed %u: only %u trace words", seed,
+                   runs[0].mTrace.mSize);
+        finished += plain.mTicks < ticks;
+        opNum += runs[0].mOps;
+        hitNum += decoded.mDecodeHit;
+        missNum += decoded.mDecodeMiss;
+    }
+    HOST_CHECK(finished == 24, "only %u of 24 sequences finished", finished);
+
+    printf("%u instructions, decode hit %u miss %u\n", opNum, hitNum, missNum);
+    printf("parse %.1f M/s, decoded %.1f M/s\n", opNum / time[0] * 1e-6, opNum / time[1] * 1e-6);
+    return host_check_result("seq_bench");
+}
@@ -0,0 +1,296 @@
+// Decodes stage files with dStage_dt_c_decode with and without ENABLE_STAGE_DECODE_INDEX
+// (user-015). Every FuncTable the loaders in src/d/d_stage.cpp declare is decoded against
+// every file, layer tables retagged per layer as dStage_setLayerTagName does, and both
+// builds must hand the same chunks to the handlers in the same order. Prints the decode
+// time of both builds per table length.
+//
+// Stage and room files extracted from the game (stage.dzs, room.dzr, roomN.dzs) can be
+// given on the command line:
+//     python tools/host_check.py stage_decode -- Stage/F_SP103/stage.dzs ...
+// Without them, stage and room files are made up from the tags of those same tables: each
+// holds most of its loader's tags, the layer tags of a few layers and some unknown tags,
+// in random order.
+//
+// region(index): src/d/d_stage.cpp #define DSTAGE_DECODE_HASH_NUM 256 => dStage_dt_c_searchChunk
+// splice: src/d/d_stage.cpp dStage_dt_c_decode
+// splice(layer): src/d/d_stage.cpp dStage_setLayerTagName
+
+#include "host_check.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define JUT_ASSERT(...)
+#define OSReport_Error(...) printf(__VA_ARGS__)
+
+struct dStage_dt_c;
+typedef int (*dStage_Func)(dStage_dt_c*, void*, int, void*);
+
+struct dStage_nodeHeader {
+    /* 0x0 */ u32 m_tag;
+    /* 0x4 */ int m_entryNum;
+    /* 0x8 */ u32 m_offset;
+};
+
+struct dStage_fileHeader {
+    /* 0x0 */ int m_chunkCount;
+    /* 0x4 */ dStage_nodeHeader m_nodes[1];
+};
+
+struct FuncTable {
+    char identifier[5];
+    dStage_Func function;
+};
+
+namespace ref {
+#define ENABLE_STAGE_DECODE_INDEX 0
+#include "splice.inc"
+#undef ENABLE_STAGE_DECODE_INDEX
+}  // namespace ref
+
+namespace indexed {
+#define ENABLE_STAGE_DECODE_INDEX 1
+#include "splice_index.inc"
+#include "splice.inc"
+#undef ENABLE_STAGE_DECODE_INDEX
+}  // namespace indexed
+
+#include "splice_layer.inc"
+
+/** The chunk each handler call got, in call order, and the number of calls. */
+static std::vector<u32> l_calls;
+static int l_callNum;
+
+static int recordCall(dStage_dt_c*, void* i_data, int, void* i_file) {
+    dStage_fileHeader* file = (dStage_fileHeader*)i_file;
+    l_calls.push_back((dStage_nodeHeader*)i_data - file->m_nodes);
+    return 1;
+}
+
+static int countCall(dStage_dt_c*, void*, int, void*) {
+    l_callNum++;
+    return 1;
+}
+
+struct Table {
+    std::string mName;
+    bool mLayer;
+    std::vector<FuncTable> mEntries;
+};
+
+/** Reads the tags of every FuncTable in d_stage.cpp. */
+static std::vector<Table> scanTables(const std::filesystem::path& source) {
+    static const std::regex table("static FuncTable (\\w+)\\[\\] = \\{([\\s\\S]*?)\\};");
+    static const std::regex tag("\"(\\w{4})\"");
+    static const std::regex layer("l_(env)?[lL]ayerFuncTableA?");
+
+    std::ifstream file(source);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    std::string text = stream.str();
+
+    std::vector<Table> tables;
+    for (std::sregex_iterator it(text.begin(), text.end(), table), end; it != end; ++it) {
+        Table result;
+        result.mName = (*it)[1];
+        result.mLayer = std::regex_match(result.mName, layer);
+        std::string body = (*it)[2];
+        for (std::sregex_iterator t(body.begin(), body.end(), tag); t != end; ++t) {
+            FuncTable entry = {};
+            memcpy(entry.identifier, (*t)[1].str().c_str(), 4);
+            entry.function = recordCall;
+            result.mEntries.push_back(entry);
+        }
+        tables.push_back(result);
+    }
+    return tables;
+}
+
+/** A file in native byte order. Tags stay as read, since identifiers are compared as bytes. */
+struct StageFile {
+    std::string mName;
+    std::vector<u32> mData;
+
+    dStage_fileHeader* get() { return (dStage_fileHeader*)mData.data(); }
+};
+
+static bool readFile(const char* path, StageFile* o_file) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<u8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 4 || 4 + be32(&data[0]) * 12 > data.size()) {
+        printf("%s: not a stage file\n", path);
+        return false;
+    }
+    o_file->mName = path;
+    o_file->mData.assign((data.size() + 3) / 4, 0);
+    memcpy(o_file->mData.data(), data.data(), data.size());
+    dStage_fileHeader* header = o_file->get();
+    header->m_chunkCount = be32(&data[0]);
+    for (int i = 0; i < header->m_chunkCount; i++) {
+        header->m_nodes[i].m_entryNum = be32(&data[4 + i * 12 + 4]);
+        header->m_nodes[i].m_offset = be32(&data[4 + i * 12 + 8]);
+    }
+    return true;
+}
+
+static void makeFiles(const std::vector<Table>& tables, std::vector<StageFile>* o_files) {
+    std::mt19937 random(0x15);
+    std::vector<u32> stageTags, roomTags, layerTags;
+    for (const Table& table : tables) {
+        std::vector<u32>& tags = table.mLayer                    ? layerTags :
+                                 table.mName == "l_roomFuncTable" ? roomTags :
+                                                                    stageTags;
+        for (const FuncTable& entry : table.mEntries) {
+            u32 tag;
+            memcpy(&tag, entry.identifier, 4);
+            if (std::find(tags.begin(), tags.end(), tag) == tags.end()) {
+                tags.push_back(tag);
+            }
+        }
+    }
+
+    for (int no = 0; no < 400; no++) {
+        std::vector<u32> tags;
+        for (u32 tag : no % 4 == 0 ? stageTags : roomTags) {
+            if (random() % 8 != 0) {
+                tags.push_back(tag);
+            }
+        }
+        int layerNum = 1 + random() % 4;
+        for (int i = 0; i < layerNum; i++) {
+            char layerTag = i == 0 ? '0' : "123456789abcde"[random() % 14];
+            for (u32 tag : layerTags) {
+                if (random() % 3 != 0) {
+                    ((char*)&tag)[3] = layerTag;
+                    if (std::find(tags.begin(), tags.end(), tag) == tags.end()) {
+                        tags.push_back(tag);
+                    }
+                }
+            }
+        }
+        int unknownNum = random() % 6;
+        for (int i = 0; i < unknownNum; i++) {
+            tags.push_back(0x58580000 | (random() & 0xFFFF));
+        }
+        std::shuffle(tags.begin(), tags.end(), random);
+
+        StageFile file;
+        file.mName = no % 4 == 0 ? "stage" : "room";
+        file.mData.assign(1 + tags.size() * 3, 0);
+        file.get()->m_chunkCount = tags.size();
+        for (size_t i = 0; i < tags.size(); i++) {
+            file.get()->m_nodes[i].m_tag = tags[i];
+            file.get()->m_nodes[i].m_entryNum = random() % 40;
+        }
+        o_files->push_back(file);
+    }
+}
+
+/** Decodes every table against @p file, the layer tables once per layer. */
+template <void (*DECODE)(void*, dStage_dt_c*, FuncTable*, int)>
+static void decodeAll(StageFile& file, std::vector<Table>& tables, int layerNum) {
+    for (Table& table : tables) {
+        for (int layer = 0; layer < (table.mLayer ? layerNum : 1); layer++) {
+            if (table.mLayer) {
+                dStage_setLayerTagName(table.mEntries.data(), table.mEntries.size(), layer);
+            }
+            DECODE(file.get(), NULL, table.mEntries.data(), table.mEntries.size());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path root = std::filesystem::path(__FILE__).parent_path() / "../..";
+    std::vector<Table> tables = scanTables(root / "src/d/d_stage.cpp");
+    size_t entryNum = 0, layerTableNum = 0;
+    for (const Table& table : tables) {
+        entryNum += table.mEntries.size();
+        layerTableNum += table.mLayer;
+    }
+    HOST_CHECK(tables.size() > 10 && layerTableNum != 0, "found %zu tables, %zu layer tables",
+               tables.size(), layerTableNum);
+
+    std::vector<StageFile> files;
+    for (int i = 1; i < argc; i++) {
+        StageFile file;
+        if (!readFile(argv[i], &file)) {
+            return 1;
+        }
+        files.push_back(file);
+    }
+    if (files.empty()) {
+        makeFiles(tables, &files);
+    }
+
+    const int layerNum = 15;
+    size_t callNum = 0, chunkNum = 0;
+    int fallbackNum = 0;
+    for (StageFile& file : files) {
+        chunkNum += file.get()->m_chunkCount;
+        fallbackNum += file.get()->m_chunkCount > 128;
+
+        std::vector<u32> calls[2];
+        for (int build = 0; build < 2; build++) {
+            l_calls.clear();
+            if (build == 0) {
+                decodeAll<ref::dStage_dt_c_decode>(file, tables, layerNum);
+            } else {
+                decodeAll<indexed::dStage_dt_c_decode>(file, tables, layerNum);
+            }
+            calls[build].swap(l_calls);
+        }
+        HOST_CHECK(calls[0] == calls[1], "%s: handler calls differ", file.mName.c_str());
+        callNum += calls[0].size();
+    }
+    printf("%zu files (%zu chunks, %d over 128), %zu tables of %zu entries: %zu calls\n",
+           files.size(), chunkNum, fallbackNum, tables.size(), entryNum, callNum);
+
+    for (Table& table : tables) {
+        for (FuncTable& entry : table.mEntries) {
+            entry.function = countCall;
+        }
+    }
+    // Time each table on its own, since the index only pays for itself on longer tables.
+    static const int l_sizeGroup[] = {1, 4, 8, 1000};
+    const int passes = 100;
+    double time[3][2] = {};
+    int decodeNum[3] = {};
+    int count[2] = {};
+    for (Table& table : tables) {
+        int group = 0;
+        while ((int)table.mEntries.size() >= l_sizeGroup[group + 1]) {
+            group++;
+        }
+        if (table.mLayer) {
+            dStage_setLayerTagName(table.mEntries.data(), table.mEntries.size(), 0);
+        }
+        decodeNum[group] += passes * files.size();
+        for (int build = 0; build < 2; build++) {
+            l_callNum = 0;
+            double start = host_seconds();
+            for (int pass = 0; pass < passes; pass++) {
+                for (StageFile& file : files) {
+                    (build == 0 ? ref::dStage_dt_c_decode : indexed::dStage_dt_c_decode)(
+                        file.get(), NULL, table.mEntries.data(), table.mEntries.size());
+                }
+            }
+            time[group][build] += host_seconds() - start;
+            count[build] += l_callNum;
+        }
+    }
+    HOST_CHECK(count[0] == count[1], "timed runs made %d and %d calls", count[0], count[1]);
+    for (int group = 0; group < 3; group++) {
+        if (decodeNum[group] != 0) {
+            printf("%d+ entry tables: scan %.0f ns, index %.0f ns per decode\n",
+                   l_sizeGroup[group], time[group][0] * 1e9 / decodeNum[group],
+                   time[group][1] * 1e9 / decodeNum[group]);
+        }
+    }
+
+    return host_check_result("stage_decode");
+}
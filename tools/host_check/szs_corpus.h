@@ -0,0 +1,189 @@
+#ifndef SZS_CORPUS_H
+#define SZS_CORPUS_H
+
+/**
+ * Host-side Yaz0/Yay0 encoders and a generated sample corpus, shared by the checks that
+ * decode compressed data.
+ */
+
+#include "host_check.h"
+#include <vector>
+
+typedef std::vector<u8> Bytes;
+
+static const u32 MAX_DIST = 0x1000;
+static const u32 MAX_COUNT = 0x111;
+
+/** Greedy longest match over a hash chain, capped so large files encode quickly. */
+struct Matcher {
+    const Bytes& mData;
+    std::vector<int> mHead;
+    std::vector<int> mPrev;
+
+    explicit Matcher(const Bytes& data) : mData(data), mHead(0x10000, -1), mPrev(data.size(), -1) {}
+
+    u32 hash(u32 i) const { return (mData[i] * 0x9E3779B1u ^ mData[i + 1] << 8 ^ mData[i + 2]) & 0xFFFF; }
+
+    void insert(u32 i) {
+        if (i + 2 < mData.size()) {
+            u32 h = hash(i);
+            mPrev[i] = mHead[h];
+            mHead[h] = i;
+        }
+    }
+
+    u32 find(u32 i, u32* dist) const {
+        u32 best = 0;
+        if (i + 2 >= mData.size()) {
+            return 0;
+        }
+        int tries = 64;
+        for (int j = mHead[hash(i)]; j >= 0 && i - j <= MAX_DIST && tries-- > 0; j = mPrev[j]) {
+            u32 n = 0;
+            while (n < MAX_COUNT && i + n < mData.size() && mData[j + n] == mData[i + n]) {
+                n++;
+            }
+            if (n > best) {
+                best = n;
+                *dist = i - j;
+            }
+        }
+        return best >= 3 ? best : 0;
+    }
+};
+
+static Bytes encodeYaz0(const Bytes& data) {
+    Bytes out(16, 0);
+    memcpy(&out[0], "Yaz0", 4);
+    put_be32(&out[4], data.size());
+    Matcher matcher(data);
+    u32 i = 0;
+    while (i < data.size()) {
+        size_t flagPos = out.size();
+        out.push_back(0);
+        for (int bit = 0; bit < 8 && i < data.size(); bit++) {
+            u32 dist;
+            u32 count = matcher.find(i, &dist);
+            if (count == 0) {
+                out[flagPos] |= 0x80 >> bit;
+                out.push_back(data[i]);
+                matcher.insert(i++);
+                continue;
+            }
+            u32 d = dist - 1;
+            if (count >= 0x12) {
+                out.push_back(d >> 8);
+                out.push_back(d);
+                out.push_back(count - 0x12);
+            } else {
+                out.push_back((count - 2) << 4 | d >> 8);
+                out.push_back(d);
+            }
+            for (u32 k = 0; k < count; k++) {
+                matcher.insert(i++);
+            }
+        }
+    }
+    return out;
+}
+
+static Bytes encodeYay0(const Bytes& data) {
+    std::vector<u32> masks;
+    Bytes links;
+    Bytes chunks;
+    Matcher matcher(data);
+    u32 i = 0;
+    int bit = 32;
+    while (i < data.size()) {
+        if (bit == 32) {
+            masks.push_back(0);
+            bit = 0;
+        }
+        u32 dist;
+        u32 count = matcher.find(i, &dist);
+        if (count == 0) {
+            masks.back() |= 0x80000000u >> bit;
+            chunks.push_back(data[i]);
+            matcher.insert(i++);
+        } else {
+            u32 d = dist - 1;
+            if (count >= 0x12) {
+                links.push_back(d >> 8);
+                links.push_back(d);
+                chunks.push_back(count - 0x12);
+            } else {
+                links.push_back((count - 2) << 4 | d >> 8);
+                links.push_back(d);
+            }
+            for (u32 k = 0; k < count; k++) {
+                matcher.insert(i++);
+            }
+        }
+        bit++;
+    }
+
+    Bytes out(16 + masks.size() * 4);
+    memcpy(&out[0], "Yay0", 4);
+    put_be32(&out[4], data.size());
+    put_be32(&out[8], out.size());
+    put_be32(&out[12], out.size() + links.size());
+    for (size_t m = 0; m < masks.size(); m++) {
+        put_be32(&out[16 + m * 4], masks[m]);
+    }
+    out.insert(out.end(), links.begin(), links.end());
+    out.insert(out.end(), chunks.begin(), chunks.end());
+    return out;
+}
+
+/** Sample files: incompressible, runs, short periods, text-like and structured data. */
+static std::vector<Bytes> makeCorpus() {
+    static const u32 sizes[] = {1, 2, 3, 17, 18, 19, 273, 274, 4096, 4097, 30000, 200000};
+    static const char* const words[] = {"J3D", "model", "anm", "joint", "mat", "tex", "  ", "\n", "0x", "ff"};
+    std::vector<Bytes> corpus;
+    HostRandom rnd(0x5A5A1234);
+    for (u32 size : sizes) {
+        for (int kind = 0; kind < 5; kind++) {
+            Bytes data(size);
+            u32 period = 1 + rnd.below(24);
+            for (u32 i = 0; i < size;) {
+                switch (kind) {
+                case 0:
+                    data[i++] = rnd.next();
+                    break;
+                case 1: {
+                    u32 run = 1 + rnd.below(600);
+                    u8 value = rnd.below(3);
+                    for (; run != 0 && i < size; run--) {
+                        data[i++] = value;
+                    }
+                    break;
+                }
+                case 2:
+                    data[i] = i < period ? rnd.next() : data[i - period];
+                    i++;
+                    break;
+                case 3: {
+                    const char* word = words[rnd.below(10)];
+                    for (; *word != '\0' && i < size; word++) {
+                        data[i++] = *word;
+                    }
+                    break;
+                }
+                default: {
+                    f32 value = (f32)rnd.below(64) * 0.25f;
+                    u32 bits;
+                    memcpy(&bits, &value, 4);
+                    for (int b = 0; b < 4 && i < size; b++) {
+                        data[i++] = bits >> (24 - b * 8);
+                    }
+                    break;
+                }
+                }
+            }
+            corpus.push_back(data);
+        }
+    }
+    return corpus;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef HOST_CHECK_TREE_SHIM_H
+#define HOST_CHECK_TREE_SHIM_H
+
+/**
+ * Included ahead of every tree source a host check builds. global.h pulls
+ * std::isnan from <cmath>, which MSL's <cmath> does not declare.
+ */
+namespace std {
+inline bool(isnan)(float x) {
+    return x != x;
+}
+}  // namespace std
+
+/**
+ * types.h makes s32 and u32 longs, which are 8 bytes on a 64 bit host. Code
+ * like JPARandom's float tricks needs them to be 32 bits, as on the console.
+ */
+#define s32 host_long_s32
+#define u32 host_long_u32
+#define vs32 host_long_vs32
+#define vu32 host_long_vu32
+#include <dolphin/types.h>
+// JGadget_outMessage overloads operator<< for both int and s32.
+#include "JSystem/JGadget/define.h"
+#undef s32
+#undef u32
+#undef vs32
+#undef vu32
+
+typedef signed int s32;
+typedef unsigned int u32;
+typedef volatile s32 vs32;
+typedef volatile u32 vu32;
+
+/**
+ * The bus clock lives in low memory on the console, which OSTicksToMicroseconds and friends
+ * read through a fixed address. Give them the GameCube's clock instead.
+ */
+#include <dolphin/os.h>
+#undef __OSBusClock
+#define __OSBusClock 162000000u
+
+/**
+ * xmmintrin.h pulls in mm_malloc.h, which wants a <stdlib.h> that MSL does not have. Nothing
+ * built here uses _mm_malloc, so its header is marked as already included.
+ */
+#define _MM_MALLOC_H_INCLUDED
+
+#endif